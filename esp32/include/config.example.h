@@ -21,7 +21,19 @@
 
 // Hardware Pin Configuration
 #define IR_RECEIVE_PIN 5    // GPIO for IR receiver (TSOP38238)
+// Capture with the RMT receiver (hardware edge timestamps, whole frames
+// per interrupt) instead of IRrecv's GPIO interrupt and timer
+// #define IR_RECEIVE_RMT
+// Or decode edge by edge as the frame arrives (pin interrupt + streaming
+// decoder): results at the frame's last edge, not after a 50ms timeout
+// #define IR_RECEIVE_STREAMING
+// Outside learning the receiver keeps listening and uploads the presses
+// of other remotes (devices/{id}/sniffed). Define to listen only while learning.
+// #define IR_NO_SNIFF
 #define IR_SEND_PIN 4       // GPIO for IR LED transmitter
+// Extra IR LEDs (rack installs), addressed as outputs 1, 2, 3 by the
+// pendingCommand "output" field; output 0 is IR_SEND_PIN. Up to 3.
+// #define IR_EXTRA_SEND_PINS 6, 7
 #define NEOPIXEL_PIN 48     // Built-in NeoPixel on ESP32-S3 DevKit
 #define NEOPIXEL_COUNT 1    // Number of NeoPixels
 #define NEOPIXEL_BRIGHTNESS 25  // 0-255, lower = dimmer (25 ≈ 10%)
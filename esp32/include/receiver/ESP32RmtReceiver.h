@@ -0,0 +1,52 @@
+#ifndef ESP32_RMT_RECEIVER_H
+#define ESP32_RMT_RECEIVER_H
+
+#include "IRmtReceiver.h"
+#include <atomic>
+#include <driver/rmt.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// RX channels are 4-7 on the ESP32-S3 (0-3 are the IR outputs)
+//
+// The legacy driver has no receive callback. With a frame hook set, a
+// small task blocks on the ring buffer instead: it takes each frame as
+// it lands, calls the hook, and parks the frame until receive() copies
+// it out and hands it back to the driver. Without a hook receive()
+// reads the ring buffer directly.
+class ESP32RmtReceiver : public IRmtReceiver {
+public:
+    explicit ESP32RmtReceiver(uint16_t pin, rmt_channel_t channel = RMT_CHANNEL_4);
+    ~ESP32RmtReceiver() override;
+    
+    bool begin(uint16_t idleThresholdUs) override;
+    bool start() override;
+    void stop() override;
+    size_t receive(RmtSymbol* symbols, size_t capacity) override;
+    bool setFrameHook(RmtFrameHook hook, void* context) override;
+
+private:
+    // Driver ring buffer: a few maximum-length frames
+    static const size_t kRingBufferBytes = 8192;
+    
+    // Frame watcher: above loop() and the sniff task, below irTx
+    static const UBaseType_t kWatchPriority = 3;
+    static const BaseType_t kWatchCore = 1;
+    static const uint32_t kWatchStackSize = 2048;
+    
+    uint16_t pin;
+    rmt_channel_t channel;
+    bool installed;
+    RingbufHandle_t ringBuffer;
+    
+    RmtFrameHook frameHook;
+    void* frameContext;
+    TaskHandle_t watcher;
+    std::atomic<rmt_item32_t*> parked;  // Taken by the watcher, not yet read
+    size_t parkedBytes;                 // Written before parked is published
+    
+    bool startWatcher();
+    static void watch(void* arg);
+};
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef EDGE_SIGNAL_CAPTURE_H
+#define EDGE_SIGNAL_CAPTURE_H
+
+#include <atomic>
+#include "ISignalCapture.h"
+#include "StreamingDecoder.h"
+#include "utils/SpscRing.h"
+
+#ifndef IRAM_ATTR
+    #define IRAM_ATTR
+#endif
+
+// ISignalCapture that decodes while the frame is arriving. IRrecv only
+// looks at a frame after its 50ms end-of-frame timeout and then decodes
+// the whole buffer; here the receiver pin's CHANGE interrupt timestamps
+// each edge into a ring, and hasSignal() feeds the durations to the
+// StreamingDecoder, so an NEC frame is ready at its footer mark and a
+// Sony frame ~1ms after its last bit.
+//
+// Frames no protocol matches are still captured as RAW: they end after
+// idleThresholdUs of quiet, like the RMT backend. decode() fills
+// decode_results the way IRrecv does (rawbuf in kRawTick units after the
+// leading gap; dedicated repeat codes flagged with repeat), and a frame is
+// held until resume(), which also drops the edges that arrived meanwhile.
+//
+// With a ready hook set, the interrupt calls it on the first edge of each
+// burst (not per edge); while that frame is partly in, pollIntervalMs()
+// asks to be polled every millisecond until the decoder or the idle
+// threshold ends it.
+class EdgeSignalCapture : public ISignalCapture {
+public:
+    typedef uint32_t (*MicrosClock)();
+    
+    static const uint16_t kDefaultIdleThresholdUs = 15000;
+    static const uint16_t kMaxTimings = 1024;
+    static const uint16_t kMinTimings = 6;    // Shorter bursts are noise
+    static const size_t kEdgeCapacity = 256;  // Edges between two polls
+    
+    explicit EdgeSignalCapture(MicrosClock clock, uint16_t idleThresholdUs = kDefaultIdleThresholdUs);
+    
+    void enable() override;
+    void disable() override;
+    void resume() override;
+    bool hasSignal() override;
+    bool decode(decode_results* results) override;
+    bool setReadyHook(CaptureReadyHook hook, void* context) override;
+    uint32_t pollIntervalMs() const override { return inFrame && !held ? 1 : 0; }
+    
+    // From the receiver pin's CHANGE interrupt: the time of one edge
+    void IRAM_ATTR onEdge(uint32_t timestampUs);
+    
+    // The held frame in microseconds, starting with a mark
+    const uint16_t* getTimings() const { return timings; }
+    uint16_t getTimingCount() const { return held ? timingCount : 0; }
+    
+    uint32_t getFrameCount() const { return frames; }
+    uint32_t getNoiseCount() const { return noise; }
+    uint32_t getOverflowCount() const { return overflows; }
+    
+    // Time from the frame's last edge to the poll that produced it
+    uint32_t getLastLatencyUs() const { return lastLatencyUs; }
+
+private:
+    MicrosClock clock;
+    uint16_t idleThresholdUs;
+    std::atomic<bool> enabled;
+    std::atomic<uint32_t> droppedEdges;  // Ring full: written by the ISR only
+    SpscRing<uint32_t, kEdgeCapacity> edges;
+    CaptureReadyHook readyHook;
+    void* readyContext;
+    uint32_t lastIsrEdge;                // Interrupt side only
+    
+    StreamingDecoder decoder;
+    bool held;
+    bool inFrame;
+    bool tooLong;
+    uint32_t lastEdge;
+    uint32_t droppedSeen;
+    uint16_t timings[kMaxTimings];
+    uint16_t timingCount;
+    uint16_t rawbuf[kMaxTimings + 1];
+    
+    uint32_t frames;
+    uint32_t noise;
+    uint32_t overflows;
+    uint32_t lastLatencyUs;
+    
+    // Drain the ring into the decoder; true once a frame is held
+    bool poll(uint32_t nowUs);
+    void beginFrame(uint32_t timestampUs);
+    
+    // The line went quiet: hold whatever the frame was, unless noise
+    bool endFrame(uint32_t nowUs);
+    bool hold(uint32_t nowUs);
+};
+
+#endif
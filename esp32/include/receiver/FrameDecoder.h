@@ -0,0 +1,27 @@
+#ifndef FRAME_DECODER_H
+#define FRAME_DECODER_H
+
+#include "transmitter/ProtocolDescriptors.h"
+
+// Timing-level decoding driven by the same protocol descriptors the
+// encoder uses. Input is a mark/space buffer starting with a mark (the
+// sendRaw layout); durations match within kTolerancePercent plus
+// kToleranceUs.
+
+namespace frame_decoder {
+
+const uint16_t kTolerancePercent = 25;
+const uint16_t kToleranceUs = 50;
+
+// Decode one frame of the given protocol and bit count. False if the
+// timings do not match the descriptor.
+bool decodeFrame(const ProtocolDescriptor& descriptor, const uint16_t* timings, uint16_t length,
+                 uint16_t bits, uint64_t* value);
+
+// Try every known protocol. Mark/space frames take their bit count from
+// the frame length, bi-phase frames use the descriptor default.
+IRProtocol identifyFrame(const uint16_t* timings, uint16_t length, uint64_t* value, uint16_t* bits);
+
+}  // namespace frame_decoder
+
+#endif
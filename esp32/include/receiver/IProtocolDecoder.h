@@ -10,15 +10,25 @@
     #include <IRrecv.h>
 #endif
 
+#include "RawTimingPool.h"
+#include "transmitter/ProtocolDescriptors.h"
+
+// Move-only: a RAW signal's rawTimings are a pool block, returned when
+// the signal is destroyed. Pass it on by reference or std::move.
 struct DecodedSignal {
-    const char* protocol;  // String literal: "NEC", "SAMSUNG", "SONY", "RAW"
+    const char* protocol;  // String literal: descriptor name ("NEC", "RC5", ...) or "RAW"
     uint32_t address;
     uint32_t command;
     uint64_t value;
     uint16_t bits;
-    uint16_t* rawTimings;
-    size_t rawLength;
+    RawTimings rawTimings;  // RAW only: rawbuf copy (kRawTick units, leading gap first)
     bool isKnownProtocol;
+    uint8_t confidence;    // 0-100: how well the learned frames agreed (0 = not assessed)
+    
+    // RAW only: the coding that reproduces rawTimings, when one does
+    // (value and bits then hold its payload; see ProtocolInference.h)
+    bool isInferred;
+    ProtocolDescriptor inferred;
 };
 
 class IProtocolDecoder {
@@ -2,19 +2,26 @@
 #define IRLIB_PROTOCOL_DECODER_H
 
 #include "IProtocolDecoder.h"
+#include "transmitter/ProtocolDescriptors.h"
 
 class IRLibProtocolDecoder : public IProtocolDecoder {
 public:
-    IRLibProtocolDecoder() = default;
+    // RAW timings are copied into blocks of pool (the shared one by default)
+    IRLibProtocolDecoder() : pool(&RawTimingPool::shared()) {}
+    explicit IRLibProtocolDecoder(RawTimingPool* pool) : pool(pool) {}
     ~IRLibProtocolDecoder() override = default;
     
     DecodedSignal decode(decode_results* raw) override;
 
 private:
-    DecodedSignal decodeNEC(decode_results* raw);
-    DecodedSignal decodeSamsung(decode_results* raw);
-    DecodedSignal decodeSony(decode_results* raw);
+    RawTimingPool* pool;
+    
+    // Protocols the library decoded; name comes from the descriptor table
+    DecodedSignal decodeKnown(decode_results* raw, IRProtocol protocol);
     DecodedSignal decodeRaw(decode_results* raw);
+    
+    // RAW timings a common coding reproduces become that coding's parameters
+    void inferCoding(decode_results* raw, DecodedSignal* signal);
 };
 
 #endif
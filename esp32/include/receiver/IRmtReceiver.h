@@ -0,0 +1,35 @@
+#ifndef I_RMT_RECEIVER_H
+#define I_RMT_RECEIVER_H
+
+#include "transmitter/IRmtChannel.h"
+
+// Called when a complete frame is waiting (from a driver task, not an
+// interrupt); receive() then returns it
+typedef void (*RmtFrameHook)(void* context);
+
+// Hardware abstraction for one RMT receive channel. The peripheral
+// timestamps every edge itself (1us ticks) and closes a frame when the
+// line has been idle for the threshold; complete frames wait in a ring
+// buffer, so the CPU sees one event per frame instead of one per edge.
+class IRmtReceiver {
+public:
+    virtual ~IRmtReceiver() = default;
+    
+    // Configure the channel; a frame ends after idleThresholdUs without
+    // an edge (at most RMT_MAX_SYMBOL_DURATION)
+    virtual bool begin(uint16_t idleThresholdUs) = 0;
+    
+    virtual bool start() = 0;
+    virtual void stop() = 0;
+    
+    // Take the oldest complete frame without waiting. Copies at most
+    // capacity symbols and returns the frame's full symbol count (0 when
+    // none is waiting), so a caller can tell a frame was cut short.
+    virtual size_t receive(RmtSymbol* symbols, size_t capacity) = 0;
+    
+    // Be told when a frame is waiting instead of polling receive(). False
+    // when the receiver cannot notify; the hook is then never called.
+    virtual bool setFrameHook(RmtFrameHook, void*) { return false; }
+};
+
+#endif
@@ -1,7 +1,19 @@
 #ifndef I_SIGNAL_CAPTURE_H
 #define I_SIGNAL_CAPTURE_H
 
-#include <IRrecv.h>
+#ifdef NATIVE_BUILD
+    // Native testing mode - use mocks
+    #include "../test/mock_arduino.h"
+#else
+    #include <IRrecv.h>
+#endif
+
+#include "transmitter/ProtocolDescriptors.h"
+
+// Called by event-driven backends when a frame may be waiting, from
+// their interrupt (edge capture) or a driver task (RMT): it must be safe
+// in both contexts and short
+typedef void (*CaptureReadyHook)(void* context);
 
 class ISignalCapture {
 public:
@@ -12,6 +24,31 @@ public:
     virtual void resume() = 0;
     virtual bool hasSignal() = 0;
     virtual bool decode(decode_results* results) = 0;
+    
+    // Be told when to look instead of polling. False for backends that
+    // can only be polled (IRrecv: its interrupt is internal to the
+    // library); the hook is then never called.
+    virtual bool setReadyHook(CaptureReadyHook, void*) { return false; }
+    
+    // While a frame is partly in and only silence will end it, how soon
+    // hasSignal() must run again (0: nothing pending, wait for the hook)
+    virtual uint32_t pollIntervalMs() const { return 0; }
 };
 
+// The library's decode type for a protocol identified by our own decoders
+inline decode_type_t decodeTypeFor(IRProtocol protocol) {
+    switch (protocol) {
+        case IRProtocol::NEC: return NEC;
+        case IRProtocol::SAMSUNG: return SAMSUNG;
+        case IRProtocol::SONY: return SONY;
+        case IRProtocol::RC5: return RC5;
+        case IRProtocol::RC6: return RC6;
+        case IRProtocol::PANASONIC: return PANASONIC;
+        case IRProtocol::JVC: return JVC;
+        case IRProtocol::LG: return LG;
+        case IRProtocol::SHARP: return SHARP;
+        default: return UNKNOWN;
+    }
+}
+
 #endif
@@ -3,6 +3,8 @@
 
 #include "ISignalCapture.h"
 #include "IProtocolDecoder.h"
+#include "SignalConsensus.h"
+#include <atomic>
 #include <functional>
 
 enum class LearningState {
@@ -18,12 +20,30 @@ using StateChangeCallback = std::function<void(LearningState)>;
 // Callback function type for captured signals
 using SignalCaptureCallback = std::function<void(const DecodedSignal&)>;
 
+// Learning collects framesToCollect captures (presses, or the frames a
+// held button repeats; at most SignalConsensus::kMaxFrames) and reports
+// their consensus, with its confidence. After the first capture it
+// waits at most collectWindowMs for the rest, then settles for what it
+// has.
+//
+// With an event-driven capture backend, update() only reads the capture
+// after its ready hook fired (or while a partial frame needs polling);
+// otherwise it just checks the deadlines. msUntilDue() says how long the
+// caller may block before update() has work, and setWakeHook() forwards
+// the capture's hook so that wait can end the moment a frame arrives.
 class LearningStateMachine {
 public:
+    static const uint8_t kDefaultFramesToCollect = 3;
+    static const uint32_t kDefaultCollectWindowMs = 3000;
+    static const uint32_t kPollIntervalMs = 10;       // Poll-only backends (IRrecv)
+    static const uint32_t kNoDeadline = 0xFFFFFFFF;
+    
     LearningStateMachine(
         ISignalCapture* signalCapture,
         IProtocolDecoder* decoder,
-        uint32_t timeoutMs = 30000
+        uint32_t timeoutMs = 30000,
+        uint8_t framesToCollect = kDefaultFramesToCollect,
+        uint32_t collectWindowMs = kDefaultCollectWindowMs
     );
 
     // State management
@@ -31,6 +51,15 @@ public:
     void stopLearning();
     void update();  // Call this in main loop
     
+    // Longest the caller may wait before update() has work: 0 when a
+    // capture is waiting, kNoDeadline when not learning
+    uint32_t msUntilDue(unsigned long now) const;
+    
+    // Also called (from the capture's interrupt) when a frame may be
+    // waiting, e.g. to notify the task that runs update()
+    void setWakeHook(CaptureReadyHook hook, void* context);
+    bool isEventDriven() const { return eventDriven; }
+    
     // State queries
     LearningState getState() const { return currentState; }
     bool isLearning() const { return currentState == LearningState::LEARNING; }
@@ -47,11 +76,24 @@ private:
     uint32_t timeoutMs;
     unsigned long learningStartTime;
     
+    SignalConsensus consensus;
+    uint8_t framesToCollect;
+    uint32_t collectWindowMs;
+    unsigned long firstFrameTime;
+    
+    bool eventDriven;
+    std::atomic<bool> captureReady;
+    CaptureReadyHook wakeHook;
+    void* wakeContext;
+    
     StateChangeCallback stateChangeCallback;
     SignalCaptureCallback signalCaptureCallback;
     
     void setState(LearningState newState);
     void handleLearningState();
+    void finishCapture();
+    
+    static void onCaptureReady(void* context);
 };
 
 #endif
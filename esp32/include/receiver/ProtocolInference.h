@@ -0,0 +1,58 @@
+#ifndef PROTOCOL_INFERENCE_H
+#define PROTOCOL_INFERENCE_H
+
+#include <cstddef>
+#include "transmitter/ProtocolDescriptors.h"
+
+// Turns a RAW capture of an unknown remote into a protocol descriptor
+// plus payload when it is one of the common codings with its own timings.
+//
+// Marks and spaces are clustered separately (durations within the
+// decoder's tolerance of a cluster's mean join it) and the shape picks
+// the coding:
+//   - pulse-distance: one mark length, two space lengths, footer mark
+//   - pulse-width: two mark lengths, one space length, no footer
+//   - bi-phase: every duration 1-4 half-bit units, pairs of opposite
+//     halves, at most one double-width bit (RC6's trailer)
+// A first mark longer than every later one is a header. The bits are
+// read in send order (MSB_FIRST): the true bit order cannot be seen.
+//
+// A candidate is only accepted when the generic frame encoder,
+// given the inferred descriptor and payload, reproduces the capture
+// timing for timing. Anything else (more than 64 bits, several frames,
+// a checksum-laden A/C state, noise) stays RAW. Frames are at most
+// kMaxTimings long and every step is a single pass over them, so a
+// call is bounded and allocation-free.
+//
+// A params string carries an inferred descriptor in pendingSignal and
+// back in a pendingCommand, with the payload in value/bits:
+//   "PD <headerMark> <headerSpace> <oneMark> <oneSpace> <zeroMark> <zeroSpace> <footerMark>"
+//   "PW ..."  (same fields)
+//   "BP <headerMark> <headerSpace> <unit> <oneMarkFirst> [<doubleWidthBit>]"
+
+namespace protocol_inference {
+
+const uint16_t kMinBits = 8;
+const uint16_t kMaxBits = 64;
+const uint16_t kMaxTimings = 2 + kMaxBits * 2 + 1;  // Header, 64 bits, footer
+const size_t kMaxParamsLength = 48;                 // Longest params string, with its NUL
+
+struct InferredCode {
+    ProtocolDescriptor descriptor;  // protocol UNKNOWN, named "RAW", default carrier
+    uint64_t value;
+    uint16_t bits;
+};
+
+// timings: microseconds, starting with a mark (a trailing space is
+// taken as the gap and ignored). False when no coding reproduces them.
+bool inferCode(const uint16_t* timings, uint16_t length, InferredCode* code);
+
+// Returns the string length, or 0 when out is too small
+size_t formatParams(const ProtocolDescriptor& descriptor, char* out, size_t capacity);
+
+// False for malformed text or timings no encoder can use
+bool parseParams(const char* text, ProtocolDescriptor* descriptor);
+
+}  // namespace protocol_inference
+
+#endif
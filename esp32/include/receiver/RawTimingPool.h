@@ -0,0 +1,117 @@
+#ifndef RAW_TIMING_POOL_H
+#define RAW_TIMING_POOL_H
+
+#include <cstdint>
+#include <cstddef>
+
+class RawTimingPool;
+
+// A RAW capture's rawbuf copy, on loan from a RawTimingPool. Move-only:
+// exactly one handle refers to a block, and it goes back to its pool
+// when that handle is destroyed, reset or assigned over. An empty handle
+// (default, moved from, or pool exhausted) has no data and size 0.
+class RawTimings {
+public:
+    RawTimings() : pool(nullptr), timings(nullptr), length(0) {}
+    ~RawTimings() { reset(); }
+    
+    RawTimings(const RawTimings&) = delete;
+    RawTimings& operator=(const RawTimings&) = delete;
+    
+    RawTimings(RawTimings&& other)
+        : pool(other.pool), timings(other.timings), length(other.length) {
+        other.pool = nullptr;
+        other.timings = nullptr;
+        other.length = 0;
+    }
+    
+    RawTimings& operator=(RawTimings&& other) {
+        if (this != &other) {
+            reset();
+            pool = other.pool;
+            timings = other.timings;
+            length = other.length;
+            other.pool = nullptr;
+            other.timings = nullptr;
+            other.length = 0;
+        }
+        return *this;
+    }
+    
+    // Return the block now
+    void reset();
+    
+    const uint16_t* data() const { return timings; }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    uint16_t operator[](size_t i) const { return timings[i]; }
+
+private:
+    friend class RawTimingPool;
+    
+    RawTimingPool* pool;
+    uint16_t* timings;
+    size_t length;
+    
+    RawTimings(RawTimingPool* pool, uint16_t* timings, size_t length)
+        : pool(pool), timings(timings), length(length) {}
+};
+
+// Fixed-block storage for the raw timings of decoded signals, so RAW
+// captures neither hit the heap per decode nor depend on the caller to
+// free them. Every block holds the largest rawbuf a capture backend
+// produces (kBlockTimings, leading gap included); the blocks are one slab
+// allocated in PSRAM when available, with a free stack in internal RAM.
+//
+// A signal lives from decode() to the end of the capture callback, so
+// two blocks cover the learning path with one to spare. Not thread-safe:
+// acquire and release from the task that decodes.
+class RawTimingPool {
+public:
+    static const uint16_t kBlockTimings = 1025;  // 1024 durations plus the leading gap
+    static const uint8_t kDefaultBlocks = 2;
+    
+    explicit RawTimingPool(uint8_t blocks = kDefaultBlocks);
+    ~RawTimingPool();
+    
+    RawTimingPool(const RawTimingPool&) = delete;
+    RawTimingPool& operator=(const RawTimingPool&) = delete;
+    
+    // Allocate storage; otherwise the first acquire() does
+    bool begin();
+    
+    // Copy length timings into a free block. The handle is empty when the
+    // pool is exhausted, unallocated, or the capture is longer than a
+    // block (counted as a failure; a truncated RAW frame is no use).
+    RawTimings acquire(const uint16_t* timings, size_t length);
+    
+    // Same, from IRrecv's rawbuf (volatile: its interrupt writes it),
+    // copied element by element
+    RawTimings acquire(const volatile uint16_t* timings, size_t length);
+    
+    // The pool decoders use unless given another
+    static RawTimingPool& shared();
+    
+    // Statistics
+    uint8_t getCapacity() const { return capacity; }
+    uint8_t getInUse() const { return slab ? capacity - freeCount : 0; }
+    uint8_t getHighWater() const { return highWater; }
+    uint32_t getFailures() const { return failures; }
+
+private:
+    friend class RawTimings;
+    
+    uint8_t capacity;
+    uint8_t freeCount;
+    uint8_t highWater;
+    uint32_t failures;
+    
+    uint16_t* slab;
+    uint8_t* freeBlocks;  // Stack of free block indexes
+    
+    // A free block for length timings, or null (counted as a failure)
+    uint16_t* take(size_t length);
+    void release(uint16_t* timings);
+};
+
+#endif
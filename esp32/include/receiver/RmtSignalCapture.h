@@ -0,0 +1,71 @@
+#ifndef RMT_SIGNAL_CAPTURE_H
+#define RMT_SIGNAL_CAPTURE_H
+
+#include "ISignalCapture.h"
+#include "IRmtReceiver.h"
+
+// ISignalCapture on the RMT receiver instead of IRrecv's GPIO interrupt
+// and sampling timer: edges are timestamped by the peripheral and whole
+// frames arrive through the driver's ring buffer, so WiFi interrupt load
+// cannot drop edges and idle or busy air costs no CPU per pulse.
+//
+// decode() identifies the frame with the descriptor-driven frame decoder
+// and fills decode_results the way IRrecv does (value and bits for known
+// protocols, rawbuf in kRawTick units after the leading gap), so the
+// protocol decoder and learning flow work unchanged. address/command are
+// left 0; they are display-only. Like IRrecv, a decoded frame is held
+// until resume().
+//
+// The ready hook is passed to the receiver, which calls it once per
+// complete frame, so nothing needs polling (pollIntervalMs() stays 0).
+class RmtSignalCapture : public ISignalCapture {
+public:
+    // Longer than any space inside a frame, shorter than the gap between
+    // repeats of all supported protocols but 20-bit Sony
+    static const uint16_t kDefaultIdleThresholdUs = 15000;
+    static const uint16_t kMaxSymbols = 512;
+    static const uint16_t kMaxTimings = kMaxSymbols * 2;
+    static const uint16_t kMinTimings = 6;  // Shorter bursts are noise
+    
+    // activeLow: demodulating receivers (TSOP) pull the line low on a mark
+    explicit RmtSignalCapture(IRmtReceiver* receiver, uint16_t idleThresholdUs = kDefaultIdleThresholdUs,
+                              bool activeLow = true);
+    
+    void enable() override;
+    void disable() override;
+    void resume() override;
+    bool hasSignal() override;
+    bool decode(decode_results* results) override;
+    bool setReadyHook(CaptureReadyHook hook, void* context) override;
+    
+    // The held frame in microseconds, starting with a mark
+    const uint16_t* getTimings() const { return timings; }
+    uint16_t getTimingCount() const { return held ? timingCount : 0; }
+    
+    uint32_t getFrameCount() const { return frames; }
+    uint32_t getNoiseCount() const { return noise; }
+    uint32_t getOverflowCount() const { return overflows; }
+
+private:
+    IRmtReceiver* receiver;
+    uint16_t idleThresholdUs;
+    bool activeLow;
+    bool begun;
+    bool enabled;
+    bool held;
+    
+    RmtSymbol symbols[kMaxSymbols];
+    uint16_t timings[kMaxTimings];
+    uint16_t timingCount;
+    uint16_t rawbuf[kMaxTimings + 1];
+    
+    uint32_t frames;
+    uint32_t noise;
+    uint32_t overflows;
+    
+    // Pull frames from the receiver until one is worth holding
+    bool fetch();
+    uint16_t toTimings(size_t symbolCount);
+};
+
+#endif
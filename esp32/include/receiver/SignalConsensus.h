@@ -0,0 +1,75 @@
+#ifndef SIGNAL_CONSENSUS_H
+#define SIGNAL_CONSENSUS_H
+
+#include "ISignalCapture.h"
+
+// Learns one command from several captures of it (separate presses, or
+// the frames a held button repeats) instead of trusting the first.
+//
+// Frames the library decoded vote on (protocol, value, bits); a majority
+// wins. Otherwise, or to rebuild the winner's timings, the largest group
+// of frames that line up slot for slot (same length, every duration
+// within kTolerancePercent) is merged by taking the median of each slot,
+// and the result is snapped to the remote's own timing grid: marks and
+// spaces are clustered separately and each replaced by its cluster's
+// mean, so one jittery capture cannot leave 540/580/610us "ones" behind.
+//
+// Storage is fixed (kMaxFrames x kMaxTimings), and build() is
+// O(frames^2 x timings) plus a sort of one frame: bounded on the device.
+class SignalConsensus {
+public:
+    static const uint8_t kMaxFrames = 5;
+    static const uint16_t kMaxTimings = 1024;    // rawbuf entries, leading gap included
+    static const uint8_t kTolerancePercent = 25; // Same slot in two frames
+    static const uint8_t kGridPercent = 15;      // Durations snapped to one grid value
+    
+    SignalConsensus();
+    
+    void reset();
+    
+    // Copy one capture. False (frame ignored) when full, for repeat codes
+    // and for frames too long to hold.
+    bool add(const decode_results& frame);
+    
+    uint8_t getFrameCount() const { return count; }
+    
+    // Merge the frames into result, in IRrecv's layout (rawbuf points
+    // into this object until the next add() or reset()). Returns the
+    // confidence, 0-100: the share of expectedFrames that agreed, scaled
+    // down by how far the agreeing frames strayed from the median.
+    uint8_t build(decode_results* result, uint8_t expectedFrames);
+
+private:
+    struct Frame {
+        int decodeType;
+        uint64_t value;
+        uint16_t bits;
+        uint32_t address;
+        uint32_t command;
+        uint16_t length;
+    };
+    
+    Frame frames[kMaxFrames];
+    uint16_t timings[kMaxFrames][kMaxTimings];
+    uint8_t count;
+    uint16_t merged[kMaxTimings];
+    uint16_t order[kMaxTimings / 2];
+    
+    bool sameKey(const Frame& a, const Frame& b) const;
+    bool aligned(uint8_t a, uint8_t b) const;
+    
+    // Frames voting for the most common decoded key; -1 if none decoded
+    int8_t majority(uint8_t* votes) const;
+    
+    // Largest set of aligned frames among candidates (bitmask)
+    uint8_t largestGroup(uint8_t candidates, uint8_t* members) const;
+    
+    // Per-slot median over members (bitmask) into merged; returns the
+    // mean deviation in percent
+    uint32_t medianOf(uint8_t members, uint8_t memberCount);
+    
+    // Snap every second slot from first to the cluster means
+    void snapToGrid(uint16_t first, uint16_t length);
+};
+
+#endif
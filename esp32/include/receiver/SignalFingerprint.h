@@ -0,0 +1,33 @@
+#ifndef SIGNAL_FINGERPRINT_H
+#define SIGNAL_FINGERPRINT_H
+
+#include "IProtocolDecoder.h"
+
+// 32-bit identity of a captured command, equal for every capture of the
+// same button:
+//   - known protocols: (protocol, value, bits)
+//   - inferred codings: (coding, value, bits)
+//   - RAW: the shape of the frame. Each duration is compared with the one
+//     two before it (same kind: mark with mark, space with space) as
+//     shorter, similar or longer, with 20% either way counting as similar,
+//     and those symbols are hashed. Jitter well inside 20% leaves the
+//     fingerprint alone, and learned signals are snapped to their timing
+//     grid by SignalConsensus before this sees them.
+// Every form is FNV-1a over a kind byte and the fields, then mixed, so
+// the low bits are fit to index a hash table. 0 is never returned (it
+// marks an empty slot).
+
+namespace signal_fingerprint {
+
+uint32_t ofCode(IRProtocol protocol, uint64_t value, uint16_t bits);
+uint32_t ofInferred(BitCoding coding, uint64_t value, uint16_t bits);
+
+// Durations starting with a mark, any unit
+uint32_t ofTimings(const uint16_t* timings, size_t length);
+
+// Picks the form for a decoded signal (rawTimings skip the leading gap)
+uint32_t of(const DecodedSignal& signal);
+
+}  // namespace signal_fingerprint
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef SIGNAL_SNIFFER_H
+#define SIGNAL_SNIFFER_H
+
+#include <atomic>
+#include "ISignalCapture.h"
+#include "IProtocolDecoder.h"
+#include "utils/SpscRing.h"
+
+// One frame heard from another remote
+struct SniffedFrame {
+    const char* protocol;  // As DecodedSignal::protocol ("RAW" when unnamed)
+    uint64_t value;
+    uint16_t bits;
+    bool repeat;           // The protocol's "still held" frame
+    uint32_t fingerprint;  // signal_fingerprint::of(), to match learned commands
+    uint32_t atMs;         // millis() when decoded
+};
+
+// Snapshot of sniffer counters (producer-written, read from either task)
+struct SnifferStats {
+    uint32_t frames;       // Decoded and queued
+    uint32_t overruns;     // Decoded but dropped: ring full
+    uint32_t depth;
+    uint32_t maxDepth;
+    uint32_t lastFrameUs;  // Capture read, decode and fingerprint of one frame
+    uint32_t maxFrameUs;
+    uint32_t meanFrameUs;
+    uint64_t busyUs;
+};
+
+// Always-on listening outside learning, so presses of the original
+// remote are seen. The sniff task (producer) reads and decodes every
+// frame into a lock-free ring and resumes the capture at once; loop()
+// (consumer) pops frames when it gets to them and never waits on the
+// receiver. A full ring drops the new frame and counts an overrun.
+// Host-testable; the FreeRTOS task lives in SniffTask.
+//
+// The capture has one reader at a time: learning takes it with pause(),
+// which returns once poll() is not in the middle of a frame, and gives
+// it back with resume().
+class SignalSniffer {
+public:
+    typedef uint32_t (*MicrosClock)();
+    
+    static const size_t kCapacity = 32;
+    static const uint32_t kPollIntervalMs = 10;  // Poll-only backends (IRrecv)
+    
+    // decoder should have its own RawTimingPool: it runs on the sniff task
+    SignalSniffer(ISignalCapture* capture, IProtocolDecoder* decoder, MicrosClock clock);
+    
+    // Producer: decode and queue the waiting frame, if any. True when
+    // one was read (queued or dropped).
+    bool poll();
+    
+    // Producer: how long the sniff task may sleep before polling again
+    // (a capture's ready hook may wake it earlier)
+    uint32_t msUntilDue() const;
+    
+    // Consumer: false when no frame is waiting
+    bool pop(SniffedFrame* frame);
+    
+    // Consumer: hand the capture to learning and back
+    void pause();
+    void resume();
+    bool isPaused() const { return paused.load(); }
+    
+    SnifferStats getStats() const;
+
+private:
+    ISignalCapture* capture;
+    IProtocolDecoder* decoder;
+    MicrosClock clock;
+    SpscRing<SniffedFrame, kCapacity> ring;
+    
+    // pause() sets paused, then waits for polling to clear; poll() sets
+    // polling, then checks paused. Sequentially consistent, so one of
+    // them always sees the other.
+    std::atomic<bool> paused;
+    std::atomic<bool> polling;
+    
+    // Producer-written
+    std::atomic<uint32_t> frames;
+    std::atomic<uint32_t> overruns;
+    std::atomic<uint32_t> maxDepth;
+    std::atomic<uint32_t> lastFrameUs;
+    std::atomic<uint32_t> maxFrameUs;
+    std::atomic<uint64_t> busyUs;
+    
+    void record(uint32_t us, bool queued);
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef SNIFF_TASK_H
+#define SNIFF_TASK_H
+
+#include "SignalSniffer.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// FreeRTOS task that runs SignalSniffer::poll(). It sits on core 1 with
+// the transmit tasks, above loop() and below them: a frame is read while
+// loop() is busy uploading, and sniffing never delays an emission.
+class SniffTask {
+public:
+    static const BaseType_t kDefaultCore = 1;
+    static const UBaseType_t kDefaultPriority = 2;  // loopTask 1, irTx 5
+    static const uint32_t kStackSize = 4096;
+    
+    explicit SniffTask(SignalSniffer* sniffer);
+    
+    bool begin(BaseType_t core = kDefaultCore, UBaseType_t priority = kDefaultPriority);
+    
+    // From the capture's ready hook: poll now
+    void IRAM_ATTR wakeFromIsr(BaseType_t* woken);
+    void wake();
+    
+    // esp_timer time, for the sniffer's per-frame cost
+    static uint32_t clockMicros();
+
+private:
+    SignalSniffer* sniffer;
+    TaskHandle_t handle;
+    
+    static void run(void* arg);
+};
+
+#endif
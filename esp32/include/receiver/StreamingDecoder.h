@@ -0,0 +1,100 @@
+#ifndef STREAMING_DECODER_H
+#define STREAMING_DECODER_H
+
+#include "transmitter/ProtocolDescriptors.h"
+
+// What a frame decoded to
+struct StreamResult {
+    IRProtocol protocol;
+    uint64_t value;
+    uint16_t bits;
+    bool repeat;  // The protocol's dedicated repeat code: no value
+};
+
+// Decodes a frame while it is still arriving, one duration at a time,
+// instead of after the end-of-frame gap. Every known protocol runs its own
+// small state machine over the same edges; a machine drops out at its
+// first mismatch (usually the header mark), and the result is emitted as
+// soon as one machine has completed and no other is still undecided:
+// - frames with a footer mark, and bi-phase frames, at their last edge
+// - frames without one (Sony's 12/15/20 bits) once the line has been
+//   quiet longer than any space the protocol uses (<1ms for Sony)
+// Durations match as in frame_decoder, and a tie resolves the same way
+// identifyFrame() does: the protocol's own bit count first, then
+// descriptor order.
+//
+// Not thread-safe; feed it from one task (the ISR only timestamps edges).
+class StreamingDecoder {
+public:
+    StreamingDecoder();
+    
+    // Forget the current frame; the next duration is a mark
+    void reset();
+    
+    // One completed duration in microseconds, marks and spaces alternating
+    // from a mark. True when this completed the frame.
+    bool push(uint32_t durationUs);
+    
+    // The line has been quiet for silentUs since the last pushed mark.
+    // True when that completed the frame.
+    bool idle(uint32_t silentUs);
+    
+    bool hasResult() const { return done; }
+    const StreamResult& getResult() const { return result; }
+    
+    // Protocols still matching the frame (0: the frame is none of them)
+    uint8_t getLiveCount() const;
+
+private:
+    enum class Phase : uint8_t {
+        HEADER_MARK,
+        HEADER_SPACE,
+        REPEAT_MARK,
+        BIT_MARK,     // Bi-phase: any duration inside the bits
+        BIT_SPACE,
+        SECOND_GAP,   // Between a frame and its inverted copy
+        COMPLETE,
+        REJECTED
+    };
+    
+    struct Matcher {
+        const ProtocolDescriptor* descriptor;
+        Phase phase;
+        bool secondFrame;
+        bool repeat;
+        bool markOne;        // The pending bit's mark fits a '1'
+        bool markZero;
+        bool markFooter;
+        uint8_t bitCount;    // Bi-phase: start bits included
+        uint8_t slots;       // Bi-phase: undecoded half-bit levels, oldest in bit 0
+        uint8_t slotCount;
+        uint16_t slotsSeen;
+        uint64_t value;
+        uint64_t firstValue;
+    };
+    
+    static const uint8_t kMaxProtocols = 16;
+    
+    Matcher matchers[kMaxProtocols];
+    uint8_t matcherCount;
+    uint16_t edges;
+    bool done;
+    StreamResult result;
+    
+    void stepMarkSpace(Matcher& m, uint32_t duration, bool mark);
+    void stepBiphase(Matcher& m, uint32_t duration, bool mark);
+    void frameDone(Matcher& m);
+    void pushBit(Matcher& m, bool one);
+    void addSlots(Matcher& m, bool mark, uint16_t units);
+    
+    // The frame ended after the last mark
+    void finish(Matcher& m);
+    
+    // Longest space the matcher could still take as part of the frame
+    uint32_t spaceLimit(const Matcher& m) const;
+    
+    // Emit a result once no matcher is undecided
+    bool settle();
+};
+
+#endif
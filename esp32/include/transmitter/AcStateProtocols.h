@@ -0,0 +1,64 @@
+#ifndef AC_STATE_PROTOCOLS_H
+#define AC_STATE_PROTOCOLS_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Air conditioner remotes send their whole state (mode, temperature,
+// fan, swing...) as one long frame of bytes on every button press,
+// 72-280 bits split into sections with their own header and checksum.
+// They are described separately from the IRProtocol value descriptors:
+// the payload is a byte array, not a 64-bit value.
+enum class AcProtocol : uint8_t {
+    UNKNOWN = 0,
+    MITSUBISHI_AC,  // 144 bits, sent twice
+    DAIKIN,         // 280 bits: preamble + three sections
+    TOSHIBA_AC      // 72 bits, sent twice
+};
+
+enum class AcChecksum : uint8_t {
+    SUM8,  // Last byte of each section = sum of the others, mod 256
+    XOR8   // Last byte of each section = XOR of the others
+};
+
+#define AC_MAX_STATE_BYTES 35
+#define AC_MAX_SECTIONS 3
+
+// Timings in microseconds (from the IRremoteESP8266 senders). Every bit
+// is bitMark followed by oneSpace/zeroSpace; each section is header,
+// bits, footer mark. Sections are separated by sectionGap and copies of
+// the whole frame by copyGap.
+struct AcStateDescriptor {
+    AcProtocol protocol;
+    const char* name;
+    uint16_t headerMark;
+    uint16_t headerSpace;
+    uint16_t bitMark;
+    uint16_t oneSpace;
+    uint16_t zeroSpace;
+    uint16_t sectionGap;
+    uint16_t copyGap;
+    uint8_t preambleBits;    // Headerless '0' bits + footer + sectionGap before the first section
+    bool msbFirst;           // Bit order within each byte
+    AcChecksum checksum;
+    uint8_t sectionCount;
+    uint8_t sectionBytes[AC_MAX_SECTIONS];
+    uint8_t copies;          // Times the frame is sent
+    uint16_t carrierKHz;
+    uint8_t dutyPercent;
+};
+
+const AcStateDescriptor* findAcDescriptor(AcProtocol protocol);
+AcProtocol acProtocolFromName(const char* name);
+
+// Total state length (sum of the sections)
+uint16_t acStateBytes(const AcStateDescriptor& descriptor);
+
+// Overwrite the checksum byte of every section. state must hold
+// acStateBytes() bytes.
+void applyAcChecksum(const AcStateDescriptor& descriptor, uint8_t* state);
+
+// True if every section's checksum byte matches
+bool verifyAcChecksum(const AcStateDescriptor& descriptor, const uint8_t* state);
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef AC_STATE_STREAM_H
+#define AC_STATE_STREAM_H
+
+#include "AcStateProtocols.h"
+#include "IRmtChannel.h"
+
+// Encodes an A/C state frame into RMT symbols chunk by chunk, so a
+// 280-bit frame sent twice never needs a full timing or symbol buffer.
+// The frame is a short list of segments (fixed timings and runs of
+// state bits) walked with a cursor; each fill() picks up where the last
+// one stopped.
+class AcStateStream : public IRmtSymbolSource {
+public:
+    AcStateStream();
+    
+    // Lay out the frame for state (acStateBytes() bytes, checksums
+    // already applied). state must stay valid while the stream is read.
+    bool begin(const AcStateDescriptor& descriptor, const uint8_t* state);
+    
+    size_t symbolCount() const override { return totalSymbols; }
+    size_t fill(RmtSymbol* symbols, size_t capacity) override;
+    
+    // Mark/space timings of the whole frame (for tests and the cache);
+    // returns the number written, or 0 if capacity is too small
+    uint16_t render(uint16_t* timings, uint16_t capacity);
+
+private:
+    // Fixed timing, or the bit timings of byteCount state bytes
+    struct Segment {
+        uint16_t duration;
+        uint8_t firstByte;
+        uint8_t byteCount;
+    };
+    
+    static const uint8_t kMaxSegments = 64;
+    
+    const AcStateDescriptor* descriptor;
+    const uint8_t* state;
+    Segment segments[kMaxSegments];
+    uint8_t segmentCount;
+    size_t totalSymbols;
+    
+    // Read cursor
+    uint8_t segment;
+    uint16_t bitTiming;      // Index into the current bit segment's timings
+    uint32_t remaining;      // Unsent part of the current timing
+    uint32_t timingIndex;    // Timings started so far; even = mark
+    
+    void addTiming(uint16_t duration);
+    void addBits(uint8_t firstByte, uint8_t byteCount);
+    void rewind();
+    bool nextTiming(uint16_t* duration);
+    bool nextHalf(uint16_t* duration, uint8_t* level);
+};
+
+#endif
@@ -10,10 +10,15 @@ public:
     ~ESP32IRTransmitter() override;
 
     void begin() override;
-    TransmitResult transmit(uint16_t* rawData, uint16_t length, uint16_t frequency = 38) override;
+    TransmitResult transmit(uint16_t* rawData, uint16_t length, uint16_t frequency = IR_DEFAULT_CARRIER_KHZ,
+                            uint8_t dutyPercent = IR_DEFAULT_DUTY_PERCENT) override;
     TransmitResult transmitNEC(uint32_t data, uint16_t nbits = 32) override;
     TransmitResult transmitSamsung(uint64_t data, uint16_t nbits = 32) override;
     TransmitResult transmitSony(uint32_t data, uint16_t nbits = 12) override;
+    TransmitResult transmitValue(IRProtocol protocol, uint64_t value, uint16_t nbits,
+                                 uint16_t carrierKHz = 0, uint8_t dutyPercent = 0) override;
+    TransmitResult transmitState(AcProtocol protocol, const uint8_t* state, uint16_t length,
+                                 uint16_t carrierKHz = 0, uint8_t dutyPercent = 0) override;
 
 private:
     IRsend* irsend;
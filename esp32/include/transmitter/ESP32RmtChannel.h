@@ -0,0 +1,33 @@
+#ifndef ESP32_RMT_CHANNEL_H
+#define ESP32_RMT_CHANNEL_H
+
+#include "IRmtChannel.h"
+#include <driver/rmt.h>
+
+class ESP32RmtChannel : public IRmtChannel {
+public:
+    explicit ESP32RmtChannel(uint16_t pin, rmt_channel_t channel = RMT_CHANNEL_0, bool inverted = false);
+    ~ESP32RmtChannel() override;
+
+    bool begin() override;
+    bool setCarrier(uint32_t frequencyHz, uint8_t dutyPercent) override;
+    bool write(const RmtSymbol* symbols, size_t count) override;
+    bool writeStream(IRmtSymbolSource* source) override;
+    bool waitDone(uint32_t timeoutMs) override;
+
+private:
+    uint16_t pin;
+    rmt_channel_t channel;
+    bool inverted;
+    bool installed;
+    uint32_t carrierFrequencyHz;
+    uint8_t carrierDutyPercent;
+    bool translatorInstalled;
+    
+    // Driver translator: called from the RMT ISR each time half of the
+    // channel memory has been sent, to refill it from the stream source
+    static void translate(const void* src, rmt_item32_t* dest, size_t srcSize, size_t wanted,
+                          size_t* translated, size_t* itemCount);
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef FRAME_ENCODER_H
+#define FRAME_ENCODER_H
+
+#include "ProtocolDescriptors.h"
+#include "IProtocolEncoder.h"
+
+// Frame encoding driven by protocol descriptors.
+//
+// encodeFrame(descriptor, ...) is the generic engine: it handles every
+// BitCoding and is what protocols without a specialization go through.
+// encodeFrame<P, Bits>() is the fast path for the common mark/space
+// frames: timings come from P::descriptor() at compile time and the bit
+// loop is unrolled by template recursion, so a frame is a straight run
+// of stores.
+//
+// All forms return the frame length in timings and write nothing when
+// the span is too small (an empty span is a size query), or 0 when the
+// descriptor cannot encode that bit count.
+
+namespace frame_encoder {
+
+uint16_t encodeFrame(const ProtocolDescriptor& descriptor, uint64_t data, uint16_t bits, TimingSpan out);
+
+// Lay the descriptor's repeats out after the frameLength timings already
+// in buffer, each gap padded so frames start framePeriodUs apart: what a
+// single press sends. Returns the new length, or 0 when the repeats do
+// not fit buffer or the frame outlasts its period.
+uint16_t appendRepeats(const ProtocolDescriptor& descriptor, TimingSpan buffer, uint16_t frameLength);
+
+// Writes bits Remaining-1 .. 0 of a Bits-wide value
+template <typename P, uint16_t Bits, uint16_t Remaining>
+struct BitWriter {
+    static uint16_t* write(uint64_t data, uint16_t* out) {
+        constexpr ProtocolDescriptor d = P::descriptor();
+        constexpr uint16_t position = d.bitOrder == BitOrder::MSB_FIRST ? Remaining - 1 : Bits - Remaining;
+        const bool one = (data >> position) & 1;
+        *out++ = one ? d.oneMark : d.zeroMark;
+        // The final space is dropped when there is no footer mark
+        if (Remaining > 1 || d.footerMark) {
+            *out++ = one ? d.oneSpace : d.zeroSpace;
+        }
+        return BitWriter<P, Bits, Remaining - 1>::write(data, out);
+    }
+};
+
+template <typename P, uint16_t Bits>
+struct BitWriter<P, Bits, 0> {
+    static uint16_t* write(uint64_t, uint16_t* out) { return out; }
+};
+
+// Fixed bit count: fully unrolled
+template <typename P, uint16_t Bits>
+uint16_t encodeFrame(uint64_t data, TimingSpan out) {
+    static_assert(P::descriptor().coding != BitCoding::BIPHASE && P::descriptor().secondFrameMask == 0,
+                  "Unrolled encoder only handles single mark/space frames");
+    constexpr ProtocolDescriptor d = P::descriptor();
+    constexpr uint16_t length = d.frameLength(Bits);
+    if (!out.data || out.capacity < length) {
+        return length;
+    }
+    
+    uint16_t* cursor = out.data;
+    if (d.headerMark) {
+        *cursor++ = d.headerMark;
+        *cursor++ = d.headerSpace;
+    }
+    cursor = BitWriter<P, Bits, Bits>::write(data, cursor);
+    if (d.footerMark) {
+        *cursor++ = d.footerMark;
+    }
+    return length;
+}
+
+// Non-standard bit count: generic engine with P's descriptor
+template <typename P>
+uint16_t encodeFrame(uint64_t data, uint16_t bits, TimingSpan out) {
+    return encodeFrame(P::descriptor(), data, bits, out);
+}
+
+}  // namespace frame_encoder
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef HOLD_REPEATER_H
+#define HOLD_REPEATER_H
+
+#include "IIRTransmitter.h"
+#include "IProtocolEncoder.h"
+
+// Press/hold/release for a held remote button. press() sends the full
+// frame once, then update() resends the protocol's repeat frame (NEC
+// repeat code, headerless JVC frame, or the full frame) every
+// framePeriodUs until release() or the safety timeout.
+//
+// The frame is rendered once per press, so toggle-bit protocols keep the
+// same toggle for the whole hold, as a real remote does.
+class HoldRepeater {
+public:
+    static const uint32_t kDefaultTimeoutMs = 10000;  // Release lost in transit
+    static const uint16_t kMaxTimings = 256;
+    
+    HoldRepeater(IIRTransmitter* transmitter, IProtocolEncoder* encoder, uint32_t timeoutMs = kDefaultTimeoutMs);
+    
+    // Start holding. Pressing the command already held only extends the
+    // timeout. Protocols without a repeat cadence are sent once.
+    // Release takes effect once the descriptor's minimum repeats are out.
+    // carrierKHz/duty override the descriptor's carrier (0 = its own).
+    TransmitResult press(IRProtocol protocol, uint64_t value, uint16_t bits, uint32_t nowMs,
+                         uint16_t carrierKHz = 0, uint8_t duty = 0);
+    void release();
+    
+    // Call from the main loop
+    void update(uint32_t nowMs);
+    
+    // Time until update() has work: 0 if a repeat is due, UINT32_MAX when idle
+    uint32_t msUntilNextRepeat(uint32_t nowMs) const;
+    
+    bool isHolding() const { return holding; }
+    uint32_t getRepeatCount() const { return repeatCount; }
+    uint32_t getTimeoutCount() const { return timeoutCount; }
+
+private:
+    IIRTransmitter* transmitter;
+    IProtocolEncoder* encoder;
+    uint32_t timeoutMs;
+    
+    bool holding;
+    IRProtocol heldProtocol;
+    uint64_t heldValue;
+    uint16_t heldBits;
+    uint16_t frequency;
+    uint8_t dutyPercent;
+    uint32_t periodMs;
+    uint32_t nextDueMs;
+    uint32_t deadlineMs;
+    uint8_t minRepeats;       // Descriptor repeats owed even to a short tap
+    uint8_t heldRepeats;
+    bool releaseRequested;
+    uint32_t repeatCount;
+    uint32_t timeoutCount;
+    
+    uint16_t frame[kMaxTimings];
+    uint16_t repeatFrame[kMaxTimings];
+    uint16_t repeatLength;
+    
+    // Fill repeatFrame from the rendered frame; false if the protocol has
+    // no usable repeat
+    bool buildRepeatFrame(const ProtocolDescriptor& descriptor, uint16_t frameLength);
+};
+
+#endif
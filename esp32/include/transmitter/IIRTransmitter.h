@@ -1,8 +1,17 @@
 #ifndef I_IR_TRANSMITTER_H
 #define I_IR_TRANSMITTER_H
 
-#include <Arduino.h>
-#include <IRsend.h>
+#ifdef NATIVE_BUILD
+    // Native testing mode - use mocks
+    #include "../test/mock_arduino.h"
+#else
+    // Embedded mode - use real Arduino/IRremoteESP8266
+    #include <Arduino.h>
+    #include <IRsend.h>
+#endif
+
+#include "ProtocolDescriptors.h"
+#include "AcStateProtocols.h"
 
 struct TransmitResult {
     bool success;
@@ -14,10 +23,23 @@ public:
     virtual ~IIRTransmitter() = default;
     
     virtual void begin() = 0;
-    virtual TransmitResult transmit(uint16_t* rawData, uint16_t length, uint16_t frequency = 38) = 0;
+    virtual TransmitResult transmit(uint16_t* rawData, uint16_t length, uint16_t frequency = IR_DEFAULT_CARRIER_KHZ,
+                                    uint8_t dutyPercent = IR_DEFAULT_DUTY_PERCENT) = 0;
     virtual TransmitResult transmitNEC(uint32_t data, uint16_t nbits = 32) = 0;
     virtual TransmitResult transmitSamsung(uint64_t data, uint16_t nbits = 32) = 0;
     virtual TransmitResult transmitSony(uint32_t data, uint16_t nbits = 12) = 0;
+    
+    // Send a decoder value for a resolved protocol. carrierKHz and
+    // dutyPercent override the descriptor's carrier (0 = protocol's own),
+    // for learned commands whose device wants something else.
+    virtual TransmitResult transmitValue(IRProtocol protocol, uint64_t value, uint16_t nbits,
+                                         uint16_t carrierKHz = 0, uint8_t dutyPercent = 0) = 0;
+    
+    // Send an A/C state frame (acStateBytes() bytes); checksums are
+    // filled in by the transmitter. carrierKHz and dutyPercent override
+    // the descriptor's carrier as for transmitValue().
+    virtual TransmitResult transmitState(AcProtocol protocol, const uint8_t* state, uint16_t length,
+                                         uint16_t carrierKHz = 0, uint8_t dutyPercent = 0) = 0;
 };
 
 #endif
@@ -12,25 +12,132 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <memory>
+#include <utility>
+#include "ProtocolDescriptors.h"
 
-// Encoded signal structure for transmission
-struct EncodedSignal {
+// Caller-owned timing buffer for the allocation-free encode overloads
+struct TimingSpan {
+    uint16_t* data;
+    uint16_t capacity;
+    
+    TimingSpan() : data(nullptr), capacity(0) {}
+    TimingSpan(uint16_t* data, uint16_t capacity) : data(data), capacity(capacity) {}
+};
+
+// Fixed-capacity arena handing out TimingSpans from inline storage.
+// Lives on the stack or as a member; reset() reclaims everything at once.
+template <uint16_t Capacity>
+class TimingArena {
+public:
+    TimingArena() : used(0) {}
+    
+    // Empty span when the arena is exhausted
+    TimingSpan allocate(uint16_t length) {
+        if (length > Capacity - used) {
+            return TimingSpan();
+        }
+        TimingSpan span(storage + used, length);
+        used += length;
+        return span;
+    }
+    
+    // Hand the unused tail to an encoder; commit() what it reports using
+    TimingSpan remaining() { return TimingSpan(storage + used, Capacity - used); }
+    void commit(uint16_t length) { used += length <= Capacity - used ? length : 0; }
+    
+    void reset() { used = 0; }
+    uint16_t size() const { return used; }
+
+private:
+    uint16_t storage[Capacity];
+    uint16_t used;
+};
+
+// Encoded signal for transmission. Move-only: rawData is a view of either
+// the signal's own buffer (heap-allocated by an encoder, freed with the
+// signal) or one the caller keeps alive (encodeRaw). Only the owned
+// buffer is ever freed; a borrowed one is never held by owned.
+class EncodedSignal {
+public:
     const char* protocol;      // Protocol name (NEC, SAMSUNG, SONY, RAW)
     uint16_t* rawData;         // Raw timing data (microseconds)
     uint16_t rawLength;        // Length of raw data array
-    uint16_t frequency;        // Carrier frequency in kHz (default 38)
+    uint16_t frequency;        // Carrier frequency in kHz (default IR_DEFAULT_CARRIER_KHZ)
     bool isKnownProtocol;      // True if protocol-specific encoding was used
+    
+    EncodedSignal()
+        : protocol(nullptr), rawData(nullptr), rawLength(0), frequency(IR_DEFAULT_CARRIER_KHZ),
+          isKnownProtocol(false) {}
+    
+    EncodedSignal(const EncodedSignal&) = delete;
+    EncodedSignal& operator=(const EncodedSignal&) = delete;
+    
+    EncodedSignal(EncodedSignal&& other)
+        : protocol(other.protocol), rawData(other.rawData), rawLength(other.rawLength),
+          frequency(other.frequency), isKnownProtocol(other.isKnownProtocol),
+          owned(std::move(other.owned)) {
+        other.rawData = nullptr;
+        other.rawLength = 0;
+    }
+    
+    EncodedSignal& operator=(EncodedSignal&& other) {
+        if (this != &other) {
+            protocol = other.protocol;
+            rawData = other.rawData;
+            rawLength = other.rawLength;
+            frequency = other.frequency;
+            isKnownProtocol = other.isKnownProtocol;
+            owned = std::move(other.owned);
+            other.rawData = nullptr;
+            other.rawLength = 0;
+        }
+        return *this;
+    }
+    
+    // Take ownership of an encoder's buffer
+    void adopt(std::unique_ptr<uint16_t[]> data, uint16_t length) {
+        owned = std::move(data);
+        rawData = owned.get();
+        rawLength = rawData ? length : 0;
+    }
+    
+    // Reference a buffer the caller keeps alive
+    void borrow(uint16_t* data, uint16_t length) {
+        owned.reset();
+        rawData = data;
+        rawLength = length;
+    }
+    
+    bool ownsRawData() const { return owned != nullptr; }
+
+private:
+    std::unique_ptr<uint16_t[]> owned;  // Null when rawData is borrowed
 };
 
 class IProtocolEncoder {
 public:
     virtual ~IProtocolEncoder() = default;
     
-    // Encode a signal from protocol parameters
+    // Encode a signal from protocol parameters (allocates; the signal owns the buffer)
     virtual EncodedSignal encode(const char* protocol, uint32_t address, uint32_t command, uint16_t bits) = 0;
     
-    // Encode from raw timing data (for unknown protocols)
-    virtual EncodedSignal encodeRaw(uint16_t* rawData, uint16_t rawLength, uint16_t frequency = 38) = 0;
+    // Encode into a caller-owned buffer without allocating. Returns the
+    // number of timings the frame needs (0 = unknown protocol); nothing is
+    // written when that exceeds out.capacity.
+    virtual uint16_t encode(const char* protocol, uint32_t address, uint32_t command, uint16_t bits, TimingSpan out) = 0;
+    
+    // Encode from the decoder's raw value (what the native senders take)
+    virtual EncodedSignal encodeValue(const char* protocol, uint64_t value, uint16_t bits) = 0;
+    virtual uint16_t encodeValue(const char* protocol, uint64_t value, uint16_t bits, TimingSpan out) = 0;
+    
+    // Hot path: protocol already resolved, no name lookup
+    virtual EncodedSignal encodeValue(IRProtocol protocol, uint64_t value, uint16_t bits) = 0;
+    virtual uint16_t encodeValue(IRProtocol protocol, uint64_t value, uint16_t bits, TimingSpan out) = 0;
+    
+    // Encode from raw timing data (for unknown protocols). The signal
+    // borrows rawData; the caller keeps ownership.
+    virtual EncodedSignal encodeRaw(uint16_t* rawData, uint16_t rawLength, uint16_t frequency = IR_DEFAULT_CARRIER_KHZ) = 0;
 };
 
 #endif
@@ -5,19 +5,35 @@
 
 class IRLibProtocolEncoders : public IProtocolEncoder {
 public:
-    IRLibProtocolEncoders() = default;
+    IRLibProtocolEncoders() : toggleStates(0) {}
     ~IRLibProtocolEncoders() override = default;
 
     EncodedSignal encode(const char* protocol, uint32_t address, uint32_t command, uint16_t bits) override;
-    EncodedSignal encodeRaw(uint16_t* rawData, uint16_t rawLength, uint16_t frequency = 38) override;
+    uint16_t encode(const char* protocol, uint32_t address, uint32_t command, uint16_t bits, TimingSpan out) override;
+    EncodedSignal encodeValue(const char* protocol, uint64_t value, uint16_t bits) override;
+    uint16_t encodeValue(const char* protocol, uint64_t value, uint16_t bits, TimingSpan out) override;
+    EncodedSignal encodeValue(IRProtocol protocol, uint64_t value, uint16_t bits) override;
+    uint16_t encodeValue(IRProtocol protocol, uint64_t value, uint16_t bits, TimingSpan out) override;
+    EncodedSignal encodeRaw(uint16_t* rawData, uint16_t rawLength, uint16_t frequency = IR_DEFAULT_CARRIER_KHZ) override;
+    
+    // Toggle bit sent with the next frame of a toggle-bit protocol (RC5/RC6).
+    // It flips after every frame written, so each send reads as a new press.
+    void setToggleState(IRProtocol protocol, bool toggled);
+    bool toggleState(IRProtocol protocol) const;
 
 private:
-    EncodedSignal encodeNEC(uint32_t address, uint32_t command);
-    EncodedSignal encodeSamsung(uint32_t address, uint32_t command);
-    EncodedSignal encodeSony(uint32_t address, uint32_t command, uint16_t bits);
+    uint16_t toggleStates;  // One bit per IRProtocol
+    
+    static uint16_t toggleFlag(IRProtocol protocol) { return 1u << static_cast<uint8_t>(protocol); }
+    
+    // Encode an already toggled value: unrolled fast path or generic engine
+    uint16_t render(const ProtocolDescriptor& descriptor, uint64_t value, uint16_t bits, TimingSpan out);
+    
+    // Pack address/command into the on-wire value; false for unknown protocols
+    bool packValue(IRProtocol protocol, uint32_t address, uint32_t command, uint16_t bits, uint64_t* value);
     
-    // Helper to allocate and copy raw data
-    uint16_t* allocateRawData(uint16_t length);
+    // Size, allocate and fill an owning signal
+    EncodedSignal allocateSignal(IRProtocol protocol, uint64_t value, uint16_t bits);
 };
 
 #endif
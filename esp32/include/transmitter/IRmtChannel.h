@@ -0,0 +1,58 @@
+#ifndef I_RMT_CHANNEL_H
+#define I_RMT_CHANNEL_H
+
+#include <cstdint>
+#include <cstddef>
+
+// RMT channels tick at 1us, and each half-symbol holds at most 15 bits
+#define RMT_MAX_SYMBOL_DURATION 32767
+
+// One RMT symbol: two (duration, level) halves. Same layout as the
+// driver's rmt_item32_t so symbol buffers are handed over without copying.
+struct RmtSymbol {
+    uint32_t duration0 : 15;
+    uint32_t level0 : 1;
+    uint32_t duration1 : 15;
+    uint32_t level1 : 1;
+};
+
+static_assert(sizeof(RmtSymbol) == sizeof(uint32_t), "RmtSymbol must pack into one 32-bit word");
+
+// Produces a transmission's symbols on demand, for frames too long to
+// render up front. fill() must return exactly capacity symbols until the
+// last chunk: a short chunk ends the transmission early.
+class IRmtSymbolSource {
+public:
+    virtual ~IRmtSymbolSource() = default;
+    
+    // Symbols in the whole transmission
+    virtual size_t symbolCount() const = 0;
+    
+    // Write the next symbols; returns the number written (0 when done)
+    virtual size_t fill(RmtSymbol* symbols, size_t capacity) = 0;
+};
+
+// Hardware abstraction for one RMT transmit channel
+class IRmtChannel {
+public:
+    virtual ~IRmtChannel() = default;
+    
+    virtual bool begin() = 0;
+    
+    // Carrier applied to every mark (level 1) symbol half
+    virtual bool setCarrier(uint32_t frequencyHz, uint8_t dutyPercent) = 0;
+    
+    // Queue symbols and return immediately. The buffer must stay valid
+    // until waitDone() reports the channel idle.
+    virtual bool write(const RmtSymbol* symbols, size_t count) = 0;
+    
+    // Queue a streamed transmission: the channel pulls symbols from the
+    // source into one half of its memory while the other half is on the
+    // air. The source must stay valid until waitDone() reports idle.
+    virtual bool writeStream(IRmtSymbolSource* source) = 0;
+    
+    // Wait up to timeoutMs for the queued symbols to finish (0 = poll)
+    virtual bool waitDone(uint32_t timeoutMs) = 0;
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef MULTI_CHANNEL_TRANSMITTER_H
+#define MULTI_CHANNEL_TRANSMITTER_H
+
+#include "ESP32RmtChannel.h"
+#include "HoldRepeater.h"
+#include "IRLibProtocolEncoders.h"
+#include "RmtIRTransmitter.h"
+#include "TransmitQueue.h"
+#include "TransmitTask.h"
+#include "WaveformCache.h"
+
+// Several IR LEDs driven from one board, addressed by logical output
+// number (pendingCommand "output"). Each output has its own RMT channel,
+// encoder (toggle bits are per device), waveform cache, hold repeater,
+// queue and transmit task, so a long A/C frame or a held button on one
+// device never delays another: the channels emit concurrently.
+class MultiChannelTransmitter {
+public:
+    static const uint8_t kMaxOutputs = 4;  // RMT TX channels on the ESP32-S3
+    
+    MultiChannelTransmitter();
+    ~MultiChannelTransmitter();
+    
+    MultiChannelTransmitter(const MultiChannelTransmitter&) = delete;
+    MultiChannelTransmitter& operator=(const MultiChannelTransmitter&) = delete;
+    
+    // Map the next output number to a GPIO, on the next free RMT
+    // channel. Call before begin(); false when all channels are used.
+    bool addOutput(uint16_t pin, bool inverted = false);
+    
+    // Bring up every channel and start the transmit tasks
+    bool begin();
+    
+    // Producer side (one task only). False for an unknown output (counted
+    // as misrouted) or when that output's queue is full.
+    bool submit(uint8_t output, const TransmitRequest& request);
+    bool submitRaw(uint8_t output, const TransmitRequest& request, const uint16_t* timings, uint16_t length);
+    
+    uint8_t getOutputCount() const { return count; }
+    uint16_t getPin(uint8_t output) const;
+    TransmitQueueStats getStats(uint8_t output) const;
+    CommandLatency* getLatency(uint8_t output);
+    const WaveformCache* getCache(uint8_t output) const;
+    uint32_t getMisrouted() const { return misrouted; }
+
+private:
+    struct Output {
+        uint16_t pin;
+        ESP32RmtChannel channel;
+        IRLibProtocolEncoders encoder;
+        WaveformCache cache;
+        RmtIRTransmitter transmitter;
+        HoldRepeater repeater;
+        CommandLatency latency;
+        TransmitQueue queue;
+        TransmitTask task;
+        
+        Output(uint16_t pin, rmt_channel_t rmtChannel, bool inverted);
+    };
+    
+    Output* outputs[kMaxOutputs];
+    uint8_t count;
+    uint32_t misrouted;
+};
+
+#endif
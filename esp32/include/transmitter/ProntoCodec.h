@@ -0,0 +1,82 @@
+#ifndef PRONTO_CODEC_H
+#define PRONTO_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Pronto hex, the format of the big public code libraries: space
+// separated 4-digit hex words
+//
+//   0000 FFFF OOOO RRRR  once pairs...  repeat pairs...
+//
+// 0000 marks a learned (modulated) code, FFFF is the carrier period in
+// units of 0.241246us, and OOOO/RRRR count the (mark, space) pairs of the
+// once sequence (sent first) and the repeat sequence (sent while held).
+// Durations are in carrier periods. Both directions work on caller
+// buffers word by word; no text is copied or allocated.
+
+namespace pronto {
+
+// Pronto clock period, in picoseconds
+const uint32_t kUnitPicos = 241246;
+
+// Space appended to a sequence that ends on a mark, since Pronto only
+// holds whole pairs (a typical inter-frame gap)
+const uint16_t kTrailingGapUs = 40000;
+
+// What a code decoded to. The once timings come first in the buffer,
+// then the repeat timings.
+struct Code {
+    uint32_t carrierHz;
+    uint16_t onceLength;
+    uint16_t repeatLength;
+    
+    Code() : carrierHz(0), onceLength(0), repeatLength(0) {}
+    
+    uint16_t carrierKHz() const { return (uint16_t)((carrierHz + 500) / 1000); }
+};
+
+// Incremental parser: text may be fed in any chunks (a word may be split
+// across them), and timings are written as each word completes.
+// Durations beyond 0xFFFF us are clamped (they are gaps).
+class Parser {
+public:
+    Parser(uint16_t* timings, uint16_t capacity);
+    
+    // False once the input is malformed or does not fit; the parser then
+    // ignores further input
+    bool feed(const char* text, size_t length);
+    
+    // End of input. Returns the number of timings (once + repeat), or 0
+    // if the code is malformed, truncated or empty.
+    uint16_t finish(Code* code);
+
+private:
+    uint16_t* timings;
+    uint16_t capacity;
+    uint16_t header[4];
+    uint32_t words;       // Completed words
+    uint32_t expected;    // Duration words announced by the header
+    uint64_t periodPicos;
+    uint16_t word;
+    uint8_t digits;
+    bool failed;
+    
+    void completeWord();
+};
+
+// Parse a whole NUL-terminated code into timings
+uint16_t decode(const char* text, uint16_t* timings, uint16_t capacity, Code* code);
+
+// Write timings (once sequence, then repeat sequence) as Pronto hex into
+// out, NUL-terminated. Returns the length written, or 0 if out is too
+// small, the carrier is 0, or both sequences are empty.
+size_t encode(const uint16_t* timings, uint16_t onceLength, uint16_t repeatLength, uint16_t carrierKHz,
+              char* out, size_t size);
+
+// Characters encode() needs, including the NUL
+size_t encodedSizeFor(uint16_t onceLength, uint16_t repeatLength);
+
+}  // namespace pronto
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef PROTOCOL_DESCRIPTORS_H
+#define PROTOCOL_DESCRIPTORS_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Protocol identifiers. Names from the cloud are mapped once, when the
+// command is parsed; everything after that switches on the enum.
+enum class IRProtocol : uint8_t {
+    UNKNOWN = 0,
+    NEC,
+    SAMSUNG,
+    SONY,
+    RC5,
+    RC6,
+    PANASONIC,  // Kaseikyo 48-bit
+    JVC,
+    LG,
+    SHARP
+};
+
+enum class BitOrder : uint8_t {
+    MSB_FIRST,
+    LSB_FIRST
+};
+
+enum class BitCoding : uint8_t {
+    PULSE_DISTANCE,  // Fixed mark, the space carries the bit (NEC)
+    PULSE_WIDTH,     // The mark carries the bit, fixed space (Sony)
+    BIPHASE          // Manchester: each bit is a level transition (RC5/RC6)
+};
+
+// What is resent while a button is held
+enum class RepeatFrame : uint8_t {
+    FULL,        // The whole frame again
+    CODE,        // Dedicated repeat code: repeatMark, repeatSpace, footer mark (NEC)
+    HEADERLESS   // The frame without its header (JVC)
+};
+
+#define PROTOCOL_NO_BIT 0xFF
+
+// Carrier for raw timings that name none. IR LEDs are driven at a third
+// duty: brighter per pulse than 50% for the same average current.
+#define IR_DEFAULT_CARRIER_KHZ 38
+#define IR_DEFAULT_DUTY_PERCENT 33
+
+// Carriers accepted as per-command overrides (the RMT can go far beyond)
+#define IR_MIN_CARRIER_KHZ 20
+#define IR_MAX_CARRIER_KHZ 500
+
+// Timing description of a protocol (microseconds). One generic engine
+// encodes and decodes every coding from these fields; adding a protocol
+// means adding a descriptor, not code.
+//
+// Mark/space codings: every bit is one mark followed by one space; a
+// frame without a footer mark drops the last bit's space (it becomes the
+// inter-frame gap).
+// Bi-phase: every bit is two half-bit units at opposite levels, sent
+// after prefixBits start bits of '1'. Leading and trailing spaces are idle
+// time and are not part of the timing buffer.
+struct ProtocolDescriptor {
+    IRProtocol protocol;
+    const char* name;
+    BitCoding coding;
+    uint16_t headerMark;      // 0 = no header
+    uint16_t headerSpace;
+    uint16_t oneMark;         // Mark/space codings only
+    uint16_t oneSpace;
+    uint16_t zeroMark;
+    uint16_t zeroSpace;
+    uint16_t footerMark;      // 0 = no footer
+    uint16_t biphaseUnit;     // Bi-phase half-bit duration
+    bool oneMarkFirst;        // Bi-phase '1' is mark->space (RC6) or space->mark (RC5)
+    uint8_t prefixBits;       // Bi-phase start bits
+    uint8_t doubleWidthBit;   // Bi-phase data bit (in send order) with double-length halves
+    uint8_t toggleBit;        // Value bit (from LSB) flipped on every new press
+    BitOrder bitOrder;
+    uint8_t defaultBits;
+    uint8_t carrierKHz;
+    uint8_t dutyPercent;      // Carrier high time
+    uint32_t secondFrameMask; // Non-zero: frame is resent XORed with this mask (Sharp)
+    uint16_t secondFrameGap;  // Space before that second frame
+    uint8_t repeats;          // Extra copies of the frame sent per press
+    uint32_t framePeriodUs;   // Start-to-start spacing of frames and held repeats (0 = no hold)
+    RepeatFrame repeatFrame;
+    uint16_t repeatMark;      // RepeatFrame::CODE only
+    uint16_t repeatSpace;
+    
+    // Timings in a mark/space frame of the given bit count (bi-phase frame
+    // length depends on the data)
+    constexpr uint16_t frameLength(uint16_t bits) const {
+        return (secondFrameMask ? 2 : 1) * ((headerMark ? 2 : 0) + bits * 2 + (footerMark ? 1 : -1)) +
+               (secondFrameMask ? 1 : 0);
+    }
+};
+
+// Compile-time descriptors, one type per protocol so the common frames
+// can be encoded by code specialized (and fully unrolled) per protocol
+
+// Held buttons send the 9ms/2.25ms repeat code every 108ms
+struct NecProtocol {
+    static constexpr ProtocolDescriptor descriptor() {
+        return ProtocolDescriptor{IRProtocol::NEC, "NEC", BitCoding::PULSE_DISTANCE,
+                                  9000, 4500,               // Header
+                                  560, 1690, 560, 560,      // One mark/space, zero mark/space
+                                  560,                      // Footer
+                                  0, false, 0, PROTOCOL_NO_BIT, PROTOCOL_NO_BIT,
+                                  BitOrder::MSB_FIRST, 32, 38, 33,
+                                  0, 0,
+                                  0, 108000,
+                                  RepeatFrame::CODE, 9000, 2250};
+    }
+};
+
+struct SamsungProtocol {
+    static constexpr ProtocolDescriptor descriptor() {
+        return ProtocolDescriptor{IRProtocol::SAMSUNG, "SAMSUNG", BitCoding::PULSE_DISTANCE,
+                                  4500, 4500,
+                                  560, 1690, 560, 560,
+                                  560,
+                                  0, false, 0, PROTOCOL_NO_BIT, PROTOCOL_NO_BIT,
+                                  BitOrder::MSB_FIRST, 32, 38, 33,
+                                  0, 0,
+                                  0, 108000,
+                                  RepeatFrame::FULL, 0, 0};
+    }
+};
+
+// Sony SIRC devices expect the frame at least three times, 45ms apart,
+// on a 40kHz carrier
+struct SonyProtocol {
+    static constexpr ProtocolDescriptor descriptor() {
+        return ProtocolDescriptor{IRProtocol::SONY, "SONY", BitCoding::PULSE_WIDTH,
+                                  2400, 600,
+                                  1200, 600, 600, 600,
+                                  0,
+                                  0, false, 0, PROTOCOL_NO_BIT, PROTOCOL_NO_BIT,
+                                  BitOrder::MSB_FIRST, 12, 40, 33,
+                                  0, 0,
+                                  2, 45000,
+                                  RepeatFrame::FULL, 0, 0};
+    }
+};
+
+// RC5: 2 start bits, then toggle | 5-bit address | 6-bit command. Philips
+// receivers are tuned to 36kHz and a 25-33% duty.
+struct Rc5Protocol {
+    static constexpr ProtocolDescriptor descriptor() {
+        return ProtocolDescriptor{IRProtocol::RC5, "RC5", BitCoding::BIPHASE,
+                                  0, 0,
+                                  0, 0, 0, 0,
+                                  0,
+                                  889, false, 2, PROTOCOL_NO_BIT, 11,
+                                  BitOrder::MSB_FIRST, 12, 36, 25,
+                                  0, 0,
+                                  0, 114000,
+                                  RepeatFrame::FULL, 0, 0};
+    }
+};
+
+// RC6 mode 0: leader, start bit, then 3-bit mode | toggle (double width) |
+// 8-bit address | 8-bit command
+struct Rc6Protocol {
+    static constexpr ProtocolDescriptor descriptor() {
+        return ProtocolDescriptor{IRProtocol::RC6, "RC6", BitCoding::BIPHASE,
+                                  2666, 889,
+                                  0, 0, 0, 0,
+                                  0,
+                                  444, true, 1, 3, 16,
+                                  BitOrder::MSB_FIRST, 20, 36, 25,
+                                  0, 0,
+                                  0, 107000,
+                                  RepeatFrame::FULL, 0, 0};
+    }
+};
+
+struct PanasonicProtocol {
+    static constexpr ProtocolDescriptor descriptor() {
+        return ProtocolDescriptor{IRProtocol::PANASONIC, "PANASONIC", BitCoding::PULSE_DISTANCE,
+                                  3456, 1728,
+                                  432, 1296, 432, 432,
+                                  432,
+                                  0, false, 0, PROTOCOL_NO_BIT, PROTOCOL_NO_BIT,
+                                  BitOrder::MSB_FIRST, 48, 37, 33,
+                                  0, 0,
+                                  0, 130000,
+                                  RepeatFrame::FULL, 0, 0};
+    }
+};
+
+struct JvcProtocol {
+    static constexpr ProtocolDescriptor descriptor() {
+        return ProtocolDescriptor{IRProtocol::JVC, "JVC", BitCoding::PULSE_DISTANCE,
+                                  8400, 4200,
+                                  525, 1725, 525, 525,
+                                  525,
+                                  0, false, 0, PROTOCOL_NO_BIT, PROTOCOL_NO_BIT,
+                                  BitOrder::MSB_FIRST, 16, 38, 33,
+                                  0, 0,
+                                  0, 60000,
+                                  RepeatFrame::HEADERLESS, 0, 0};
+    }
+};
+
+struct LgProtocol {
+    static constexpr ProtocolDescriptor descriptor() {
+        return ProtocolDescriptor{IRProtocol::LG, "LG", BitCoding::PULSE_DISTANCE,
+                                  8500, 4250,
+                                  550, 1600, 550, 550,
+                                  550,
+                                  0, false, 0, PROTOCOL_NO_BIT, PROTOCOL_NO_BIT,
+                                  BitOrder::MSB_FIRST, 28, 38, 33,
+                                  0, 0,
+                                  0, 108000,
+                                  RepeatFrame::CODE, 8500, 2250};
+    }
+};
+
+// Sharp: headerless, each frame is followed by a copy with the command
+// and check bits inverted
+struct SharpProtocol {
+    static constexpr ProtocolDescriptor descriptor() {
+        return ProtocolDescriptor{IRProtocol::SHARP, "SHARP", BitCoding::PULSE_DISTANCE,
+                                  0, 0,
+                                  260, 1820, 260, 780,
+                                  260,
+                                  0, false, 0, PROTOCOL_NO_BIT, PROTOCOL_NO_BIT,
+                                  BitOrder::MSB_FIRST, 15, 38, 33,
+                                  0x3FF, 43602,
+                                  0, 0,
+                                  RepeatFrame::FULL, 0, 0};
+    }
+};
+
+// Runtime lookups (not for the per-frame hot path)
+IRProtocol protocolFromName(const char* name);
+const char* protocolName(IRProtocol protocol);
+const ProtocolDescriptor* findDescriptor(IRProtocol protocol);
+
+// All known descriptors, for decoders that try every protocol
+const ProtocolDescriptor* protocolDescriptors(size_t* count);
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef RMT_IR_TRANSMITTER_H
+#define RMT_IR_TRANSMITTER_H
+
+#include "IIRTransmitter.h"
+#include "IRmtChannel.h"
+#include "IProtocolEncoder.h"
+#include "WaveformCache.h"
+#include "AcStateStream.h"
+
+// IIRTransmitter backed by an RMT channel. Frames are converted to RMT
+// symbols and queued on the peripheral, so transmit calls return as soon
+// as the frame is handed over instead of bit-banging with interrupts off.
+class RmtIRTransmitter : public IIRTransmitter {
+public:
+    // cache is optional; when set, value-based sends reuse rendered frames
+    RmtIRTransmitter(IRmtChannel* channel, IProtocolEncoder* encoder, WaveformCache* cache = nullptr);
+    ~RmtIRTransmitter() override = default;
+
+    void begin() override;
+    TransmitResult transmit(uint16_t* rawData, uint16_t length, uint16_t frequency = IR_DEFAULT_CARRIER_KHZ,
+                            uint8_t dutyPercent = IR_DEFAULT_DUTY_PERCENT) override;
+    TransmitResult transmitNEC(uint32_t data, uint16_t nbits = 32) override;
+    TransmitResult transmitSamsung(uint64_t data, uint16_t nbits = 32) override;
+    TransmitResult transmitSony(uint32_t data, uint16_t nbits = 12) override;
+    TransmitResult transmitValue(IRProtocol protocol, uint64_t value, uint16_t nbits,
+                                 uint16_t carrierKHz = 0, uint8_t dutyPercent = 0) override;
+    
+    // Streamed: symbols are encoded chunk by chunk while the previous
+    // chunk is on the air, so frame length is not bounded by kMaxSymbols
+    TransmitResult transmitState(AcProtocol protocol, const uint8_t* state, uint16_t length,
+                                 uint16_t carrierKHz = 0, uint8_t dutyPercent = 0) override;
+    
+    // True while the previous frame is still being emitted
+    bool isBusy();
+
+    static const uint16_t kMaxTimings = 256;
+    static const size_t kMaxSymbols = 256;
+    static const uint32_t kBusyTimeoutMs = 500;  // Longest frame we wait out before queueing the next
+
+private:
+    IRmtChannel* channel;
+    IProtocolEncoder* encoder;
+    WaveformCache* cache;
+    
+    // Symbols are read by the peripheral after transmit() returns, so they
+    // live in the transmitter rather than on the caller's stack
+    RmtSymbol symbols[kMaxSymbols];
+    uint16_t timings[kMaxTimings];
+    
+    // Read by the channel while a state frame streams out
+    uint8_t stateFrame[AC_MAX_STATE_BYTES];
+    AcStateStream stateStream;
+    
+    // Renders the frame plus the descriptor's repeats, on the descriptor's
+    // carrier unless overridden
+    TransmitResult renderAndQueue(const ProtocolDescriptor& descriptor, uint64_t value, uint16_t nbits,
+                                  uint16_t carrierKHz, uint8_t dutyPercent);
+    TransmitResult queue(const uint16_t* frameTimings, uint16_t length, uint16_t frequency, uint8_t dutyPercent);
+};
+
+#endif
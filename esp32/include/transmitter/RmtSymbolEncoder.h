@@ -0,0 +1,17 @@
+#ifndef RMT_SYMBOL_ENCODER_H
+#define RMT_SYMBOL_ENCODER_H
+
+#include "IRmtChannel.h"
+
+// Converts mark/space timing buffers (microseconds, mark first - the same
+// layout EncodedSignal::rawData and IRsend::sendRaw use) into RMT symbols.
+class RmtSymbolEncoder {
+public:
+    // Number of symbols needed for the given timings
+    static size_t symbolCount(const uint16_t* timings, uint16_t length);
+    
+    // Returns the number of symbols written, or 0 if capacity is too small
+    static size_t encode(const uint16_t* timings, uint16_t length, RmtSymbol* symbols, size_t capacity);
+};
+
+#endif
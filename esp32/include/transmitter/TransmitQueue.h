@@ -0,0 +1,132 @@
+#ifndef TRANSMIT_QUEUE_H
+#define TRANSMIT_QUEUE_H
+
+#include <atomic>
+#include "IIRTransmitter.h"
+#include "HoldRepeater.h"
+#include "utils/CommandLatency.h"
+#include "utils/RawTimingCodec.h"
+#include "utils/SpscRing.h"
+
+// Microsecond clock (esp_timer on the device, a fake in tests). 64-bit
+// so the millisecond time derived for holds wraps like millis().
+typedef uint64_t (*MicrosClock)();
+
+enum class TransmitAction : uint8_t {
+    SEND,     // One frame (plus the protocol's own repeats)
+    PRESS,    // Start a hold
+    RELEASE,  // End the hold
+    RAW,      // Timings staged by submitRaw()
+    STATE     // A/C state frame carried in the request
+};
+
+struct TransmitRequest {
+    TransmitAction action;
+    IRProtocol protocol;
+    uint64_t value;
+    uint16_t bits;
+    uint8_t count;        // SEND only: frames to send, one frame period apart
+    uint16_t carrierKHz;  // 0 = protocol's own (RAW: IR_DEFAULT_CARRIER_KHZ)
+    uint8_t dutyPercent;  // 0 = protocol's own (RAW: IR_DEFAULT_DUTY_PERCENT)
+    uint8_t rawSlot;      // RAW only; set by submitRaw()
+    AcProtocol acProtocol;  // STATE only
+    uint8_t stateLength;
+    uint8_t state[AC_MAX_STATE_BYTES];
+    uint32_t enqueuedUs;  // Set by submit()
+    CommandTimestamps timestamps;  // Upstream stamps; tx stamps added here
+    
+    TransmitRequest()
+        : action(TransmitAction::SEND), protocol(IRProtocol::UNKNOWN), value(0), bits(0), count(1),
+          carrierKHz(0), dutyPercent(0), rawSlot(0), acProtocol(AcProtocol::UNKNOWN), stateLength(0), enqueuedUs(0) {}
+};
+
+// Snapshot of queue counters. Each is written by one side only, so a
+// snapshot taken from either task is consistent per field.
+struct TransmitQueueStats {
+    uint32_t submitted;
+    uint32_t dropped;      // Ring full
+    uint32_t completed;    // Sends and presses; releases are not counted
+    uint32_t failed;
+    uint32_t depth;
+    uint32_t maxDepth;
+    uint32_t lastWaitUs;   // Submit to start of execution
+    uint32_t maxWaitUs;
+    uint32_t meanWaitUs;
+    uint32_t burstFrames;  // Extra frames sent for coalesced SENDs (count > 1)
+    uint64_t busyUs;       // Time spent executing requests, incl. waiting out the previous frame
+};
+
+// Commands from the network side (producer) to the transmit side
+// (consumer) through a lock-free ring, so emission never waits on the
+// loop task. Holds are driven from the consumer too. Host-testable; the
+// FreeRTOS task lives in TransmitTask.
+class TransmitQueue {
+public:
+    static const size_t kCapacity = 16;
+    static const uint32_t kIdleWaitMs = 100;
+    static const uint8_t kRawSlots = 2;
+    static const uint32_t kDefaultFramePeriodUs = 110000;  // Protocols without a cadence
+    
+    // latency is optional; when set, every executed send/press is recorded
+    TransmitQueue(IIRTransmitter* transmitter, HoldRepeater* repeater, MicrosClock clock,
+                  CommandLatency* latency = nullptr);
+    
+    // Producer: false (and counted as dropped) when the ring is full
+    bool submit(const TransmitRequest& request);
+    
+    // Producer: copy timings into a free raw slot and queue a RAW
+    // request. False (counted as dropped) if both slots are still
+    // waiting to be sent, the ring is full, or length is out of range.
+    bool submitRaw(const TransmitRequest& request, const uint16_t* timings, uint16_t length);
+    
+    // Consumer: run queued requests, due burst frames and hold repeats.
+    // A SEND with count > 1 sends its frames one frame period apart
+    // (the protocol's minimum legal spacing); requests behind it wait.
+    // Returns how long the consumer may sleep (ms) if nothing new is
+    // submitted.
+    uint32_t service();
+    
+    TransmitQueueStats getStats() const;
+
+private:
+    IIRTransmitter* transmitter;
+    HoldRepeater* repeater;
+    MicrosClock clock;
+    CommandLatency* latency;
+    SpscRing<TransmitRequest, kCapacity> ring;
+    
+    // Raw timings are too large for ring entries; a slot is claimed by
+    // the producer and released by the consumer once it is transmitted
+    struct RawSlot {
+        uint16_t timings[raw_timing::kMaxTimings];
+        uint16_t length;
+        std::atomic<bool> busy;
+    };
+    RawSlot rawSlots[kRawSlots];
+    
+    // Producer-written
+    std::atomic<uint32_t> submitted;
+    std::atomic<uint32_t> dropped;
+    std::atomic<uint32_t> maxDepth;
+    
+    // Consumer-written
+    std::atomic<uint32_t> completed;
+    std::atomic<uint32_t> failed;
+    std::atomic<uint32_t> lastWaitUs;
+    std::atomic<uint32_t> maxWaitUs;
+    std::atomic<uint64_t> totalWaitUs;
+    std::atomic<uint32_t> burstFrames;
+    std::atomic<uint64_t> busyUs;
+    
+    // Consumer-only: SEND frames still owed. The queue stays blocked for
+    // one period after the last frame, so the next request keeps the gap.
+    TransmitRequest burst;
+    bool bursting;
+    uint8_t burstRemaining;
+    uint64_t burstPeriodUs;
+    uint64_t burstNextUs;
+    
+    void runBurst(uint64_t nowUs);
+};
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef TRANSMIT_TASK_H
+#define TRANSMIT_TASK_H
+
+#include "TransmitQueue.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// FreeRTOS task that drains a TransmitQueue. WiFi and lwIP run on core
+// 0, so the task is pinned to core 1 above the Arduino loop task's
+// priority: a queued command preempts loop() as soon as it is submitted,
+// whatever the network code is doing.
+class TransmitTask {
+public:
+    static const BaseType_t kDefaultCore = 1;
+    static const UBaseType_t kDefaultPriority = 5;  // loopTask runs at 1
+    static const uint32_t kStackSize = 4096;
+    
+    explicit TransmitTask(TransmitQueue* queue);
+    
+    bool begin(BaseType_t core = kDefaultCore, UBaseType_t priority = kDefaultPriority);
+    
+    // Producer side (one task only): queue and wake the transmit task
+    bool submit(const TransmitRequest& request);
+    bool submitRaw(const TransmitRequest& request, const uint16_t* timings, uint16_t length);
+    
+    // esp_timer time, for TransmitQueue and command timestamps
+    static uint64_t clockMicros();
+
+private:
+    TransmitQueue* queue;
+    TaskHandle_t handle;
+    
+    static void run(void* arg);
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef WAVEFORM_CACHE_H
+#define WAVEFORM_CACHE_H
+
+#include <cstdint>
+#include <cstddef>
+#include "ProtocolDescriptors.h"
+
+// Bounded LRU cache of ready-to-emit timing buffers keyed by
+// (protocol, value, bits). Repeat presses of the same button skip
+// encoding entirely. Timing storage is one slab allocated in PSRAM
+// when available; entry bookkeeping stays in internal RAM.
+class WaveformCache {
+public:
+    explicit WaveformCache(uint16_t capacity = 32, uint16_t maxTimings = 256);
+    ~WaveformCache();
+    
+    WaveformCache(const WaveformCache&) = delete;
+    WaveformCache& operator=(const WaveformCache&) = delete;
+    
+    // Allocate storage. Lookups miss and inserts fail until this succeeds;
+    // it never does for a zero capacity or maxTimings.
+    bool begin();
+    
+    // Returns the cached buffer (valid until the next insert) or nullptr
+    const uint16_t* lookup(IRProtocol protocol, uint64_t value, uint16_t bits,
+                           uint16_t* length, uint16_t* frequency);
+    
+    // Store a buffer, evicting the least recently used entry when full
+    bool insert(IRProtocol protocol, uint64_t value, uint16_t bits,
+                const uint16_t* timings, uint16_t length, uint16_t frequency);
+    
+    void clear();
+    
+    // Statistics
+    uint16_t size() const { return count; }
+    uint16_t getCapacity() const { return capacity; }
+    uint32_t getHits() const { return hits; }
+    uint32_t getMisses() const { return misses; }
+    uint32_t getEvictions() const { return evictions; }
+
+private:
+    struct Entry {
+        uint32_t hash;
+        uint64_t value;
+        uint16_t bits;
+        uint16_t length;
+        uint16_t frequency;
+        uint16_t prev;  // LRU list links (kNone = end)
+        uint16_t next;
+        IRProtocol protocol;
+    };
+    
+    static const uint16_t kNone = 0xFFFF;
+    
+    uint16_t capacity;
+    uint16_t maxTimings;
+    uint16_t count;
+    uint16_t head;  // Most recently used
+    uint16_t tail;  // Least recently used
+    
+    Entry* entries;
+    uint16_t* slab;  // capacity * maxTimings timings
+    
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    
+    static uint32_t hashKey(IRProtocol protocol, uint64_t value, uint16_t bits);
+    int32_t find(uint32_t hash, IRProtocol protocol, uint64_t value, uint16_t bits) const;
+    void unlink(uint16_t index);
+    void pushFront(uint16_t index);
+};
+
+#endif
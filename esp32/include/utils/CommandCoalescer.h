@@ -0,0 +1,49 @@
+#ifndef COMMAND_COALESCER_H
+#define COMMAND_COALESCER_H
+
+#include "PendingCommand.h"
+
+// Merges rapid identical taps (ten volume-ups) into one "send N times"
+// job. The first tap of a run is passed straight through, so a single
+// press costs no extra latency; identical taps that follow within
+// kWindowMs of each other are counted and emitted together when the
+// window closes, a different command arrives, or kMaxRepeat is reached.
+class CommandCoalescer {
+public:
+    static const uint32_t kWindowMs = 150;
+    static const uint8_t kMaxRepeat = 20;
+    
+    CommandCoalescer();
+    
+    // Only plain value taps merge; holds, raw, state and scheduled
+    // commands do not
+    static bool canMerge(const PendingCommand& cmd);
+    
+    // Offer a mergeable tap. emit runs for anything that is ready now
+    // (a flushed run, then the tap itself if it starts a new run).
+    void offer(const PendingCommand& cmd, uint32_t nowMs, const CommandCallback& emit);
+    
+    // Emit the pending run once its window has closed
+    void update(uint32_t nowMs, const CommandCallback& emit);
+    
+    // Emit the pending run now (before an unmergeable command)
+    void flush(const CommandCallback& emit);
+    
+    // True while a run is open (taps may still merge into it)
+    bool isOpen() const { return open; }
+    
+    uint32_t getMergedCount() const { return mergedCount; }  // Taps folded into a run
+    uint32_t getRunCount() const { return runCount; }        // Merged jobs emitted
+
+private:
+    PendingCommand run;
+    bool open;
+    uint8_t pending;         // Taps merged since the first one went out
+    uint32_t deadlineMs;
+    uint32_t mergedCount;
+    uint32_t runCount;
+    
+    static bool sameCommand(const PendingCommand& a, const PendingCommand& b);
+};
+
+#endif
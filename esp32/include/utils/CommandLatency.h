@@ -0,0 +1,52 @@
+#ifndef COMMAND_LATENCY_H
+#define COMMAND_LATENCY_H
+
+#include "LatencyHistogram.h"
+
+// esp_timer microsecond stamps taken as a command moves through the
+// device. 0 = stage not stamped (e.g. a hold repeat has no stream event).
+struct CommandTimestamps {
+    uint32_t streamUs;    // onStreamData entry
+    uint32_t handoffUs;   // FirebaseManager::update hands the step to the callback
+    uint32_t dispatchUs;  // onCommandReceived entry
+    uint32_t txStartUs;   // Transmit task starts the frame
+    uint32_t txEndUs;     // Frame queued on the peripheral
+    
+    CommandTimestamps() : streamUs(0), handoffUs(0), dispatchUs(0), txStartUs(0), txEndUs(0) {}
+};
+
+enum class LatencyStage : uint8_t {
+    STREAM_TO_HANDOFF,    // SSE parse + wait for the next loop() pass
+    HANDOFF_TO_DISPATCH,  // Callback plumbing
+    DISPATCH_TO_TX_START, // Transmit queue wait
+    TX_START_TO_END,      // Render + RMT handover
+    TOTAL,                // Stream event to frame queued
+    COUNT
+};
+
+// Per-stage latency histograms for executed commands
+class CommandLatency {
+public:
+    static const uint8_t kStageCount = static_cast<uint8_t>(LatencyStage::COUNT);
+    
+    // Records every stage whose two ends are stamped
+    void record(const CommandTimestamps& timestamps);
+    void reset();
+    
+    const LatencyHistogram& stage(LatencyStage stage) const {
+        return histograms[static_cast<uint8_t>(stage)];
+    }
+    
+    static const char* stageName(LatencyStage stage);
+    
+    // One line per stage, newline-separated. Returns the length written,
+    // truncated to fit.
+    size_t format(char* out, size_t size) const;
+
+private:
+    LatencyHistogram histograms[kStageCount];
+    
+    void recordSpan(LatencyStage stage, uint32_t fromUs, uint32_t toUs);
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef COMMAND_SCHEDULER_H
+#define COMMAND_SCHEDULER_H
+
+#include <functional>
+#include "TimerWheel.h"
+#include "transmitter/ProtocolDescriptors.h"
+
+// A value command to send later ("turn off in 30 min")
+struct ScheduledCommand {
+    uint32_t id;          // Chosen by the web app; scheduling an id again replaces it
+    uint32_t dueEpoch;    // Unix seconds
+    IRProtocol protocol;
+    uint64_t value;
+    uint16_t bits;
+    uint8_t output;       // IR emitter
+    uint16_t carrierKHz;  // 0 = protocol's own
+    uint8_t dutyPercent;
+};
+
+// Persistent storage for the armed timers (NVS on the device). The
+// table is written whole, at most once per kSaveIntervalMs, when a timer
+// is added or cancelled. Firing only advances the fired-through mark, a
+// single word, and leaves the table as it was.
+class ITimerStore {
+public:
+    virtual ~ITimerStore() = default;
+    
+    // Returns the number of commands read
+    virtual uint8_t load(ScheduledCommand* commands, uint8_t capacity) = 0;
+    virtual bool save(const ScheduledCommand* commands, uint8_t count) = 0;
+    
+    // Due time of the latest command fired, so a stored one-shot that
+    // already went off is not fired again after a reboot
+    virtual uint32_t loadFiredThrough() = 0;
+    virtual bool saveFiredThrough(uint32_t epochSec) = 0;
+};
+
+// Fires stored commands at wall-clock times from the main loop, so
+// timers keep working when the browser that set them is closed, and
+// survive a reboot. Due times are absolute; the wheel runs on millis().
+//
+// Scheduling and cancelling only mark the table dirty; update() writes
+// it at most once per kSaveIntervalMs, so a burst of changes costs one
+// flash write and none of them runs inside scheduleAt()/cancel(). A
+// change made just before power is lost can therefore be forgotten.
+class CommandScheduler {
+public:
+    static const uint32_t kMinValidEpoch = 1600000000;  // Before this the clock is unset
+    static const uint32_t kMaxDelaySec = 7 * 24 * 3600;
+    static const uint32_t kMaxLateSec = 300;            // Overdue by more at boot: dropped
+    static const uint32_t kSaveIntervalMs = 2000;       // Between two store writes
+    
+    using ScheduledCallback = std::function<void(const ScheduledCommand& command)>;
+    
+    explicit CommandScheduler(ITimerStore* store, uint32_t tickMs = 1000);
+    
+    // False until the wall clock is valid, when the table is full, or the
+    // time is more than kMaxDelaySec away. A time already passed fires
+    // on the next tick.
+    bool scheduleAt(const ScheduledCommand& command, uint32_t nowMs, uint32_t epochSec);
+    bool scheduleIn(const ScheduledCommand& command, uint32_t delaySec, uint32_t nowMs, uint32_t epochSec);
+    bool cancel(uint32_t id);
+    
+    // Call from loop() with time(nullptr). Restores persisted timers the
+    // first time the wall clock is valid, fires due commands, then writes
+    // pending changes when the last write is kSaveIntervalMs old.
+    void update(uint32_t nowMs, uint32_t epochSec, const ScheduledCallback& fire);
+    
+    bool isRestored() const { return restored; }
+    uint8_t getCount() const { return wheel.getArmedCount(); }
+    uint32_t getFiredCount() const { return firedCount; }
+    bool isDirty() const { return tableDirty || firedDirty; }
+
+private:
+    TimerWheel wheel;
+    ITimerStore* store;
+    ScheduledCommand commands[TimerWheel::kMaxTimers];  // Indexed by wheel timer
+    bool restored;
+    uint32_t firedCount;
+    uint32_t firedThrough;  // Latest dueEpoch fired
+    bool tableDirty;        // Armed set differs from the store
+    bool firedDirty;        // firedThrough differs from the store
+    bool written;           // lastWriteMs is valid
+    uint32_t lastWriteMs;
+    
+    bool arm(const ScheduledCommand& command, uint32_t nowMs, uint32_t epochSec);
+    uint8_t find(uint32_t id) const;
+    void flush(uint32_t nowMs);
+};
+
+#endif
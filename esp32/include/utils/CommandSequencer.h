@@ -0,0 +1,31 @@
+#ifndef COMMAND_SEQUENCER_H
+#define COMMAND_SEQUENCER_H
+
+#include "PendingCommand.h"
+
+// Plays a CommandBatch from the main loop without blocking it. Steps with
+// no gap go out back to back in the same update(); a step with a gap
+// holds the next one until gapMs after it was dispatched.
+class CommandSequencer {
+public:
+    CommandSequencer();
+    
+    // Copy the batch and arm the first step. False if a batch is still
+    // playing or the batch is empty.
+    bool start(const CommandBatch& batch, uint32_t nowMs);
+    
+    // Dispatch every step that is due. Returns true once, on the call
+    // that dispatches the last step.
+    bool update(uint32_t nowMs, const CommandCallback& dispatch);
+    
+    bool isActive() const { return active; }
+    uint8_t getRemaining() const { return active ? batch.count - next : 0; }
+
+private:
+    CommandBatch batch;
+    uint8_t next;
+    uint32_t nextDueMs;
+    bool active;
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef FINGERPRINT_INDEX_H
+#define FINGERPRINT_INDEX_H
+
+#include <cstdint>
+#include <cstddef>
+
+// One learned command: its signal fingerprint (see SignalFingerprint.h)
+// and the id it was given when first learned
+struct FingerprintEntry {
+    uint32_t fingerprint;
+    uint32_t learnedId;
+};
+
+// Persistent storage for the index (a LittleFS file on the device; the
+// default NVS partition is too small for a large library). Entries are
+// only ever appended, one per newly learned command, so learning writes
+// 8 bytes rather than the whole table.
+class IFingerprintStore {
+public:
+    virtual ~IFingerprintStore() = default;
+    
+    // Entries from offset on, in the order appended; returns the number read
+    virtual uint32_t load(uint32_t offset, FingerprintEntry* entries, uint32_t capacity) = 0;
+    virtual bool append(const FingerprintEntry& entry) = 0;
+    virtual bool clear() = 0;
+};
+
+// Which learned command a capture is, without asking the cloud. An open
+// addressing table (linear probing, power-of-two slots, kept at most 3/4
+// full) maps fingerprints to learned ids, so a lookup is a hash and a
+// probe or two whatever the library size. The slots are allocated in
+// PSRAM when available: 8 bytes each, 128KB for the default 16384, which
+// holds a 12288-command library.
+class FingerprintIndex {
+public:
+    static const uint32_t kDefaultSlots = 16384;
+    static const uint32_t kNotFound = 0;
+    
+    // slots is rounded up to a power of two
+    explicit FingerprintIndex(IFingerprintStore* store, uint32_t slots = kDefaultSlots);
+    ~FingerprintIndex();
+    
+    FingerprintIndex(const FingerprintIndex&) = delete;
+    FingerprintIndex& operator=(const FingerprintIndex&) = delete;
+    
+    // Allocate and load the stored entries. Lookups miss and learning
+    // fails until this succeeds.
+    bool begin();
+    
+    // The learned id, or kNotFound
+    uint32_t find(uint32_t fingerprint) const;
+    
+    // The id of a fingerprint already learned (isNew false), else the next
+    // id, stored and persisted (isNew true). kNotFound when the index is
+    // full or not allocated.
+    uint32_t learn(uint32_t fingerprint, bool* isNew);
+    
+    // Forget every learned command, here and in the store
+    void clear();
+    
+    // Statistics
+    uint32_t size() const { return count; }
+    uint32_t getCapacity() const { return maxEntries; }
+    size_t getMemoryBytes() const { return (size_t)(mask + 1) * sizeof(FingerprintEntry); }
+    uint32_t getLongestProbe() const { return longestProbe; }
+
+private:
+    IFingerprintStore* store;
+    uint32_t mask;        // Slots - 1
+    uint32_t maxEntries;
+    uint32_t count;
+    uint32_t nextId;
+    uint32_t longestProbe;
+    FingerprintEntry* slots;  // fingerprint 0 = empty
+    
+    // Slot holding fingerprint, or the empty slot where it would go
+    uint32_t slotFor(uint32_t fingerprint, uint32_t* probes) const;
+    void place(const FingerprintEntry& entry);
+};
+
+#endif
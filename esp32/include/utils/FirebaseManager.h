@@ -5,6 +5,11 @@
 #include <WiFi.h>
 #include <Firebase_ESP_Client.h>
 #include "receiver/IProtocolDecoder.h"
+#include "utils/CommandCoalescer.h"
+#include "utils/CommandSequencer.h"
+#include "utils/PendingCommand.h"
+#include "utils/SniffBatch.h"
+#include "utils/SpscRing.h"
 
 enum class FirebaseState {
     DISCONNECTED,
@@ -19,16 +24,6 @@ enum class FirebaseState {
 // Callback for isLearning state changes
 using LearningStateCallback = std::function<void(bool isLearning)>;
 
-// Command received via RTDB pendingCommand
-struct PendingCommand {
-    String protocol;
-    uint64_t value;
-    uint16_t bits;
-};
-
-// Callback for command dispatch via RTDB pendingCommand
-using CommandCallback = std::function<void(const PendingCommand& cmd)>;
-
 class FirebaseManager {
 public:
     FirebaseManager(
@@ -52,9 +47,16 @@ public:
     bool beginDeviceStream();
     
     // Firestore operations
-    bool uploadSignal(const DecodedSignal& signal, const String& commandName);
+    // learnedId/alreadyLearned: the capture's entry in the fingerprint
+    // index, so the web app can point at the command instead of adding a duplicate
+    bool uploadSignal(const DecodedSignal& signal, const String& commandName,
+                      uint32_t learnedId = 0, bool alreadyLearned = false);
     bool setLearningMode(bool isLearning);
     
+    // One document per batch of presses heard from other remotes, under
+    // devices/{id}/sniffed, with the sniffer's counters at upload time
+    bool uploadSniffedEvents(const SniffBatch& batch, const SnifferStats& stats);
+    
     // Callbacks
     void onLearningStateChange(LearningStateCallback callback) { 
         learningStateCallback = callback; 
@@ -62,6 +64,14 @@ public:
     void onCommandReceived(CommandCallback callback) {
         commandCallback = callback;
     }
+    void onMacroReceived(MacroCallback callback) {
+        macroCallback = callback;
+    }
+    
+    // Telemetry: taps merged into "send N times" jobs, and stream events
+    // dropped because update() fell behind
+    uint32_t getCoalescedCount() const { return coalescer.getMergedCount(); }
+    uint32_t getDroppedCommandCount() const { return droppedBatches; }
 
 private:
     // Configuration
@@ -88,25 +98,47 @@ private:
     // Thread-safe flags set by RTDB stream callback, consumed by update()
     volatile bool pendingLearningChange;
     volatile bool pendingLearningState;
-    volatile bool pendingCommandReceived;
     bool lastLearningState;
-    PendingCommand pendingCmd;
+    
+    // Stream task -> update(): every pendingCommand write, in order, so a
+    // burst of taps is not collapsed into the last one
+    static const size_t kIncomingBatches = 4;
+    SpscRing<CommandBatch, kIncomingBatches> incomingBatches;
+    CommandBatch streamBatch;   // Parse target, stream task only
+    CommandBatch nextBatch;     // Popped by update()
+    volatile uint32_t droppedBatches;
+    bool deletePending;
+    CommandCoalescer coalescer;
+    CommandSequencer sequencer;
     
     // Callbacks
     LearningStateCallback learningStateCallback;
     CommandCallback commandCallback;
+    MacroCallback macroCallback;
     
     // Stream callbacks (static so they can be passed to library)
     static FirebaseManager* instance;  // Singleton ref for static callbacks
     static void onStreamData(FirebaseStream data);
     static void onStreamTimeout(bool timeout);
     
+    // Parse a pendingCommand object (single command, "commands" array,
+    // or a macro definition, trigger or removal)
+    static bool parsePendingCommand(FirebaseJson& json, CommandBatch* batch);
+    static bool parseCommand(FirebaseJson& json, const String& prefix, CommandBatch* batch, PendingCommand* cmd);
+    static uint8_t parseHexBytes(const char* text, uint8_t* out, uint8_t capacity);
+    static void stampStreamTime(CommandBatch* batch, uint32_t streamUs);
+    void queueBatch(uint32_t streamUs);  // Stream task: stamp and hand streamBatch to update()
+    
+    // Sequencer step -> commandCallback, stamping the handoff time
+    void handOff(const PendingCommand& cmd);
+    
     // Helper methods
     bool connectWiFi();        // Initial connection with network scan
     bool reconnectWiFi();      // Reconnection with full radio reset
     bool startWiFiConnection(); // Shared connection logic
     String getDevicePath() const;
     String getCommandsPath() const;
+    String getSniffedPath() const;
     String getRtdbDevicePath() const;
 };
 
@@ -0,0 +1,47 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed power-of-two bucket histogram of microsecond latencies. Bucket 0
+// holds 0us, bucket i holds [2^(i-1), 2^i) us, and the last bucket holds
+// everything from ~4.2s up. No allocation; one writer, any number of
+// readers (counters are relaxed atomics, so a read during a record may
+// be one sample behind).
+class LatencyHistogram {
+public:
+    static const uint8_t kBucketCount = 24;
+    
+    LatencyHistogram();
+    
+    void record(uint32_t us);
+    void reset();
+    
+    uint32_t getCount() const { return count.load(std::memory_order_relaxed); }
+    uint32_t getMinUs() const;
+    uint32_t getMaxUs() const { return maxUs.load(std::memory_order_relaxed); }
+    uint32_t getMeanUs() const;
+    uint32_t getBucket(uint8_t bucket) const;
+    
+    // Upper bound of the bucket holding the given percentile (0-100),
+    // clamped to the largest sample
+    uint32_t percentileUs(uint8_t percentile) const;
+    
+    static uint8_t bucketFor(uint32_t us);
+    static uint32_t bucketUpperUs(uint8_t bucket);  // Exclusive
+    
+    // One line: label, count, min/mean/p50/p90/p99/max. Returns the
+    // length written (snprintf semantics).
+    size_t format(char* out, size_t size, const char* label) const;
+
+private:
+    std::atomic<uint32_t> buckets[kBucketCount];
+    std::atomic<uint32_t> count;
+    std::atomic<uint32_t> minUs;
+    std::atomic<uint32_t> maxUs;
+    std::atomic<uint64_t> totalUs;
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef LITTLEFS_FINGERPRINT_STORE_H
+#define LITTLEFS_FINGERPRINT_STORE_H
+
+#include "FingerprintIndex.h"
+
+// Learned fingerprints as an append-only LittleFS file: a version word,
+// then one 8-byte entry per learned command. The NVS partition (20KB,
+// shared with timers and macros) cannot hold a large library; the
+// filesystem partition can. A file from another layout version is
+// ignored and replaced on the next learn.
+class LittleFsFingerprintStore : public IFingerprintStore {
+public:
+    uint32_t load(uint32_t offset, FingerprintEntry* entries, uint32_t capacity) override;
+    bool append(const FingerprintEntry& entry) override;
+    bool clear() override;
+
+private:
+    bool mounted = false;
+    
+    bool mount();
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef MACRO_PROGRAM_H
+#define MACRO_PROGRAM_H
+
+#include <cstdint>
+#include <cstddef>
+#include "PendingCommand.h"
+#include "transmitter/IProtocolEncoder.h"
+
+// A stored macro ("movie mode") compiled once, on the device, into
+// rendered waveforms plus a bytecode of references to them and delays.
+// Running one sends nothing to the encoders: every step is already a
+// timing buffer ready for the transmitter's RAW path.
+//
+// Bytecode (one byte opcode, little-endian operands):
+//   EMIT <waveform> <output>   send waveform on that IR emitter
+//   WAIT <ms:16>               idle before the next step
+//   END
+struct MacroWaveform {
+    uint16_t offset;      // Into the timing pool
+    uint16_t length;
+    uint16_t carrierKHz;
+    uint8_t dutyPercent;
+};
+
+enum class MacroError : uint8_t {
+    NONE,
+    EMPTY,            // No steps
+    UNSUPPORTED_STEP, // Press/release, cancel, scheduled or A/C state step
+    ENCODE_FAILED,    // Unknown protocol or bit count
+    TOO_LARGE         // Out of waveform, code or timing space
+};
+
+const char* macroErrorName(MacroError error);
+
+class MacroProgram {
+public:
+    static const uint8_t kVersion = 1;        // Bumped when the stored layout changes
+    static const uint8_t kMaxWaveforms = CommandBatch::kMaxCommands;
+    static const uint16_t kMaxCode = 128;
+    static const uint16_t kMaxTimings = 1024;
+    
+    static const uint8_t kOpEnd = 0x00;
+    static const uint8_t kOpEmit = 0x01;
+    static const uint8_t kOpWait = 0x02;
+    
+    // Bytes serialize() needs for the largest program
+    static const size_t kMaxSerializedSize =
+        6 + kMaxWaveforms * 7 + kMaxCode + kMaxTimings * sizeof(uint16_t);
+    
+    MacroProgram() { clear(); }
+    
+    void clear();
+    
+    // Render every step of a pendingCommand batch: value commands through
+    // encoder (its own instance, so toggle bits do not disturb the
+    // outputs'), RAW and Pronto steps as given. gapMs becomes a WAIT.
+    // Identical waveforms are stored once.
+    MacroError compile(const CommandBatch& batch, IProtocolEncoder* encoder);
+    
+    // Flat form for flash. deserialize() rejects other versions and
+    // anything that does not validate, leaving the program empty.
+    size_t serialize(uint8_t* out, size_t size) const;
+    bool deserialize(const uint8_t* data, size_t size);
+    
+    // Steps that emit (one per EMIT op)
+    uint8_t getStepCount() const;
+    
+    uint8_t getWaveformCount() const { return waveformCount; }
+    uint16_t getCodeLength() const { return codeLength; }
+    uint16_t getTimingCount() const { return timingCount; }
+    const MacroWaveform& getWaveform(uint8_t index) const { return waveforms[index]; }
+    const uint16_t* getTimings(const MacroWaveform& waveform) const { return timings + waveform.offset; }
+    const uint8_t* getCode() const { return code; }
+
+private:
+    uint8_t waveformCount;
+    uint16_t codeLength;
+    uint16_t timingCount;
+    MacroWaveform waveforms[kMaxWaveforms];
+    uint8_t code[kMaxCode];
+    uint16_t timings[kMaxTimings];
+    
+    // Index of an identical stored waveform, else stores it; -1 when full
+    int16_t addWaveform(const uint16_t* data, uint16_t length, uint16_t carrierKHz, uint8_t dutyPercent);
+    bool emit(uint8_t op, uint8_t a, uint8_t b);
+    bool validate() const;
+};
+
+// Persistent storage for compiled macros by id (NVS on the device)
+class IMacroStore {
+public:
+    virtual ~IMacroStore() = default;
+    
+    virtual bool load(uint32_t id, MacroProgram* program) = 0;
+    virtual bool save(uint32_t id, const MacroProgram& program) = 0;
+    virtual bool remove(uint32_t id) = 0;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef MACRO_RUNNER_H
+#define MACRO_RUNNER_H
+
+#include <functional>
+#include "MacroProgram.h"
+
+// When one emitted step of a macro went out, relative to the macro's start
+struct MacroStepTiming {
+    uint32_t plannedMs;  // Sum of the WAITs before it
+    uint32_t actualMs;   // When it was handed to the transmitter
+    uint32_t lateMs;     // Past its own due time (loop period, full queue)
+};
+
+// Hands one ready-to-emit waveform to the transmitter; false when it
+// cannot be taken now (queue or RAW slots full)
+using MacroEmitCallback = std::function<bool(uint8_t output, const uint16_t* timings, uint16_t length,
+                                             uint16_t carrierKHz, uint8_t dutyPercent)>;
+
+// Interprets a compiled macro from the main loop without blocking it,
+// like CommandSequencer does for a live batch: update() runs every op
+// that is due and returns. A WAIT counts from when the step before it
+// went out. An EMIT the transmitter refuses is retried on the next
+// update() rather than dropped.
+class MacroRunner {
+public:
+    static const uint8_t kMaxSteps = MacroProgram::kMaxCode / 3;
+    
+    MacroRunner();
+    
+    // Copy the program and arm its first op. False while another macro
+    // is running or for an empty program.
+    bool start(uint32_t id, const MacroProgram& program, uint32_t nowMs);
+    
+    // Returns true once, on the call that runs the END
+    bool update(uint32_t nowMs, const MacroEmitCallback& emit);
+    
+    bool isActive() const { return active; }
+    uint32_t getMacroId() const { return macroId; }
+    
+    // Timing of each step of the current or last run, for the log
+    uint8_t getStepCount() const { return stepCount; }
+    const MacroStepTiming& getStepTiming(uint8_t step) const { return steps[step]; }
+    uint32_t getDeferredCount() const { return deferred; }
+
+private:
+    MacroProgram program;
+    uint32_t macroId;
+    uint16_t pc;
+    uint32_t startMs;
+    uint32_t nextDueMs;
+    uint32_t plannedMs;
+    bool active;
+    MacroStepTiming steps[kMaxSteps];
+    uint8_t stepCount;
+    uint32_t deferred;
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef NVS_MACRO_STORE_H
+#define NVS_MACRO_STORE_H
+
+#include <Preferences.h>
+#include "MacroProgram.h"
+
+// Compiled macros in NVS, one blob per id. The blob carries the program
+// layout version, so a firmware that changes it ignores old macros
+// until they are defined again.
+class NvsMacroStore : public IMacroStore {
+public:
+    bool load(uint32_t id, MacroProgram* program) override;
+    bool save(uint32_t id, const MacroProgram& program) override;
+    bool remove(uint32_t id) override;
+
+private:
+    Preferences preferences;
+    uint8_t blob[MacroProgram::kMaxSerializedSize];
+    
+    static void keyFor(uint32_t id, char* key);
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef NVS_TIMER_STORE_H
+#define NVS_TIMER_STORE_H
+
+#include <Preferences.h>
+#include "CommandScheduler.h"
+
+// Scheduled commands as one NVS blob, versioned so a layout change
+// discards old data instead of misreading it, plus the fired-through
+// mark as its own word (firing rewrites only that)
+class NvsTimerStore : public ITimerStore {
+public:
+    uint8_t load(ScheduledCommand* commands, uint8_t capacity) override;
+    bool save(const ScheduledCommand* commands, uint8_t count) override;
+    uint32_t loadFiredThrough() override;
+    bool saveFiredThrough(uint32_t epochSec) override;
+
+private:
+    static const uint8_t kVersion = 3;
+    Preferences preferences;
+};
+
+#endif
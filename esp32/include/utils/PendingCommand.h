@@ -0,0 +1,96 @@
+#ifndef PENDING_COMMAND_H
+#define PENDING_COMMAND_H
+
+#ifdef NATIVE_BUILD
+    #include "../test/mock_arduino.h"
+#else
+    #include <Arduino.h>
+#endif
+
+#include <functional>
+#include "CommandLatency.h"
+#include "RawTimingCodec.h"
+#include "transmitter/ProtocolDescriptors.h"
+#include "transmitter/AcStateProtocols.h"
+
+// What the web UI did with the button
+enum class CommandEvent : uint8_t {
+    TAP,      // Single send (no "event" field)
+    PRESS,    // Button went down: send, then repeat until RELEASE
+    RELEASE,
+    CANCEL    // Drop the scheduled command with scheduleId
+};
+
+// Command received via RTDB pendingCommand
+struct PendingCommand {
+    String protocol;
+    IRProtocol protocolId;  // Resolved from protocol once, at parse time
+    uint64_t value;
+    uint16_t bits;
+    uint16_t gapMs;         // Idle time before the next step of a batch
+    uint8_t repeatCount;    // Times to send, one frame period apart (coalesced taps)
+    uint8_t output;         // IR emitter to send from (0 = IR_SEND_PIN)
+    uint16_t carrierKHz;    // "frequency": 0 = the protocol's own carrier
+    uint8_t dutyPercent;    // "duty": 0 = the protocol's own duty cycle
+    CommandEvent event;
+    CommandTimestamps timestamps;
+    
+    // Scheduled sends: fire at atEpoch (Unix seconds) or delaySec from
+    // now, on the device, instead of immediately
+    uint32_t scheduleId;
+    uint32_t atEpoch;
+    uint32_t delaySec;
+    
+    // RAW commands: timings decoded from the "raw" field into the batch's
+    // rawTimings. rawTimings is only set on the copy handed to the
+    // callback and is valid for the duration of the call.
+    uint16_t rawOffset;
+    uint16_t rawLength;
+    const uint16_t* rawTimings;
+    
+    // A/C state frames: protocol names the AcStateDescriptor, "state"
+    // carries the bytes (checksums are recomputed on send)
+    AcProtocol acProtocol;
+    uint8_t stateLength;
+    uint8_t state[AC_MAX_STATE_BYTES];
+    
+    PendingCommand()
+        : protocolId(IRProtocol::UNKNOWN), value(0), bits(0), gapMs(0), repeatCount(1), output(0),
+          carrierKHz(0), dutyPercent(0), event(CommandEvent::TAP), scheduleId(0), atEpoch(0), delaySec(0),
+          rawOffset(0), rawLength(0), rawTimings(nullptr), acProtocol(AcProtocol::UNKNOWN), stateLength(0) {}
+    
+    bool isRaw() const { return rawLength > 0; }
+    bool isState() const { return stateLength > 0; }
+    bool isScheduled() const { return atEpoch > 0 || delaySec > 0; }
+};
+
+// What a pendingCommand write does with stored macros
+enum class MacroAction : uint8_t {
+    NONE,    // Plain command(s): play now
+    DEFINE,  // {defineMacro: id, commands: [...]}: compile and store, send nothing
+    RUN,     // {macro: id}: play the stored macro
+    REMOVE   // {deleteMacro: id}
+};
+
+// Ordered steps of one pendingCommand write. A single command is a
+// batch of one. RAW steps share one timing buffer.
+struct CommandBatch {
+    static const uint8_t kMaxCommands = 16;
+    
+    PendingCommand commands[kMaxCommands];
+    uint8_t count;
+    uint16_t rawTimings[raw_timing::kMaxTimings];
+    uint16_t rawUsed;
+    MacroAction macroAction;
+    uint32_t macroId;
+    
+    CommandBatch() : count(0), rawUsed(0), macroAction(MacroAction::NONE), macroId(0) {}
+};
+
+// Callback for command dispatch via RTDB pendingCommand
+using CommandCallback = std::function<void(const PendingCommand& cmd)>;
+
+// Callback for macro writes; batch holds the steps of a DEFINE
+using MacroCallback = std::function<void(MacroAction action, uint32_t id, const CommandBatch& batch)>;
+
+#endif
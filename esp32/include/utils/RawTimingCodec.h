@@ -0,0 +1,33 @@
+#ifndef RAW_TIMING_CODEC_H
+#define RAW_TIMING_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Compact text form of a raw mark/space buffer, for the RTDB "raw" field.
+// Each duration is stored as the zigzag delta from the previous duration
+// of the same kind (mark or space), LEB128 varint packed, and the bytes
+// are base64url encoded without padding. Repeated bit timings come out as
+// one byte each, so an NEC frame is ~110 characters instead of the
+// ~300 of a decimal array.
+
+namespace raw_timing {
+
+// Largest buffer a raw command can carry (one RMT transmission)
+const uint16_t kMaxTimings = 512;
+
+// Encode into out (NUL-terminated). Returns the length written, or 0 if
+// out is too small.
+size_t encode(const uint16_t* timings, uint16_t length, char* out, size_t size);
+
+// Decode straight into timings. Returns the number of durations, or 0 if
+// the text is malformed, a duration is out of range (0 or > 0xFFFF), or
+// more than capacity durations are present.
+uint16_t decode(const char* text, uint16_t* timings, uint16_t capacity);
+
+// Characters encode() needs for length durations, including the NUL
+size_t encodedSizeFor(uint16_t length);
+
+}  // namespace raw_timing
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef SNIFF_BATCH_H
+#define SNIFF_BATCH_H
+
+#include "receiver/SignalSniffer.h"
+
+// A press of the original remote, as uploaded
+struct SniffEvent {
+    SniffedFrame frame;   // The first frame of the press
+    uint32_t learnedId;   // FingerprintIndex id, 0 when not a learned command
+    uint16_t frames;      // Frames of the press: 1, more while it was held
+    uint32_t lastMs;      // millis() of its last frame
+};
+
+// Sniffed frames collected on the loop task for one upload every
+// flushMs, or sooner once kCapacity presses are waiting. A held button
+// sends its frame (or a repeat code) every ~100ms; those frames are
+// folded into one event, counted, instead of filling the batch.
+class SniffBatch {
+public:
+    static const uint8_t kCapacity = 16;
+    static const uint32_t kDefaultFlushMs = 30000;
+    static const uint32_t kHoldGapMs = 250;  // Longer silence ends a press
+    
+    explicit SniffBatch(uint32_t flushMs = kDefaultFlushMs);
+    
+    // Fold a frame into the press it continues, or start a new event.
+    // False when it starts one and the batch is full (leave it queued).
+    bool add(const SniffedFrame& frame, uint32_t learnedId);
+    
+    // Full, or the oldest event has waited flushMs
+    bool isDue(uint32_t nowMs) const;
+    bool isFull() const { return count >= kCapacity; }
+    
+    uint8_t size() const { return count; }
+    const SniffEvent& operator[](uint8_t index) const { return events[index]; }
+    
+    // After an upload. The press still in progress keeps absorbing its
+    // repeats, so a hold across an upload is not reported twice.
+    void clear() { count = 0; }
+
+private:
+    uint32_t flushMs;
+    SniffEvent events[kCapacity];
+    uint8_t count;
+    
+    // The latest press, whether or not it is still in the batch
+    uint32_t lastFingerprint;
+    uint32_t lastMs;
+    bool hasLast;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-size lock-free ring for exactly one producer and one consumer
+// (e.g. the loop task and a worker task). Each index is written by one
+// side only; acquire/release ordering publishes the slot contents.
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscRing() : head(0), tail(0) {}
+    
+    // Producer side. False when full (the item is not queued).
+    bool push(const T& item) {
+        const uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) >= N) {
+            return false;
+        }
+        slots[t & (N - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Consumer side. False when empty.
+    bool pop(T* item) {
+        const uint32_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        *item = slots[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Either side; exact only from the consumer when the producer is idle
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    T slots[N];
+    std::atomic<uint32_t> head;  // Next slot to read (consumer)
+    std::atomic<uint32_t> tail;  // Next slot to write (producer)
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstdint>
+#include <functional>
+
+// Hashed timer wheel: kSlots buckets of tickMs each. A timer lands in
+// the bucket (now + delay) % kSlots with the number of full turns still
+// to wait; each tick visits one bucket, so the cost per tick does not
+// depend on how many timers are armed. Timers come from a fixed pool and
+// are linked through their pool index (no allocation).
+class TimerWheel {
+public:
+    static const uint16_t kSlots = 64;
+    static const uint8_t kMaxTimers = 16;
+    static const uint8_t kNoTimer = 0xFF;
+    static const uint8_t kMaxTicksPerAdvance = 8;  // Catch-up is spread over calls
+    
+    using FireCallback = std::function<void(uint8_t timer)>;
+    
+    explicit TimerWheel(uint32_t tickMs = 1000);
+    
+    // Align the wheel with the clock; drops every timer
+    void reset(uint32_t nowMs);
+    
+    // Arm a timer delayMs from nowMs; returns its pool index, or kNoTimer
+    // when the pool is full. Fires on the first tick at or after the due
+    // time, so never early and at most one tick late.
+    uint8_t schedule(uint32_t delayMs, uint32_t nowMs);
+    bool cancel(uint8_t timer);
+    
+    // Run the ticks that have elapsed (at most kMaxTicksPerAdvance per
+    // call) and fire due timers
+    void advance(uint32_t nowMs, const FireCallback& fire);
+    
+    bool isArmed(uint8_t timer) const { return timer < kMaxTimers && timers[timer].inUse; }
+    uint8_t getArmedCount() const { return armed; }
+    uint32_t getTickMs() const { return tickMs; }
+
+private:
+    struct Timer {
+        uint32_t rounds;   // Full wheel turns left
+        uint8_t next;      // Next timer in the same bucket
+        uint8_t bucket;
+        bool inUse;
+    };
+    
+    uint32_t tickMs;
+    uint32_t lastTickMs;   // Time of the last processed tick
+    uint16_t cursor;       // Bucket of the last processed tick
+    uint8_t armed;
+    uint8_t heads[kSlots];
+    Timer timers[kMaxTimers];
+    
+    void unlink(uint8_t timer);
+};
+
+#endif
@@ -95,7 +95,7 @@ void loop() {
             delay(200);
         } else {
             Serial.print("Raw data length: ");
-            Serial.println(decoded.rawLength);
+            Serial.println(decoded.rawTimings.size());
             Serial.println("(Unknown protocol - raw timings captured)");
             
             // Flash orange for unknown protocol
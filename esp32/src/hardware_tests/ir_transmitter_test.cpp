@@ -109,11 +109,6 @@ void transmitTestSignal() {
     // Transmit the signal
     TransmitResult result = irTransmitter.transmit(encoded.rawData, encoded.rawLength, encoded.frequency);
     
-    // Clean up
-    if (encoded.rawData) {
-        delete[] encoded.rawData;
-    }
-    
     if (result.success) {
         Serial.println("[SUCCESS] Signal transmitted!");
         statusLED.setPixelColor(0, COLOR_SUCCESS);
@@ -19,15 +19,34 @@
 
 // Receiver components
 #include "receiver/ESP32SignalCapture.h"
+#include "receiver/ESP32RmtReceiver.h"
+#include "receiver/RmtSignalCapture.h"
+#include "receiver/EdgeSignalCapture.h"
 #include "receiver/IRLibProtocolDecoder.h"
 #include "receiver/LearningStateMachine.h"
+#include "receiver/ProtocolInference.h"
+#include "receiver/SignalFingerprint.h"
+#include "receiver/SignalSniffer.h"
+#include "receiver/SniffTask.h"
 
 // Transmitter components
-#include "transmitter/ESP32IRTransmitter.h"
+#include "transmitter/MultiChannelTransmitter.h"
 
 // Firebase integration
 #include "utils/FirebaseManager.h"
 
+// On-device timers
+#include "utils/CommandScheduler.h"
+#include "utils/NvsTimerStore.h"
+
+// Stored macros
+#include "utils/MacroRunner.h"
+#include "utils/NvsMacroStore.h"
+
+// Learned-command index
+#include "utils/FingerprintIndex.h"
+#include "utils/LittleFsFingerprintStore.h"
+
 // Firebase helper includes (must be after FirebaseManager)
 #include "addons/TokenHelper.h"
 #include "addons/RTDBHelper.h"
@@ -35,12 +54,83 @@
 // ============== Hardware Instances ==============
 
 // Receiver subsystem
+#if defined(IR_RECEIVE_RMT)
+ESP32RmtReceiver rmtReceiver(IR_RECEIVE_PIN);
+RmtSignalCapture signalCapture(&rmtReceiver);
+#elif defined(IR_RECEIVE_STREAMING)
+EdgeSignalCapture signalCapture([]() -> uint32_t { return micros(); });
+
+void IRAM_ATTR onIrReceiveEdge() {
+    signalCapture.onEdge(micros());
+}
+#else
 ESP32SignalCapture signalCapture(IR_RECEIVE_PIN);
+#endif
 IRLibProtocolDecoder protocolDecoder;
 LearningStateMachine learningStateMachine(&signalCapture, &protocolDecoder, LEARNING_TIMEOUT_MS);
 
-// Transmitter subsystem
-ESP32IRTransmitter irTransmitter(IR_SEND_PIN, false);  // GPIO 4, not inverted
+#ifndef IR_NO_SNIFF
+// Outside learning the receiver stays on: the sniff task decodes every
+// frame into a ring (with its own decoder and pool, as it runs beside
+// loop()), and loop() matches them to learned commands and uploads them
+// in batches. Learning pauses it while it reads the capture.
+RawTimingPool sniffPool(1);
+IRLibProtocolDecoder sniffDecoder(&sniffPool);
+SignalSniffer sniffer(&signalCapture, &sniffDecoder, SniffTask::clockMicros);
+SniffTask sniffTask(&sniffer);
+SniffBatch sniffBatch;
+static const uint32_t kSniffRetryMs = 5000;
+#endif
+
+// loop() sleeps between iterations on a task notification: the receiver
+// gives it when a frame starts arriving (edge capture, from its
+// interrupt) or has arrived (RMT, from the driver's watcher task), so
+// learning wakes at once instead of on the next tick, and reads nothing
+// while the air is quiet. IRrecv cannot notify and is polled each tick.
+static const uint32_t kLoopTickMs = 10;
+static TaskHandle_t loopTaskHandle = nullptr;
+
+void IRAM_ATTR wakeLoopTask(void*) {
+    if (!xPortInIsrContext()) {
+        xTaskNotifyGive(loopTaskHandle);
+#ifndef IR_NO_SNIFF
+        sniffTask.wake();
+#endif
+        return;
+    }
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(loopTaskHandle, &woken);
+#ifndef IR_NO_SNIFF
+    sniffTask.wakeFromIsr(&woken);
+#endif
+    portYIELD_FROM_ISR(woken);
+}
+
+// Transmitter subsystem: one RMT channel, queue and transmit task (core 1,
+// away from the WiFi stack) per IR LED, so emitters send concurrently.
+// Each output keeps stream-to-emission histograms ('l' on serial prints them).
+MultiChannelTransmitter irOutputs;
+
+#ifdef IR_EXTRA_SEND_PINS
+static const uint16_t kExtraSendPins[] = {IR_EXTRA_SEND_PINS};
+#endif
+
+// Scheduled sends ("off in 30 min"), kept in NVS across reboots
+NvsTimerStore timerStore;
+CommandScheduler commandScheduler(&timerStore);
+
+// Stored macros ("movie mode"): compiled to waveforms once, with their own
+// encoder so toggle bits do not disturb the outputs', kept in NVS and
+// played from loop() by id
+IRLibProtocolEncoders macroEncoder;
+NvsMacroStore macroStore;
+MacroProgram macroProgram;  // Compile/load target
+MacroRunner macroRunner;
+
+// Every command learned, by signal fingerprint, kept in flash: a capture
+// is matched to the command it already is without asking the cloud
+LittleFsFingerprintStore fingerprintStore;
+FingerprintIndex fingerprintIndex(&fingerprintStore);
 
 // Firebase integration
 FirebaseManager firebaseManager(
@@ -81,6 +171,9 @@ void onLearningStateChanged(LearningState state) {
             statusLED.show();
             // Update Firestore to indicate learning complete
             firebaseManager.setLearningMode(false);
+#ifndef IR_NO_SNIFF
+            sniffer.resume();
+#endif
             break;
             
         case LearningState::LEARNING:
@@ -117,11 +210,43 @@ void onSignalCaptured(const DecodedSignal& signal) {
     Serial.println(signal.bits);
     Serial.print("Known Protocol: ");
     Serial.println(signal.isKnownProtocol ? "Yes" : "No");
+    Serial.print("Confidence: ");
+    Serial.print(signal.confidence);
+    Serial.println("%");
+    if (!signal.isKnownProtocol) {
+        const RawTimingPool& pool = RawTimingPool::shared();
+        Serial.print("Raw timings: ");
+        Serial.print(signal.rawTimings.size());
+        Serial.print(" (pool ");
+        Serial.print(pool.getInUse());
+        Serial.print("/");
+        Serial.print(pool.getCapacity());
+        Serial.print(" in use, high water ");
+        Serial.print(pool.getHighWater());
+        Serial.print(", failures ");
+        Serial.print(pool.getFailures());
+        Serial.println(")");
+    }
+    char params[protocol_inference::kMaxParamsLength];
+    if (signal.isInferred && protocol_inference::formatParams(signal.inferred, params, sizeof(params)) > 0) {
+        Serial.print("Inferred coding: ");
+        Serial.println(params);
+    }
+    
+    bool isNew = false;
+    uint32_t learnedId = fingerprintIndex.learn(signal_fingerprint::of(signal), &isNew);
+    if (learnedId == FingerprintIndex::kNotFound) {
+        Serial.println("Learned as: - (fingerprint index full or unavailable)");
+    } else {
+        Serial.print("Learned as: #");
+        Serial.print(learnedId);
+        Serial.println(isNew ? " (new)" : " (already learned)");
+    }
     Serial.println("=========================================");
     
     // Upload to Firestore
     String commandName = String("cmd_") + String(millis());
-    if (firebaseManager.uploadSignal(signal, commandName)) {
+    if (firebaseManager.uploadSignal(signal, commandName, learnedId, !isNew)) {
         Serial.println("[Main] Signal uploaded to Firestore successfully!");
     } else {
         Serial.println("[Main] Failed to upload signal to Firestore");
@@ -131,26 +256,204 @@ void onSignalCaptured(const DecodedSignal& signal) {
 // Track when to revert LED back to ready after transmit flash
 unsigned long txLedRevertTime = 0;
 
+// Scheduled command due: sent like a tap from the cloud
+void onScheduledCommand(const ScheduledCommand& command) {
+    Serial.print("[Timers] Firing schedule ");
+    Serial.println(command.id);
+    
+    TransmitRequest request;
+    request.action = TransmitAction::SEND;
+    request.protocol = command.protocol;
+    request.value = command.value;
+    request.bits = command.bits;
+    request.carrierKHz = command.carrierKHz;
+    request.dutyPercent = command.dutyPercent;
+    request.timestamps.dispatchUs = (uint32_t)TransmitTask::clockMicros();
+    if (!irOutputs.submit(command.output, request)) {
+        Serial.println("[TX] Transmit queue full or no such output!");
+    }
+}
+
+void scheduleCommand(const PendingCommand& cmd) {
+    if (cmd.protocolId == IRProtocol::UNKNOWN || cmd.isRaw() || cmd.isState()) {
+        Serial.println("[Timers] Only protocol value commands can be scheduled");
+        return;
+    }
+    
+    ScheduledCommand scheduled;
+    scheduled.id = cmd.scheduleId;
+    scheduled.dueEpoch = cmd.atEpoch;
+    scheduled.protocol = cmd.protocolId;
+    scheduled.value = cmd.value;
+    scheduled.bits = cmd.bits;
+    scheduled.output = cmd.output;
+    scheduled.carrierKHz = cmd.carrierKHz;
+    scheduled.dutyPercent = cmd.dutyPercent;
+    
+    uint32_t epochSec = (uint32_t)time(nullptr);
+    bool armed = cmd.atEpoch
+        ? commandScheduler.scheduleAt(scheduled, millis(), epochSec)
+        : commandScheduler.scheduleIn(scheduled, cmd.delaySec, millis(), epochSec);
+    Serial.print(armed ? "[Timers] Scheduled " : "[Timers] Schedule rejected ");
+    Serial.println(cmd.scheduleId);
+}
+
+void onMacroReceived(MacroAction action, uint32_t id, const CommandBatch& batch) {
+    if (action == MacroAction::DEFINE) {
+        MacroError error = macroProgram.compile(batch, &macroEncoder);
+        if (error != MacroError::NONE) {
+            Serial.print("[Macros] Macro ");
+            Serial.print(id);
+            Serial.print(" rejected: ");
+            Serial.println(macroErrorName(error));
+            return;
+        }
+        Serial.print(macroStore.save(id, macroProgram) ? "[Macros] Stored macro " : "[Macros] Store failed for ");
+        Serial.print(id);
+        Serial.print(": ");
+        Serial.print(macroProgram.getStepCount());
+        Serial.print(" steps, ");
+        Serial.print(macroProgram.getWaveformCount());
+        Serial.print(" waveforms, ");
+        Serial.print(macroProgram.getTimingCount());
+        Serial.println(" timings");
+        return;
+    }
+    
+    if (action == MacroAction::REMOVE) {
+        Serial.print(macroStore.remove(id) ? "[Macros] Removed macro " : "[Macros] No macro ");
+        Serial.println(id);
+        return;
+    }
+    
+    if (macroRunner.isActive()) {
+        Serial.print("[Macros] Busy with macro ");
+        Serial.print(macroRunner.getMacroId());
+        Serial.print(" - dropped ");
+        Serial.println(id);
+        return;
+    }
+    if (!macroStore.load(id, &macroProgram) || !macroRunner.start(id, macroProgram, millis())) {
+        Serial.print("[Macros] No macro ");
+        Serial.println(id);
+        return;
+    }
+    Serial.print("[Macros] Running macro ");
+    Serial.println(id);
+    statusLED.setPixelColor(0, COLOR_TX_PROCESSING);
+    statusLED.show();
+}
+
+// Macro step: the waveform is already rendered, so it goes out as RAW
+bool emitMacroStep(uint8_t output, const uint16_t* timings, uint16_t length, uint16_t carrierKHz,
+                   uint8_t dutyPercent) {
+    TransmitRequest request;
+    request.carrierKHz = carrierKHz;
+    request.dutyPercent = dutyPercent;
+    request.timestamps.dispatchUs = (uint32_t)TransmitTask::clockMicros();
+    return irOutputs.submitRaw(output, request, timings, length);
+}
+
+// Per-step timing of the macro that just finished
+void reportMacroTiming() {
+    Serial.print("[Macros] Macro ");
+    Serial.print(macroRunner.getMacroId());
+    Serial.print(" done, deferred sends=");
+    Serial.println(macroRunner.getDeferredCount());
+    for (uint8_t step = 0; step < macroRunner.getStepCount(); step++) {
+        const MacroStepTiming& timing = macroRunner.getStepTiming(step);
+        Serial.print("[Macros]   step ");
+        Serial.print(step);
+        Serial.print(": planned=");
+        Serial.print(timing.plannedMs);
+        Serial.print("ms actual=");
+        Serial.print(timing.actualMs);
+        Serial.print("ms late=");
+        Serial.print(timing.lateMs);
+        Serial.println("ms");
+    }
+}
+
 void onCommandReceived(const PendingCommand& cmd) {
+    if (cmd.event == CommandEvent::CANCEL) {
+        Serial.print(commandScheduler.cancel(cmd.scheduleId) ? "[Timers] Cancelled " : "[Timers] No schedule ");
+        Serial.println(cmd.scheduleId);
+        return;
+    }
+    if (cmd.isScheduled()) {
+        scheduleCommand(cmd);
+        return;
+    }
+    
+    TransmitRequest request;
+    request.protocol = cmd.protocolId;
+    request.value = cmd.value;
+    request.bits = cmd.bits;
+    request.count = cmd.repeatCount;
+    request.carrierKHz = cmd.carrierKHz;
+    request.dutyPercent = cmd.dutyPercent;
+    request.timestamps = cmd.timestamps;
+    request.timestamps.dispatchUs = (uint32_t)TransmitTask::clockMicros();
+    
+    if (cmd.event == CommandEvent::RELEASE) {
+        Serial.println("[TX] Release");
+        request.action = TransmitAction::RELEASE;
+        irOutputs.submit(cmd.output, request);
+        return;
+    }
+    
     statusLED.setPixelColor(0, COLOR_TX_PROCESSING);
     statusLED.show();
     
+    if (cmd.isState()) {
+        Serial.print("[TX] Dispatching A/C state: ");
+        Serial.print(cmd.protocol);
+        Serial.print(" ");
+        Serial.print(cmd.stateLength);
+        Serial.println(" bytes");
+        request.action = TransmitAction::STATE;
+        request.acProtocol = cmd.acProtocol;
+        request.stateLength = cmd.stateLength;
+        memcpy(request.state, cmd.state, cmd.stateLength);
+        if (!irOutputs.submit(cmd.output, request)) {
+            Serial.println("[TX] Transmit queue full or no such output!");
+            statusLED.setPixelColor(0, COLOR_TX_FAILED);
+            statusLED.show();
+            txLedRevertTime = millis() + 1000;
+        }
+        return;
+    }
+    
+    // RAW timings are copied into a transmit slot; cmd.rawTimings is only
+    // valid during this call
+    if (cmd.isRaw()) {
+        Serial.print("[TX] Dispatching RAW: ");
+        Serial.print(cmd.rawLength);
+        Serial.print(" timings @ ");
+        Serial.print(cmd.carrierKHz ? cmd.carrierKHz : IR_DEFAULT_CARRIER_KHZ);
+        Serial.println("kHz");
+        if (!irOutputs.submitRaw(cmd.output, request, cmd.rawTimings, cmd.rawLength)) {
+            Serial.println("[TX] Transmit queue full or no such output!");
+            statusLED.setPixelColor(0, COLOR_TX_FAILED);
+            statusLED.show();
+            txLedRevertTime = millis() + 1000;
+        }
+        return;
+    }
+    
     Serial.print("[TX] Dispatching: ");
     Serial.print(cmd.protocol);
     Serial.print(" value=0x");
     Serial.print((unsigned long)cmd.value, HEX);
     Serial.print(" bits=");
-    Serial.println(cmd.bits);
-    
-    // Dispatch to library's native sender based on protocol
-    TransmitResult result;
-    if (cmd.protocol == "SAMSUNG") {
-        result = irTransmitter.transmitSamsung(cmd.value, cmd.bits);
-    } else if (cmd.protocol == "NEC") {
-        result = irTransmitter.transmitNEC((uint32_t)cmd.value, cmd.bits);
-    } else if (cmd.protocol == "SONY") {
-        result = irTransmitter.transmitSony((uint32_t)cmd.value, cmd.bits);
-    } else {
+    Serial.print(cmd.bits);
+    Serial.print(" x");
+    Serial.print(cmd.repeatCount);
+    Serial.print(" output=");
+    Serial.println(cmd.output);
+    
+    // Protocol was resolved when the stream event was parsed
+    if (cmd.protocolId == IRProtocol::UNKNOWN) {
         Serial.print("[TX] Unknown protocol: ");
         Serial.println(cmd.protocol);
         statusLED.setPixelColor(0, COLOR_TX_FAILED);
@@ -159,32 +462,160 @@ void onCommandReceived(const PendingCommand& cmd) {
         return;
     }
     
-    if (result.success) {
-        Serial.print("[TX] Transmitted OK: ");
-        Serial.print(cmd.protocol);
-        Serial.print(" value=0x");
-        Serial.println((unsigned long)cmd.value, HEX);
-        statusLED.setPixelColor(0, COLOR_TX_SUCCESS);
-        statusLED.show();
-        txLedRevertTime = millis() + 500;
-    } else {
-        Serial.println("[TX] Transmit failed!");
+    // Emitted by the transmit task; the outcome is reported from loop()
+    request.action = cmd.event == CommandEvent::PRESS ? TransmitAction::PRESS : TransmitAction::SEND;
+    if (!irOutputs.submit(cmd.output, request)) {
+        Serial.println("[TX] Transmit queue full or no such output!");
         statusLED.setPixelColor(0, COLOR_TX_FAILED);
         statusLED.show();
         txLedRevertTime = millis() + 1000;
     }
 }
 
+// Serial 'l': print command latency histograms, 'L': print and reset,
+// 's': print sniffer counters
+void handleSerialCommands() {
+    while (Serial.available() > 0) {
+        char c = Serial.read();
+#ifndef IR_NO_SNIFF
+        if (c == 's') {
+            SnifferStats stats = sniffer.getStats();
+            Serial.print("[SNIFF] frames=");
+            Serial.print(stats.frames);
+            Serial.print(" overruns=");
+            Serial.print(stats.overruns);
+            Serial.print(" depth=");
+            Serial.print(stats.depth);
+            Serial.print(" max=");
+            Serial.print(stats.maxDepth);
+            Serial.print(" frame=");
+            Serial.print(stats.lastFrameUs);
+            Serial.print("us mean=");
+            Serial.print(stats.meanFrameUs);
+            Serial.print("us max=");
+            Serial.print(stats.maxFrameUs);
+            Serial.print("us batched=");
+            Serial.println(sniffBatch.size());
+            continue;
+        }
+#endif
+        if (c != 'l' && c != 'L') {
+            continue;
+        }
+        
+        static char report[768];
+        for (uint8_t output = 0; output < irOutputs.getOutputCount(); output++) {
+            CommandLatency* latency = irOutputs.getLatency(output);
+            latency->format(report, sizeof(report));
+            Serial.print("[LAT] Output ");
+            Serial.print(output);
+            Serial.println(" command latency (us):");
+            Serial.print(report);
+            if (c == 'L') {
+                latency->reset();
+            }
+        }
+        if (c == 'L') {
+            Serial.println("[LAT] Reset");
+        }
+    }
+}
+
+// Report transmit outcomes counted by each output's transmit task
+void reportTransmitResults() {
+    static uint32_t lastCompleted[MultiChannelTransmitter::kMaxOutputs] = {0};
+    static uint32_t lastFailed[MultiChannelTransmitter::kMaxOutputs] = {0};
+    
+    for (uint8_t output = 0; output < irOutputs.getOutputCount(); output++) {
+        TransmitQueueStats stats = irOutputs.getStats(output);
+        if (stats.failed != lastFailed[output]) {
+            lastFailed[output] = stats.failed;
+            Serial.print("[TX] Transmit failed on output ");
+            Serial.println(output);
+            statusLED.setPixelColor(0, COLOR_TX_FAILED);
+            statusLED.show();
+            txLedRevertTime = millis() + 1000;
+        } else if (stats.completed != lastCompleted[output]) {
+            lastCompleted[output] = stats.completed;
+            const WaveformCache* cache = irOutputs.getCache(output);
+            Serial.print("[TX] Output ");
+            Serial.print(output);
+            Serial.print(" (GPIO ");
+            Serial.print(irOutputs.getPin(output));
+            Serial.print(") OK: queue depth=");
+            Serial.print(stats.depth);
+            Serial.print(" max=");
+            Serial.print(stats.maxDepth);
+            Serial.print(" wait=");
+            Serial.print(stats.lastWaitUs);
+            Serial.print("us max=");
+            Serial.print(stats.maxWaitUs);
+            Serial.print("us mean=");
+            Serial.print(stats.meanWaitUs);
+            Serial.print("us busy=");
+            Serial.print((unsigned long)(stats.busyUs / 1000));
+            Serial.print("ms dropped=");
+            Serial.println(stats.dropped);
+            Serial.print("[TX] Waveform cache: hits=");
+            Serial.print(cache->getHits());
+            Serial.print(" misses=");
+            Serial.print(cache->getMisses());
+            Serial.print(" evictions=");
+            Serial.println(cache->getEvictions());
+            Serial.print("[TX] Coalesced taps=");
+            Serial.print(firebaseManager.getCoalescedCount());
+            Serial.print(" burst frames=");
+            Serial.print(stats.burstFrames);
+            Serial.print(" stream drops=");
+            Serial.print(firebaseManager.getDroppedCommandCount());
+            Serial.print(" misrouted=");
+            Serial.println(irOutputs.getMisrouted());
+            statusLED.setPixelColor(0, COLOR_TX_SUCCESS);
+            statusLED.show();
+            txLedRevertTime = millis() + 500;
+        }
+    }
+}
+
+#ifndef IR_NO_SNIFF
+// Sniffed frames into the batch, matched to learned commands here (the
+// task that learns them), and the batch uploaded when due. While a full
+// batch cannot go out, frames wait in the ring and then count as overruns.
+void drainSniffedFrames() {
+    SniffedFrame frame;
+    while (!sniffBatch.isFull() && sniffer.pop(&frame)) {
+        sniffBatch.add(frame, fingerprintIndex.find(frame.fingerprint));
+    }
+    
+    static uint32_t lastAttemptMs = 0;
+    uint32_t now = millis();
+    if (!sniffBatch.isDue(now) || !firebaseManager.isReady() ||
+        (lastAttemptMs != 0 && now - lastAttemptMs < kSniffRetryMs)) {
+        return;
+    }
+    lastAttemptMs = now;
+    if (firebaseManager.uploadSniffedEvents(sniffBatch, sniffer.getStats())) {
+        sniffBatch.clear();
+        lastAttemptMs = 0;
+    }
+}
+#endif
+
 void onFirebaseLearningModeChanged(bool isLearning) {
     Serial.print("[Firebase] Learning mode changed: ");
     Serial.println(isLearning ? "ON" : "OFF");
     
     if (isLearning) {
+#ifndef IR_NO_SNIFF
+        sniffer.pause();  // Learning reads the capture from here on
+#endif
         signalCapture.enable();
         learningStateMachine.startLearning();
     } else {
         learningStateMachine.stopLearning();
+#ifdef IR_NO_SNIFF
         signalCapture.disable();
+#endif
     }
 }
 
@@ -202,20 +633,63 @@ void setup() {
     statusLED.setPixelColor(0, COLOR_CONNECTING);
     statusLED.show();
     
-    // IR receiver is initialized on-demand when learning mode is activated
+    // IR receiver is enabled at boot for sniffing, or on demand when
+    // learning mode is activated (IR_NO_SNIFF)
     Serial.print("[Pulsr] IR Receiver on GPIO ");
     Serial.println(IR_RECEIVE_PIN);
+#ifdef IR_RECEIVE_STREAMING
+    // Edges are timestamped from here on; the capture ignores them until enabled
+    pinMode(IR_RECEIVE_PIN, INPUT);
+    attachInterrupt(digitalPinToInterrupt(IR_RECEIVE_PIN), onIrReceiveEdge, CHANGE);
+#endif
+    if (!RawTimingPool::shared().begin()) {
+        Serial.println("[Pulsr] Raw timing pool allocation failed!");
+    }
+    if (fingerprintIndex.begin()) {
+        Serial.print("[Pulsr] Learned commands: ");
+        Serial.println(fingerprintIndex.size());
+    } else {
+        Serial.println("[Pulsr] Fingerprint index allocation failed!");
+    }
     
-    // Initialize IR transmitter
-    irTransmitter.begin();
-    Serial.print("[Pulsr] IR Transmitter initialized on GPIO ");
-    Serial.println(IR_SEND_PIN);
+    // Initialize IR transmitters: output 0 is IR_SEND_PIN, then any extras
+    irOutputs.addOutput(IR_SEND_PIN);
+#ifdef IR_EXTRA_SEND_PINS
+    for (size_t i = 0; i < sizeof(kExtraSendPins) / sizeof(kExtraSendPins[0]); i++) {
+        if (!irOutputs.addOutput(kExtraSendPins[i])) {
+            Serial.println("[Pulsr] Too many IR outputs - extra pins ignored");
+            break;
+        }
+    }
+#endif
+    if (!irOutputs.begin()) {
+        Serial.println("[Pulsr] Transmit task creation failed!");
+    }
+    for (uint8_t output = 0; output < irOutputs.getOutputCount(); output++) {
+        Serial.print("[Pulsr] IR output ");
+        Serial.print(output);
+        Serial.print(" on GPIO ");
+        Serial.println(irOutputs.getPin(output));
+    }
+    
+    // Wall clock for scheduled commands (UTC); SNTP syncs once WiFi is up
+    configTime(0, 0, "pool.ntp.org", "time.nist.gov");
     
     // Set up callbacks
     learningStateMachine.onStateChange(onLearningStateChanged);
     learningStateMachine.onSignalCapture(onSignalCaptured);
+    loopTaskHandle = xTaskGetCurrentTaskHandle();
+    learningStateMachine.setWakeHook(wakeLoopTask, nullptr);
+#ifndef IR_NO_SNIFF
+    // Listen from boot; learning takes the capture over when asked
+    signalCapture.enable();
+    if (!sniffTask.begin()) {
+        Serial.println("[Pulsr] Sniff task creation failed!");
+    }
+#endif
     firebaseManager.onLearningStateChange(onFirebaseLearningModeChanged);
     firebaseManager.onCommandReceived(onCommandReceived);
+    firebaseManager.onMacroReceived(onMacroReceived);
     
     // Connect to Firebase
     Serial.println("[Pulsr] Connecting to Firebase...");
@@ -238,6 +712,21 @@ void loop() {
     
     // Update learning state machine (handles timeouts and signal capture)
     learningStateMachine.update();
+#ifndef IR_NO_SNIFF
+    drainSniffedFrames();
+#endif
+    
+    // Fire due scheduled commands (restores NVS timers once time is set)
+    commandScheduler.update(millis(), (uint32_t)time(nullptr), onScheduledCommand);
+    
+    // Play the running macro's due steps
+    if (macroRunner.isActive() && macroRunner.update(millis(), emitMacroStep)) {
+        reportMacroTiming();
+    }
+    
+    // LED/serial feedback for frames the transmit task sent
+    reportTransmitResults();
+    handleSerialCommands();
     
     // Revert transmit LED flash back to ready color after timeout
     if (txLedRevertTime > 0 && millis() >= txLedRevertTime) {
@@ -265,5 +754,8 @@ void loop() {
         lastFirebaseState = currentFirebaseState;
     }
     
-    delay(10);
+    // Until the next tick, or earlier when learning is due (a capture
+    // arrived, or its deadline passed)
+    uint32_t waitMs = learningStateMachine.msUntilDue(millis());
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs < kLoopTickMs ? waitMs : kLoopTickMs));
 }
@@ -0,0 +1,145 @@
+#include "receiver/ESP32RmtReceiver.h"
+#include <Arduino.h>
+#include <cstring>
+
+// 80MHz APB / 80 = 1 tick per microsecond, like the transmit channels
+#define RMT_CLOCK_DIVIDER 80
+
+// Glitch filter in APB ticks (8-bit): pulses under ~3us are dropped in
+// hardware before they become edges
+#define RMT_RX_FILTER_TICKS 255
+
+ESP32RmtReceiver::ESP32RmtReceiver(uint16_t pin, rmt_channel_t channel)
+    : pin(pin),
+      channel(channel),
+      installed(false),
+      ringBuffer(nullptr),
+      frameHook(nullptr),
+      frameContext(nullptr),
+      watcher(nullptr),
+      parked(nullptr),
+      parkedBytes(0) {
+}
+
+ESP32RmtReceiver::~ESP32RmtReceiver() {
+    if (watcher) {
+        vTaskDelete(watcher);
+        rmt_item32_t* items = parked.exchange(nullptr);
+        if (items) {
+            vRingbufferReturnItem(ringBuffer, items);
+        }
+    }
+    if (installed) {
+        rmt_rx_stop(channel);
+        rmt_driver_uninstall(channel);
+    }
+}
+
+bool ESP32RmtReceiver::begin(uint16_t idleThresholdUs) {
+    if (installed) {
+        return !frameHook || startWatcher();
+    }
+    
+    rmt_config_t config = RMT_DEFAULT_CONFIG_RX((gpio_num_t)pin, channel);
+    config.clk_div = RMT_CLOCK_DIVIDER;
+    config.mem_block_num = 1;
+    config.rx_config.filter_en = true;
+    config.rx_config.filter_ticks_thresh = RMT_RX_FILTER_TICKS;
+    config.rx_config.idle_threshold = idleThresholdUs;
+    
+    if (rmt_config(&config) != ESP_OK) {
+        Serial.println("[RMT] RX channel config failed");
+        return false;
+    }
+    
+    // The driver moves each finished frame into the ring buffer from its
+    // ISR; we never see individual edges
+    if (rmt_driver_install(channel, kRingBufferBytes, 0) != ESP_OK ||
+        rmt_get_ringbuf_handle(channel, &ringBuffer) != ESP_OK) {
+        Serial.println("[RMT] RX driver install failed");
+        return false;
+    }
+
+#if SOC_RMT_SUPPORT_RX_PINGPONG
+    // Frames longer than the channel's 48-symbol block (A/C remotes) are
+    // drained half a block at a time instead of overflowing
+    rmt_set_rx_thr_intr_en(channel, true, SOC_RMT_MEM_WORDS_PER_CHANNEL / 2);
+#endif
+
+    installed = true;
+    return !frameHook || startWatcher();
+}
+
+bool ESP32RmtReceiver::setFrameHook(RmtFrameHook hook, void* context) {
+    // Set once, before frames flow: the watcher reads these without a lock
+    frameContext = context;
+    frameHook = hook;
+    return !installed || startWatcher();
+}
+
+bool ESP32RmtReceiver::startWatcher() {
+    if (watcher) {
+        return true;
+    }
+    if (xTaskCreatePinnedToCore(watch, "irRxWatch", kWatchStackSize, this, kWatchPriority, &watcher, kWatchCore) !=
+        pdPASS) {
+        Serial.println("[RMT] RX watcher task failed");
+        watcher = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void ESP32RmtReceiver::watch(void* arg) {
+    ESP32RmtReceiver* self = static_cast<ESP32RmtReceiver*>(arg);
+    for (;;) {
+        size_t bytes = 0;
+        rmt_item32_t* items = (rmt_item32_t*)xRingbufferReceive(self->ringBuffer, &bytes, portMAX_DELAY);
+        if (!items) {
+            continue;
+        }
+        self->parkedBytes = bytes;
+        self->parked.store(items, std::memory_order_release);
+        self->frameHook(self->frameContext);
+        
+        // Until receive() has copied the frame and returned it
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+bool ESP32RmtReceiver::start() {
+    return installed && rmt_rx_start(channel, true) == ESP_OK;
+}
+
+void ESP32RmtReceiver::stop() {
+    if (installed) {
+        rmt_rx_stop(channel);
+    }
+}
+
+size_t ESP32RmtReceiver::receive(RmtSymbol* symbols, size_t capacity) {
+    if (!installed) {
+        return 0;
+    }
+    
+    // The watcher owns the ring buffer once it runs
+    size_t bytes = 0;
+    rmt_item32_t* items;
+    if (watcher) {
+        items = parked.exchange(nullptr, std::memory_order_acquire);
+        bytes = parkedBytes;
+    } else {
+        items = (rmt_item32_t*)xRingbufferReceive(ringBuffer, &bytes, 0);
+    }
+    if (!items) {
+        return 0;
+    }
+    
+    size_t count = bytes / sizeof(rmt_item32_t);
+    memcpy(symbols, items, (count < capacity ? count : capacity) * sizeof(rmt_item32_t));
+    vRingbufferReturnItem(ringBuffer, items);
+    if (watcher) {
+        xTaskNotifyGive(watcher);
+    }
+    return count;
+}
@@ -0,0 +1,177 @@
+#include "receiver/EdgeSignalCapture.h"
+
+EdgeSignalCapture::EdgeSignalCapture(MicrosClock clock, uint16_t idleThresholdUs)
+    : clock(clock),
+      idleThresholdUs(idleThresholdUs),
+      enabled(false),
+      droppedEdges(0),
+      readyHook(nullptr),
+      readyContext(nullptr),
+      lastIsrEdge(0u - idleThresholdUs),  // The first edge starts a burst
+      held(false),
+      inFrame(false),
+      tooLong(false),
+      lastEdge(0),
+      droppedSeen(0),
+      timingCount(0),
+      frames(0),
+      noise(0),
+      overflows(0),
+      lastLatencyUs(0) {
+}
+
+void EdgeSignalCapture::enable() {
+    resume();
+    enabled.store(true, std::memory_order_release);
+}
+
+void EdgeSignalCapture::disable() {
+    enabled.store(false, std::memory_order_release);
+    held = false;
+}
+
+void EdgeSignalCapture::resume() {
+    // Edges that arrived while a frame was held belong to no frame we
+    // can still line up with
+    uint32_t stale;
+    while (edges.pop(&stale)) {
+    }
+    droppedSeen = droppedEdges.load(std::memory_order_acquire);
+    held = false;
+    inFrame = false;
+}
+
+void IRAM_ATTR EdgeSignalCapture::onEdge(uint32_t timestampUs) {
+    if (!enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (!edges.push(timestampUs)) {
+        droppedEdges.fetch_add(1, std::memory_order_release);
+    }
+    
+    // A burst starts after idle: wake the consumer once, it polls from there
+    const bool burstStart = timestampUs - lastIsrEdge >= idleThresholdUs;
+    lastIsrEdge = timestampUs;
+    if (burstStart && readyHook) {
+        readyHook(readyContext);
+    }
+}
+
+bool EdgeSignalCapture::setReadyHook(CaptureReadyHook hook, void* context) {
+    // Set before enable(): the interrupt reads these without a lock
+    readyContext = context;
+    readyHook = hook;
+    return true;
+}
+
+bool EdgeSignalCapture::hasSignal() {
+    return held || (enabled.load(std::memory_order_acquire) && poll(clock()));
+}
+
+void EdgeSignalCapture::beginFrame(uint32_t timestampUs) {
+    inFrame = true;
+    tooLong = false;
+    lastEdge = timestampUs;
+    timingCount = 0;
+    decoder.reset();
+}
+
+bool EdgeSignalCapture::hold(uint32_t nowUs) {
+    held = true;
+    inFrame = false;
+    frames++;
+    lastLatencyUs = nowUs - lastEdge;
+    return true;
+}
+
+bool EdgeSignalCapture::endFrame(uint32_t nowUs) {
+    inFrame = false;
+    if (tooLong) {
+        overflows++;
+        return false;
+    }
+    if (timingCount < kMinTimings) {
+        noise++;
+        return false;
+    }
+    return hold(nowUs);
+}
+
+bool EdgeSignalCapture::poll(uint32_t nowUs) {
+    uint32_t timestamp;
+    while (edges.pop(&timestamp)) {
+        // A lost edge swaps marks and spaces for the rest of the frame
+        const uint32_t dropped = droppedEdges.load(std::memory_order_acquire);
+        if (dropped != droppedSeen) {
+            droppedSeen = dropped;
+            if (inFrame) {
+                tooLong = true;
+            }
+        }
+        
+        if (!inFrame) {
+            beginFrame(timestamp);  // The line was idle: this edge starts a mark
+            continue;
+        }
+        
+        const uint32_t duration = timestamp - lastEdge;
+        const bool space = timingCount % 2 == 1;
+        if (space && duration >= idleThresholdUs) {
+            // The gap before the next frame ends this one
+            if (!tooLong && decoder.idle(duration)) {
+                return hold(nowUs);
+            }
+            if (endFrame(nowUs)) {
+                return true;
+            }
+            beginFrame(timestamp);
+            continue;
+        }
+        
+        lastEdge = timestamp;
+        if (timingCount >= kMaxTimings) {
+            tooLong = true;
+            continue;
+        }
+        timings[timingCount++] = duration > 0xFFFF ? 0xFFFF : (uint16_t)duration;
+        if (!tooLong && decoder.push(duration)) {
+            return hold(nowUs);
+        }
+    }
+    
+    // Quiet since the last mark ended
+    if (inFrame && timingCount % 2 == 1) {
+        const uint32_t silent = nowUs - lastEdge;
+        if (!tooLong && decoder.idle(silent)) {
+            return hold(nowUs);
+        }
+        if (silent >= idleThresholdUs) {
+            return endFrame(nowUs);
+        }
+    }
+    return false;
+}
+
+bool EdgeSignalCapture::decode(decode_results* results) {
+    if (!results || !hasSignal()) {
+        return false;
+    }
+    
+    const bool known = decoder.hasResult();
+    const StreamResult& decoded = decoder.getResult();
+    results->decode_type = known ? decodeTypeFor(decoded.protocol) : UNKNOWN;
+    results->value = !known ? 0 : decoded.repeat ? UINT64_MAX : decoded.value;  // IRrecv's kRepeat
+    results->bits = known ? decoded.bits : 0;
+    results->address = 0;
+    results->command = 0;
+    results->repeat = known && decoded.repeat;
+    
+    // IRrecv layout: the gap before the frame, then every duration
+    rawbuf[0] = idleThresholdUs / kRawTick;
+    for (uint16_t i = 0; i < timingCount; i++) {
+        rawbuf[i + 1] = (timings[i] + kRawTick / 2) / kRawTick;
+    }
+    results->rawbuf = rawbuf;
+    results->rawlen = timingCount + 1;
+    return true;
+}
@@ -0,0 +1,185 @@
+#include "receiver/FrameDecoder.h"
+
+namespace frame_decoder {
+
+namespace {
+
+const uint16_t kMaxBiphaseSlots = 160;
+
+bool matches(uint16_t measured, uint16_t expected) {
+    uint32_t tolerance = (uint32_t)expected * kTolerancePercent / 100 + kToleranceUs;
+    uint32_t difference = measured > expected ? measured - expected : expected - measured;
+    return difference <= tolerance;
+}
+
+void storeBit(const ProtocolDescriptor& d, uint16_t bits, uint16_t index, bool one, uint64_t* value) {
+    if (!one) {
+        return;
+    }
+    uint16_t position = d.bitOrder == BitOrder::MSB_FIRST ? bits - 1 - index : index;
+    *value |= 1ULL << position;
+}
+
+// Returns the number of timings consumed, 0 on mismatch
+uint16_t decodeMarkSpaceFrame(const ProtocolDescriptor& d, const uint16_t* timings, uint16_t length,
+                              uint16_t bits, uint64_t* value) {
+    uint16_t needed = d.headerMark ? 2 : 0;
+    needed += bits * 2 + (d.footerMark ? 1 : -1);
+    if (length < needed) {
+        return 0;
+    }
+    
+    uint16_t idx = 0;
+    if (d.headerMark) {
+        if (!matches(timings[0], d.headerMark) || !matches(timings[1], d.headerSpace)) {
+            return 0;
+        }
+        idx = 2;
+    }
+    
+    *value = 0;
+    for (uint16_t i = 0; i < bits; i++) {
+        uint16_t mark = timings[idx++];
+        bool hasSpace = i + 1 < bits || d.footerMark;
+        uint16_t space = hasSpace ? timings[idx++] : 0;
+        
+        bool one = matches(mark, d.oneMark) && (!hasSpace || matches(space, d.oneSpace));
+        bool zero = matches(mark, d.zeroMark) && (!hasSpace || matches(space, d.zeroSpace));
+        if (one == zero) {
+            return 0;  // Neither, or indistinguishable (no space to tell them apart)
+        }
+        storeBit(d, bits, i, one, value);
+    }
+    
+    if (d.footerMark && !matches(timings[idx++], d.footerMark)) {
+        return 0;
+    }
+    return idx;
+}
+
+bool decodeBiphaseFrame(const ProtocolDescriptor& d, const uint16_t* timings, uint16_t length,
+                        uint16_t bits, uint64_t* value) {
+    uint16_t idx = 0;
+    if (d.headerMark) {
+        if (length < 2 || !matches(timings[0], d.headerMark) || !matches(timings[1], d.headerSpace)) {
+            return false;
+        }
+        idx = 2;
+    }
+    
+    // Expand the timings back into half-bit slots (true = mark)
+    const uint16_t needed = (d.prefixBits + bits) * 2 + (d.doubleWidthBit < bits ? 2 : 0);
+    if (needed > kMaxBiphaseSlots) {
+        return false;
+    }
+    bool slots[kMaxBiphaseSlots];
+    uint16_t count = 0;
+    
+    // A frame opening with a space half loses it to idle time
+    bool firstHalfMark = d.prefixBits == 0 || d.oneMarkFirst;
+    if (!firstHalfMark) {
+        slots[count++] = false;
+    }
+    
+    bool mark = true;
+    for (; idx < length; idx++, mark = !mark) {
+        uint16_t units = (timings[idx] + d.biphaseUnit / 2) / d.biphaseUnit;
+        if (units == 0 || units > 4 || !matches(timings[idx], units * d.biphaseUnit) ||
+            count + units > needed) {
+            return false;
+        }
+        for (uint16_t u = 0; u < units; u++) {
+            slots[count++] = mark;
+        }
+    }
+    
+    // And a frame closing with one
+    while (count < needed) {
+        slots[count++] = false;
+    }
+    
+    uint16_t pos = 0;
+    *value = 0;
+    for (uint16_t i = 0; i < d.prefixBits + bits; i++) {
+        bool isData = i >= d.prefixBits;
+        uint16_t half = isData && i - d.prefixBits == d.doubleWidthBit ? 2 : 1;
+        bool first = slots[pos];
+        bool second = slots[pos + half];
+        if (first == second || slots[pos + half - 1] != first || slots[pos + 2 * half - 1] != second) {
+            return false;
+        }
+        bool one = first == d.oneMarkFirst;
+        if (!isData && !one) {
+            return false;  // Start bits are always '1'
+        }
+        if (isData) {
+            storeBit(d, bits, i - d.prefixBits, one, value);
+        }
+        pos += 2 * half;
+    }
+    return true;
+}
+
+}  // namespace
+
+bool decodeFrame(const ProtocolDescriptor& d, const uint16_t* timings, uint16_t length,
+                 uint16_t bits, uint64_t* value) {
+    if (!timings || !value || bits == 0 || bits > 64) {
+        return false;
+    }
+    
+    if (d.coding == BitCoding::BIPHASE) {
+        return decodeBiphaseFrame(d, timings, length, bits, value);
+    }
+    
+    uint16_t used = decodeMarkSpaceFrame(d, timings, length, bits, value);
+    if (used == 0) {
+        return false;
+    }
+    if (!d.secondFrameMask) {
+        return used == length;
+    }
+    
+    // The second frame must be the first with the mask bits inverted
+    uint64_t second = 0;
+    if (used + 1 >= length || !matches(timings[used], d.secondFrameGap)) {
+        return false;
+    }
+    uint16_t secondUsed = decodeMarkSpaceFrame(d, timings + used + 1, length - used - 1, bits, &second);
+    return secondUsed == length - used - 1 && second == (*value ^ d.secondFrameMask);
+}
+
+IRProtocol identifyFrame(const uint16_t* timings, uint16_t length, uint64_t* value, uint16_t* bits) {
+    size_t count = 0;
+    const ProtocolDescriptor* descriptors = protocolDescriptors(&count);
+    
+    // Several protocols share near-identical headers (NEC, JVC, LG), so
+    // frames of a protocol's own bit count are preferred before any
+    // non-standard length is accepted
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t i = 0; i < count; i++) {
+            const ProtocolDescriptor& d = descriptors[i];
+            uint16_t frameBits = d.defaultBits;
+            
+            if (d.coding != BitCoding::BIPHASE) {
+                int32_t frameLength = d.secondFrameMask ? (length - 1) / 2 : length;
+                int32_t body = frameLength - (d.headerMark ? 2 : 0) - (d.footerMark ? 1 : -1);
+                if (body <= 0 || body % 2 != 0) {
+                    continue;
+                }
+                frameBits = body / 2;
+            }
+            if ((pass == 0) != (frameBits == d.defaultBits)) {
+                continue;
+            }
+            
+            if (decodeFrame(d, timings, length, frameBits, value)) {
+                *bits = frameBits;
+                return d.protocol;
+            }
+        }
+    }
+    return IRProtocol::UNKNOWN;
+}
+
+}  // namespace frame_decoder
@@ -1,4 +1,5 @@
 #include "receiver/IRLibProtocolDecoder.h"
+#include "receiver/ProtocolInference.h"
 
 #ifndef NATIVE_BUILD
     #include <Arduino.h>
@@ -11,56 +12,34 @@ DecodedSignal IRLibProtocolDecoder::decode(decode_results* raw) {
     
     switch (raw->decode_type) {
         case NEC:
-            return decodeNEC(raw);
+            return decodeKnown(raw, IRProtocol::NEC);
         case SAMSUNG:
-            return decodeSamsung(raw);
+            return decodeKnown(raw, IRProtocol::SAMSUNG);
         case SONY:
-            return decodeSony(raw);
+            return decodeKnown(raw, IRProtocol::SONY);
+        case RC5:
+            return decodeKnown(raw, IRProtocol::RC5);
+        case RC6:
+            return decodeKnown(raw, IRProtocol::RC6);
+        case PANASONIC:
+            return decodeKnown(raw, IRProtocol::PANASONIC);
+        case JVC:
+            return decodeKnown(raw, IRProtocol::JVC);
+        case LG:
+            return decodeKnown(raw, IRProtocol::LG);
+        case SHARP:
+            return decodeKnown(raw, IRProtocol::SHARP);
         default:
             return decodeRaw(raw);
     }
 }
 
-DecodedSignal IRLibProtocolDecoder::decodeNEC(decode_results* raw) {
+DecodedSignal IRLibProtocolDecoder::decodeKnown(decode_results* raw, IRProtocol protocol) {
     DecodedSignal signal = {};  // Zero-initialize
-    signal.protocol = "NEC";
+    signal.protocol = protocolName(protocol);
     signal.isKnownProtocol = true;
     signal.value = raw->value;
     signal.bits = raw->bits;
-    signal.rawTimings = nullptr;
-    signal.rawLength = 0;
-    
-    // Use the library's already-extracted address and command
-    signal.address = raw->address;
-    signal.command = raw->command;
-    
-    return signal;
-}
-
-DecodedSignal IRLibProtocolDecoder::decodeSamsung(decode_results* raw) {
-    DecodedSignal signal = {};  // Zero-initialize
-    signal.protocol = "SAMSUNG";
-    signal.isKnownProtocol = true;
-    signal.value = raw->value;
-    signal.bits = raw->bits;
-    signal.rawTimings = nullptr;
-    signal.rawLength = 0;
-    
-    // Use the library's already-extracted address and command
-    signal.address = raw->address;
-    signal.command = raw->command;
-    
-    return signal;
-}
-
-DecodedSignal IRLibProtocolDecoder::decodeSony(decode_results* raw) {
-    DecodedSignal signal = {};  // Zero-initialize
-    signal.protocol = "SONY";
-    signal.isKnownProtocol = true;
-    signal.value = raw->value;
-    signal.bits = raw->bits;
-    signal.rawTimings = nullptr;
-    signal.rawLength = 0;
     
     // Use the library's already-extracted address and command
     signal.address = raw->address;
@@ -79,18 +58,32 @@ DecodedSignal IRLibProtocolDecoder::decodeRaw(decode_results* raw) {
     signal.command = 0;
     
     if (raw && raw->rawbuf && raw->rawlen > 0) {
-        // Allocate memory for raw timing data
-        signal.rawLength = raw->rawlen;
-        signal.rawTimings = new uint16_t[raw->rawlen];
-        
-        // Copy raw timing data
-        for (size_t i = 0; i < raw->rawlen; i++) {
-            signal.rawTimings[i] = raw->rawbuf[i];
-        }
-    } else {
-        signal.rawTimings = nullptr;
-        signal.rawLength = 0;
+        // rawbuf belongs to the capture and is reused on resume(): copy it
+        signal.rawTimings = pool->acquire(raw->rawbuf, raw->rawlen);
+        inferCoding(raw, &signal);
     }
     
     return signal;
 }
+
+void IRLibProtocolDecoder::inferCoding(decode_results* raw, DecodedSignal* signal) {
+    // Most unknown remotes are a standard coding with their own timings;
+    // only frames short enough to be one are looked at
+    const uint16_t length = raw->rawlen - 1;
+    if (length > protocol_inference::kMaxTimings) {
+        return;
+    }
+    uint16_t timings[protocol_inference::kMaxTimings];
+    for (uint16_t i = 0; i < length; i++) {
+        uint32_t us = (uint32_t)raw->rawbuf[i + 1] * kRawTick;
+        timings[i] = us > 0xFFFF ? 0xFFFF : (uint16_t)us;
+    }
+    
+    protocol_inference::InferredCode code;
+    if (protocol_inference::inferCode(timings, length, &code)) {
+        signal->isInferred = true;
+        signal->inferred = code.descriptor;
+        signal->value = code.value;
+        signal->bits = code.bits;
+    }
+}
@@ -1,18 +1,67 @@
 #include "receiver/LearningStateMachine.h"
-#include <Arduino.h>
+
+#ifndef NATIVE_BUILD
+    #include <Arduino.h>
+#endif
 
 LearningStateMachine::LearningStateMachine(
     ISignalCapture* signalCapture,
     IProtocolDecoder* decoder,
-    uint32_t timeoutMs
+    uint32_t timeoutMs,
+    uint8_t framesToCollect,
+    uint32_t collectWindowMs
 ) : signalCapture(signalCapture),
     decoder(decoder),
     currentState(LearningState::IDLE),
     timeoutMs(timeoutMs),
     learningStartTime(0),
+    framesToCollect(framesToCollect == 0 ? 1
+                    : framesToCollect > SignalConsensus::kMaxFrames ? SignalConsensus::kMaxFrames
+                    : framesToCollect),
+    collectWindowMs(collectWindowMs),
+    firstFrameTime(0),
+    eventDriven(false),
+    captureReady(false),
+    wakeHook(nullptr),
+    wakeContext(nullptr),
     stateChangeCallback(nullptr),
     signalCaptureCallback(nullptr)
 {
+    eventDriven = signalCapture->setReadyHook(onCaptureReady, this);
+}
+
+void LearningStateMachine::onCaptureReady(void* context) {
+    LearningStateMachine* self = static_cast<LearningStateMachine*>(context);
+    self->captureReady.store(true, std::memory_order_release);
+    if (self->wakeHook) {
+        self->wakeHook(self->wakeContext);
+    }
+}
+
+void LearningStateMachine::setWakeHook(CaptureReadyHook hook, void* context) {
+    wakeContext = context;
+    wakeHook = hook;
+}
+
+uint32_t LearningStateMachine::msUntilDue(unsigned long now) const {
+    if (currentState != LearningState::LEARNING) {
+        return kNoDeadline;
+    }
+    if (captureReady.load(std::memory_order_acquire)) {
+        return 0;
+    }
+    
+    // The timeout before the first frame, the collect window after it
+    const uint8_t frames = consensus.getFrameCount();
+    const unsigned long elapsed = now - (frames == 0 ? learningStartTime : firstFrameTime);
+    const uint32_t limit = frames == 0 ? timeoutMs : collectWindowMs;
+    uint32_t wait = elapsed > limit ? 0 : limit - elapsed + 1;
+    
+    const uint32_t poll = eventDriven ? signalCapture->pollIntervalMs() : kPollIntervalMs;
+    if (poll > 0 && poll < wait) {
+        wait = poll;
+    }
+    return wait;
 }
 
 void LearningStateMachine::startLearning() {
@@ -21,6 +70,8 @@ void LearningStateMachine::startLearning() {
     }
     
     learningStartTime = millis();
+    consensus.reset();
+    captureReady.store(false, std::memory_order_relaxed);
     signalCapture->resume();
     setState(LearningState::LEARNING);
 }
@@ -48,30 +99,49 @@ void LearningStateMachine::setState(LearningState newState) {
 }
 
 void LearningStateMachine::handleLearningState() {
+    const unsigned long now = millis();
+    
+    // Each capture is copied into the consensus, then the receiver is
+    // resumed straight away for the next press or repeat frame. An
+    // event-driven backend is only read once it said a frame may be in.
+    bool ready = captureReady.exchange(false, std::memory_order_acq_rel);
+    if (!eventDriven || ready || signalCapture->pollIntervalMs() > 0) {
+        decode_results results;
+        if (signalCapture->decode(&results)) {
+            if (consensus.add(results) && consensus.getFrameCount() == 1) {
+                firstFrameTime = now;
+            }
+            signalCapture->resume();
+        }
+    }
+    
+    uint8_t frames = consensus.getFrameCount();
+    if (frames >= framesToCollect || (frames > 0 && now - firstFrameTime > collectWindowMs)) {
+        finishCapture();
+        return;
+    }
+    
     // Check for timeout
-    if (millis() - learningStartTime > timeoutMs) {
+    if (frames == 0 && now - learningStartTime > timeoutMs) {
         setState(LearningState::TIMEOUT);
         setState(LearningState::IDLE); // Auto-return to idle after timeout
-        return;
     }
+}
+
+void LearningStateMachine::finishCapture() {
+    decode_results merged;
+    uint8_t confidence = consensus.build(&merged, framesToCollect);
+    DecodedSignal signal = decoder->decode(&merged);
+    signal.confidence = confidence;
+    consensus.reset();
     
-    // Check for signal
-    decode_results results;
-    if (signalCapture->decode(&results)) {
-        // Signal captured! Decode it
-        DecodedSignal signal = decoder->decode(&results);
-        
-        setState(LearningState::CAPTURED);
-        
-        // Notify callback
-        if (signalCaptureCallback) {
-            signalCaptureCallback(signal);
-        }
-        
-        // Resume receiver for next capture
-        signalCapture->resume();
-        
-        // Return to idle
-        setState(LearningState::IDLE);
+    setState(LearningState::CAPTURED);
+    
+    // Notify callback
+    if (signalCaptureCallback) {
+        signalCaptureCallback(signal);
     }
+    
+    // Return to idle
+    setState(LearningState::IDLE);
 }
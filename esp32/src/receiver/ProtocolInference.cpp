@@ -0,0 +1,343 @@
+#include "receiver/ProtocolInference.h"
+#include "receiver/FrameDecoder.h"
+#include "transmitter/FrameEncoder.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace protocol_inference {
+
+namespace {
+
+const uint8_t kMaxClusters = 4;
+const uint8_t kMaxUnits = 4;                       // Longest bi-phase run, in half-bit units
+const uint16_t kMaxSlots = kMaxTimings * kMaxUnits;
+
+bool matches(uint32_t measured, uint32_t expected) {
+    uint32_t tolerance = expected * frame_decoder::kTolerancePercent / 100 + frame_decoder::kToleranceUs;
+    uint32_t difference = measured > expected ? measured - expected : expected - measured;
+    return difference <= tolerance;
+}
+
+struct Cluster {
+    uint32_t sum;
+    uint16_t count;
+    
+    uint16_t mean() const { return (uint16_t)((sum + count / 2) / count); }
+};
+
+// Groups timings[first], timings[first + step], ... below end by
+// duration, shortest first. Returns the cluster count, or capacity + 1
+// when there are more.
+uint8_t clusterDurations(const uint16_t* timings, uint16_t first, uint16_t end, uint16_t step,
+                         Cluster* clusters, uint8_t capacity) {
+    uint8_t count = 0;
+    for (uint16_t i = first; i < end; i += step) {
+        uint8_t c = 0;
+        while (c < count && !matches(timings[i], clusters[c].mean())) {
+            c++;
+        }
+        if (c == count) {
+            if (count == capacity) {
+                return capacity + 1;
+            }
+            clusters[count++] = Cluster{0, 0};
+        }
+        clusters[c].sum += timings[i];
+        clusters[c].count++;
+    }
+    
+    for (uint8_t i = 1; i < count; i++) {
+        Cluster key = clusters[i];
+        uint8_t j = i;
+        for (; j > 0 && clusters[j - 1].mean() > key.mean(); j--) {
+            clusters[j] = clusters[j - 1];
+        }
+        clusters[j] = key;
+    }
+    return count;
+}
+
+ProtocolDescriptor blankDescriptor(BitCoding coding) {
+    return ProtocolDescriptor{IRProtocol::UNKNOWN, "RAW", coding,
+                              0, 0,
+                              0, 0, 0, 0,
+                              0,
+                              0, false, 0, PROTOCOL_NO_BIT, PROTOCOL_NO_BIT,
+                              BitOrder::MSB_FIRST, 0, IR_DEFAULT_CARRIER_KHZ, IR_DEFAULT_DUTY_PERCENT,
+                              0, 0,
+                              0, 0,
+                              RepeatFrame::FULL, 0, 0};
+}
+
+// The first mark is a header when it is longer than, and unlike, every later one
+bool hasHeader(const uint16_t* timings, uint16_t length) {
+    uint16_t longest = 0;
+    for (uint16_t i = 2; i < length; i += 2) {
+        longest = timings[i] > longest ? timings[i] : longest;
+    }
+    return longest > 0 && timings[0] > longest && !matches(timings[0], longest);
+}
+
+// The generic encoder must give back the capture
+bool reproduces(const InferredCode& code, const uint16_t* timings, uint16_t length) {
+    uint16_t frame[kMaxTimings];
+    if (frame_encoder::encodeFrame(code.descriptor, code.value, code.bits, TimingSpan(frame, kMaxTimings)) != length) {
+        return false;
+    }
+    for (uint16_t i = 0; i < length; i++) {
+        if (!matches(timings[i], frame[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool nearer(uint16_t duration, uint16_t a, uint16_t b) {
+    uint16_t toA = duration > a ? duration - a : a - duration;
+    uint16_t toB = duration > b ? duration - b : b - duration;
+    return toA < toB;
+}
+
+// Pulse-distance frames end in a footer mark and keep every bit's space;
+// pulse-width frames end on the last bit's mark
+bool inferMarkSpace(const uint16_t* timings, uint16_t length, bool header, BitCoding coding,
+                    InferredCode* code) {
+    const bool distance = coding == BitCoding::PULSE_DISTANCE;
+    const uint16_t first = header ? 2 : 0;
+    const uint16_t bits = distance ? (length - first - 1) / 2 : (length - first + 1) / 2;
+    if (bits < kMinBits || bits > kMaxBits) {
+        return false;
+    }
+    
+    Cluster marks[2];
+    Cluster spaces[2];
+    uint8_t markCount = clusterDurations(timings, first, distance ? length - 1 : length, 2, marks, 2);
+    uint8_t spaceCount = clusterDurations(timings, first + 1, length - 1, 2, spaces, 2);
+    if (markCount != (distance ? 1 : 2) || spaceCount != (distance ? 2 : 1)) {
+        return false;
+    }
+    
+    ProtocolDescriptor d = blankDescriptor(coding);
+    if (header) {
+        d.headerMark = timings[0];
+        d.headerSpace = timings[1];
+    }
+    d.zeroMark = marks[0].mean();
+    d.oneMark = marks[markCount - 1].mean();
+    d.zeroSpace = spaces[0].mean();
+    d.oneSpace = spaces[spaceCount - 1].mean();
+    if (distance) {
+        const uint16_t footer = timings[length - 1];
+        d.footerMark = matches(footer, d.oneMark) ? d.oneMark : footer;
+    }
+    
+    // The long mark or space is a one
+    uint64_t value = 0;
+    for (uint16_t i = 0; i < bits; i++) {
+        const uint16_t timing = timings[first + i * 2 + (distance ? 1 : 0)];
+        const bool one = distance ? nearer(timing, d.oneSpace, d.zeroSpace) : nearer(timing, d.oneMark, d.zeroMark);
+        value = (value << 1) | (one ? 1 : 0);
+    }
+    
+    d.defaultBits = bits;
+    code->descriptor = d;
+    code->value = value;
+    code->bits = bits;
+    return true;
+}
+
+// Reads half-bit levels (true = mark) in pairs. leadingSpace puts back
+// the idle space half the encoder drops before the first mark; a
+// missing half after the last one is the idle space after it.
+bool readBiphaseBits(const bool* slots, uint16_t slotCount, bool leadingSpace, ProtocolDescriptor* d,
+                     uint64_t* value, uint16_t* bits) {
+    const uint16_t total = slotCount + (leadingSpace ? 1 : 0);
+    auto level = [&](uint16_t i) {
+        if (i >= total) {
+            return false;
+        }
+        return leadingSpace ? (i > 0 && slots[i - 1]) : slots[i];
+    };
+    
+    *value = 0;
+    *bits = 0;
+    d->doubleWidthBit = PROTOCOL_NO_BIT;
+    uint16_t p = 0;
+    while (p < total) {
+        const bool firstHalf = level(p);
+        if (level(p + 1) != firstHalf) {
+            p += 2;
+        } else if (p + 2 < total && level(p + 2) != firstHalf && level(p + 3) != firstHalf &&
+                   d->doubleWidthBit == PROTOCOL_NO_BIT) {
+            d->doubleWidthBit = *bits;
+            p += 4;
+        } else {
+            return false;
+        }
+        
+        // The first bit reads as a one, like every protocol's start bit
+        if (*bits == 0) {
+            d->oneMarkFirst = firstHalf;
+        }
+        if (*bits == kMaxBits) {
+            return false;
+        }
+        *value = (*value << 1) | (firstHalf == d->oneMarkFirst ? 1 : 0);
+        (*bits)++;
+    }
+    return *bits >= kMinBits;
+}
+
+bool inferBiphase(const uint16_t* timings, uint16_t length, bool header, InferredCode* code) {
+    const uint16_t first = header ? 2 : 0;
+    Cluster marks[kMaxClusters];
+    Cluster spaces[kMaxClusters];
+    uint8_t markCount = clusterDurations(timings, first, length, 2, marks, kMaxClusters);
+    uint8_t spaceCount = clusterDurations(timings, first + 1, length, 2, spaces, kMaxClusters);
+    if (markCount == 0 || markCount > kMaxClusters || spaceCount == 0 || spaceCount > kMaxClusters) {
+        return false;
+    }
+    
+    // The shortest mark and space are one unit each; receivers stretch
+    // marks and shorten spaces by about the same skew
+    const uint32_t unit = (marks[0].mean() + spaces[0].mean()) / 2;
+    const int32_t skew = (int32_t)marks[0].mean() - (int32_t)unit;
+    if (unit == 0 || (uint32_t)(skew < 0 ? -skew : skew) > unit / 2) {
+        return false;
+    }
+    
+    // Every duration a whole number of units
+    bool slots[kMaxSlots];
+    uint16_t slotCount = 0;
+    for (uint16_t i = first; i < length; i++) {
+        const bool mark = (i - first) % 2 == 0;
+        const int32_t unskewed = (int32_t)timings[i] + (mark ? -skew : skew);
+        const uint32_t units = unskewed > 0 ? (unskewed + unit / 2) / unit : 0;
+        if (units == 0 || units > kMaxUnits || !matches(unskewed, units * unit)) {
+            return false;
+        }
+        for (uint32_t u = 0; u < units; u++) {
+            slots[slotCount++] = mark;
+        }
+    }
+    
+    ProtocolDescriptor d = blankDescriptor(BitCoding::BIPHASE);
+    if (header) {
+        d.headerMark = timings[0];
+        d.headerSpace = timings[1];
+    }
+    d.biphaseUnit = unit;
+    
+    // Without a header the frame may have started with an idle space half
+    for (int leading = 0; leading <= (header ? 0 : 1); leading++) {
+        if (readBiphaseBits(slots, slotCount, leading == 1, &d, &code->value, &code->bits)) {
+            d.defaultBits = code->bits;
+            code->descriptor = d;
+            if (reproduces(*code, timings, length)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+bool inferCode(const uint16_t* timings, uint16_t length, InferredCode* code) {
+    if (!timings || !code) {
+        return false;
+    }
+    if (length % 2 == 0 && length > 0) {
+        length--;  // Ends on a space: the gap after the frame
+    }
+    if (length < kMinBits || length > kMaxTimings) {
+        return false;
+    }
+    
+    const bool header = hasHeader(timings, length);
+    if (inferMarkSpace(timings, length, header, BitCoding::PULSE_DISTANCE, code) &&
+        reproduces(*code, timings, length)) {
+        return true;
+    }
+    if (inferMarkSpace(timings, length, header, BitCoding::PULSE_WIDTH, code) &&
+        reproduces(*code, timings, length)) {
+        return true;
+    }
+    return inferBiphase(timings, length, header, code);
+}
+
+size_t formatParams(const ProtocolDescriptor& d, char* out, size_t capacity) {
+    int written;
+    if (d.coding == BitCoding::BIPHASE) {
+        written = d.doubleWidthBit == PROTOCOL_NO_BIT
+            ? snprintf(out, capacity, "BP %u %u %u %u", d.headerMark, d.headerSpace, d.biphaseUnit,
+                       d.oneMarkFirst ? 1u : 0u)
+            : snprintf(out, capacity, "BP %u %u %u %u %u", d.headerMark, d.headerSpace, d.biphaseUnit,
+                       d.oneMarkFirst ? 1u : 0u, (unsigned)d.doubleWidthBit);
+    } else {
+        written = snprintf(out, capacity, "%s %u %u %u %u %u %u %u",
+                           d.coding == BitCoding::PULSE_DISTANCE ? "PD" : "PW", d.headerMark, d.headerSpace,
+                           d.oneMark, d.oneSpace, d.zeroMark, d.zeroSpace, d.footerMark);
+    }
+    return written > 0 && (size_t)written < capacity ? written : 0;
+}
+
+bool parseParams(const char* text, ProtocolDescriptor* descriptor) {
+    if (!text || !descriptor) {
+        return false;
+    }
+    
+    BitCoding coding;
+    if (strncmp(text, "PD ", 3) == 0) {
+        coding = BitCoding::PULSE_DISTANCE;
+    } else if (strncmp(text, "PW ", 3) == 0) {
+        coding = BitCoding::PULSE_WIDTH;
+    } else if (strncmp(text, "BP ", 3) == 0) {
+        coding = BitCoding::BIPHASE;
+    } else {
+        return false;
+    }
+    
+    uint32_t fields[7];
+    uint8_t count = 0;
+    const char* p = text + 2;
+    while (*p) {
+        char* end = nullptr;
+        unsigned long field = strtoul(p, &end, 10);
+        if (end == p || (*end && *end != ' ') || field > 0xFFFF || count == 7) {
+            return false;
+        }
+        fields[count++] = field;
+        p = end;
+    }
+    
+    ProtocolDescriptor d = blankDescriptor(coding);
+    d.headerMark = count > 0 ? fields[0] : 0;
+    d.headerSpace = count > 1 ? fields[1] : 0;
+    if (d.headerMark && !d.headerSpace) {
+        return false;
+    }
+    if (coding == BitCoding::BIPHASE) {
+        if ((count != 4 && count != 5) || fields[2] == 0 || fields[3] > 1 || (count == 5 && fields[4] >= kMaxBits)) {
+            return false;
+        }
+        d.biphaseUnit = fields[2];
+        d.oneMarkFirst = fields[3] == 1;
+        d.doubleWidthBit = count == 5 ? fields[4] : PROTOCOL_NO_BIT;
+    } else {
+        if (count != 7 || !fields[2] || !fields[3] || !fields[4] || !fields[5]) {
+            return false;
+        }
+        d.oneMark = fields[2];
+        d.oneSpace = fields[3];
+        d.zeroMark = fields[4];
+        d.zeroSpace = fields[5];
+        d.footerMark = fields[6];
+    }
+    *descriptor = d;
+    return true;
+}
+
+}  // namespace protocol_inference
@@ -0,0 +1,109 @@
+#include "receiver/RawTimingPool.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#ifndef NATIVE_BUILD
+    #include <esp_heap_caps.h>
+#endif
+
+void RawTimings::reset() {
+    if (pool) {
+        pool->release(timings);
+    }
+    pool = nullptr;
+    timings = nullptr;
+    length = 0;
+}
+
+RawTimingPool::RawTimingPool(uint8_t blocks)
+    : capacity(blocks),
+      freeCount(0),
+      highWater(0),
+      failures(0),
+      slab(nullptr),
+      freeBlocks(nullptr)
+{
+}
+
+RawTimingPool::~RawTimingPool() {
+    free(freeBlocks);
+    free(slab);
+}
+
+bool RawTimingPool::begin() {
+    if (slab) {
+        return true;
+    }
+    
+    size_t slabBytes = (size_t)capacity * kBlockTimings * sizeof(uint16_t);
+
+#ifndef NATIVE_BUILD
+    // Captures are large and only read once, when uploaded: keep them in PSRAM
+    slab = (uint16_t*)heap_caps_malloc(slabBytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!slab) {
+        slab = (uint16_t*)malloc(slabBytes);
+    }
+#else
+    slab = (uint16_t*)malloc(slabBytes);
+#endif
+    freeBlocks = (uint8_t*)malloc(capacity);
+    
+    if (!slab || !freeBlocks) {
+        free(slab);
+        free(freeBlocks);
+        slab = nullptr;
+        freeBlocks = nullptr;
+        return false;
+    }
+    
+    // Lowest index on top, so a quiet system keeps reusing the same block
+    for (uint8_t i = 0; i < capacity; i++) {
+        freeBlocks[i] = capacity - 1 - i;
+    }
+    freeCount = capacity;
+    return true;
+}
+
+RawTimingPool& RawTimingPool::shared() {
+    static RawTimingPool pool;
+    return pool;
+}
+
+uint16_t* RawTimingPool::take(size_t length) {
+    if (length > kBlockTimings || !begin() || freeCount == 0) {
+        failures++;
+        return nullptr;
+    }
+    
+    uint16_t* block = slab + (size_t)freeBlocks[--freeCount] * kBlockTimings;
+    uint8_t inUse = capacity - freeCount;
+    if (inUse > highWater) {
+        highWater = inUse;
+    }
+    return block;
+}
+
+RawTimings RawTimingPool::acquire(const uint16_t* timings, size_t length) {
+    uint16_t* block = timings && length > 0 ? take(length) : nullptr;
+    if (!block) {
+        return RawTimings();
+    }
+    memcpy(block, timings, length * sizeof(uint16_t));
+    return RawTimings(this, block, length);
+}
+
+RawTimings RawTimingPool::acquire(const volatile uint16_t* timings, size_t length) {
+    uint16_t* block = timings && length > 0 ? take(length) : nullptr;
+    if (!block) {
+        return RawTimings();
+    }
+    for (size_t i = 0; i < length; i++) {
+        block[i] = timings[i];
+    }
+    return RawTimings(this, block, length);
+}
+
+void RawTimingPool::release(uint16_t* timings) {
+    freeBlocks[freeCount++] = (uint8_t)((timings - slab) / kBlockTimings);
+}
@@ -0,0 +1,126 @@
+#include "receiver/RmtSignalCapture.h"
+#include "receiver/FrameDecoder.h"
+
+RmtSignalCapture::RmtSignalCapture(IRmtReceiver* receiver, uint16_t idleThresholdUs, bool activeLow)
+    : receiver(receiver),
+      idleThresholdUs(idleThresholdUs),
+      activeLow(activeLow),
+      begun(false),
+      enabled(false),
+      held(false),
+      timingCount(0),
+      frames(0),
+      noise(0),
+      overflows(0) {
+}
+
+void RmtSignalCapture::enable() {
+    if (!begun) {
+        begun = receiver->begin(idleThresholdUs);
+    }
+    enabled = begun && receiver->start();
+    held = false;
+}
+
+void RmtSignalCapture::disable() {
+    receiver->stop();
+    enabled = false;
+    held = false;
+}
+
+void RmtSignalCapture::resume() {
+    held = false;
+}
+
+bool RmtSignalCapture::setReadyHook(CaptureReadyHook hook, void* context) {
+    return receiver->setFrameHook(hook, context);
+}
+
+bool RmtSignalCapture::hasSignal() {
+    return held || (enabled && fetch());
+}
+
+bool RmtSignalCapture::fetch() {
+    size_t count;
+    while ((count = receiver->receive(symbols, kMaxSymbols)) > 0) {
+        if (count > kMaxSymbols) {
+            overflows++;
+            continue;
+        }
+        timingCount = toTimings(count);
+        if (timingCount < kMinTimings) {
+            noise++;
+            continue;
+        }
+        frames++;
+        held = true;
+        return true;
+    }
+    return false;
+}
+
+uint16_t RmtSignalCapture::toTimings(size_t symbolCount) {
+    const uint8_t markLevel = activeLow ? 0 : 1;
+    uint16_t count = 0;
+    int lastMark = -1;
+    uint32_t accumulated = 0;
+    
+    // A zero-length half is the driver's end-of-frame marker. Halves at
+    // the same level (a long pulse split over symbols) are merged, and
+    // leading idle is skipped so the buffer starts with a mark.
+    for (size_t i = 0; i < symbolCount; i++) {
+        const uint32_t durations[2] = {symbols[i].duration0, symbols[i].duration1};
+        const uint8_t levels[2] = {(uint8_t)symbols[i].level0, (uint8_t)symbols[i].level1};
+        for (int h = 0; h < 2; h++) {
+            if (durations[h] == 0) {
+                i = symbolCount;
+                break;
+            }
+            int mark = levels[h] == markLevel ? 1 : 0;
+            if (lastMark < 0 && !mark) {
+                continue;
+            }
+            if (mark == lastMark) {
+                accumulated += durations[h];
+                continue;
+            }
+            if (lastMark >= 0 && count < kMaxTimings) {
+                timings[count++] = accumulated > 0xFFFF ? 0xFFFF : (uint16_t)accumulated;
+            }
+            lastMark = mark;
+            accumulated = durations[h];
+        }
+    }
+    
+    // The trailing space is idle time, not part of the frame
+    if (lastMark == 1 && count < kMaxTimings) {
+        timings[count++] = accumulated > 0xFFFF ? 0xFFFF : (uint16_t)accumulated;
+    }
+    return count;
+}
+
+bool RmtSignalCapture::decode(decode_results* results) {
+    if (!results || !hasSignal()) {
+        return false;
+    }
+    
+    uint64_t value = 0;
+    uint16_t bits = 0;
+    IRProtocol protocol = frame_decoder::identifyFrame(timings, timingCount, &value, &bits);
+    
+    results->decode_type = decodeTypeFor(protocol);
+    results->value = protocol == IRProtocol::UNKNOWN ? 0 : value;
+    results->bits = protocol == IRProtocol::UNKNOWN ? 0 : bits;
+    results->address = 0;
+    results->command = 0;
+    results->repeat = false;
+    
+    // IRrecv layout: the gap before the frame, then every duration
+    rawbuf[0] = idleThresholdUs / kRawTick;
+    for (uint16_t i = 0; i < timingCount; i++) {
+        rawbuf[i + 1] = (timings[i] + kRawTick / 2) / kRawTick;
+    }
+    results->rawbuf = rawbuf;
+    results->rawlen = timingCount + 1;
+    return true;
+}
@@ -0,0 +1,218 @@
+#include "receiver/SignalConsensus.h"
+#include <algorithm>
+
+SignalConsensus::SignalConsensus() : count(0) {
+}
+
+void SignalConsensus::reset() {
+    count = 0;
+}
+
+bool SignalConsensus::add(const decode_results& frame) {
+    if (count >= kMaxFrames || frame.repeat || !frame.rawbuf || frame.rawlen < 2 || frame.rawlen > kMaxTimings) {
+        return false;
+    }
+    
+    Frame& stored = frames[count];
+    stored.decodeType = frame.decode_type;
+    stored.value = frame.value;
+    stored.bits = frame.bits;
+    stored.address = frame.address;
+    stored.command = frame.command;
+    stored.length = frame.rawlen;
+    for (uint16_t i = 0; i < stored.length; i++) {
+        timings[count][i] = frame.rawbuf[i];
+    }
+    count++;
+    return true;
+}
+
+bool SignalConsensus::sameKey(const Frame& a, const Frame& b) const {
+    return a.decodeType == b.decodeType && a.value == b.value && a.bits == b.bits;
+}
+
+bool SignalConsensus::aligned(uint8_t a, uint8_t b) const {
+    if (frames[a].length != frames[b].length) {
+        return false;
+    }
+    
+    // Slot 0 is the gap before the frame: idle time, not compared
+    for (uint16_t i = 1; i < frames[a].length; i++) {
+        uint32_t x = timings[a][i];
+        uint32_t y = timings[b][i];
+        uint32_t difference = x > y ? x - y : y - x;
+        if (difference * 100 > (x > y ? x : y) * kTolerancePercent) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int8_t SignalConsensus::majority(uint8_t* votes) const {
+    int8_t winner = -1;
+    *votes = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (frames[i].decodeType <= 0) {
+            continue;  // UNKNOWN or UNUSED: nothing to vote for
+        }
+        uint8_t n = 0;
+        for (uint8_t j = 0; j < count; j++) {
+            n += sameKey(frames[i], frames[j]) ? 1 : 0;
+        }
+        if (n > *votes) {
+            *votes = n;
+            winner = i;
+        }
+    }
+    return winner;
+}
+
+uint8_t SignalConsensus::largestGroup(uint8_t candidates, uint8_t* members) const {
+    uint8_t best = 0;
+    *members = 0;
+    for (uint8_t r = 0; r < count; r++) {
+        if (!(candidates & (1 << r))) {
+            continue;
+        }
+        uint8_t group = 0;
+        uint8_t size = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            if ((candidates & (1 << i)) && aligned(r, i)) {
+                group |= 1 << i;
+                size++;
+            }
+        }
+        if (size > best) {
+            best = size;
+            *members = group;
+        }
+    }
+    return best;
+}
+
+uint32_t SignalConsensus::medianOf(uint8_t members, uint8_t memberCount) {
+    uint8_t index[kMaxFrames] = {};
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (members & (1 << i)) {
+            index[n++] = i;
+        }
+    }
+    merged[0] = 0;
+    if (n == 0) {
+        return 0;
+    }
+    
+    const uint16_t length = frames[index[0]].length;
+    uint64_t deviation = 0;
+    for (uint8_t k = 0; k < n; k++) {
+        merged[0] = std::max(merged[0], timings[index[k]][0]);
+    }
+    
+    for (uint16_t slot = 1; slot < length; slot++) {
+        // Insertion sort of at most kMaxFrames values
+        uint16_t values[kMaxFrames] = {};
+        for (uint8_t k = 0; k < n; k++) {
+            uint16_t v = timings[index[k]][slot];
+            uint8_t j = k;
+            for (; j > 0 && values[j - 1] > v; j--) {
+                values[j] = values[j - 1];
+            }
+            values[j] = v;
+        }
+        uint16_t median = n % 2 ? values[n / 2] : (uint16_t)((values[n / 2 - 1] + values[n / 2] + 1) / 2);
+        merged[slot] = median;
+        
+        for (uint8_t k = 0; k < n; k++) {
+            uint32_t difference = values[k] > median ? values[k] - median : median - values[k];
+            deviation += median ? difference * 100 / median : 0;
+        }
+    }
+    
+    const uint32_t samples = (uint32_t)(length - 1) * memberCount;
+    return samples ? (uint32_t)(deviation / samples) : 0;
+}
+
+void SignalConsensus::snapToGrid(uint16_t first, uint16_t length) {
+    uint16_t n = 0;
+    for (uint16_t slot = first; slot < length; slot += 2) {
+        order[n++] = slot;
+    }
+    const uint16_t* values = merged;
+    std::sort(order, order + n, [values](uint16_t a, uint16_t b) { return values[a] < values[b]; });
+    
+    // Walk the slots shortest first; a cluster ends where a duration is
+    // more than kGridPercent above the cluster's shortest
+    uint16_t start = 0;
+    while (start < n) {
+        const uint32_t limit = (uint32_t)merged[order[start]] * (100 + kGridPercent) / 100;
+        uint16_t end = start;
+        uint32_t sum = 0;
+        while (end < n && merged[order[end]] <= limit) {
+            sum += merged[order[end]];
+            end++;
+        }
+        const uint16_t mean = (uint16_t)((sum + (end - start) / 2) / (end - start));
+        for (uint16_t i = start; i < end; i++) {
+            merged[order[i]] = mean;
+        }
+        start = end;
+    }
+}
+
+uint8_t SignalConsensus::build(decode_results* result, uint8_t expectedFrames) {
+    result->decode_type = UNKNOWN;
+    result->value = 0;
+    result->bits = 0;
+    result->address = 0;
+    result->command = 0;
+    result->repeat = false;
+    result->rawbuf = merged;
+    result->rawlen = 0;
+    if (count == 0) {
+        return 0;
+    }
+    
+    const uint8_t expected = std::max(expectedFrames, count);
+    uint8_t votes = 0;
+    int8_t winner = majority(&votes);
+    bool known = winner >= 0 && votes * 2 > count;
+    
+    // Timings come from the frames that agree: the winner's voters, or
+    // any frames when nothing was decoded
+    uint8_t candidates = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!known || sameKey(frames[i], frames[winner])) {
+            candidates |= 1 << i;
+        }
+    }
+    uint8_t members = 0;
+    uint8_t memberCount = largestGroup(candidates, &members);
+    uint32_t deviation = medianOf(members, memberCount);
+    
+    uint16_t length = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (members & (1 << i)) {
+            length = frames[i].length;
+            break;
+        }
+    }
+    snapToGrid(1, length);  // Marks
+    snapToGrid(2, length);  // Spaces
+    result->rawlen = length;
+    
+    if (known) {
+        const Frame& frame = frames[winner];
+        result->decode_type = (decode_type_t)frame.decodeType;
+        result->value = frame.value;
+        result->bits = frame.bits;
+        result->address = frame.address;
+        result->command = frame.command;
+        return (uint8_t)(100 * votes / expected);
+    }
+    
+    if (deviation >= kTolerancePercent) {
+        return 0;
+    }
+    return (uint8_t)(100 * memberCount * (kTolerancePercent - deviation) / (expected * kTolerancePercent));
+}
@@ -0,0 +1,77 @@
+#include "receiver/SignalFingerprint.h"
+
+namespace signal_fingerprint {
+
+namespace {
+
+const uint32_t kFnvOffset = 2166136261u;
+const uint32_t kFnvPrime = 16777619u;
+
+// Kind bytes: protocol ids are below 0x80
+const uint8_t kInferredKind = 0x80;
+const uint8_t kRawKind = 0xFF;
+
+uint32_t feed(uint32_t hash, uint8_t byte) {
+    return (hash ^ byte) * kFnvPrime;
+}
+
+uint32_t feedCode(uint32_t hash, uint64_t value, uint16_t bits) {
+    hash = feed(hash, bits & 0xFF);
+    hash = feed(hash, bits >> 8);
+    for (uint8_t i = 0; i < 8; i++) {
+        hash = feed(hash, (value >> (i * 8)) & 0xFF);
+    }
+    return hash;
+}
+
+// Murmur3's finalizer; never 0 out
+uint32_t finish(uint32_t hash) {
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+    return hash ? hash : 1;
+}
+
+// 0 shorter, 1 similar, 2 longer (within 20% either way is similar)
+uint8_t compare(uint32_t previous, uint32_t duration) {
+    if (duration * 10 < previous * 8) {
+        return 0;
+    }
+    if (previous * 10 < duration * 8) {
+        return 2;
+    }
+    return 1;
+}
+
+}  // namespace
+
+uint32_t ofCode(IRProtocol protocol, uint64_t value, uint16_t bits) {
+    return finish(feedCode(feed(kFnvOffset, (uint8_t)protocol), value, bits));
+}
+
+uint32_t ofInferred(BitCoding coding, uint64_t value, uint16_t bits) {
+    return finish(feedCode(feed(kFnvOffset, kInferredKind | (uint8_t)coding), value, bits));
+}
+
+uint32_t ofTimings(const uint16_t* timings, size_t length) {
+    uint32_t hash = feed(kFnvOffset, kRawKind);
+    for (size_t i = 2; i < length; i++) {
+        hash = feed(hash, compare(timings[i - 2], timings[i]));
+    }
+    return finish(hash);
+}
+
+uint32_t of(const DecodedSignal& signal) {
+    if (signal.isKnownProtocol) {
+        return ofCode(protocolFromName(signal.protocol), signal.value, signal.bits);
+    }
+    if (signal.isInferred) {
+        return ofInferred(signal.inferred.coding, signal.value, signal.bits);
+    }
+    const size_t length = signal.rawTimings.size();
+    return length > 1 ? ofTimings(signal.rawTimings.data() + 1, length - 1) : ofTimings(nullptr, 0);
+}
+
+}  // namespace signal_fingerprint
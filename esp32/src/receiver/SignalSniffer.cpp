@@ -0,0 +1,105 @@
+#include "receiver/SignalSniffer.h"
+#include "receiver/SignalFingerprint.h"
+
+#ifndef NATIVE_BUILD
+    #include <Arduino.h>
+#endif
+
+SignalSniffer::SignalSniffer(ISignalCapture* capture, IProtocolDecoder* decoder, MicrosClock clock)
+    : capture(capture),
+      decoder(decoder),
+      clock(clock),
+      paused(false),
+      polling(false),
+      frames(0),
+      overruns(0),
+      maxDepth(0),
+      lastFrameUs(0),
+      maxFrameUs(0),
+      busyUs(0)
+{
+}
+
+bool SignalSniffer::poll() {
+    polling.store(true);
+    if (paused.load()) {
+        polling.store(false);
+        return false;
+    }
+    
+    const uint32_t start = clock();
+    decode_results results;
+    bool read = capture->decode(&results);
+    if (read) {
+        SniffedFrame frame;
+        {
+            // The pool block of a RAW signal goes back before the frame is queued
+            DecodedSignal signal = decoder->decode(&results);
+            frame.protocol = signal.protocol;
+            frame.value = signal.value;
+            frame.bits = signal.bits;
+            frame.repeat = results.repeat;
+            frame.fingerprint = signal_fingerprint::of(signal);
+            frame.atMs = millis();
+        }
+        capture->resume();
+        record(clock() - start, ring.push(frame));
+    }
+    polling.store(false);
+    return read;
+}
+
+void SignalSniffer::record(uint32_t us, bool queued) {
+    if (queued) {
+        frames.fetch_add(1, std::memory_order_relaxed);
+        uint32_t depth = ring.size();
+        if (depth > maxDepth.load(std::memory_order_relaxed)) {
+            maxDepth.store(depth, std::memory_order_relaxed);
+        }
+    } else {
+        overruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    lastFrameUs.store(us, std::memory_order_relaxed);
+    if (us > maxFrameUs.load(std::memory_order_relaxed)) {
+        maxFrameUs.store(us, std::memory_order_relaxed);
+    }
+    busyUs.fetch_add(us, std::memory_order_relaxed);
+}
+
+uint32_t SignalSniffer::msUntilDue() const {
+    // A partly received frame asks to be polled sooner
+    const uint32_t poll = capture->pollIntervalMs();
+    return poll > 0 && poll < kPollIntervalMs ? poll : kPollIntervalMs;
+}
+
+bool SignalSniffer::pop(SniffedFrame* frame) {
+    return ring.pop(frame);
+}
+
+void SignalSniffer::pause() {
+    paused.store(true);
+    while (polling.load()) {
+#ifndef NATIVE_BUILD
+        // Only on another core: the sniff task outranks loop() on its own
+        taskYIELD();
+#endif
+    }
+}
+
+void SignalSniffer::resume() {
+    paused.store(false);
+}
+
+SnifferStats SignalSniffer::getStats() const {
+    SnifferStats stats;
+    stats.frames = frames.load(std::memory_order_relaxed);
+    stats.overruns = overruns.load(std::memory_order_relaxed);
+    stats.depth = ring.size();
+    stats.maxDepth = maxDepth.load(std::memory_order_relaxed);
+    stats.lastFrameUs = lastFrameUs.load(std::memory_order_relaxed);
+    stats.maxFrameUs = maxFrameUs.load(std::memory_order_relaxed);
+    stats.busyUs = busyUs.load(std::memory_order_relaxed);
+    uint32_t decoded = stats.frames + stats.overruns;
+    stats.meanFrameUs = decoded ? (uint32_t)(stats.busyUs / decoded) : 0;
+    return stats;
+}
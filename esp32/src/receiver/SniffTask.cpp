@@ -0,0 +1,40 @@
+#include "receiver/SniffTask.h"
+#include <esp_timer.h>
+
+SniffTask::SniffTask(SignalSniffer* sniffer)
+    : sniffer(sniffer), handle(nullptr) {
+}
+
+bool SniffTask::begin(BaseType_t core, UBaseType_t priority) {
+    if (handle) {
+        return true;
+    }
+    return xTaskCreatePinnedToCore(run, "irSniff", kStackSize, this, priority, &handle, core) == pdPASS;
+}
+
+void IRAM_ATTR SniffTask::wakeFromIsr(BaseType_t* woken) {
+    if (handle) {
+        vTaskNotifyGiveFromISR(handle, woken);
+    }
+}
+
+void SniffTask::wake() {
+    if (handle) {
+        xTaskNotifyGive(handle);
+    }
+}
+
+void SniffTask::run(void* arg) {
+    SniffTask* self = static_cast<SniffTask*>(arg);
+    for (;;) {
+        // Straight on while frames keep coming (a held button's repeats)
+        if (self->sniffer->poll()) {
+            continue;
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(self->sniffer->msUntilDue()));
+    }
+}
+
+uint32_t SniffTask::clockMicros() {
+    return (uint32_t)esp_timer_get_time();
+}
@@ -0,0 +1,378 @@
+#include "receiver/StreamingDecoder.h"
+#include "receiver/FrameDecoder.h"
+
+namespace {
+
+const uint8_t kMaxBits = 64;
+
+bool matches(uint32_t measured, uint32_t expected) {
+    uint32_t tolerance = expected * frame_decoder::kTolerancePercent / 100 + frame_decoder::kToleranceUs;
+    uint32_t difference = measured > expected ? measured - expected : expected - measured;
+    return difference <= tolerance;
+}
+
+// Longest duration that still matches expected
+uint32_t upper(uint32_t expected) {
+    return expected + expected * frame_decoder::kTolerancePercent / 100 + frame_decoder::kToleranceUs;
+}
+
+uint32_t longest(uint32_t a, uint32_t b) {
+    return a > b ? a : b;
+}
+
+uint16_t biphaseSlots(const ProtocolDescriptor& d) {
+    return (d.prefixBits + d.defaultBits) * 2 + (d.doubleWidthBit < d.defaultBits ? 2 : 0);
+}
+
+}  // namespace
+
+StreamingDecoder::StreamingDecoder() : matcherCount(0), edges(0), done(false) {
+    size_t count = 0;
+    const ProtocolDescriptor* descriptors = protocolDescriptors(&count);
+    for (size_t i = 0; i < count && matcherCount < kMaxProtocols; i++) {
+        matchers[matcherCount++].descriptor = &descriptors[i];
+    }
+    reset();
+}
+
+void StreamingDecoder::reset() {
+    for (uint8_t i = 0; i < matcherCount; i++) {
+        Matcher& m = matchers[i];
+        m.phase = Phase::HEADER_MARK;
+        m.secondFrame = false;
+        m.repeat = false;
+        m.markOne = false;
+        m.markZero = false;
+        m.markFooter = false;
+        m.bitCount = 0;
+        m.slots = 0;
+        m.slotCount = 0;
+        m.slotsSeen = 0;
+        m.value = 0;
+        m.firstValue = 0;
+    }
+    edges = 0;
+    done = false;
+    result = StreamResult{IRProtocol::UNKNOWN, 0, 0, false};
+}
+
+uint8_t StreamingDecoder::getLiveCount() const {
+    uint8_t live = 0;
+    for (uint8_t i = 0; i < matcherCount; i++) {
+        live += matchers[i].phase != Phase::REJECTED ? 1 : 0;
+    }
+    return live;
+}
+
+bool StreamingDecoder::push(uint32_t durationUs) {
+    if (done) {
+        return false;  // Settled until reset()
+    }
+    
+    const bool mark = edges % 2 == 0;
+    edges++;
+    for (uint8_t i = 0; i < matcherCount; i++) {
+        Matcher& m = matchers[i];
+        if (m.phase == Phase::REJECTED) {
+            continue;
+        }
+        if (!mark && durationUs > spaceLimit(m)) {
+            finish(m);  // Too long for this protocol: its frame is over
+        } else if (m.phase == Phase::COMPLETE) {
+            m.phase = Phase::REJECTED;  // The frame goes on past its end
+        } else if (m.descriptor->coding == BitCoding::BIPHASE) {
+            stepBiphase(m, durationUs, mark);
+        } else {
+            stepMarkSpace(m, durationUs, mark);
+        }
+    }
+    return settle();
+}
+
+bool StreamingDecoder::idle(uint32_t silentUs) {
+    if (done || edges % 2 == 0) {
+        return false;  // Nothing pushed, or the last duration was a space
+    }
+    for (uint8_t i = 0; i < matcherCount; i++) {
+        Matcher& m = matchers[i];
+        if (m.phase != Phase::REJECTED && m.phase != Phase::COMPLETE && silentUs > spaceLimit(m)) {
+            finish(m);
+        }
+    }
+    return settle();
+}
+
+void StreamingDecoder::pushBit(Matcher& m, bool one) {
+    // MSB-first values shift in, so the bit count need not be known yet
+    if (m.descriptor->bitOrder == BitOrder::MSB_FIRST) {
+        m.value = (m.value << 1) | (one ? 1 : 0);
+    } else if (one) {
+        m.value |= 1ULL << m.bitCount;
+    }
+    m.bitCount++;
+}
+
+void StreamingDecoder::frameDone(Matcher& m) {
+    const ProtocolDescriptor& d = *m.descriptor;
+    if (d.secondFrameMask && !m.secondFrame) {
+        m.phase = Phase::SECOND_GAP;
+        return;
+    }
+    if (d.secondFrameMask) {
+        // The copy must be the first frame with the mask bits inverted
+        if (m.value != (m.firstValue ^ d.secondFrameMask)) {
+            m.phase = Phase::REJECTED;
+            return;
+        }
+        m.value = m.firstValue;
+    }
+    m.phase = Phase::COMPLETE;
+}
+
+void StreamingDecoder::stepMarkSpace(Matcher& m, uint32_t duration, bool mark) {
+    const ProtocolDescriptor& d = *m.descriptor;
+    switch (m.phase) {
+        case Phase::HEADER_MARK:
+            if (d.headerMark) {
+                m.phase = matches(duration, d.headerMark) ? Phase::HEADER_SPACE : Phase::REJECTED;
+                return;
+            }
+            m.phase = Phase::BIT_MARK;  // Headerless: this is the first bit's mark
+            stepMarkSpace(m, duration, mark);
+            return;
+        
+        case Phase::HEADER_SPACE:
+            if (matches(duration, d.headerSpace)) {
+                m.phase = Phase::BIT_MARK;
+            } else if (d.repeatFrame == RepeatFrame::CODE && matches(duration, d.repeatSpace)) {
+                m.phase = Phase::REPEAT_MARK;
+            } else {
+                m.phase = Phase::REJECTED;
+            }
+            return;
+        
+        case Phase::REPEAT_MARK:
+            m.repeat = matches(duration, d.footerMark ? d.footerMark : d.oneMark);
+            m.phase = m.repeat ? Phase::COMPLETE : Phase::REJECTED;
+            return;
+        
+        case Phase::BIT_MARK:
+            m.markOne = matches(duration, d.oneMark);
+            m.markZero = matches(duration, d.zeroMark);
+            m.markFooter = d.footerMark && matches(duration, d.footerMark);
+            
+            // At the protocol's own bit count the footer ends the frame
+            // now, without waiting for the gap
+            if (d.footerMark && m.bitCount == d.defaultBits) {
+                if (m.markFooter) {
+                    frameDone(m);
+                } else {
+                    m.phase = Phase::REJECTED;
+                }
+                return;
+            }
+            m.phase = m.markOne || m.markZero || m.markFooter ? Phase::BIT_SPACE : Phase::REJECTED;
+            return;
+        
+        case Phase::BIT_SPACE: {
+            bool one = m.markOne && matches(duration, d.oneSpace);
+            bool zero = m.markZero && matches(duration, d.zeroSpace);
+            if (one == zero || m.bitCount >= kMaxBits) {
+                m.phase = Phase::REJECTED;
+                return;
+            }
+            pushBit(m, one);
+            m.phase = Phase::BIT_MARK;
+            return;
+        }
+        
+        case Phase::SECOND_GAP:
+            if (!matches(duration, d.secondFrameGap)) {
+                m.phase = Phase::REJECTED;
+                return;
+            }
+            m.secondFrame = true;
+            m.firstValue = m.value;
+            m.value = 0;
+            m.bitCount = 0;
+            m.phase = Phase::HEADER_MARK;
+            return;
+        
+        default:
+            return;
+    }
+}
+
+void StreamingDecoder::addSlots(Matcher& m, bool mark, uint16_t units) {
+    const ProtocolDescriptor& d = *m.descriptor;
+    if (m.slotsSeen + units > biphaseSlots(d)) {
+        m.phase = Phase::REJECTED;
+        return;
+    }
+    if (mark) {
+        m.slots |= ((1u << units) - 1) << m.slotCount;  // At most 4 units onto at most 3 pending
+    }
+    m.slotCount += units;
+    m.slotsSeen += units;
+    
+    // Decode every bit whose halves are all in
+    const uint8_t total = d.prefixBits + d.defaultBits;
+    while (m.bitCount < total) {
+        bool isData = m.bitCount >= d.prefixBits;
+        uint8_t half = isData && m.bitCount - d.prefixBits == d.doubleWidthBit ? 2 : 1;
+        if (m.slotCount < 2 * half) {
+            return;
+        }
+        bool first = m.slots & 1;
+        bool second = (m.slots >> half) & 1;
+        bool firstEnd = (m.slots >> (half - 1)) & 1;
+        bool secondEnd = (m.slots >> (2 * half - 1)) & 1;
+        bool one = first == d.oneMarkFirst;
+        if (first == second || firstEnd != first || secondEnd != second || (!isData && !one)) {
+            m.phase = Phase::REJECTED;  // No transition mid-bit, or a '0' start bit
+            return;
+        }
+        m.slots >>= 2 * half;
+        m.slotCount -= 2 * half;
+        if (isData) {
+            uint8_t index = m.bitCount - d.prefixBits;
+            if (d.bitOrder == BitOrder::MSB_FIRST) {
+                m.value = (m.value << 1) | (one ? 1 : 0);
+            } else if (one) {
+                m.value |= 1ULL << index;
+            }
+        }
+        m.bitCount++;
+    }
+    m.phase = Phase::COMPLETE;
+}
+
+void StreamingDecoder::stepBiphase(Matcher& m, uint32_t duration, bool mark) {
+    const ProtocolDescriptor& d = *m.descriptor;
+    if (m.phase == Phase::HEADER_MARK && d.headerMark) {
+        m.phase = matches(duration, d.headerMark) ? Phase::HEADER_SPACE : Phase::REJECTED;
+        return;
+    }
+    if (m.phase == Phase::HEADER_MARK || m.phase == Phase::HEADER_SPACE) {
+        if (m.phase == Phase::HEADER_SPACE && !matches(duration, d.headerSpace)) {
+            m.phase = Phase::REJECTED;
+            return;
+        }
+        m.phase = Phase::BIT_MARK;
+        
+        // A frame opening with a space half loses it to idle time
+        if (d.prefixBits != 0 && !d.oneMarkFirst) {
+            addSlots(m, false, 1);
+        }
+        if (m.phase != Phase::BIT_MARK || d.headerMark) {
+            return;  // Rejected, or that duration was the header space
+        }
+    }
+    
+    uint32_t units = (duration + d.biphaseUnit / 2) / d.biphaseUnit;
+    if (units == 0 || units > 4 || !matches(duration, units * d.biphaseUnit)) {
+        m.phase = Phase::REJECTED;
+        return;
+    }
+    addSlots(m, mark, units);
+    
+    // Only space halves left: they are the idle line, so the frame is
+    // complete at this mark (padding with more than one half cannot
+    // decode, as every bit has a mark half)
+    if (mark && m.phase == Phase::BIT_MARK) {
+        Matcher padded = m;
+        addSlots(padded, false, biphaseSlots(d) - padded.slotsSeen);
+        if (padded.phase == Phase::COMPLETE) {
+            m = padded;
+        }
+    }
+}
+
+void StreamingDecoder::finish(Matcher& m) {
+    const ProtocolDescriptor& d = *m.descriptor;
+    if (m.phase == Phase::COMPLETE) {
+        return;
+    }
+    
+    if (d.coding == BitCoding::BIPHASE) {
+        if (m.phase == Phase::BIT_MARK) {
+            addSlots(m, false, biphaseSlots(d) - m.slotsSeen);
+        }
+        if (m.phase != Phase::COMPLETE) {
+            m.phase = Phase::REJECTED;
+        }
+        return;
+    }
+    
+    // A frame of another bit count than the protocol's own, ended by the
+    // gap after its last mark: the footer, or a bit told by its mark alone
+    if (m.phase != Phase::BIT_SPACE || d.secondFrameMask) {
+        m.phase = Phase::REJECTED;
+        return;
+    }
+    if (d.footerMark) {
+        m.phase = m.markFooter && m.bitCount > 0 ? Phase::COMPLETE : Phase::REJECTED;
+        return;
+    }
+    if (m.markOne == m.markZero || m.bitCount >= kMaxBits) {
+        m.phase = Phase::REJECTED;
+        return;
+    }
+    pushBit(m, m.markOne);
+    m.phase = Phase::COMPLETE;
+}
+
+uint32_t StreamingDecoder::spaceLimit(const Matcher& m) const {
+    const ProtocolDescriptor& d = *m.descriptor;
+    if (d.coding == BitCoding::BIPHASE) {
+        return m.phase == Phase::HEADER_SPACE ? upper(d.headerSpace) : upper(4 * d.biphaseUnit);
+    }
+    
+    const uint32_t bitSpace = upper(longest(d.oneSpace, d.zeroSpace));
+    switch (m.phase) {
+        case Phase::HEADER_SPACE:
+            return upper(longest(d.headerSpace, d.repeatFrame == RepeatFrame::CODE ? d.repeatSpace : 0));
+        case Phase::SECOND_GAP:
+            return upper(d.secondFrameGap);
+        case Phase::COMPLETE:
+            // Any space the protocol could use inside a frame means the
+            // frame went on
+            return longest(bitSpace, upper(d.headerSpace));
+        default:
+            return bitSpace;
+    }
+}
+
+bool StreamingDecoder::settle() {
+    int8_t standard = -1;
+    int8_t other = -1;
+    for (uint8_t i = 0; i < matcherCount; i++) {
+        const Matcher& m = matchers[i];
+        if (m.phase == Phase::REJECTED) {
+            continue;
+        }
+        if (m.phase != Phase::COMPLETE) {
+            return false;  // Still undecided: it may yet win
+        }
+        const ProtocolDescriptor& d = *m.descriptor;
+        uint16_t bits = d.coding == BitCoding::BIPHASE ? d.defaultBits : m.bitCount;
+        if ((m.repeat || bits == d.defaultBits) && standard < 0) {
+            standard = i;
+        } else if (other < 0) {
+            other = i;
+        }
+    }
+    
+    int8_t winner = standard >= 0 ? standard : other;
+    if (winner < 0) {
+        return false;
+    }
+    const Matcher& m = matchers[winner];
+    const ProtocolDescriptor& d = *m.descriptor;
+    result.protocol = d.protocol;
+    result.repeat = m.repeat;
+    result.value = m.repeat ? 0 : m.value;
+    result.bits = m.repeat ? 0 : (d.coding == BitCoding::BIPHASE ? d.defaultBits : m.bitCount);
+    done = true;
+    return true;
+}
@@ -0,0 +1,72 @@
+#include "transmitter/AcStateProtocols.h"
+#include <cstring>
+
+static const AcStateDescriptor acDescriptors[] = {
+    // protocol, name, header, bit mark, one/zero space, section/copy gap,
+    // preamble, msbFirst, checksum, sections, copies, kHz, duty (the
+    // library's A/C senders all use 50%)
+    {AcProtocol::MITSUBISHI_AC, "MITSUBISHI_AC", 3400, 1750, 450, 1300, 420, 0, 17100,
+     0, false, AcChecksum::SUM8, 1, {18, 0, 0}, 2, 38, 50},
+    {AcProtocol::DAIKIN, "DAIKIN", 3650, 1623, 428, 1280, 428, 29000, 0,
+     5, false, AcChecksum::SUM8, 3, {8, 8, 19}, 1, 38, 50},
+    {AcProtocol::TOSHIBA_AC, "TOSHIBA_AC", 4400, 4300, 580, 1600, 490, 0, 7400,
+     0, true, AcChecksum::XOR8, 1, {9, 0, 0}, 2, 38, 50},
+};
+
+static const size_t acDescriptorCount = sizeof(acDescriptors) / sizeof(acDescriptors[0]);
+
+const AcStateDescriptor* findAcDescriptor(AcProtocol protocol) {
+    for (size_t i = 0; i < acDescriptorCount; i++) {
+        if (acDescriptors[i].protocol == protocol) {
+            return &acDescriptors[i];
+        }
+    }
+    return nullptr;
+}
+
+AcProtocol acProtocolFromName(const char* name) {
+    if (!name) {
+        return AcProtocol::UNKNOWN;
+    }
+    for (size_t i = 0; i < acDescriptorCount; i++) {
+        if (strcmp(acDescriptors[i].name, name) == 0) {
+            return acDescriptors[i].protocol;
+        }
+    }
+    return AcProtocol::UNKNOWN;
+}
+
+uint16_t acStateBytes(const AcStateDescriptor& descriptor) {
+    uint16_t total = 0;
+    for (uint8_t s = 0; s < descriptor.sectionCount; s++) {
+        total += descriptor.sectionBytes[s];
+    }
+    return total;
+}
+
+static uint8_t sectionChecksum(AcChecksum checksum, const uint8_t* section, uint8_t length) {
+    uint8_t result = 0;
+    for (uint8_t i = 0; i + 1 < length; i++) {
+        result = checksum == AcChecksum::XOR8 ? (uint8_t)(result ^ section[i]) : (uint8_t)(result + section[i]);
+    }
+    return result;
+}
+
+void applyAcChecksum(const AcStateDescriptor& descriptor, uint8_t* state) {
+    for (uint8_t s = 0; s < descriptor.sectionCount; s++) {
+        uint8_t length = descriptor.sectionBytes[s];
+        state[length - 1] = sectionChecksum(descriptor.checksum, state, length);
+        state += length;
+    }
+}
+
+bool verifyAcChecksum(const AcStateDescriptor& descriptor, const uint8_t* state) {
+    for (uint8_t s = 0; s < descriptor.sectionCount; s++) {
+        uint8_t length = descriptor.sectionBytes[s];
+        if (state[length - 1] != sectionChecksum(descriptor.checksum, state, length)) {
+            return false;
+        }
+        state += length;
+    }
+    return true;
+}
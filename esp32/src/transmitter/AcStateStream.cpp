@@ -0,0 +1,180 @@
+#include "transmitter/AcStateStream.h"
+
+AcStateStream::AcStateStream()
+    : descriptor(nullptr),
+      state(nullptr),
+      segmentCount(0),
+      totalSymbols(0),
+      segment(0),
+      bitTiming(0),
+      remaining(0),
+      timingIndex(0) {
+}
+
+bool AcStateStream::begin(const AcStateDescriptor& desc, const uint8_t* stateBytes) {
+    descriptor = &desc;
+    state = stateBytes;
+    segmentCount = 0;
+    totalSymbols = 0;
+    
+    // Gaps keep marks and spaces alternating; a zero gap would merge them
+    if (!state || desc.sectionCount == 0 || desc.sectionCount > AC_MAX_SECTIONS || desc.copies == 0 ||
+        (desc.sectionCount > 1 && desc.sectionGap == 0) || (desc.preambleBits > 0 && desc.sectionGap == 0) ||
+        (desc.copies > 1 && desc.copyGap == 0)) {
+        return false;
+    }
+    
+    for (uint8_t copy = 0; copy < desc.copies; copy++) {
+        if (copy > 0) {
+            addTiming(desc.copyGap);
+        }
+        if (desc.preambleBits > 0) {
+            for (uint8_t i = 0; i < desc.preambleBits; i++) {
+                addTiming(desc.bitMark);
+                addTiming(desc.zeroSpace);
+            }
+            addTiming(desc.bitMark);
+            addTiming(desc.sectionGap);
+        }
+        
+        uint8_t firstByte = 0;
+        for (uint8_t s = 0; s < desc.sectionCount; s++) {
+            if (s > 0) {
+                addTiming(desc.sectionGap);
+            }
+            addTiming(desc.headerMark);
+            addTiming(desc.headerSpace);
+            addBits(firstByte, desc.sectionBytes[s]);
+            addTiming(desc.bitMark);  // Footer
+            firstByte += desc.sectionBytes[s];
+        }
+    }
+    if (segmentCount > kMaxSegments) {
+        return false;
+    }
+    
+    // Count halves (timings longer than one half are split) for the
+    // driver, which needs the stream length up front
+    rewind();
+    size_t halves = 0;
+    uint16_t duration;
+    uint8_t level;
+    while (nextHalf(&duration, &level)) {
+        halves++;
+    }
+    totalSymbols = (halves + 1) / 2;
+    rewind();
+    return totalSymbols > 0;
+}
+
+void AcStateStream::addTiming(uint16_t duration) {
+    if (segmentCount < kMaxSegments) {
+        segments[segmentCount].duration = duration;
+        segments[segmentCount].byteCount = 0;
+    }
+    segmentCount++;  // Overflow is reported by begin()
+}
+
+void AcStateStream::addBits(uint8_t firstByte, uint8_t byteCount) {
+    if (segmentCount < kMaxSegments) {
+        segments[segmentCount].duration = 0;
+        segments[segmentCount].firstByte = firstByte;
+        segments[segmentCount].byteCount = byteCount;
+    }
+    segmentCount++;
+}
+
+void AcStateStream::rewind() {
+    segment = 0;
+    bitTiming = 0;
+    remaining = 0;
+    timingIndex = 0;
+}
+
+bool AcStateStream::nextTiming(uint16_t* duration) {
+    while (segment < segmentCount) {
+        const Segment& current = segments[segment];
+        if (current.byteCount == 0) {
+            segment++;
+            *duration = current.duration;
+            return true;
+        }
+        
+        // Bit run: mark, then the space that carries the bit
+        uint16_t timings = (uint16_t)current.byteCount * 16;
+        if (bitTiming >= timings) {
+            segment++;
+            bitTiming = 0;
+            continue;
+        }
+        
+        uint16_t bit = bitTiming / 2;
+        bool isMark = (bitTiming % 2) == 0;
+        bitTiming++;
+        if (isMark) {
+            *duration = descriptor->bitMark;
+            return true;
+        }
+        uint8_t byte = state[current.firstByte + bit / 8];
+        uint8_t shift = descriptor->msbFirst ? 7 - (bit % 8) : bit % 8;
+        *duration = ((byte >> shift) & 1) ? descriptor->oneSpace : descriptor->zeroSpace;
+        return true;
+    }
+    return false;
+}
+
+bool AcStateStream::nextHalf(uint16_t* duration, uint8_t* level) {
+    if (remaining == 0) {
+        uint16_t timing;
+        if (!nextTiming(&timing)) {
+            return false;
+        }
+        remaining = timing;
+        timingIndex++;
+    }
+    
+    // Long gaps are split into several halves at the same level
+    uint32_t half = remaining > RMT_MAX_SYMBOL_DURATION ? RMT_MAX_SYMBOL_DURATION : remaining;
+    remaining -= half;
+    *duration = (uint16_t)half;
+    *level = (timingIndex % 2) == 1 ? 1 : 0;  // First timing is a mark
+    return true;
+}
+
+size_t AcStateStream::fill(RmtSymbol* symbols, size_t capacity) {
+    size_t count = 0;
+    while (count < capacity) {
+        uint16_t duration0;
+        uint8_t level0;
+        if (!nextHalf(&duration0, &level0)) {
+            break;
+        }
+        
+        // An odd half count ends on a zero-length half, the end marker
+        uint16_t duration1 = 0;
+        uint8_t level1 = 0;
+        nextHalf(&duration1, &level1);
+        
+        symbols[count].duration0 = duration0;
+        symbols[count].level0 = level0;
+        symbols[count].duration1 = duration1;
+        symbols[count].level1 = level1;
+        count++;
+    }
+    return count;
+}
+
+uint16_t AcStateStream::render(uint16_t* timings, uint16_t capacity) {
+    rewind();
+    uint16_t length = 0;
+    uint16_t duration;
+    while (nextTiming(&duration)) {
+        if (length >= capacity) {
+            rewind();
+            return 0;
+        }
+        timings[length++] = duration;
+    }
+    rewind();
+    return length;
+}
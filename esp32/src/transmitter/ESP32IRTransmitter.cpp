@@ -19,9 +19,13 @@ void ESP32IRTransmitter::begin() {
     irsend->begin();
 }
 
-TransmitResult ESP32IRTransmitter::transmit(uint16_t* rawData, uint16_t length, uint16_t frequency) {
+TransmitResult ESP32IRTransmitter::transmit(uint16_t* rawData, uint16_t length, uint16_t frequency,
+                                            uint8_t dutyPercent) {
     TransmitResult result;
     
+    // sendRaw() always uses the library's default duty
+    (void)dutyPercent;
+    
     if (!rawData || length == 0) {
         result.success = false;
         result.errorMessage = "Invalid raw data";
@@ -75,3 +79,41 @@ TransmitResult ESP32IRTransmitter::transmitSony(uint32_t data, uint16_t nbits) {
     result.errorMessage = "";
     return result;
 }
+
+TransmitResult ESP32IRTransmitter::transmitValue(IRProtocol protocol, uint64_t value, uint16_t nbits,
+                                                 uint16_t carrierKHz, uint8_t dutyPercent) {
+    // The native senders fix their own carrier; overrides need the RMT transmitter
+    (void)carrierKHz;
+    (void)dutyPercent;
+    
+    switch (protocol) {
+        case IRProtocol::NEC:
+            return transmitNEC((uint32_t)value, nbits);
+        case IRProtocol::SAMSUNG:
+            return transmitSamsung(value, nbits);
+        case IRProtocol::SONY:
+            return transmitSony((uint32_t)value, nbits);
+        default: {
+            TransmitResult result;
+            result.success = false;
+            result.errorMessage = "Unsupported protocol";
+            return result;
+        }
+    }
+}
+
+TransmitResult ESP32IRTransmitter::transmitState(AcProtocol protocol, const uint8_t* state, uint16_t length,
+                                                 uint16_t carrierKHz, uint8_t dutyPercent) {
+    (void)protocol;
+    (void)state;
+    (void)length;
+    (void)carrierKHz;
+    (void)dutyPercent;
+    
+    // A 280-bit frame would keep interrupts off for hundreds of ms in
+    // IRsend's bit-bang loop; state frames go through RmtIRTransmitter
+    TransmitResult result;
+    result.success = false;
+    result.errorMessage = "State frames need the RMT transmitter";
+    return result;
+}
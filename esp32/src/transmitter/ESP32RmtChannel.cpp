@@ -0,0 +1,125 @@
+#include "transmitter/ESP32RmtChannel.h"
+#include <Arduino.h>
+
+static_assert(sizeof(RmtSymbol) == sizeof(rmt_item32_t), "RmtSymbol must match rmt_item32_t");
+
+// 80MHz APB / 80 = 1 tick per microsecond, matching the timing buffers
+#define RMT_CLOCK_DIVIDER 80
+
+ESP32RmtChannel::ESP32RmtChannel(uint16_t pin, rmt_channel_t channel, bool inverted)
+    : pin(pin), channel(channel), inverted(inverted), installed(false),
+      carrierFrequencyHz(0), carrierDutyPercent(0), translatorInstalled(false) {
+}
+
+ESP32RmtChannel::~ESP32RmtChannel() {
+    if (installed) {
+        rmt_driver_uninstall(channel);
+    }
+}
+
+bool ESP32RmtChannel::begin() {
+    if (installed) {
+        return true;
+    }
+    
+    rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)pin, channel);
+    config.clk_div = RMT_CLOCK_DIVIDER;
+    config.mem_block_num = 1;
+    config.tx_config.carrier_en = true;
+    config.tx_config.carrier_freq_hz = 38000;
+    config.tx_config.carrier_duty_percent = 33;
+    config.tx_config.carrier_level = inverted ? RMT_CARRIER_LEVEL_LOW : RMT_CARRIER_LEVEL_HIGH;
+    config.tx_config.idle_output_en = true;
+    config.tx_config.idle_level = inverted ? RMT_IDLE_LEVEL_HIGH : RMT_IDLE_LEVEL_LOW;
+    
+    if (rmt_config(&config) != ESP_OK) {
+        Serial.println("[RMT] Channel config failed");
+        return false;
+    }
+    
+    // No RX ring buffer; the driver refills channel memory from our
+    // symbol buffer in its ISR, so long frames need no extra copy
+    if (rmt_driver_install(channel, 0, 0) != ESP_OK) {
+        Serial.println("[RMT] Driver install failed");
+        return false;
+    }
+    
+    installed = true;
+    carrierFrequencyHz = config.tx_config.carrier_freq_hz;
+    carrierDutyPercent = config.tx_config.carrier_duty_percent;
+    return true;
+}
+
+bool ESP32RmtChannel::setCarrier(uint32_t frequencyHz, uint8_t dutyPercent) {
+    if (!installed || frequencyHz == 0 || dutyPercent == 0 || dutyPercent >= 100) {
+        return false;
+    }
+    
+    // Only touch the peripheral when the carrier actually changes
+    if (frequencyHz == carrierFrequencyHz && dutyPercent == carrierDutyPercent) {
+        return true;
+    }
+    
+    // Carrier high/low durations are counted in source clock (APB) ticks
+    uint32_t period = APB_CLK_FREQ / frequencyHz;
+    uint16_t high = (uint16_t)(period * dutyPercent / 100);
+    uint16_t low = (uint16_t)(period - high);
+    
+    if (rmt_set_tx_carrier(channel, true, high, low,
+                           inverted ? RMT_CARRIER_LEVEL_LOW : RMT_CARRIER_LEVEL_HIGH) != ESP_OK) {
+        return false;
+    }
+    
+    carrierFrequencyHz = frequencyHz;
+    carrierDutyPercent = dutyPercent;
+    return true;
+}
+
+bool ESP32RmtChannel::write(const RmtSymbol* symbols, size_t count) {
+    if (!installed || !symbols || count == 0) {
+        return false;
+    }
+    
+    // wait_tx_done = false: return as soon as the frame is queued
+    return rmt_write_items(channel, reinterpret_cast<const rmt_item32_t*>(symbols), count, false) == ESP_OK;
+}
+
+bool ESP32RmtChannel::writeStream(IRmtSymbolSource* source) {
+    if (!installed || !source || source->symbolCount() == 0) {
+        return false;
+    }
+    
+    if (!translatorInstalled) {
+        if (rmt_translator_init(channel, translate) != ESP_OK) {
+            return false;
+        }
+        translatorInstalled = true;
+    }
+    rmt_translator_set_context(channel, source);
+    
+    // The driver walks a "sample" buffer of one byte per symbol, handing
+    // the translator the remaining count; the bytes themselves are never
+    // read, the source produces the symbols
+    static const uint8_t kSampleStandIn = 0;
+    return rmt_write_sample(channel, &kSampleStandIn, source->symbolCount(), false) == ESP_OK;
+}
+
+void ESP32RmtChannel::translate(const void* src, rmt_item32_t* dest, size_t srcSize, size_t wanted,
+                                size_t* translated, size_t* itemCount) {
+    (void)src;
+    void* context = nullptr;
+    rmt_translator_get_context(itemCount, &context);
+    IRmtSymbolSource* source = static_cast<IRmtSymbolSource*>(context);
+    
+    size_t capacity = wanted < srcSize ? wanted : srcSize;
+    size_t count = source ? source->fill(reinterpret_cast<RmtSymbol*>(dest), capacity) : 0;
+    *translated = count ? count : srcSize;  // Never stall the driver on a short source
+    *itemCount = count;
+}
+
+bool ESP32RmtChannel::waitDone(uint32_t timeoutMs) {
+    if (!installed) {
+        return true;
+    }
+    return rmt_wait_tx_done(channel, pdMS_TO_TICKS(timeoutMs)) == ESP_OK;
+}
@@ -0,0 +1,153 @@
+#include "transmitter/FrameEncoder.h"
+
+namespace frame_encoder {
+
+namespace {
+
+// Appends alternating mark/space durations. With an empty span it only
+// counts, so the same pass sizes and then fills the frame.
+class TimingWriter {
+public:
+    explicit TimingWriter(TimingSpan out) : out(out), length(0), lastLevel(false) {}
+    
+    // Mark/space codings alternate strictly, starting with a mark
+    void push(uint16_t duration) {
+        if (out.data) {
+            out.data[length] = duration;
+        }
+        length++;
+        lastLevel = !lastLevel;
+    }
+    
+    // Bi-phase halves: same-level neighbours merge into one timing, and
+    // a space before the first mark is idle time
+    void level(bool mark, uint16_t duration) {
+        if (length == 0 && !mark) {
+            return;
+        }
+        if (length > 0 && mark == lastLevel) {
+            if (out.data) {
+                out.data[length - 1] += duration;
+            }
+            return;
+        }
+        push(duration);
+        lastLevel = mark;
+    }
+    
+    // Bi-phase frames end at the last mark
+    void trimTrailingSpace() {
+        if (length > 0 && !lastLevel) {
+            length--;
+            lastLevel = true;
+        }
+    }
+    
+    uint16_t size() const { return length; }
+
+private:
+    TimingSpan out;
+    uint16_t length;
+    bool lastLevel;  // Level of the last timing written (true = mark)
+};
+
+bool bitAt(const ProtocolDescriptor& d, uint64_t data, uint16_t bits, uint16_t index) {
+    uint16_t position = d.bitOrder == BitOrder::MSB_FIRST ? bits - 1 - index : index;
+    return (data >> position) & 1;
+}
+
+void writeMarkSpaceFrame(const ProtocolDescriptor& d, uint64_t data, uint16_t bits, TimingWriter& writer) {
+    if (d.headerMark) {
+        writer.push(d.headerMark);
+        writer.push(d.headerSpace);
+    }
+    for (uint16_t i = 0; i < bits; i++) {
+        bool one = bitAt(d, data, bits, i);
+        writer.push(one ? d.oneMark : d.zeroMark);
+        // The final space is dropped when there is no footer mark
+        if (i + 1 < bits || d.footerMark) {
+            writer.push(one ? d.oneSpace : d.zeroSpace);
+        }
+    }
+    if (d.footerMark) {
+        writer.push(d.footerMark);
+    }
+}
+
+void writeBiphaseBit(const ProtocolDescriptor& d, bool one, uint16_t halfDuration, TimingWriter& writer) {
+    bool firstHalfMark = one == d.oneMarkFirst;
+    writer.level(firstHalfMark, halfDuration);
+    writer.level(!firstHalfMark, halfDuration);
+}
+
+void writeBiphaseFrame(const ProtocolDescriptor& d, uint64_t data, uint16_t bits, TimingWriter& writer) {
+    if (d.headerMark) {
+        writer.level(true, d.headerMark);
+        writer.level(false, d.headerSpace);
+    }
+    for (uint8_t i = 0; i < d.prefixBits; i++) {
+        writeBiphaseBit(d, true, d.biphaseUnit, writer);
+    }
+    for (uint16_t i = 0; i < bits; i++) {
+        uint16_t half = i == d.doubleWidthBit ? d.biphaseUnit * 2 : d.biphaseUnit;
+        writeBiphaseBit(d, bitAt(d, data, bits, i), half, writer);
+    }
+    writer.trimTrailingSpace();
+}
+
+void writeFrame(const ProtocolDescriptor& d, uint64_t data, uint16_t bits, TimingWriter& writer) {
+    if (d.coding == BitCoding::BIPHASE) {
+        writeBiphaseFrame(d, data, bits, writer);
+        return;
+    }
+    writeMarkSpaceFrame(d, data, bits, writer);
+    if (d.secondFrameMask) {
+        writer.push(d.secondFrameGap);
+        writeMarkSpaceFrame(d, data ^ d.secondFrameMask, bits, writer);
+    }
+}
+
+}  // namespace
+
+uint16_t encodeFrame(const ProtocolDescriptor& d, uint64_t data, uint16_t bits, TimingSpan out) {
+    if (bits == 0 || bits > 64) {
+        return 0;
+    }
+    
+    // Size first so a short span is left untouched
+    TimingWriter sizer((TimingSpan()));
+    writeFrame(d, data, bits, sizer);
+    if (!out.data || out.capacity < sizer.size()) {
+        return sizer.size();
+    }
+    
+    TimingWriter writer(out);
+    writeFrame(d, data, bits, writer);
+    return writer.size();
+}
+
+uint16_t appendRepeats(const ProtocolDescriptor& d, TimingSpan buffer, uint16_t frameLength) {
+    if (!buffer.data || frameLength == 0 || frameLength > buffer.capacity) {
+        return 0;
+    }
+    
+    uint32_t frameDuration = 0;
+    for (uint16_t i = 0; i < frameLength; i++) {
+        frameDuration += buffer.data[i];
+    }
+    
+    uint16_t length = frameLength;
+    for (uint8_t frame = 1; frame <= d.repeats; frame++) {
+        uint32_t gap = d.framePeriodUs > frameDuration ? d.framePeriodUs - frameDuration : 0;
+        if (gap == 0 || gap > 0xFFFF || (uint32_t)length + 1 + frameLength > buffer.capacity) {
+            return 0;
+        }
+        buffer.data[length++] = (uint16_t)gap;
+        for (uint16_t i = 0; i < frameLength; i++) {
+            buffer.data[length++] = buffer.data[i];
+        }
+    }
+    return length;
+}
+
+}  // namespace frame_encoder
@@ -0,0 +1,143 @@
+#include "transmitter/HoldRepeater.h"
+
+HoldRepeater::HoldRepeater(IIRTransmitter* transmitter, IProtocolEncoder* encoder, uint32_t timeoutMs)
+    : transmitter(transmitter),
+      encoder(encoder),
+      timeoutMs(timeoutMs),
+      holding(false),
+      heldProtocol(IRProtocol::UNKNOWN),
+      heldValue(0),
+      heldBits(0),
+      frequency(IR_DEFAULT_CARRIER_KHZ),
+      dutyPercent(IR_DEFAULT_DUTY_PERCENT),
+      periodMs(0),
+      nextDueMs(0),
+      deadlineMs(0),
+      minRepeats(0),
+      heldRepeats(0),
+      releaseRequested(false),
+      repeatCount(0),
+      timeoutCount(0),
+      repeatLength(0) {
+}
+
+TransmitResult HoldRepeater::press(IRProtocol protocol, uint64_t value, uint16_t bits, uint32_t nowMs,
+                                   uint16_t carrierKHz, uint8_t duty) {
+    TransmitResult result;
+    
+    // Same button still down: the press is a keep-alive
+    if (holding && protocol == heldProtocol && value == heldValue && bits == heldBits) {
+        deadlineMs = nowMs + timeoutMs;
+        releaseRequested = false;
+        result.success = true;
+        return result;
+    }
+    holding = false;
+    
+    const ProtocolDescriptor* descriptor = findDescriptor(protocol);
+    uint16_t length = descriptor ? encoder->encodeValue(protocol, value, bits, TimingSpan(frame, kMaxTimings)) : 0;
+    if (length == 0 || length > kMaxTimings) {
+        result.success = false;
+        result.errorMessage = "Encoding failed";
+        return result;
+    }
+    
+    frequency = carrierKHz ? carrierKHz : descriptor->carrierKHz;
+    dutyPercent = duty ? duty : descriptor->dutyPercent;
+    result = transmitter->transmit(frame, length, frequency, dutyPercent);
+    if (!result.success || descriptor->framePeriodUs == 0 || !buildRepeatFrame(*descriptor, length)) {
+        return result;
+    }
+    
+    holding = true;
+    heldProtocol = protocol;
+    heldValue = value;
+    heldBits = bits;
+    minRepeats = descriptor->repeats;
+    heldRepeats = 0;
+    releaseRequested = false;
+    periodMs = descriptor->framePeriodUs / 1000;
+    nextDueMs = nowMs + periodMs;
+    deadlineMs = nowMs + timeoutMs;
+    return result;
+}
+
+void HoldRepeater::release() {
+    // A tap still gets the protocol's minimum repeats (Sony's three frames)
+    if (heldRepeats >= minRepeats) {
+        holding = false;
+    } else {
+        releaseRequested = true;
+    }
+}
+
+void HoldRepeater::update(uint32_t nowMs) {
+    if (!holding) {
+        return;
+    }
+    
+    // Wrap-safe comparisons against millis()
+    if ((int32_t)(nowMs - deadlineMs) >= 0) {
+        holding = false;
+        timeoutCount++;
+        return;
+    }
+    if ((int32_t)(nowMs - nextDueMs) < 0) {
+        return;
+    }
+    
+    if (transmitter->transmit(repeatFrame, repeatLength, frequency, dutyPercent).success) {
+        repeatCount++;
+        if (heldRepeats < 0xFF) {
+            heldRepeats++;
+        }
+    }
+    if (releaseRequested && heldRepeats >= minRepeats) {
+        holding = false;
+        return;
+    }
+    
+    // Keep the cadence; after a stall, restart it rather than bursting
+    // the missed repeats
+    nextDueMs += periodMs;
+    if ((int32_t)(nowMs - nextDueMs) >= 0) {
+        nextDueMs = nowMs + periodMs;
+    }
+}
+
+uint32_t HoldRepeater::msUntilNextRepeat(uint32_t nowMs) const {
+    if (!holding) {
+        return UINT32_MAX;
+    }
+    int32_t untilRepeat = (int32_t)(nextDueMs - nowMs);
+    int32_t untilDeadline = (int32_t)(deadlineMs - nowMs);
+    int32_t until = untilRepeat < untilDeadline ? untilRepeat : untilDeadline;
+    return until > 0 ? (uint32_t)until : 0;
+}
+
+bool HoldRepeater::buildRepeatFrame(const ProtocolDescriptor& descriptor, uint16_t frameLength) {
+    switch (descriptor.repeatFrame) {
+        case RepeatFrame::CODE:
+            repeatFrame[0] = descriptor.repeatMark;
+            repeatFrame[1] = descriptor.repeatSpace;
+            repeatFrame[2] = descriptor.footerMark;
+            repeatLength = 3;
+            return true;
+        case RepeatFrame::HEADERLESS:
+            if (!descriptor.headerMark || frameLength <= 2) {
+                return false;
+            }
+            repeatLength = frameLength - 2;
+            for (uint16_t i = 0; i < repeatLength; i++) {
+                repeatFrame[i] = frame[i + 2];
+            }
+            return true;
+        case RepeatFrame::FULL:
+        default:
+            repeatLength = frameLength;
+            for (uint16_t i = 0; i < repeatLength; i++) {
+                repeatFrame[i] = frame[i];
+            }
+            return true;
+    }
+}
@@ -1,173 +1,213 @@
 #include "transmitter/IRLibProtocolEncoders.h"
+#include "transmitter/FrameEncoder.h"
 
 #ifndef NATIVE_BUILD
     #include <Arduino.h>
 #endif
 
-#include <cstring>
+#include <new>
 
-EncodedSignal IRLibProtocolEncoders::encode(const char* protocol, uint32_t address, uint32_t command, uint16_t bits) {
-    // Route to appropriate encoder based on protocol
-    if (strcmp(protocol, "NEC") == 0) {
-        return encodeNEC(address, command);
-    } else if (strcmp(protocol, "SAMSUNG") == 0) {
-        return encodeSamsung(address, command);
-    } else if (strcmp(protocol, "SONY") == 0) {
-        return encodeSony(address, command, bits);
+using frame_encoder::encodeFrame;
+
+namespace {
+
+struct UnrolledEncoder {
+    IRProtocol protocol;
+    uint16_t bits;
+    uint16_t (*encode)(uint64_t data, TimingSpan out);
+};
+
+const UnrolledEncoder unrolledEncoders[] = {
+    {IRProtocol::NEC, 32, &encodeFrame<NecProtocol, 32>},
+    {IRProtocol::SAMSUNG, 32, &encodeFrame<SamsungProtocol, 32>},
+    {IRProtocol::SONY, 12, &encodeFrame<SonyProtocol, 12>},
+    {IRProtocol::SONY, 15, &encodeFrame<SonyProtocol, 15>},
+    {IRProtocol::SONY, 20, &encodeFrame<SonyProtocol, 20>},
+};
+
+uint32_t reverseBits(uint32_t input, uint8_t bits) {
+    uint32_t output = 0;
+    for (uint8_t i = 0; i < bits; i++) {
+        output = (output << 1) | ((input >> i) & 1);
     }
-    
-    // Unknown protocol - return empty signal
-    EncodedSignal signal = {};
-    signal.protocol = "UNKNOWN";
-    signal.rawData = nullptr;
-    signal.rawLength = 0;
-    signal.frequency = 38;
-    signal.isKnownProtocol = false;
-    return signal;
+    return output;
 }
 
-EncodedSignal IRLibProtocolEncoders::encodeRaw(uint16_t* rawData, uint16_t rawLength, uint16_t frequency) {
-    EncodedSignal signal = {};
-    signal.protocol = "RAW";
-    signal.rawData = rawData;  // Direct reference (caller owns memory)
-    signal.rawLength = rawLength;
-    signal.frequency = frequency;
-    signal.isKnownProtocol = false;
-    return signal;
-}
+}  // namespace
 
-EncodedSignal IRLibProtocolEncoders::encodeNEC(uint32_t address, uint32_t command) {
-    EncodedSignal signal = {};
-    signal.protocol = "NEC";
-    signal.frequency = 38;
-    signal.isKnownProtocol = true;
-    
-    // NEC protocol timing (in microseconds)
-    // Header: 9000us mark, 4500us space
-    // Logical '0': 560us mark, 560us space
-    // Logical '1': 560us mark, 1690us space
-    // Footer: 560us mark
-    
-    // NEC sends: 8-bit address, 8-bit ~address, 8-bit command, 8-bit ~command
-    // Total: 32 bits = 64 pulses (mark + space for each bit) + header (2) + footer (1) = 67 elements
-    
-    signal.rawLength = 67;
-    signal.rawData = allocateRawData(signal.rawLength);
-    
-    if (!signal.rawData) {
+EncodedSignal IRLibProtocolEncoders::encode(const char* protocol, uint32_t address, uint32_t command, uint16_t bits) {
+    IRProtocol id = protocolFromName(protocol);
+    uint64_t value = 0;
+    if (!packValue(id, address, command, bits, &value)) {
+        // Unknown protocol - return empty signal
+        EncodedSignal signal;
+        signal.protocol = "UNKNOWN";
+        signal.frequency = IR_DEFAULT_CARRIER_KHZ;
         signal.isKnownProtocol = false;
-        signal.rawLength = 0;
         return signal;
     }
     
-    uint16_t idx = 0;
-    
-    // Header
-    signal.rawData[idx++] = 9000;
-    signal.rawData[idx++] = 4500;
-    
-    // Combine address and command into 32-bit value
-    // NEC format: address (8 bits) | ~address (8 bits) | command (8 bits) | ~command (8 bits)
-    uint32_t data = (address & 0xFF) | ((~address & 0xFF) << 8) | ((command & 0xFF) << 16) | ((~command & 0xFF) << 24);
-    
-    // Encode 32 bits (MSB first, matching IRremoteESP8266 convention)
-    for (int i = 31; i >= 0; i--) {
-        signal.rawData[idx++] = 560;  // Mark
-        signal.rawData[idx++] = ((data >> i) & 1) ? 1690 : 560;  // Space (1690 for '1', 560 for '0')
+    return allocateSignal(id, value, bits);
+}
+
+uint16_t IRLibProtocolEncoders::encode(const char* protocol, uint32_t address, uint32_t command, uint16_t bits, TimingSpan out) {
+    IRProtocol id = protocolFromName(protocol);
+    uint64_t value = 0;
+    if (!packValue(id, address, command, bits, &value)) {
+        return 0;
     }
-    
-    // Footer mark
-    signal.rawData[idx++] = 560;
-    
-    return signal;
+    return encodeValue(id, value, bits, out);
 }
 
-EncodedSignal IRLibProtocolEncoders::encodeSamsung(uint32_t address, uint32_t command) {
-    EncodedSignal signal = {};
-    signal.protocol = "SAMSUNG";
-    signal.frequency = 38;
-    signal.isKnownProtocol = true;
-    
-    // Samsung protocol is similar to NEC but with different header timing
-    // Header: 4500us mark, 4500us space
-    // Logical '0': 560us mark, 560us space
-    // Logical '1': 560us mark, 1690us space
-    // Footer: 560us mark
-    
-    signal.rawLength = 67;
-    signal.rawData = allocateRawData(signal.rawLength);
-    
-    if (!signal.rawData) {
-        signal.isKnownProtocol = false;
-        signal.rawLength = 0;
-        return signal;
+EncodedSignal IRLibProtocolEncoders::encodeValue(const char* protocol, uint64_t value, uint16_t bits) {
+    return allocateSignal(protocolFromName(protocol), value, bits);
+}
+
+uint16_t IRLibProtocolEncoders::encodeValue(const char* protocol, uint64_t value, uint16_t bits, TimingSpan out) {
+    return encodeValue(protocolFromName(protocol), value, bits, out);
+}
+
+EncodedSignal IRLibProtocolEncoders::encodeValue(IRProtocol protocol, uint64_t value, uint16_t bits) {
+    return allocateSignal(protocol, value, bits);
+}
+
+uint16_t IRLibProtocolEncoders::encodeValue(IRProtocol protocol, uint64_t value, uint16_t bits, TimingSpan out) {
+    // The value is already the on-wire data, no address/command packing
+    const ProtocolDescriptor* descriptor = findDescriptor(protocol);
+    if (!descriptor) {
+        return 0;
     }
     
-    uint16_t idx = 0;
-    
-    // Samsung header
-    signal.rawData[idx++] = 4500;
-    signal.rawData[idx++] = 4500;
-    
-    // Combine address and command (IRremoteESP8266 format: address in upper 16 bits)
-    uint32_t data = ((address & 0xFFFF) << 16) | ((command & 0xFF) << 8) | (~command & 0xFF);
-    
-    // Encode 32 bits (MSB first, matching IRremoteESP8266 convention)
-    for (int i = 31; i >= 0; i--) {
-        signal.rawData[idx++] = 560;
-        signal.rawData[idx++] = ((data >> i) & 1) ? 1690 : 560;
+    // Toggle-bit protocols carry the encoder's per-protocol toggle state
+    // instead of whatever toggle the stored value was captured with
+    const bool toggles = descriptor->toggleBit != PROTOCOL_NO_BIT && descriptor->toggleBit < bits;
+    if (toggles) {
+        const uint64_t mask = 1ULL << descriptor->toggleBit;
+        value = (value & ~mask) | (toggleState(protocol) ? mask : 0);
     }
     
-    // Footer
-    signal.rawData[idx++] = 560;
+    uint16_t length = render(*descriptor, value, bits, out);
     
+    // A frame actually written is a new press; size queries are not
+    if (toggles && length > 0 && out.data && length <= out.capacity) {
+        toggleStates ^= toggleFlag(protocol);
+    }
+    return length;
+}
+
+void IRLibProtocolEncoders::setToggleState(IRProtocol protocol, bool toggled) {
+    if (toggled) {
+        toggleStates |= toggleFlag(protocol);
+    } else {
+        toggleStates &= ~toggleFlag(protocol);
+    }
+}
+
+bool IRLibProtocolEncoders::toggleState(IRProtocol protocol) const {
+    return (toggleStates & toggleFlag(protocol)) != 0;
+}
+
+uint16_t IRLibProtocolEncoders::render(const ProtocolDescriptor& descriptor, uint64_t value, uint16_t bits, TimingSpan out) {
+    // Standard frames of the most used protocols take the unrolled
+    // encoder; everything else goes through the generic engine
+    for (size_t i = 0; i < sizeof(unrolledEncoders) / sizeof(unrolledEncoders[0]); i++) {
+        if (unrolledEncoders[i].protocol == descriptor.protocol && unrolledEncoders[i].bits == bits) {
+            return unrolledEncoders[i].encode(value, out);
+        }
+    }
+    return encodeFrame(descriptor, value, bits, out);
+}
+
+EncodedSignal IRLibProtocolEncoders::encodeRaw(uint16_t* rawData, uint16_t rawLength, uint16_t frequency) {
+    EncodedSignal signal;
+    signal.protocol = "RAW";
+    signal.borrow(rawData, rawLength);  // Direct reference (caller owns memory)
+    signal.frequency = frequency;
+    signal.isKnownProtocol = false;
     return signal;
 }
 
-EncodedSignal IRLibProtocolEncoders::encodeSony(uint32_t address, uint32_t command, uint16_t bits) {
-    EncodedSignal signal = {};
-    signal.protocol = "SONY";
-    signal.frequency = 38;
-    signal.isKnownProtocol = true;
-    
-    // Sony SIRC protocol timing
-    // Header: 2400us mark
-    // Logical '0': 600us space
-    // Logical '1': 1200us space
-    // Each bit ends with 600us mark
-    
-    // Sony format: 7-bit command | 5/8/13-bit address (depending on 12/15/20-bit variant)
-    // For 12-bit: 7-bit command + 5-bit address = 12 bits
-    
-    signal.rawLength = (bits * 2) + 1;  // Each bit is mark+space, plus header mark
-    signal.rawData = allocateRawData(signal.rawLength);
+bool IRLibProtocolEncoders::packValue(IRProtocol protocol, uint32_t address, uint32_t command, uint16_t bits, uint64_t* value) {
+    switch (protocol) {
+        case IRProtocol::NEC:
+            // NEC format: address (8 bits) | ~address (8 bits) | command (8 bits) | ~command (8 bits)
+            *value = (address & 0xFF) | ((~address & 0xFF) << 8) | ((command & 0xFF) << 16) | ((~command & 0xFF) << 24);
+            return true;
+        case IRProtocol::SAMSUNG:
+            // IRremoteESP8266 format: address in upper 16 bits
+            *value = ((address & 0xFFFF) << 16) | ((command & 0xFF) << 8) | (~command & 0xFF);
+            return true;
+        case IRProtocol::SONY:
+            // Sony format: 7-bit command | 5/8/13-bit address (depending on 12/15/20-bit variant)
+            // For 12-bit: 7-bit command + 5-bit address = 12 bits
+            if (bits <= 7) {
+                return false;
+            }
+            *value = (command & 0x7F) | ((address & ((1 << (bits - 7)) - 1)) << 7);
+            return true;
+        case IRProtocol::RC5:
+            // RC5 format: toggle | 5-bit address | 6-bit command (toggle is set at send time)
+            *value = ((address & 0x1F) << 6) | (command & 0x3F);
+            return true;
+        case IRProtocol::RC6:
+            // RC6 mode 0: mode (3 bits) | toggle | 8-bit address | 8-bit command
+            *value = ((address & 0xFF) << 8) | (command & 0xFF);
+            return true;
+        case IRProtocol::PANASONIC: {
+            // Kaseikyo: 16-bit Panasonic vendor ID | device | subdevice | function | checksum
+            // The address carries device (high byte) and subdevice (low byte)
+            uint8_t device = (address >> 8) & 0xFF;
+            uint8_t subdevice = address & 0xFF;
+            uint8_t function = command & 0xFF;
+            uint8_t checksum = device ^ subdevice ^ function;
+            *value = (0x4004ULL << 32) | ((uint64_t)device << 24) | ((uint64_t)subdevice << 16) | (function << 8) | checksum;
+            return true;
+        }
+        case IRProtocol::JVC:
+            // JVC format: 8-bit address then 8-bit command, each sent LSB first
+            *value = reverseBits(((command & 0xFF) << 8) | (address & 0xFF), 16);
+            return true;
+        case IRProtocol::LG: {
+            // LG format: 8-bit address | 16-bit command | 4-bit nibble checksum of the command
+            uint8_t checksum = 0;
+            for (uint8_t nibble = 0; nibble < 4; nibble++) {
+                checksum += (command >> (nibble * 4)) & 0xF;
+            }
+            *value = ((address & 0xFF) << 20) | ((command & 0xFFFF) << 4) | (checksum & 0xF);
+            return true;
+        }
+        case IRProtocol::SHARP:
+            // Sharp format: 5-bit address | 8-bit command (both LSB first) | expansion (1) | check (0)
+            *value = (reverseBits(address & 0x1F, 5) << 10) | (reverseBits(command & 0xFF, 8) << 2) | 0x2;
+            return true;
+        default:
+            return false;
+    }
+}
+
+EncodedSignal IRLibProtocolEncoders::allocateSignal(IRProtocol protocol, uint64_t value, uint16_t bits) {
+    EncodedSignal signal;
+    signal.protocol = "UNKNOWN";
+    signal.frequency = IR_DEFAULT_CARRIER_KHZ;
+    signal.isKnownProtocol = false;
     
-    if (!signal.rawData) {
-        signal.isKnownProtocol = false;
-        signal.rawLength = 0;
+    const ProtocolDescriptor* descriptor = findDescriptor(protocol);
+    uint16_t length = descriptor ? encodeValue(protocol, value, bits, TimingSpan()) : 0;
+    if (length == 0) {
         return signal;
     }
     
-    uint16_t idx = 0;
-    
-    // Sony header (just a mark, no space before first bit)
-    signal.rawData[idx++] = 2400;
-    
-    // Combine command (7 bits) and address (5/8/13 bits depending on total bits)
-    uint32_t data = (command & 0x7F) | ((address & ((1 << (bits - 7)) - 1)) << 7);
+    signal.protocol = descriptor->name;
+    signal.frequency = descriptor->carrierKHz;
     
-    // Encode bits (MSB first, matching IRremoteESP8266 convention)
-    for (int i = bits - 1; i >= 0; i--) {
-        signal.rawData[idx++] = (((data >> i) & 1)) ? 1200 : 600;  // Space
-        signal.rawData[idx++] = 600;  // Mark
+    // Owned by the returned signal, released when it goes out of scope
+    std::unique_ptr<uint16_t[]> data(new (std::nothrow) uint16_t[length]);
+    if (!data) {
+        return signal;
     }
     
+    encodeValue(protocol, value, bits, TimingSpan(data.get(), length));
+    signal.adopt(std::move(data), length);
+    signal.isKnownProtocol = true;
     return signal;
 }
-
-uint16_t* IRLibProtocolEncoders::allocateRawData(uint16_t length) {
-    // Allocate raw timing array
-    // Note: In production, caller is responsible for freeing this memory
-    uint16_t* data = new uint16_t[length];
-    return data;
-}
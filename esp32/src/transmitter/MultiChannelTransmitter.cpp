@@ -0,0 +1,89 @@
+#include "transmitter/MultiChannelTransmitter.h"
+
+MultiChannelTransmitter::Output::Output(uint16_t pin, rmt_channel_t rmtChannel, bool inverted)
+    : pin(pin),
+      channel(pin, rmtChannel, inverted),
+      transmitter(&channel, &encoder, &cache),
+      repeater(&transmitter, &encoder),
+      queue(&transmitter, &repeater, TransmitTask::clockMicros, &latency),
+      task(&queue) {
+}
+
+MultiChannelTransmitter::MultiChannelTransmitter()
+    : count(0), misrouted(0) {
+    for (uint8_t i = 0; i < kMaxOutputs; i++) {
+        outputs[i] = nullptr;
+    }
+}
+
+MultiChannelTransmitter::~MultiChannelTransmitter() {
+    for (uint8_t i = 0; i < count; i++) {
+        delete outputs[i];
+    }
+}
+
+bool MultiChannelTransmitter::addOutput(uint16_t pin, bool inverted) {
+    if (count >= kMaxOutputs) {
+        return false;
+    }
+    
+    // Output n drives RMT channel n; the symbol buffers are large, so
+    // outputs live on the heap rather than in .bss for every board
+    outputs[count] = new Output(pin, (rmt_channel_t)(RMT_CHANNEL_0 + count), inverted);
+    count++;
+    return true;
+}
+
+bool MultiChannelTransmitter::begin() {
+    bool ok = true;
+    for (uint8_t i = 0; i < count; i++) {
+        Output* output = outputs[i];
+        if (!output->cache.begin()) {
+            Serial.print("[TX] Waveform cache allocation failed on output ");
+            Serial.println(i);
+        }
+        output->transmitter.begin();
+        if (!output->task.begin()) {
+            Serial.print("[TX] Transmit task creation failed on output ");
+            Serial.println(i);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool MultiChannelTransmitter::submit(uint8_t output, const TransmitRequest& request) {
+    if (output >= count) {
+        misrouted++;
+        return false;
+    }
+    return outputs[output]->task.submit(request);
+}
+
+bool MultiChannelTransmitter::submitRaw(uint8_t output, const TransmitRequest& request, const uint16_t* timings,
+                                        uint16_t length) {
+    if (output >= count) {
+        misrouted++;
+        return false;
+    }
+    return outputs[output]->task.submitRaw(request, timings, length);
+}
+
+uint16_t MultiChannelTransmitter::getPin(uint8_t output) const {
+    return output < count ? outputs[output]->pin : 0;
+}
+
+TransmitQueueStats MultiChannelTransmitter::getStats(uint8_t output) const {
+    if (output >= count) {
+        return TransmitQueueStats();
+    }
+    return outputs[output]->queue.getStats();
+}
+
+CommandLatency* MultiChannelTransmitter::getLatency(uint8_t output) {
+    return output < count ? &outputs[output]->latency : nullptr;
+}
+
+const WaveformCache* MultiChannelTransmitter::getCache(uint8_t output) const {
+    return output < count ? &outputs[output]->cache : nullptr;
+}
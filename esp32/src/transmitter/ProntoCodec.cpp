@@ -0,0 +1,160 @@
+#include "transmitter/ProntoCodec.h"
+#include <cstring>
+
+namespace pronto {
+
+namespace {
+
+const char kHexDigits[] = "0123456789ABCDEF";
+const uint16_t kLearnedCode = 0x0000;
+const uint8_t kHeaderWords = 4;
+const uint8_t kWordChars = 5;  // Four digits and a separator (the last one becomes the NUL)
+
+int8_t hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+bool isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Sequences are padded to whole pairs
+uint16_t paddedLength(uint16_t length) {
+    return (uint16_t)(length + (length & 1));
+}
+
+void writeWord(char* out, uint16_t value) {
+    out[0] = kHexDigits[(value >> 12) & 0xF];
+    out[1] = kHexDigits[(value >> 8) & 0xF];
+    out[2] = kHexDigits[(value >> 4) & 0xF];
+    out[3] = kHexDigits[value & 0xF];
+    out[4] = ' ';
+}
+
+}  // namespace
+
+Parser::Parser(uint16_t* timings, uint16_t capacity)
+    : timings(timings), capacity(capacity), words(0), expected(0), periodPicos(0), word(0), digits(0),
+      failed(false) {
+    memset(header, 0, sizeof(header));
+}
+
+bool Parser::feed(const char* text, size_t length) {
+    for (size_t i = 0; i < length && !failed; i++) {
+        int8_t value = hexValue(text[i]);
+        if (value >= 0) {
+            if (digits == 4) {
+                failed = true;
+                break;
+            }
+            word = (uint16_t)((word << 4) | value);
+            digits++;
+        } else if (isSeparator(text[i])) {
+            if (digits > 0) {
+                completeWord();
+            }
+        } else {
+            failed = true;
+        }
+    }
+    return !failed;
+}
+
+void Parser::completeWord() {
+    const uint16_t value = word;
+    word = 0;
+    digits = 0;
+    
+    if (words < kHeaderWords) {
+        header[words++] = value;
+        if (words == 1 && value != kLearnedCode) {
+            failed = true;  // Unmodulated and pre-decoded formats are not timings
+        } else if (words == 2) {
+            periodPicos = (uint64_t)value * kUnitPicos;
+            failed = value == 0;
+        } else if (words == kHeaderWords) {
+            expected = 2u * ((uint32_t)header[2] + header[3]);
+            failed = expected == 0 || expected > capacity;
+        }
+        return;
+    }
+    
+    uint32_t index = words++ - kHeaderWords;
+    if (index >= expected || value == 0) {
+        failed = true;
+        return;
+    }
+    uint64_t us = ((uint64_t)value * periodPicos + 500000) / 1000000;
+    timings[index] = us > 0xFFFF ? 0xFFFF : (uint16_t)us;
+}
+
+uint16_t Parser::finish(Code* code) {
+    if (digits > 0 && !failed) {
+        completeWord();
+    }
+    if (failed || words < kHeaderWords || words - kHeaderWords != expected) {
+        failed = true;
+        return 0;
+    }
+    
+    if (code) {
+        code->carrierHz = (uint32_t)(1000000000000ULL / periodPicos);
+        code->onceLength = (uint16_t)(2 * header[2]);
+        code->repeatLength = (uint16_t)(2 * header[3]);
+    }
+    return (uint16_t)expected;
+}
+
+uint16_t decode(const char* text, uint16_t* timings, uint16_t capacity, Code* code) {
+    if (!text || !timings) {
+        return 0;
+    }
+    Parser parser(timings, capacity);
+    parser.feed(text, strlen(text));
+    return parser.finish(code);
+}
+
+size_t encodedSizeFor(uint16_t onceLength, uint16_t repeatLength) {
+    return ((size_t)kHeaderWords + paddedLength(onceLength) + paddedLength(repeatLength)) * kWordChars;
+}
+
+size_t encode(const uint16_t* timings, uint16_t onceLength, uint16_t repeatLength, uint16_t carrierKHz,
+              char* out, size_t size) {
+    size_t needed = encodedSizeFor(onceLength, repeatLength);
+    if (!out || size < needed || carrierKHz == 0 || (onceLength == 0 && repeatLength == 0) ||
+        (!timings && onceLength + repeatLength > 0)) {
+        if (out && size > 0) out[0] = '\0';
+        return 0;
+    }
+    
+    // Carrier period (1e9 ps / kHz) in Pronto units, rounded
+    const uint64_t divisor = (uint64_t)carrierKHz * kUnitPicos;
+    uint16_t periodWord = (uint16_t)((1000000000ULL + divisor / 2) / divisor);
+    const uint64_t periodPicos = (uint64_t)periodWord * kUnitPicos;
+    
+    char* p = out;
+    writeWord(p, kLearnedCode);
+    writeWord(p += kWordChars, periodWord);
+    writeWord(p += kWordChars, paddedLength(onceLength) / 2);
+    writeWord(p += kWordChars, paddedLength(repeatLength) / 2);
+    
+    const uint16_t lengths[2] = {onceLength, repeatLength};
+    const uint16_t* sequence = timings;
+    for (uint8_t s = 0; s < 2; s++) {
+        for (uint16_t i = 0; i < paddedLength(lengths[s]); i++) {
+            uint16_t us = i < lengths[s] ? sequence[i] : kTrailingGapUs;
+            uint64_t periods = ((uint64_t)us * 1000000 + periodPicos / 2) / periodPicos;
+            writeWord(p += kWordChars, periods == 0 ? 1 : periods > 0xFFFF ? 0xFFFF : (uint16_t)periods);
+        }
+        sequence += lengths[s];
+    }
+    
+    // The last separator terminates the string
+    p[kWordChars - 1] = '\0';
+    return needed - 1;
+}
+
+}  // namespace pronto
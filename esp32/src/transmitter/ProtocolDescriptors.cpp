@@ -0,0 +1,48 @@
+#include "transmitter/ProtocolDescriptors.h"
+
+#include <cstring>
+
+// Kept in IRProtocol order so findDescriptor() is an index
+static const ProtocolDescriptor descriptors[] = {
+    NecProtocol::descriptor(),
+    SamsungProtocol::descriptor(),
+    SonyProtocol::descriptor(),
+    Rc5Protocol::descriptor(),
+    Rc6Protocol::descriptor(),
+    PanasonicProtocol::descriptor(),
+    JvcProtocol::descriptor(),
+    LgProtocol::descriptor(),
+    SharpProtocol::descriptor(),
+};
+
+static const size_t descriptorCount = sizeof(descriptors) / sizeof(descriptors[0]);
+
+IRProtocol protocolFromName(const char* name) {
+    if (!name) {
+        return IRProtocol::UNKNOWN;
+    }
+    for (size_t i = 0; i < descriptorCount; i++) {
+        if (strcmp(descriptors[i].name, name) == 0) {
+            return descriptors[i].protocol;
+        }
+    }
+    return IRProtocol::UNKNOWN;
+}
+
+const char* protocolName(IRProtocol protocol) {
+    const ProtocolDescriptor* descriptor = findDescriptor(protocol);
+    return descriptor ? descriptor->name : "UNKNOWN";
+}
+
+const ProtocolDescriptor* findDescriptor(IRProtocol protocol) {
+    size_t index = static_cast<size_t>(protocol) - 1;
+    if (protocol == IRProtocol::UNKNOWN || index >= descriptorCount || descriptors[index].protocol != protocol) {
+        return nullptr;
+    }
+    return &descriptors[index];
+}
+
+const ProtocolDescriptor* protocolDescriptors(size_t* count) {
+    *count = descriptorCount;
+    return descriptors;
+}
@@ -0,0 +1,174 @@
+#include "transmitter/RmtIRTransmitter.h"
+#include "transmitter/RmtSymbolEncoder.h"
+#include "transmitter/FrameEncoder.h"
+#include <cstring>
+
+RmtIRTransmitter::RmtIRTransmitter(IRmtChannel* channel, IProtocolEncoder* encoder, WaveformCache* cache)
+    : channel(channel), encoder(encoder), cache(cache) {
+}
+
+void RmtIRTransmitter::begin() {
+    channel->begin();
+}
+
+bool RmtIRTransmitter::isBusy() {
+    return !channel->waitDone(0);
+}
+
+TransmitResult RmtIRTransmitter::transmit(uint16_t* rawData, uint16_t length, uint16_t frequency,
+                                         uint8_t dutyPercent) {
+    TransmitResult result;
+    
+    if (!rawData || length == 0) {
+        result.success = false;
+        result.errorMessage = "Invalid raw data";
+        return result;
+    }
+    
+    return queue(rawData, length, frequency, dutyPercent);
+}
+
+TransmitResult RmtIRTransmitter::transmitNEC(uint32_t data, uint16_t nbits) {
+    return transmitValue(IRProtocol::NEC, data, nbits);
+}
+
+TransmitResult RmtIRTransmitter::transmitSamsung(uint64_t data, uint16_t nbits) {
+    return transmitValue(IRProtocol::SAMSUNG, data, nbits);
+}
+
+TransmitResult RmtIRTransmitter::transmitSony(uint32_t data, uint16_t nbits) {
+    return transmitValue(IRProtocol::SONY, data, nbits);
+}
+
+TransmitResult RmtIRTransmitter::transmitValue(IRProtocol protocol, uint64_t value, uint16_t nbits,
+                                              uint16_t carrierKHz, uint8_t dutyPercent) {
+    const ProtocolDescriptor* descriptor = findDescriptor(protocol);
+    if (!descriptor) {
+        TransmitResult result;
+        result.success = false;
+        result.errorMessage = "Unsupported protocol";
+        return result;
+    }
+    return renderAndQueue(*descriptor, value, nbits, carrierKHz, dutyPercent);
+}
+
+TransmitResult RmtIRTransmitter::transmitState(AcProtocol protocol, const uint8_t* state, uint16_t length,
+                                              uint16_t carrierKHz, uint8_t dutyPercent) {
+    TransmitResult result;
+    result.success = false;
+    
+    const AcStateDescriptor* descriptor = findAcDescriptor(protocol);
+    if (!descriptor) {
+        result.errorMessage = "Unsupported protocol";
+        return result;
+    }
+    if (!state || length != acStateBytes(*descriptor)) {
+        result.errorMessage = "Invalid state length";
+        return result;
+    }
+    
+    // The previous stream may still be reading stateFrame
+    if (!channel->waitDone(kBusyTimeoutMs)) {
+        result.errorMessage = "Transmitter busy";
+        return result;
+    }
+    
+    memcpy(stateFrame, state, length);
+    applyAcChecksum(*descriptor, stateFrame);
+    if (!stateStream.begin(*descriptor, stateFrame)) {
+        result.errorMessage = "Encoding failed";
+        return result;
+    }
+    
+    const uint16_t frequency = carrierKHz ? carrierKHz : descriptor->carrierKHz;
+    const uint8_t duty = dutyPercent ? dutyPercent : descriptor->dutyPercent;
+    if (!channel->setCarrier((uint32_t)frequency * 1000, duty) ||
+        !channel->writeStream(&stateStream)) {
+        result.errorMessage = "RMT write failed";
+        return result;
+    }
+    
+    result.success = true;
+    result.errorMessage = "";
+    return result;
+}
+
+TransmitResult RmtIRTransmitter::renderAndQueue(const ProtocolDescriptor& descriptor, uint64_t value, uint16_t nbits,
+                                               uint16_t carrierKHz, uint8_t dutyPercent) {
+    TransmitResult result;
+    const IRProtocol protocol = descriptor.protocol;
+    const uint8_t duty = dutyPercent ? dutyPercent : descriptor.dutyPercent;
+    
+    // Toggle-bit protocols render differently on every press, so only
+    // the others are cached
+    const bool cacheable = cache && descriptor.toggleBit == PROTOCOL_NO_BIT;
+    
+    // Repeat press: the rendered frame (repeats included) is ready to emit
+    if (cacheable) {
+        uint16_t cachedLength = 0;
+        uint16_t cachedFrequency = 0;
+        const uint16_t* cached = cache->lookup(protocol, value, nbits, &cachedLength, &cachedFrequency);
+        if (cached) {
+            return queue(cached, cachedLength, carrierKHz ? carrierKHz : cachedFrequency, duty);
+        }
+    }
+    
+    // Render straight into the scratch buffer, no allocation per press
+    uint16_t frameLength = encoder->encodeValue(protocol, value, nbits, TimingSpan(timings, kMaxTimings));
+    if (frameLength == 0) {
+        result.success = false;
+        result.errorMessage = "Encoding failed";
+        return result;
+    }
+    if (frameLength > kMaxTimings) {
+        result.success = false;
+        result.errorMessage = "Frame too long";
+        return result;
+    }
+    
+    // Lay out the repeats after the first frame, padding each gap so
+    // frames start framePeriodUs apart
+    uint16_t length = frame_encoder::appendRepeats(descriptor, TimingSpan(timings, kMaxTimings), frameLength);
+    if (length == 0) {
+        result.success = false;
+        result.errorMessage = "Frame too long";
+        return result;
+    }
+    
+    // The cache keeps the protocol's own carrier; overrides apply per send
+    if (cacheable) {
+        cache->insert(protocol, value, nbits, timings, length, descriptor.carrierKHz);
+    }
+    
+    return queue(timings, length, carrierKHz ? carrierKHz : descriptor.carrierKHz, duty);
+}
+
+TransmitResult RmtIRTransmitter::queue(const uint16_t* frameTimings, uint16_t length, uint16_t frequency,
+                                      uint8_t dutyPercent) {
+    TransmitResult result;
+    
+    // The symbol buffer is still being read while a frame is on the air
+    if (!channel->waitDone(kBusyTimeoutMs)) {
+        result.success = false;
+        result.errorMessage = "Transmitter busy";
+        return result;
+    }
+    
+    size_t count = RmtSymbolEncoder::encode(frameTimings, length, symbols, kMaxSymbols);
+    if (count == 0) {
+        result.success = false;
+        result.errorMessage = "Frame too long";
+        return result;
+    }
+    
+    if (!channel->setCarrier((uint32_t)frequency * 1000, dutyPercent) ||
+        !channel->write(symbols, count)) {
+        result.success = false;
+        result.errorMessage = "RMT write failed";
+        return result;
+    }
+    
+    result.success = true;
+    result.errorMessage = "";
+    return result;
+}
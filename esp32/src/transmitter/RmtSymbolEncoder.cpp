@@ -0,0 +1,63 @@
+#include "transmitter/RmtSymbolEncoder.h"
+
+// Timings longer than one symbol half are split into several halves
+// at the same level
+static uint16_t halvesFor(uint16_t duration) {
+    if (duration == 0) {
+        return 0;
+    }
+    return (duration + RMT_MAX_SYMBOL_DURATION - 1) / RMT_MAX_SYMBOL_DURATION;
+}
+
+size_t RmtSymbolEncoder::symbolCount(const uint16_t* timings, uint16_t length) {
+    if (!timings) {
+        return 0;
+    }
+    
+    size_t halves = 0;
+    for (uint16_t i = 0; i < length; i++) {
+        halves += halvesFor(timings[i]);
+    }
+    
+    return (halves + 1) / 2;
+}
+
+size_t RmtSymbolEncoder::encode(const uint16_t* timings, uint16_t length, RmtSymbol* symbols, size_t capacity) {
+    size_t needed = symbolCount(timings, length);
+    if (needed == 0 || !symbols || needed > capacity) {
+        return 0;
+    }
+    
+    size_t count = 0;
+    bool firstHalf = true;
+    
+    for (uint16_t i = 0; i < length; i++) {
+        uint32_t level = (i % 2 == 0) ? 1 : 0;  // Even entries are marks
+        uint32_t remaining = timings[i];
+        
+        while (remaining > 0) {
+            uint32_t duration = remaining > RMT_MAX_SYMBOL_DURATION ? RMT_MAX_SYMBOL_DURATION : remaining;
+            remaining -= duration;
+            
+            if (firstHalf) {
+                symbols[count].duration0 = duration;
+                symbols[count].level0 = level;
+                symbols[count].duration1 = 0;
+                symbols[count].level1 = 0;
+            } else {
+                symbols[count].duration1 = duration;
+                symbols[count].level1 = level;
+                count++;
+            }
+            firstHalf = !firstHalf;
+        }
+    }
+    
+    // Odd half count: last symbol keeps a zero-length second half,
+    // which the RMT treats as the end marker
+    if (!firstHalf) {
+        count++;
+    }
+    
+    return count;
+}
@@ -0,0 +1,188 @@
+#include "transmitter/TransmitQueue.h"
+#include <cstring>
+
+TransmitQueue::TransmitQueue(IIRTransmitter* transmitter, HoldRepeater* repeater, MicrosClock clock,
+                             CommandLatency* latency)
+    : transmitter(transmitter),
+      repeater(repeater),
+      clock(clock),
+      latency(latency),
+      submitted(0),
+      dropped(0),
+      maxDepth(0),
+      completed(0),
+      failed(0),
+      lastWaitUs(0),
+      maxWaitUs(0),
+      totalWaitUs(0),
+      burstFrames(0),
+      busyUs(0),
+      bursting(false),
+      burstRemaining(0),
+      burstPeriodUs(0),
+      burstNextUs(0) {
+    for (uint8_t i = 0; i < kRawSlots; i++) {
+        rawSlots[i].length = 0;
+        rawSlots[i].busy.store(false, std::memory_order_relaxed);
+    }
+}
+
+bool TransmitQueue::submit(const TransmitRequest& request) {
+    TransmitRequest queued = request;
+    queued.enqueuedUs = (uint32_t)clock();
+    if (!ring.push(queued)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    submitted.fetch_add(1, std::memory_order_relaxed);
+    uint32_t depth = ring.size();
+    if (depth > maxDepth.load(std::memory_order_relaxed)) {
+        maxDepth.store(depth, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool TransmitQueue::submitRaw(const TransmitRequest& request, const uint16_t* timings, uint16_t length) {
+    RawSlot* slot = nullptr;
+    uint8_t index = 0;
+    for (; index < kRawSlots; index++) {
+        if (!rawSlots[index].busy.load(std::memory_order_acquire)) {
+            slot = &rawSlots[index];
+            break;
+        }
+    }
+    if (!slot || !timings || length == 0 || length > raw_timing::kMaxTimings) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    memcpy(slot->timings, timings, length * sizeof(uint16_t));
+    slot->length = length;
+    slot->busy.store(true, std::memory_order_release);
+    
+    TransmitRequest queued = request;
+    queued.action = TransmitAction::RAW;
+    queued.rawSlot = index;
+    if (!submit(queued)) {
+        slot->busy.store(false, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+void TransmitQueue::runBurst(uint64_t nowUs) {
+    if (!bursting || nowUs < burstNextUs) {
+        return;
+    }
+    
+    // The last frame's period has passed: later requests may go out
+    if (burstRemaining == 0) {
+        bursting = false;
+        return;
+    }
+    
+    transmitter->transmitValue(burst.protocol, burst.value, burst.bits, burst.carrierKHz, burst.dutyPercent);
+    burstFrames.fetch_add(1, std::memory_order_relaxed);
+    busyUs.fetch_add(clock() - nowUs, std::memory_order_relaxed);
+    burstRemaining--;
+    burstNextUs += burstPeriodUs;
+    
+    // Fell behind (a long stall): restart the cadence instead of bunching
+    if (burstNextUs < nowUs) {
+        burstNextUs = nowUs + burstPeriodUs;
+    }
+}
+
+uint32_t TransmitQueue::service() {
+    runBurst(clock());
+    
+    TransmitRequest request;
+    while (!bursting && ring.pop(&request)) {
+        const uint64_t now = clock();
+        const uint32_t nowUs = (uint32_t)now;
+        
+        // Releases emit nothing and are not counted as transmissions
+        if (request.action == TransmitAction::RELEASE) {
+            repeater->release();
+            continue;
+        }
+        
+        uint32_t wait = nowUs - request.enqueuedUs;
+        lastWaitUs.store(wait, std::memory_order_relaxed);
+        if (wait > maxWaitUs.load(std::memory_order_relaxed)) {
+            maxWaitUs.store(wait, std::memory_order_relaxed);
+        }
+        totalWaitUs.fetch_add(wait, std::memory_order_relaxed);
+        
+        bool success;
+        if (request.action == TransmitAction::RAW) {
+            RawSlot& slot = rawSlots[request.rawSlot];
+            success = transmitter->transmit(slot.timings, slot.length,
+                                            request.carrierKHz ? request.carrierKHz : IR_DEFAULT_CARRIER_KHZ,
+                                            request.dutyPercent ? request.dutyPercent : IR_DEFAULT_DUTY_PERCENT)
+                          .success;
+            slot.busy.store(false, std::memory_order_release);
+        } else if (request.action == TransmitAction::STATE) {
+            success = transmitter->transmitState(request.acProtocol, request.state, request.stateLength,
+                                                 request.carrierKHz, request.dutyPercent).success;
+        } else if (request.action == TransmitAction::PRESS) {
+            success = repeater->press(request.protocol, request.value, request.bits, (uint32_t)(now / 1000),
+                                      request.carrierKHz, request.dutyPercent).success;
+        } else {
+            success = transmitter->transmitValue(request.protocol, request.value, request.bits, request.carrierKHz,
+                                                 request.dutyPercent).success;
+        }
+        
+        if (success && request.action == TransmitAction::SEND && request.count > 1) {
+            const ProtocolDescriptor* descriptor = findDescriptor(request.protocol);
+            burst = request;
+            bursting = true;
+            burstRemaining = request.count - 1;
+            burstPeriodUs = descriptor && descriptor->framePeriodUs ? descriptor->framePeriodUs : kDefaultFramePeriodUs;
+            burstNextUs = now + burstPeriodUs;
+        }
+        
+        const uint64_t end = clock();
+        busyUs.fetch_add(end - now, std::memory_order_relaxed);
+        if (latency) {
+            request.timestamps.txStartUs = nowUs;
+            request.timestamps.txEndUs = (uint32_t)end;
+            latency->record(request.timestamps);
+        }
+        if (success) {
+            completed.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            failed.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    
+    const uint64_t now = clock();
+    const uint32_t nowMs = (uint32_t)(now / 1000);
+    repeater->update(nowMs);
+    
+    uint32_t sleepMs = repeater->msUntilNextRepeat(nowMs);
+    if (bursting) {
+        // Round up so the frame is due when the consumer wakes
+        uint32_t untilBurst = burstNextUs > now ? (uint32_t)((burstNextUs - now + 999) / 1000) : 0;
+        sleepMs = untilBurst < sleepMs ? untilBurst : sleepMs;
+    }
+    return sleepMs < kIdleWaitMs ? sleepMs : kIdleWaitMs;
+}
+
+TransmitQueueStats TransmitQueue::getStats() const {
+    TransmitQueueStats stats;
+    stats.submitted = submitted.load(std::memory_order_relaxed);
+    stats.dropped = dropped.load(std::memory_order_relaxed);
+    stats.completed = completed.load(std::memory_order_relaxed);
+    stats.failed = failed.load(std::memory_order_relaxed);
+    stats.depth = ring.size();
+    stats.maxDepth = maxDepth.load(std::memory_order_relaxed);
+    stats.lastWaitUs = lastWaitUs.load(std::memory_order_relaxed);
+    stats.maxWaitUs = maxWaitUs.load(std::memory_order_relaxed);
+    uint32_t executed = stats.completed + stats.failed;
+    stats.burstFrames = burstFrames.load(std::memory_order_relaxed);
+    stats.busyUs = busyUs.load(std::memory_order_relaxed);
+    stats.meanWaitUs = executed ? (uint32_t)(totalWaitUs.load(std::memory_order_relaxed) / executed) : 0;
+    return stats;
+}
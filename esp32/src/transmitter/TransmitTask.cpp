@@ -0,0 +1,42 @@
+#include "transmitter/TransmitTask.h"
+#include <esp_timer.h>
+
+TransmitTask::TransmitTask(TransmitQueue* queue)
+    : queue(queue), handle(nullptr) {
+}
+
+bool TransmitTask::begin(BaseType_t core, UBaseType_t priority) {
+    if (handle) {
+        return true;
+    }
+    return xTaskCreatePinnedToCore(run, "irTx", kStackSize, this, priority, &handle, core) == pdPASS;
+}
+
+bool TransmitTask::submit(const TransmitRequest& request) {
+    bool queued = queue->submit(request);
+    if (queued && handle) {
+        xTaskNotifyGive(handle);
+    }
+    return queued;
+}
+
+bool TransmitTask::submitRaw(const TransmitRequest& request, const uint16_t* timings, uint16_t length) {
+    bool queued = queue->submitRaw(request, timings, length);
+    if (queued && handle) {
+        xTaskNotifyGive(handle);
+    }
+    return queued;
+}
+
+void TransmitTask::run(void* arg) {
+    TransmitTask* self = static_cast<TransmitTask*>(arg);
+    for (;;) {
+        uint32_t sleepMs = self->queue->service();
+        // Woken early by submit(); otherwise by the next hold repeat
+        ulTaskNotifyTake(pdTRUE, sleepMs ? pdMS_TO_TICKS(sleepMs) : 1);
+    }
+}
+
+uint64_t TransmitTask::clockMicros() {
+    return (uint64_t)esp_timer_get_time();
+}
@@ -0,0 +1,185 @@
+#include "transmitter/WaveformCache.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#ifndef NATIVE_BUILD
+    #include <esp_heap_caps.h>
+#endif
+
+WaveformCache::WaveformCache(uint16_t capacity, uint16_t maxTimings)
+    : capacity(capacity < kNone ? capacity : kNone - 1),
+      maxTimings(maxTimings),
+      count(0),
+      head(kNone),
+      tail(kNone),
+      entries(nullptr),
+      slab(nullptr),
+      hits(0),
+      misses(0),
+      evictions(0)
+{
+}
+
+WaveformCache::~WaveformCache() {
+    free(entries);
+    free(slab);
+}
+
+bool WaveformCache::begin() {
+    if (slab) {
+        return true;
+    }
+    if (capacity == 0 || maxTimings == 0) {
+        return false;  // malloc(0) may return non-null: nothing to hold
+    }
+    
+    size_t slabBytes = (size_t)capacity * maxTimings * sizeof(uint16_t);
+    
+#ifndef NATIVE_BUILD
+    // Timing data is bulky and only read per press: keep it in PSRAM
+    slab = (uint16_t*)heap_caps_malloc(slabBytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!slab) {
+        slab = (uint16_t*)malloc(slabBytes);
+    }
+#else
+    slab = (uint16_t*)malloc(slabBytes);
+#endif
+    entries = (Entry*)calloc(capacity, sizeof(Entry));
+    
+    if (!slab || !entries) {
+        free(slab);
+        free(entries);
+        slab = nullptr;
+        entries = nullptr;
+        return false;
+    }
+    
+    clear();
+    return true;
+}
+
+const uint16_t* WaveformCache::lookup(IRProtocol protocol, uint64_t value, uint16_t bits,
+                                      uint16_t* length, uint16_t* frequency) {
+    if (!slab) {
+        misses++;
+        return nullptr;
+    }
+    
+    int32_t index = find(hashKey(protocol, value, bits), protocol, value, bits);
+    if (index < 0) {
+        misses++;
+        return nullptr;
+    }
+    
+    hits++;
+    
+    // Move to front so it survives eviction longest
+    if ((uint16_t)index != head) {
+        unlink(index);
+        pushFront(index);
+    }
+    
+    *length = entries[index].length;
+    *frequency = entries[index].frequency;
+    return slab + (size_t)index * maxTimings;
+}
+
+bool WaveformCache::insert(IRProtocol protocol, uint64_t value, uint16_t bits,
+                           const uint16_t* timings, uint16_t length, uint16_t frequency) {
+    if (!slab || !timings || length == 0 || length > maxTimings) {
+        return false;
+    }
+    
+    uint32_t hash = hashKey(protocol, value, bits);
+    int32_t index = find(hash, protocol, value, bits);
+    
+    if (index >= 0) {
+        // Refresh an existing entry in place
+        unlink(index);
+    } else if (count < capacity) {
+        index = count++;
+    } else {
+        // Evict the least recently used entry
+        index = tail;
+        unlink(index);
+        evictions++;
+    }
+    
+    Entry& entry = entries[index];
+    entry.hash = hash;
+    entry.value = value;
+    entry.bits = bits;
+    entry.length = length;
+    entry.frequency = frequency;
+    entry.protocol = protocol;
+    memcpy(slab + (size_t)index * maxTimings, timings, length * sizeof(uint16_t));
+    
+    pushFront(index);
+    return true;
+}
+
+void WaveformCache::clear() {
+    count = 0;
+    head = kNone;
+    tail = kNone;
+}
+
+uint32_t WaveformCache::hashKey(IRProtocol protocol, uint64_t value, uint16_t bits) {
+    // FNV-1a over the key fields
+    uint32_t hash = 2166136261u;
+    hash = (hash ^ (uint8_t)protocol) * 16777619u;
+    for (int i = 0; i < 8; i++) {
+        hash = (hash ^ (uint8_t)(value >> (i * 8))) * 16777619u;
+    }
+    hash = (hash ^ (uint8_t)bits) * 16777619u;
+    hash = (hash ^ (uint8_t)(bits >> 8)) * 16777619u;
+    return hash;
+}
+
+int32_t WaveformCache::find(uint32_t hash, IRProtocol protocol, uint64_t value, uint16_t bits) const {
+    // Capacity is a few dozen entries: a scan of the bookkeeping array
+    // is cheaper than maintaining a separate index
+    for (uint16_t i = 0; i < count; i++) {
+        const Entry& entry = entries[i];
+        if (entry.hash == hash && entry.value == value && entry.bits == bits &&
+            entry.protocol == protocol) {
+            return (int32_t)i;
+        }
+    }
+    return -1;
+}
+
+void WaveformCache::unlink(uint16_t index) {
+    Entry& entry = entries[index];
+    
+    if (entry.prev != kNone) {
+        entries[entry.prev].next = entry.next;
+    } else {
+        head = entry.next;
+    }
+    
+    if (entry.next != kNone) {
+        entries[entry.next].prev = entry.prev;
+    } else {
+        tail = entry.prev;
+    }
+    
+    entry.prev = kNone;
+    entry.next = kNone;
+}
+
+void WaveformCache::pushFront(uint16_t index) {
+    Entry& entry = entries[index];
+    entry.prev = kNone;
+    entry.next = head;
+    
+    if (head != kNone) {
+        entries[head].prev = index;
+    }
+    head = index;
+    
+    if (tail == kNone) {
+        tail = index;
+    }
+}
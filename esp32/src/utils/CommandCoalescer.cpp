@@ -0,0 +1,66 @@
+#include "utils/CommandCoalescer.h"
+
+CommandCoalescer::CommandCoalescer()
+    : open(false),
+      pending(0),
+      deadlineMs(0),
+      mergedCount(0),
+      runCount(0) {
+}
+
+bool CommandCoalescer::canMerge(const PendingCommand& cmd) {
+    return cmd.event == CommandEvent::TAP && !cmd.isRaw() && !cmd.isState() && !cmd.isScheduled() &&
+           cmd.protocolId != IRProtocol::UNKNOWN;
+}
+
+bool CommandCoalescer::sameCommand(const PendingCommand& a, const PendingCommand& b) {
+    return a.protocolId == b.protocolId && a.value == b.value && a.bits == b.bits && a.output == b.output &&
+           a.carrierKHz == b.carrierKHz && a.dutyPercent == b.dutyPercent;
+}
+
+void CommandCoalescer::offer(const PendingCommand& cmd, uint32_t nowMs, const CommandCallback& emit) {
+    // Wrap-safe comparison against millis()
+    if (open && sameCommand(cmd, run) && (int32_t)(nowMs - deadlineMs) < 0) {
+        pending++;
+        mergedCount++;
+        deadlineMs = nowMs + kWindowMs;
+        if (pending >= kMaxRepeat) {
+            flush(emit);
+            // Keep the run open: further taps start the next job
+            open = true;
+            deadlineMs = nowMs + kWindowMs;
+        }
+        return;
+    }
+    
+    flush(emit);
+    
+    // First tap of a run goes out immediately
+    run = cmd;
+    run.repeatCount = 1;
+    open = true;
+    pending = 0;
+    deadlineMs = nowMs + kWindowMs;
+    if (emit) {
+        emit(run);
+    }
+}
+
+void CommandCoalescer::update(uint32_t nowMs, const CommandCallback& emit) {
+    if (open && (int32_t)(nowMs - deadlineMs) >= 0) {
+        flush(emit);
+    }
+}
+
+void CommandCoalescer::flush(const CommandCallback& emit) {
+    if (open && pending > 0) {
+        PendingCommand job = run;
+        job.repeatCount = pending;
+        runCount++;
+        if (emit) {
+            emit(job);
+        }
+    }
+    open = false;
+    pending = 0;
+}
@@ -0,0 +1,56 @@
+#include "utils/CommandLatency.h"
+
+void CommandLatency::record(const CommandTimestamps& t) {
+    recordSpan(LatencyStage::STREAM_TO_HANDOFF, t.streamUs, t.handoffUs);
+    recordSpan(LatencyStage::HANDOFF_TO_DISPATCH, t.handoffUs, t.dispatchUs);
+    recordSpan(LatencyStage::DISPATCH_TO_TX_START, t.dispatchUs, t.txStartUs);
+    recordSpan(LatencyStage::TX_START_TO_END, t.txStartUs, t.txEndUs);
+    
+    // End to end from the earliest stamp available
+    uint32_t firstUs = t.streamUs ? t.streamUs : (t.handoffUs ? t.handoffUs : t.dispatchUs);
+    recordSpan(LatencyStage::TOTAL, firstUs, t.txEndUs);
+}
+
+void CommandLatency::reset() {
+    for (uint8_t i = 0; i < kStageCount; i++) {
+        histograms[i].reset();
+    }
+}
+
+const char* CommandLatency::stageName(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::STREAM_TO_HANDOFF: return "stream->handoff";
+        case LatencyStage::HANDOFF_TO_DISPATCH: return "handoff->dispatch";
+        case LatencyStage::DISPATCH_TO_TX_START: return "dispatch->txStart";
+        case LatencyStage::TX_START_TO_END: return "txStart->txEnd";
+        case LatencyStage::TOTAL: return "total";
+        default: return "?";
+    }
+}
+
+size_t CommandLatency::format(char* out, size_t size) const {
+    if (size == 0) {
+        return 0;
+    }
+    out[0] = '\0';
+    
+    size_t length = 0;
+    for (uint8_t i = 0; i < kStageCount; i++) {
+        size_t written = histograms[i].format(out + length, size - length, stageName(static_cast<LatencyStage>(i)));
+        if (length + written + 1 >= size) {
+            return size - 1;  // Truncated
+        }
+        length += written;
+        out[length++] = '\n';
+        out[length] = '\0';
+    }
+    return length;
+}
+
+void CommandLatency::recordSpan(LatencyStage stage, uint32_t fromUs, uint32_t toUs) {
+    if (fromUs == 0 || toUs == 0) {
+        return;
+    }
+    // Unsigned difference survives the 32-bit microsecond wrap (~71 min)
+    histograms[static_cast<uint8_t>(stage)].record(toUs - fromUs);
+}
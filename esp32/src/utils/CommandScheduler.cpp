@@ -0,0 +1,141 @@
+#include "utils/CommandScheduler.h"
+
+CommandScheduler::CommandScheduler(ITimerStore* store, uint32_t tickMs)
+    : wheel(tickMs),
+      store(store),
+      restored(false),
+      firedCount(0),
+      firedThrough(0),
+      tableDirty(false),
+      firedDirty(false),
+      written(false),
+      lastWriteMs(0) {
+}
+
+bool CommandScheduler::scheduleAt(const ScheduledCommand& command, uint32_t nowMs, uint32_t epochSec) {
+    if (!restored || epochSec < kMinValidEpoch) {
+        return false;
+    }
+    if (!arm(command, nowMs, epochSec)) {
+        return false;
+    }
+    tableDirty = true;
+    return true;
+}
+
+bool CommandScheduler::scheduleIn(const ScheduledCommand& command, uint32_t delaySec, uint32_t nowMs,
+                                  uint32_t epochSec) {
+    ScheduledCommand absolute = command;
+    absolute.dueEpoch = epochSec + delaySec;
+    return scheduleAt(absolute, nowMs, epochSec);
+}
+
+bool CommandScheduler::cancel(uint32_t id) {
+    uint8_t timer = find(id);
+    if (timer == TimerWheel::kNoTimer) {
+        return false;
+    }
+    wheel.cancel(timer);
+    tableDirty = true;
+    return true;
+}
+
+bool CommandScheduler::arm(const ScheduledCommand& command, uint32_t nowMs, uint32_t epochSec) {
+    uint32_t delaySec = command.dueEpoch > epochSec ? command.dueEpoch - epochSec : 0;
+    if (delaySec > kMaxDelaySec) {
+        return false;
+    }
+    
+    // Same id: the new time replaces the old one
+    uint8_t existing = find(command.id);
+    if (existing != TimerWheel::kNoTimer) {
+        wheel.cancel(existing);
+    }
+    
+    uint8_t timer = wheel.schedule(delaySec * 1000, nowMs);
+    if (timer == TimerWheel::kNoTimer) {
+        return false;
+    }
+    commands[timer] = command;
+    
+    // A time already passed fires at once; keep it above the fired-through
+    // mark so a reboot before then does not take it for fired
+    if (commands[timer].dueEpoch <= firedThrough) {
+        commands[timer].dueEpoch = firedThrough + 1;
+    }
+    return true;
+}
+
+uint8_t CommandScheduler::find(uint32_t id) const {
+    for (uint8_t i = 0; i < TimerWheel::kMaxTimers; i++) {
+        if (wheel.isArmed(i) && commands[i].id == id) {
+            return i;
+        }
+    }
+    return TimerWheel::kNoTimer;
+}
+
+void CommandScheduler::flush(uint32_t nowMs) {
+    if (!store || !(tableDirty || firedDirty) || (written && nowMs - lastWriteMs < kSaveIntervalMs)) {
+        return;
+    }
+    written = true;
+    lastWriteMs = nowMs;
+    
+    // A rewritten table no longer holds fired commands, so the mark can wait
+    if (tableDirty) {
+        ScheduledCommand armed[TimerWheel::kMaxTimers];
+        uint8_t count = 0;
+        for (uint8_t i = 0; i < TimerWheel::kMaxTimers; i++) {
+            if (wheel.isArmed(i)) {
+                armed[count++] = commands[i];
+            }
+        }
+        store->save(armed, count);
+        tableDirty = false;
+        firedDirty = false;
+    } else {
+        store->saveFiredThrough(firedThrough);
+        firedDirty = false;
+    }
+}
+
+void CommandScheduler::update(uint32_t nowMs, uint32_t epochSec, const ScheduledCallback& fire) {
+    if (!restored) {
+        if (epochSec < kMinValidEpoch) {
+            return;
+        }
+        
+        // First valid wall clock: re-arm what was stored before the
+        // reboot, dropping what already fired and anything too stale to
+        // still be wanted
+        wheel.reset(nowMs);
+        restored = true;
+        if (store) {
+            firedThrough = store->loadFiredThrough();
+            ScheduledCommand stored[TimerWheel::kMaxTimers];
+            uint8_t count = store->load(stored, TimerWheel::kMaxTimers);
+            uint8_t kept = 0;
+            for (uint8_t i = 0; i < count; i++) {
+                if (stored[i].dueEpoch > firedThrough && stored[i].dueEpoch + kMaxLateSec >= epochSec &&
+                    arm(stored[i], nowMs, epochSec)) {
+                    kept++;
+                }
+            }
+            tableDirty = kept != count;
+        }
+    }
+    
+    // The stored table still lists a fired one-shot; only the mark moves
+    wheel.advance(nowMs, [&](uint8_t timer) {
+        firedCount++;
+        if (commands[timer].dueEpoch > firedThrough) {
+            firedThrough = commands[timer].dueEpoch;
+            firedDirty = true;
+        }
+        if (fire) {
+            fire(commands[timer]);
+        }
+    });
+    flush(nowMs);
+}
@@ -0,0 +1,38 @@
+#include "utils/CommandSequencer.h"
+
+CommandSequencer::CommandSequencer()
+    : next(0),
+      nextDueMs(0),
+      active(false) {
+}
+
+bool CommandSequencer::start(const CommandBatch& commands, uint32_t nowMs) {
+    if (active || commands.count == 0) {
+        return false;
+    }
+    
+    batch = commands;
+    next = 0;
+    nextDueMs = nowMs;
+    active = true;
+    return true;
+}
+
+bool CommandSequencer::update(uint32_t nowMs, const CommandCallback& dispatch) {
+    // Wrap-safe comparison against millis()
+    while (active && (int32_t)(nowMs - nextDueMs) >= 0) {
+        PendingCommand& cmd = batch.commands[next++];
+        if (dispatch) {
+            // Point RAW steps at this copy of the batch's timings
+            cmd.rawTimings = cmd.isRaw() ? batch.rawTimings + cmd.rawOffset : nullptr;
+            dispatch(cmd);
+        }
+        
+        if (next >= batch.count) {
+            active = false;
+            return true;
+        }
+        nextDueMs = nowMs + cmd.gapMs;
+    }
+    return false;
+}
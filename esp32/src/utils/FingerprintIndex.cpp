@@ -0,0 +1,122 @@
+#include "utils/FingerprintIndex.h"
+
+#include <cstdlib>
+
+#ifndef NATIVE_BUILD
+    #include <esp_heap_caps.h>
+#endif
+
+FingerprintIndex::FingerprintIndex(IFingerprintStore* store, uint32_t slots)
+    : store(store),
+      mask(0),
+      maxEntries(0),
+      count(0),
+      nextId(1),
+      longestProbe(0),
+      slots(nullptr)
+{
+    uint32_t size = 1;
+    while (size < slots) {
+        size <<= 1;
+    }
+    mask = size - 1;
+    maxEntries = size / 4 * 3;
+}
+
+FingerprintIndex::~FingerprintIndex() {
+    free(slots);
+}
+
+bool FingerprintIndex::begin() {
+    if (slots) {
+        return true;
+    }
+    
+    size_t bytes = getMemoryBytes();
+#ifndef NATIVE_BUILD
+    // Large and only probed once per capture: keep it in PSRAM
+    slots = (FingerprintEntry*)heap_caps_calloc(1, bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!slots) {
+        slots = (FingerprintEntry*)calloc(1, bytes);
+    }
+#else
+    slots = (FingerprintEntry*)calloc(1, bytes);
+#endif
+    if (!slots) {
+        return false;
+    }
+    
+    // Read back in chunks; ids continue after the highest stored one
+    FingerprintEntry chunk[32];
+    uint32_t offset = 0;
+    uint32_t read;
+    while (store && (read = store->load(offset, chunk, 32)) > 0) {
+        for (uint32_t i = 0; i < read && count < maxEntries; i++) {
+            if (chunk[i].fingerprint == 0 || find(chunk[i].fingerprint) != kNotFound) {
+                continue;
+            }
+            place(chunk[i]);
+            nextId = chunk[i].learnedId >= nextId ? chunk[i].learnedId + 1 : nextId;
+        }
+        offset += read;
+    }
+    return true;
+}
+
+uint32_t FingerprintIndex::slotFor(uint32_t fingerprint, uint32_t* probes) const {
+    // Fingerprints are already mixed: the low bits pick the slot
+    uint32_t slot = fingerprint & mask;
+    *probes = 1;
+    while (slots[slot].fingerprint != 0 && slots[slot].fingerprint != fingerprint) {
+        slot = (slot + 1) & mask;
+        (*probes)++;
+    }
+    return slot;
+}
+
+void FingerprintIndex::place(const FingerprintEntry& entry) {
+    uint32_t probes;
+    slots[slotFor(entry.fingerprint, &probes)] = entry;
+    longestProbe = probes > longestProbe ? probes : longestProbe;
+    count++;
+}
+
+uint32_t FingerprintIndex::find(uint32_t fingerprint) const {
+    if (!slots || fingerprint == 0) {
+        return kNotFound;
+    }
+    uint32_t probes;
+    const FingerprintEntry& entry = slots[slotFor(fingerprint, &probes)];
+    return entry.fingerprint == fingerprint ? entry.learnedId : kNotFound;
+}
+
+uint32_t FingerprintIndex::learn(uint32_t fingerprint, bool* isNew) {
+    *isNew = false;
+    uint32_t id = find(fingerprint);
+    if (id != kNotFound || !slots || fingerprint == 0 || count >= maxEntries) {
+        return id;
+    }
+    
+    FingerprintEntry entry = {fingerprint, nextId};
+    if (store && !store->append(entry)) {
+        return kNotFound;  // Not remembered after a reboot: do not hand out the id
+    }
+    place(entry);
+    nextId++;
+    *isNew = true;
+    return entry.learnedId;
+}
+
+void FingerprintIndex::clear() {
+    if (slots) {
+        for (uint32_t i = 0; i <= mask; i++) {
+            slots[i] = FingerprintEntry{0, 0};
+        }
+    }
+    if (store) {
+        store->clear();
+    }
+    count = 0;
+    nextId = 1;
+    longestProbe = 0;
+}
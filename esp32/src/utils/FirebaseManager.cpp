@@ -1,4 +1,9 @@
 #include "utils/FirebaseManager.h"
+#include "receiver/ProtocolInference.h"
+#include "receiver/SignalFingerprint.h"
+#include "transmitter/ProntoCodec.h"
+#include "transmitter/FrameEncoder.h"
+#include <esp_timer.h>
 
 // Static singleton reference for stream callbacks
 FirebaseManager* FirebaseManager::instance = nullptr;
@@ -25,10 +30,12 @@ FirebaseManager::FirebaseManager(
     streamStarted(false),
     pendingLearningChange(false),
     pendingLearningState(false),
-    pendingCommandReceived(false),
+    droppedBatches(0),
+    deletePending(false),
     lastLearningState(false),
     learningStateCallback(nullptr),
-    commandCallback(nullptr)
+    commandCallback(nullptr),
+    macroCallback(nullptr)
 {
     instance = this;
 }
@@ -109,21 +116,46 @@ void FirebaseManager::update() {
         }
     }
     
-    if (pendingCommandReceived) {
-        pendingCommandReceived = false;
-        
-        Serial.print("[RTDB] Command received: ");
-        Serial.print(pendingCmd.protocol);
-        Serial.print(" value=0x");
-        Serial.print((unsigned long)pendingCmd.value, HEX);
-        Serial.print(" bits=");
-        Serial.println(pendingCmd.bits);
+    const uint32_t nowMs = millis();
+    CommandCallback send = [this](const PendingCommand& cmd) { handOff(cmd); };
+    
+    // Commands play in arrival order. Single taps go through the
+    // coalescer; anything else closes the open run first, and a batch
+    // that arrives while another is playing waits for it to finish.
+    while (!sequencer.isActive() && incomingBatches.pop(&nextBatch)) {
+        deletePending = true;
+        if (nextBatch.macroAction == MacroAction::NONE && nextBatch.count == 1 &&
+            CommandCoalescer::canMerge(nextBatch.commands[0])) {
+            coalescer.offer(nextBatch.commands[0], nowMs, send);
+            continue;
+        }
+        coalescer.flush(send);
         
-        if (commandCallback) {
-            commandCallback(pendingCmd);
+        // Macros are compiled, stored and played by the callback's owner
+        if (nextBatch.macroAction != MacroAction::NONE) {
+            if (macroCallback) {
+                macroCallback(nextBatch.macroAction, nextBatch.macroId, nextBatch);
+            }
+            continue;
         }
         
-        // Clear pendingCommand from RTDB so it doesn't re-trigger on reconnect
+        Serial.print("[RTDB] Command received: ");
+        Serial.print(nextBatch.count);
+        Serial.println(nextBatch.count == 1 ? " step" : " steps");
+        
+        sequencer.start(nextBatch, nowMs);
+    }
+    
+    coalescer.update(nowMs, send);
+    if (sequencer.isActive()) {
+        sequencer.update(nowMs, send);
+    }
+    
+    // Clear pendingCommand from RTDB so it doesn't re-trigger on reconnect.
+    // The delete is a blocking round trip, so it waits until everything
+    // received so far has played: a run of taps costs one.
+    if (deletePending && !sequencer.isActive() && !coalescer.isOpen() && incomingBatches.empty()) {
+        deletePending = false;
         String cmdPath = getRtdbDevicePath() + "/pendingCommand";
         Firebase.RTDB.deleteNode(&fbdo, cmdPath.c_str());
     }
@@ -153,6 +185,7 @@ bool FirebaseManager::beginDeviceStream() {
 
 void FirebaseManager::onStreamData(FirebaseStream data) {
     if (!instance) return;
+    uint32_t streamUs = (uint32_t)esp_timer_get_time();
     
     String path = data.dataPath();
     
@@ -163,13 +196,9 @@ void FirebaseManager::onStreamData(FirebaseStream data) {
         // Command dispatch — parse the command object
         if (data.dataType() == "json") {
             FirebaseJson json = data.jsonObject();
-            FirebaseJsonData result;
-            
-            if (json.get(result, "protocol")) instance->pendingCmd.protocol = result.stringValue;
-            if (json.get(result, "value")) instance->pendingCmd.value = strtoull(result.stringValue.c_str(), nullptr, 10);
-            if (json.get(result, "bits")) instance->pendingCmd.bits = result.intValue;
-            
-            instance->pendingCommandReceived = true;
+            if (parsePendingCommand(json, &instance->streamBatch)) {
+                instance->queueBatch(streamUs);
+            }
         }
     } else if (path == "/") {
         // Initial stream event sends the entire node — parse children
@@ -186,13 +215,207 @@ void FirebaseManager::onStreamData(FirebaseStream data) {
         if (json.get(cmdData, "pendingCommand") && cmdData.type == "object") {
             FirebaseJson cmdJson;
             cmdJson.setJsonData(cmdData.stringValue);
-            FirebaseJsonData r;
-            if (cmdJson.get(r, "protocol")) instance->pendingCmd.protocol = r.stringValue;
-            if (cmdJson.get(r, "value")) instance->pendingCmd.value = strtoull(r.stringValue.c_str(), nullptr, 10);
-            if (cmdJson.get(r, "bits")) instance->pendingCmd.bits = r.intValue;
-            instance->pendingCommandReceived = true;
+            if (parsePendingCommand(cmdJson, &instance->streamBatch)) {
+                instance->queueBatch(streamUs);
+            }
+        }
+    }
+}
+
+bool FirebaseManager::parsePendingCommand(FirebaseJson& json, CommandBatch* batch) {
+    batch->count = 0;
+    batch->rawUsed = 0;
+    batch->macroAction = MacroAction::NONE;
+    batch->macroId = 0;
+    
+    // Stored macros: {macro: id} plays one, {deleteMacro: id} drops it, and
+    // {defineMacro: id, commands: [...]} stores the batch instead of sending
+    FirebaseJsonData result;
+    if (json.get(result, "macro")) {
+        batch->macroAction = MacroAction::RUN;
+        batch->macroId = (uint32_t)result.intValue;
+        return true;
+    }
+    if (json.get(result, "deleteMacro")) {
+        batch->macroAction = MacroAction::REMOVE;
+        batch->macroId = (uint32_t)result.intValue;
+        return true;
+    }
+    if (json.get(result, "defineMacro")) {
+        batch->macroAction = MacroAction::DEFINE;
+        batch->macroId = (uint32_t)result.intValue;
+    }
+    
+    // Batched form: {commands: [{protocol, value, bits, gapMs}, ...], timestamp}
+    // A missing element ends the array; an invalid one rejects the whole
+    // batch, as a scene with a step left out is not the scene asked for
+    if (json.get(result, "commands") && result.type == "array") {
+        for (uint8_t i = 0; i < CommandBatch::kMaxCommands; i++) {
+            String element = String("commands/[") + i + "]";
+            if (!json.get(result, element)) {
+                break;
+            }
+            if (!parseCommand(json, element + "/", batch, &batch->commands[i])) {
+                Serial.print("[RTDB] Invalid command ");
+                Serial.print(i);
+                Serial.println(" - batch rejected");
+                batch->count = 0;
+                batch->rawUsed = 0;
+                return false;
+            }
+            batch->count++;
+        }
+        if (json.get(result, String("commands/[") + CommandBatch::kMaxCommands + "]")) {
+            Serial.print("[RTDB] Command batch truncated to ");
+            Serial.println(CommandBatch::kMaxCommands);
+        }
+        return batch->count > 0;
+    }
+    
+    // Single form: {protocol, value, bits, timestamp}
+    if (parseCommand(json, "", batch, &batch->commands[0])) {
+        batch->count = 1;
+    }
+    return batch->count > 0;
+}
+
+void FirebaseManager::queueBatch(uint32_t streamUs) {
+    stampStreamTime(&streamBatch, streamUs);
+    if (!incomingBatches.push(streamBatch)) {
+        droppedBatches = droppedBatches + 1;
+        Serial.println("[RTDB] Command backlog full - dropped");
+    }
+}
+
+void FirebaseManager::stampStreamTime(CommandBatch* batch, uint32_t streamUs) {
+    for (uint8_t i = 0; i < batch->count; i++) {
+        batch->commands[i].timestamps = CommandTimestamps();
+        batch->commands[i].timestamps.streamUs = streamUs;
+    }
+}
+
+void FirebaseManager::handOff(const PendingCommand& cmd) {
+    if (!commandCallback) {
+        return;
+    }
+    PendingCommand stamped = cmd;
+    stamped.timestamps.handoffUs = (uint32_t)esp_timer_get_time();
+    commandCallback(stamped);
+}
+
+bool FirebaseManager::parseCommand(FirebaseJson& json, const String& prefix, CommandBatch* batch,
+                                   PendingCommand* cmd) {
+    FirebaseJsonData result;
+    *cmd = PendingCommand();
+    
+    cmd->event = CommandEvent::TAP;
+    if (json.get(result, prefix + "event")) {
+        if (result.stringValue == "press") cmd->event = CommandEvent::PRESS;
+        else if (result.stringValue == "release") cmd->event = CommandEvent::RELEASE;
+        else if (result.stringValue == "cancel") cmd->event = CommandEvent::CANCEL;
+    }
+    cmd->scheduleId = json.get(result, prefix + "scheduleId") ? (uint32_t)result.intValue : 0;
+    cmd->atEpoch = json.get(result, prefix + "at") ? (uint32_t)result.intValue : 0;
+    cmd->delaySec = json.get(result, prefix + "delaySec") ? (uint32_t)result.intValue : 0;
+    
+    // A release or cancel needs no command: it ends whatever is held or
+    // drops the schedule named by scheduleId. A Pronto code is its own.
+    bool hasProtocol = json.get(result, prefix + "protocol");
+    cmd->protocol = hasProtocol ? result.stringValue : String("");
+    bool hasPronto = json.get(result, prefix + "pronto");
+    if (!hasProtocol && !hasPronto && cmd->event != CommandEvent::RELEASE && cmd->event != CommandEvent::CANCEL) {
+        return false;
+    }
+    if (!hasProtocol && hasPronto) {
+        cmd->protocol = "PRONTO";
+    }
+    cmd->protocolId = protocolFromName(cmd->protocol.c_str());
+    cmd->value = json.get(result, prefix + "value") ? strtoull(result.stringValue.c_str(), nullptr, 10) : 0;
+    cmd->bits = json.get(result, prefix + "bits") ? result.intValue : 0;
+    cmd->gapMs = json.get(result, prefix + "gapMs") ? result.intValue : 0;
+    cmd->output = json.get(result, prefix + "output") ? result.intValue : 0;
+    
+    // Carrier of the learned command, when its device wants other than
+    // the protocol's own; values out of range fall back to that
+    uint32_t carrier = json.get(result, prefix + "frequency") ? (uint32_t)result.intValue : 0;
+    uint32_t duty = json.get(result, prefix + "duty") ? (uint32_t)result.intValue : 0;
+    cmd->carrierKHz = carrier >= IR_MIN_CARRIER_KHZ && carrier <= IR_MAX_CARRIER_KHZ ? carrier : 0;
+    cmd->dutyPercent = duty > 0 && duty < 100 ? duty : 0;
+    
+    // RAW: {protocol: "RAW", raw: "<packed timings>", frequency: kHz},
+    // decoded straight into the batch's shared timing buffer
+    if (json.get(result, prefix + "raw")) {
+        uint16_t length = raw_timing::decode(result.stringValue.c_str(), batch->rawTimings + batch->rawUsed,
+                                             raw_timing::kMaxTimings - batch->rawUsed);
+        if (length == 0) {
+            Serial.println("[RTDB] Invalid or oversized raw timings");
+            return false;
+        }
+        cmd->rawOffset = batch->rawUsed;
+        cmd->rawLength = length;
+        batch->rawUsed += length;
+    }
+    
+    // Inferred coding: {protocol: "RAW", params: "PD 9000 4500 ...", value, bits},
+    // encoded by the generic frame engine into the batch's timing buffer
+    if (json.get(result, prefix + "params")) {
+        ProtocolDescriptor descriptor;
+        uint16_t capacity = raw_timing::kMaxTimings - batch->rawUsed;
+        uint16_t length = protocol_inference::parseParams(result.stringValue.c_str(), &descriptor)
+            ? frame_encoder::encodeFrame(descriptor, cmd->value, cmd->bits,
+                                         TimingSpan(batch->rawTimings + batch->rawUsed, capacity))
+            : 0;
+        if (length == 0 || length > capacity) {
+            Serial.println("[RTDB] Invalid or oversized params");
+            return false;
+        }
+        cmd->rawOffset = batch->rawUsed;
+        cmd->rawLength = length;
+        batch->rawUsed += length;
+    }
+    
+    // Pronto: {pronto: "0000 006D ..."}, sent as RAW on the code's own
+    // carrier. A tap sends the once sequence, or the repeat sequence when
+    // there is none; its last space is only the gap before another frame.
+    if (hasPronto && json.get(result, prefix + "pronto")) {
+        pronto::Code code;
+        uint16_t length = pronto::decode(result.stringValue.c_str(), batch->rawTimings + batch->rawUsed,
+                                         raw_timing::kMaxTimings - batch->rawUsed, &code);
+        if (length == 0 || code.carrierKHz() < IR_MIN_CARRIER_KHZ || code.carrierKHz() > IR_MAX_CARRIER_KHZ) {
+            Serial.println("[RTDB] Invalid or oversized Pronto code");
+            return false;
+        }
+        cmd->rawOffset = batch->rawUsed;
+        cmd->rawLength = (code.onceLength ? code.onceLength : code.repeatLength) - 1;
+        cmd->carrierKHz = code.carrierKHz();
+        batch->rawUsed += cmd->rawLength;
+    }
+    
+    // A/C state: {protocol: "DAIKIN", state: "<hex bytes>"}
+    if (json.get(result, prefix + "state")) {
+        cmd->acProtocol = acProtocolFromName(cmd->protocol.c_str());
+        const AcStateDescriptor* descriptor = findAcDescriptor(cmd->acProtocol);
+        cmd->stateLength = parseHexBytes(result.stringValue.c_str(), cmd->state, AC_MAX_STATE_BYTES);
+        if (!descriptor || cmd->stateLength != acStateBytes(*descriptor)) {
+            Serial.println("[RTDB] Invalid A/C state");
+            return false;
         }
     }
+    return true;
+}
+
+uint8_t FirebaseManager::parseHexBytes(const char* text, uint8_t* out, uint8_t capacity) {
+    uint8_t count = 0;
+    for (const char* p = text; p[0] && p[1]; p += 2) {
+        char pair[3] = {p[0], p[1], '\0'};
+        char* end = nullptr;
+        unsigned long byte = strtoul(pair, &end, 16);
+        if (end != pair + 2 || count >= capacity) {
+            return 0;
+        }
+        out[count++] = (uint8_t)byte;
+    }
+    return count;
 }
 
 void FirebaseManager::onStreamTimeout(bool timeout) {
@@ -275,7 +498,8 @@ bool FirebaseManager::startWiFiConnection() {
     return true;
 }
 
-bool FirebaseManager::uploadSignal(const DecodedSignal& signal, const String& commandName) {
+bool FirebaseManager::uploadSignal(const DecodedSignal& signal, const String& commandName,
+                                   uint32_t learnedId, bool alreadyLearned) {
     if (!isReady()) {
         Serial.println("[Firebase] Not ready - cannot upload signal");
         return false;
@@ -292,6 +516,73 @@ bool FirebaseManager::uploadSignal(const DecodedSignal& signal, const String& co
     content.set("fields/pendingSignal/mapValue/fields/value/stringValue", String(signal.value));
     content.set("fields/pendingSignal/mapValue/fields/bits/integerValue", String(signal.bits));
     content.set("fields/pendingSignal/mapValue/fields/isKnownProtocol/booleanValue", signal.isKnownProtocol);
+    content.set("fields/pendingSignal/mapValue/fields/confidence/integerValue", String(signal.confidence));
+    
+    // Same fingerprint = same button: a recapture names the command it
+    // already is rather than becoming a second copy
+    char fingerprint[9];
+    snprintf(fingerprint, sizeof(fingerprint), "%08lx", (unsigned long)signal_fingerprint::of(signal));
+    content.set("fields/pendingSignal/mapValue/fields/fingerprint/stringValue", fingerprint);
+    if (learnedId != 0) {
+        content.set("fields/pendingSignal/mapValue/fields/learnedId/integerValue", String(learnedId));
+        content.set("fields/pendingSignal/mapValue/fields/alreadyLearned/booleanValue", alreadyLearned);
+    }
+    
+    // The receiver only sees the demodulated envelope, so the carrier is
+    // the protocol's own. Stored with the command so it can be edited for
+    // devices that want another and sent back as an override.
+    const ProtocolDescriptor* descriptor = findDescriptor(protocolFromName(signal.protocol));
+    uint8_t carrierKHz = descriptor ? descriptor->carrierKHz : IR_DEFAULT_CARRIER_KHZ;
+    uint8_t dutyPercent = descriptor ? descriptor->dutyPercent : IR_DEFAULT_DUTY_PERCENT;
+    content.set("fields/pendingSignal/mapValue/fields/frequency/integerValue", String(carrierKHz));
+    content.set("fields/pendingSignal/mapValue/fields/duty/integerValue", String(dutyPercent));
+    
+    // Unknown protocols that a standard coding reproduces are sent as its
+    // parameters; a pendingCommand with the same params/value/bits replays
+    // them. The rest carry their timings in the same packed form a RAW
+    // pendingCommand takes, so the web app can send them back verbatim
+    // (when replayable, below).
+    // rawbuf is in kRawTick units and starts with the leading gap.
+    if (signal.isInferred) {
+        char params[protocol_inference::kMaxParamsLength];
+        if (protocol_inference::formatParams(signal.inferred, params, sizeof(params)) > 0) {
+            content.set("fields/pendingSignal/mapValue/fields/params/stringValue", params);
+        }
+    }
+    
+    // Sized to a whole pool block, so a long A/C capture is never cut
+    // short. A RAW or Pronto pendingCommand replays at most
+    // raw_timing::kMaxTimings, so a longer capture is marked replayable
+    // false and gets no packed raw to send back; its Pronto form is kept
+    // for other remotes and code libraries.
+    if (!signal.isKnownProtocol && signal.rawTimings.size() > 1) {
+        static const uint16_t kMaxUploadTimings = RawTimingPool::kBlockTimings - 1;
+        static uint16_t timings[kMaxUploadTimings];
+        static char packed[kMaxUploadTimings * 4 + 1];
+        uint16_t length = 0;
+        for (size_t i = 1; i < signal.rawTimings.size() && length < kMaxUploadTimings; i++) {
+            uint32_t us = (uint32_t)signal.rawTimings[i] * kRawTick;
+            timings[length++] = us > 0xFFFF ? 0xFFFF : (uint16_t)us;
+        }
+        const bool replayable = signal.isInferred || length <= raw_timing::kMaxTimings;
+        content.set("fields/pendingSignal/mapValue/fields/rawLength/integerValue", String(length));
+        content.set("fields/pendingSignal/mapValue/fields/replayable/booleanValue", replayable);
+        if (!replayable) {
+            Serial.print("[Firebase] RAW capture of ");
+            Serial.print(length);
+            Serial.print(" timings is longer than a RAW command replays (");
+            Serial.print(raw_timing::kMaxTimings);
+            Serial.println("); uploaded as not replayable");
+        } else if (!signal.isInferred && raw_timing::encode(timings, length, packed, sizeof(packed)) > 0) {
+            content.set("fields/pendingSignal/mapValue/fields/raw/stringValue", packed);
+        }
+        
+        // Also as Pronto hex, for sharing with other remotes and code libraries
+        static char prontoText[(4 + kMaxUploadTimings) * 5];
+        if (pronto::encode(timings, length, 0, IR_DEFAULT_CARRIER_KHZ, prontoText, sizeof(prontoText)) > 0) {
+            content.set("fields/pendingSignal/mapValue/fields/pronto/stringValue", prontoText);
+        }
+    }
     
     // Use ISO 8601 timestamp format (required by Firestore REST API)
     time_t now = time(nullptr);
@@ -314,6 +605,53 @@ bool FirebaseManager::uploadSignal(const DecodedSignal& signal, const String& co
     }
 }
 
+bool FirebaseManager::uploadSniffedEvents(const SniffBatch& batch, const SnifferStats& stats) {
+    if (!isReady()) {
+        return false;
+    }
+    
+    // Events carry millis(); convert to wall time from the current offset
+    time_t now = time(nullptr);
+    uint32_t nowMs = millis();
+    char timestamp[30];
+    
+    FirebaseJson content;
+    for (uint8_t i = 0; i < batch.size(); i++) {
+        const SniffEvent& event = batch[i];
+        String prefix = String("fields/events/arrayValue/values/[") + i + "]/mapValue/fields/";
+        char fingerprint[9];
+        snprintf(fingerprint, sizeof(fingerprint), "%08lx", (unsigned long)event.frame.fingerprint);
+        time_t at = now - (time_t)((nowMs - event.frame.atMs) / 1000);
+        strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&at));
+        
+        content.set(prefix + "protocol/stringValue", event.frame.protocol);
+        content.set(prefix + "value/stringValue", String(event.frame.value));
+        content.set(prefix + "bits/integerValue", String(event.frame.bits));
+        content.set(prefix + "fingerprint/stringValue", fingerprint);
+        content.set(prefix + "learnedId/integerValue", String(event.learnedId));
+        content.set(prefix + "frames/integerValue", String(event.frames));
+        content.set(prefix + "heldMs/integerValue", String(event.lastMs - event.frame.atMs));
+        content.set(prefix + "at/timestampValue", timestamp);
+    }
+    content.set("fields/overruns/integerValue", String(stats.overruns));
+    content.set("fields/meanFrameUs/integerValue", String(stats.meanFrameUs));
+    content.set("fields/maxFrameUs/integerValue", String(stats.maxFrameUs));
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    content.set("fields/uploadedAt/timestampValue", timestamp);
+    
+    String collectionPath = getSniffedPath();
+    if (Firebase.Firestore.createDocument(&fbdo, projectId, "", collectionPath.c_str(), content.raw())) {
+        Serial.print("[Firebase] Uploaded ");
+        Serial.print(batch.size());
+        Serial.println(" sniffed presses");
+        return true;
+    } else {
+        Serial.print("[Firebase] Sniffed upload failed: ");
+        Serial.println(fbdo.errorReason());
+        return false;
+    }
+}
+
 bool FirebaseManager::setLearningMode(bool isLearning) {
     if (!isReady()) {
         Serial.println("[Firebase] Not ready - cannot set learning mode");
@@ -347,6 +685,10 @@ String FirebaseManager::getCommandsPath() const {
     return getDevicePath() + "/commands";
 }
 
+String FirebaseManager::getSniffedPath() const {
+    return getDevicePath() + "/sniffed";
+}
+
 String FirebaseManager::getRtdbDevicePath() const {
     return String("/devices/") + deviceId;
 }
@@ -0,0 +1,95 @@
+#include "utils/LatencyHistogram.h"
+
+#include <cstdio>
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::record(uint32_t us) {
+    uint8_t bucket = bucketFor(us);
+    buckets[bucket].store(buckets[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    
+    if (us < minUs.load(std::memory_order_relaxed)) {
+        minUs.store(us, std::memory_order_relaxed);
+    }
+    if (us > maxUs.load(std::memory_order_relaxed)) {
+        maxUs.store(us, std::memory_order_relaxed);
+    }
+    totalUs.store(totalUs.load(std::memory_order_relaxed) + us, std::memory_order_relaxed);
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::reset() {
+    for (uint8_t i = 0; i < kBucketCount; i++) {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    minUs.store(UINT32_MAX, std::memory_order_relaxed);
+    maxUs.store(0, std::memory_order_relaxed);
+    totalUs.store(0, std::memory_order_relaxed);
+}
+
+uint32_t LatencyHistogram::getMinUs() const {
+    return getCount() ? minUs.load(std::memory_order_relaxed) : 0;
+}
+
+uint32_t LatencyHistogram::getMeanUs() const {
+    uint32_t samples = getCount();
+    return samples ? (uint32_t)(totalUs.load(std::memory_order_relaxed) / samples) : 0;
+}
+
+uint32_t LatencyHistogram::getBucket(uint8_t bucket) const {
+    return bucket < kBucketCount ? buckets[bucket].load(std::memory_order_relaxed) : 0;
+}
+
+uint32_t LatencyHistogram::percentileUs(uint8_t percentile) const {
+    uint32_t samples = getCount();
+    if (samples == 0) {
+        return 0;
+    }
+    
+    // Rank of the sample at this percentile (1-based, rounded up)
+    uint64_t rank = ((uint64_t)samples * (percentile > 100 ? 100 : percentile) + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+    
+    uint64_t seen = 0;
+    for (uint8_t i = 0; i < kBucketCount; i++) {
+        seen += getBucket(i);
+        if (seen >= rank) {
+            uint32_t upper = bucketUpperUs(i);
+            return upper < getMaxUs() ? upper : getMaxUs();
+        }
+    }
+    return getMaxUs();
+}
+
+uint8_t LatencyHistogram::bucketFor(uint32_t us) {
+    if (us == 0) {
+        return 0;
+    }
+    uint8_t bucket = 32 - __builtin_clz(us);
+    return bucket < kBucketCount ? bucket : kBucketCount - 1;
+}
+
+uint32_t LatencyHistogram::bucketUpperUs(uint8_t bucket) {
+    if (bucket >= kBucketCount - 1) {
+        return UINT32_MAX;
+    }
+    return 1u << bucket;
+}
+
+size_t LatencyHistogram::format(char* out, size_t size, const char* label) const {
+    int written = snprintf(out, size, "%-18s n=%lu min=%lu mean=%lu p50<=%lu p90<=%lu p99<=%lu max=%lu us",
+                           label,
+                           (unsigned long)getCount(),
+                           (unsigned long)getMinUs(),
+                           (unsigned long)getMeanUs(),
+                           (unsigned long)percentileUs(50),
+                           (unsigned long)percentileUs(90),
+                           (unsigned long)percentileUs(99),
+                           (unsigned long)getMaxUs());
+    return written > 0 ? (size_t)written : 0;
+}
@@ -0,0 +1,65 @@
+#include "utils/LittleFsFingerprintStore.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+
+static const char* kPath = "/fingerprints.bin";
+static const uint32_t kVersion = 1;
+
+bool LittleFsFingerprintStore::mount() {
+    if (!mounted) {
+        // Formats the partition on first use
+        mounted = LittleFS.begin(true);
+        if (!mounted) {
+            Serial.println("[Fingerprints] LittleFS mount failed");
+        }
+    }
+    return mounted;
+}
+
+uint32_t LittleFsFingerprintStore::load(uint32_t offset, FingerprintEntry* entries, uint32_t capacity) {
+    if (!mount() || !LittleFS.exists(kPath)) {
+        return 0;
+    }
+    
+    File file = LittleFS.open(kPath, "r");
+    if (!file) {
+        return 0;
+    }
+    uint32_t version = 0;
+    uint32_t read = 0;
+    if (file.read((uint8_t*)&version, sizeof(version)) == sizeof(version) && version == kVersion &&
+        file.seek(sizeof(version) + offset * sizeof(FingerprintEntry))) {
+        read = file.read((uint8_t*)entries, capacity * sizeof(FingerprintEntry)) / sizeof(FingerprintEntry);
+    }
+    file.close();
+    return read;
+}
+
+bool LittleFsFingerprintStore::append(const FingerprintEntry& entry) {
+    if (!mount()) {
+        return false;
+    }
+    
+    // Start the file over when missing or from another version
+    bool fresh = true;
+    if (LittleFS.exists(kPath)) {
+        File existing = LittleFS.open(kPath, "r");
+        uint32_t version = 0;
+        fresh = !existing || existing.read((uint8_t*)&version, sizeof(version)) != sizeof(version) ||
+                version != kVersion;
+        existing.close();
+    }
+    
+    File file = LittleFS.open(kPath, fresh ? "w" : "a");
+    bool ok = file && (!fresh || file.write((const uint8_t*)&kVersion, sizeof(kVersion)) == sizeof(kVersion)) &&
+              file.write((const uint8_t*)&entry, sizeof(entry)) == sizeof(entry);
+    file.close();
+    if (!ok) {
+        Serial.println("[Fingerprints] LittleFS write failed");
+    }
+    return ok;
+}
+
+bool LittleFsFingerprintStore::clear() {
+    return mount() && (!LittleFS.exists(kPath) || LittleFS.remove(kPath));
+}
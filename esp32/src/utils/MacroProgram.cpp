@@ -0,0 +1,228 @@
+#include "utils/MacroProgram.h"
+#include "transmitter/FrameEncoder.h"
+#include <cstring>
+
+const char* macroErrorName(MacroError error) {
+    switch (error) {
+        case MacroError::NONE: return "OK";
+        case MacroError::EMPTY: return "empty macro";
+        case MacroError::UNSUPPORTED_STEP: return "step cannot be stored";
+        case MacroError::ENCODE_FAILED: return "step could not be encoded";
+        case MacroError::TOO_LARGE: return "macro too large";
+    }
+    return "unknown";
+}
+
+void MacroProgram::clear() {
+    waveformCount = 0;
+    codeLength = 0;
+    timingCount = 0;
+}
+
+MacroError MacroProgram::compile(const CommandBatch& batch, IProtocolEncoder* encoder) {
+    clear();
+    if (batch.count == 0) {
+        return MacroError::EMPTY;
+    }
+    
+    uint16_t scratch[raw_timing::kMaxTimings];
+    for (uint8_t i = 0; i < batch.count; i++) {
+        const PendingCommand& cmd = batch.commands[i];
+        if (cmd.event != CommandEvent::TAP || cmd.isScheduled() || cmd.isState()) {
+            clear();
+            return MacroError::UNSUPPORTED_STEP;
+        }
+        
+        // Same carrier rules as a live send: the command's override, else
+        // the protocol's own, else the RAW defaults
+        const ProtocolDescriptor* descriptor = findDescriptor(cmd.protocolId);
+        uint16_t carrier = cmd.carrierKHz ? cmd.carrierKHz
+                         : descriptor && !cmd.isRaw() ? descriptor->carrierKHz : IR_DEFAULT_CARRIER_KHZ;
+        uint8_t duty = cmd.dutyPercent ? cmd.dutyPercent
+                     : descriptor && !cmd.isRaw() ? descriptor->dutyPercent : IR_DEFAULT_DUTY_PERCENT;
+        
+        const uint16_t* data = scratch;
+        uint16_t length;
+        if (cmd.isRaw()) {
+            data = batch.rawTimings + cmd.rawOffset;
+            length = cmd.rawLength;
+        } else {
+            // Rendered as a live press is, protocol repeats included
+            TimingSpan out(scratch, raw_timing::kMaxTimings);
+            length = encoder && descriptor ? encoder->encodeValue(cmd.protocolId, cmd.value, cmd.bits, out) : 0;
+            length = length > 0 && length <= out.capacity ? frame_encoder::appendRepeats(*descriptor, out, length) : 0;
+            if (length == 0) {
+                clear();
+                return MacroError::ENCODE_FAILED;
+            }
+        }
+        
+        // Coalesced taps are separate presses, one frame period apart as
+        // in a live burst
+        const uint32_t periodUs = descriptor && descriptor->framePeriodUs ? descriptor->framePeriodUs : 0;
+        const uint16_t periodMs = (uint16_t)((periodUs + 999) / 1000);
+        
+        int16_t waveform = addWaveform(data, length, carrier, duty);
+        bool fits = waveform >= 0;
+        for (uint8_t r = 0; fits && r < cmd.repeatCount; r++) {
+            if (r > 0 && periodMs > 0) {
+                fits = emit(kOpWait, periodMs & 0xFF, periodMs >> 8);
+            }
+            fits = fits && emit(kOpEmit, (uint8_t)waveform, cmd.output);
+        }
+        if (fits && cmd.gapMs > 0 && i + 1 < batch.count) {
+            fits = emit(kOpWait, cmd.gapMs & 0xFF, cmd.gapMs >> 8);
+        }
+        if (!fits) {
+            clear();
+            return MacroError::TOO_LARGE;
+        }
+    }
+    
+    code[codeLength++] = kOpEnd;
+    return MacroError::NONE;
+}
+
+int16_t MacroProgram::addWaveform(const uint16_t* data, uint16_t length, uint16_t carrierKHz, uint8_t dutyPercent) {
+    // Toggle-bit protocols render differently on each press, so two taps
+    // of the same RC5 button stay two waveforms
+    for (uint8_t i = 0; i < waveformCount; i++) {
+        const MacroWaveform& existing = waveforms[i];
+        if (existing.length == length && existing.carrierKHz == carrierKHz &&
+            existing.dutyPercent == dutyPercent &&
+            memcmp(timings + existing.offset, data, length * sizeof(uint16_t)) == 0) {
+            return i;
+        }
+    }
+    
+    if (waveformCount >= kMaxWaveforms || length > kMaxTimings - timingCount) {
+        return -1;
+    }
+    MacroWaveform& waveform = waveforms[waveformCount];
+    waveform.offset = timingCount;
+    waveform.length = length;
+    waveform.carrierKHz = carrierKHz;
+    waveform.dutyPercent = dutyPercent;
+    memcpy(timings + timingCount, data, length * sizeof(uint16_t));
+    timingCount += length;
+    return waveformCount++;
+}
+
+bool MacroProgram::emit(uint8_t op, uint8_t a, uint8_t b) {
+    // Leave room for the END
+    if (codeLength + 3 >= kMaxCode) {
+        return false;
+    }
+    code[codeLength++] = op;
+    code[codeLength++] = a;
+    code[codeLength++] = b;
+    return true;
+}
+
+uint8_t MacroProgram::getStepCount() const {
+    uint8_t steps = 0;
+    for (uint16_t pc = 0; pc < codeLength && code[pc] != kOpEnd; pc += 3) {
+        steps += code[pc] == kOpEmit ? 1 : 0;
+    }
+    return steps;
+}
+
+// ============== Flash Layout ==============
+//
+// version, waveformCount, codeLength:16, timingCount:16, then per
+// waveform offset:16 length:16 carrier:16 duty, the code, the timings.
+
+static void putU16(uint8_t*& p, uint16_t v) {
+    *p++ = v & 0xFF;
+    *p++ = v >> 8;
+}
+
+static uint16_t getU16(const uint8_t*& p) {
+    uint16_t v = p[0] | (p[1] << 8);
+    p += 2;
+    return v;
+}
+
+size_t MacroProgram::serialize(uint8_t* out, size_t size) const {
+    const size_t needed = 6 + waveformCount * 7 + codeLength + timingCount * sizeof(uint16_t);
+    if (codeLength == 0 || size < needed) {
+        return 0;
+    }
+    
+    uint8_t* p = out;
+    *p++ = kVersion;
+    *p++ = waveformCount;
+    putU16(p, codeLength);
+    putU16(p, timingCount);
+    for (uint8_t i = 0; i < waveformCount; i++) {
+        putU16(p, waveforms[i].offset);
+        putU16(p, waveforms[i].length);
+        putU16(p, waveforms[i].carrierKHz);
+        *p++ = waveforms[i].dutyPercent;
+    }
+    memcpy(p, code, codeLength);
+    p += codeLength;
+    for (uint16_t i = 0; i < timingCount; i++) {
+        putU16(p, timings[i]);
+    }
+    return needed;
+}
+
+bool MacroProgram::deserialize(const uint8_t* data, size_t size) {
+    clear();
+    if (!data || size < 6 || data[0] != kVersion) {
+        return false;
+    }
+    
+    const uint8_t* p = data + 1;
+    uint8_t storedWaveforms = *p++;
+    uint16_t storedCode = getU16(p);
+    uint16_t storedTimings = getU16(p);
+    if (storedWaveforms > kMaxWaveforms || storedCode == 0 || storedCode > kMaxCode || storedTimings > kMaxTimings ||
+        size != 6 + storedWaveforms * 7 + storedCode + storedTimings * sizeof(uint16_t)) {
+        return false;
+    }
+    
+    waveformCount = storedWaveforms;
+    codeLength = storedCode;
+    timingCount = storedTimings;
+    for (uint8_t i = 0; i < waveformCount; i++) {
+        waveforms[i].offset = getU16(p);
+        waveforms[i].length = getU16(p);
+        waveforms[i].carrierKHz = getU16(p);
+        waveforms[i].dutyPercent = *p++;
+    }
+    memcpy(code, p, codeLength);
+    p += codeLength;
+    for (uint16_t i = 0; i < timingCount; i++) {
+        timings[i] = getU16(p);
+    }
+    
+    if (!validate()) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool MacroProgram::validate() const {
+    for (uint8_t i = 0; i < waveformCount; i++) {
+        const MacroWaveform& waveform = waveforms[i];
+        if (waveform.length == 0 || waveform.offset > timingCount ||
+            waveform.length > timingCount - waveform.offset) {
+            return false;
+        }
+    }
+    
+    // Every op whole and known, every EMIT naming a stored waveform, and
+    // an END where the code stops
+    uint16_t pc = 0;
+    while (pc < codeLength && code[pc] != kOpEnd) {
+        if (pc + 3 > codeLength || (code[pc] != kOpEmit && code[pc] != kOpWait) ||
+            (code[pc] == kOpEmit && code[pc + 1] >= waveformCount)) {
+            return false;
+        }
+        pc += 3;
+    }
+    return pc + 1 == codeLength;
+}
@@ -0,0 +1,66 @@
+#include "utils/MacroRunner.h"
+
+MacroRunner::MacroRunner()
+    : macroId(0),
+      pc(0),
+      startMs(0),
+      nextDueMs(0),
+      plannedMs(0),
+      active(false),
+      stepCount(0),
+      deferred(0) {
+}
+
+bool MacroRunner::start(uint32_t id, const MacroProgram& compiled, uint32_t nowMs) {
+    if (active || compiled.getCodeLength() == 0) {
+        return false;
+    }
+    
+    program = compiled;
+    macroId = id;
+    pc = 0;
+    startMs = nowMs;
+    nextDueMs = nowMs;
+    plannedMs = 0;
+    stepCount = 0;
+    active = true;
+    return true;
+}
+
+bool MacroRunner::update(uint32_t nowMs, const MacroEmitCallback& emit) {
+    const uint8_t* code = program.getCode();
+    
+    // Wrap-safe comparison against millis()
+    while (active && (int32_t)(nowMs - nextDueMs) >= 0) {
+        const uint8_t op = code[pc];
+        if (op == MacroProgram::kOpEnd) {
+            active = false;
+            return true;
+        }
+        
+        if (op == MacroProgram::kOpWait) {
+            const uint16_t waitMs = code[pc + 1] | (code[pc + 2] << 8);
+            plannedMs += waitMs;
+            nextDueMs += waitMs;
+            pc += 3;
+            continue;
+        }
+        
+        const MacroWaveform& waveform = program.getWaveform(code[pc + 1]);
+        if (emit && !emit(code[pc + 2], program.getTimings(waveform), waveform.length, waveform.carrierKHz,
+                          waveform.dutyPercent)) {
+            deferred++;
+            return false;
+        }
+        
+        if (stepCount < kMaxSteps) {
+            MacroStepTiming& timing = steps[stepCount++];
+            timing.plannedMs = plannedMs;
+            timing.actualMs = nowMs - startMs;
+            timing.lateMs = nowMs - nextDueMs;
+        }
+        nextDueMs = nowMs;
+        pc += 3;
+    }
+    return false;
+}
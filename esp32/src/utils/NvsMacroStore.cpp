@@ -0,0 +1,51 @@
+#include "utils/NvsMacroStore.h"
+
+static const char* kNamespace = "pulsrMacros";
+
+// NVS keys are at most 15 characters
+void NvsMacroStore::keyFor(uint32_t id, char* key) {
+    snprintf(key, 12, "m%lu", (unsigned long)id);
+}
+
+bool NvsMacroStore::load(uint32_t id, MacroProgram* program) {
+    if (!preferences.begin(kNamespace, true)) {
+        return false;
+    }
+    
+    char key[12];
+    keyFor(id, key);
+    size_t bytes = preferences.getBytesLength(key);
+    bool ok = bytes > 0 && bytes <= sizeof(blob) && preferences.getBytes(key, blob, bytes) == bytes &&
+              program->deserialize(blob, bytes);
+    preferences.end();
+    return ok;
+}
+
+bool NvsMacroStore::save(uint32_t id, const MacroProgram& program) {
+    size_t bytes = program.serialize(blob, sizeof(blob));
+    if (bytes == 0 || !preferences.begin(kNamespace, false)) {
+        Serial.println("[Macros] NVS open failed");
+        return false;
+    }
+    
+    char key[12];
+    keyFor(id, key);
+    bool ok = preferences.putBytes(key, blob, bytes) == bytes;
+    preferences.end();
+    if (!ok) {
+        Serial.println("[Macros] NVS write failed");
+    }
+    return ok;
+}
+
+bool NvsMacroStore::remove(uint32_t id) {
+    if (!preferences.begin(kNamespace, false)) {
+        return false;
+    }
+    
+    char key[12];
+    keyFor(id, key);
+    bool ok = preferences.remove(key);
+    preferences.end();
+    return ok;
+}
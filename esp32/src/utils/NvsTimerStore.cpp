@@ -0,0 +1,65 @@
+#include "utils/NvsTimerStore.h"
+
+static const char* kNamespace = "pulsr";
+static const char* kVersionKey = "timersVer";
+static const char* kTimersKey = "timers";
+static const char* kFiredKey = "timersFired";
+
+uint8_t NvsTimerStore::load(ScheduledCommand* commands, uint8_t capacity) {
+    if (!preferences.begin(kNamespace, true)) {
+        return 0;
+    }
+    
+    uint8_t count = 0;
+    if (preferences.getUChar(kVersionKey, 0) == kVersion) {
+        size_t bytes = preferences.getBytesLength(kTimersKey);
+        if (bytes % sizeof(ScheduledCommand) == 0 && bytes / sizeof(ScheduledCommand) <= capacity) {
+            preferences.getBytes(kTimersKey, commands, bytes);
+            count = (uint8_t)(bytes / sizeof(ScheduledCommand));
+        }
+    }
+    preferences.end();
+    return count;
+}
+
+bool NvsTimerStore::save(const ScheduledCommand* commands, uint8_t count) {
+    if (!preferences.begin(kNamespace, false)) {
+        Serial.println("[Timers] NVS open failed");
+        return false;
+    }
+    
+    bool ok = preferences.putUChar(kVersionKey, kVersion) == 1;
+    if (count == 0) {
+        preferences.remove(kTimersKey);
+    } else {
+        ok = ok && preferences.putBytes(kTimersKey, commands, count * sizeof(ScheduledCommand)) ==
+                       count * sizeof(ScheduledCommand);
+    }
+    preferences.end();
+    if (!ok) {
+        Serial.println("[Timers] NVS write failed");
+    }
+    return ok;
+}
+
+uint32_t NvsTimerStore::loadFiredThrough() {
+    if (!preferences.begin(kNamespace, true)) {
+        return 0;
+    }
+    uint32_t epochSec = preferences.getUInt(kFiredKey, 0);
+    preferences.end();
+    return epochSec;
+}
+
+bool NvsTimerStore::saveFiredThrough(uint32_t epochSec) {
+    if (!preferences.begin(kNamespace, false)) {
+        Serial.println("[Timers] NVS open failed");
+        return false;
+    }
+    bool ok = preferences.putUInt(kFiredKey, epochSec) == sizeof(epochSec);
+    preferences.end();
+    if (!ok) {
+        Serial.println("[Timers] NVS write failed");
+    }
+    return ok;
+}
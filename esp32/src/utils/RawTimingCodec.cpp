@@ -0,0 +1,153 @@
+#include "utils/RawTimingCodec.h"
+
+namespace raw_timing {
+
+namespace {
+
+const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// A delta is at most 17 bits after zigzag, so three varint bytes
+const uint8_t kMaxVarintBytes = 3;
+
+int8_t sextetFor(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '-') return 62;
+    if (c == '_') return 63;
+    return -1;
+}
+
+uint32_t zigzag(int32_t delta) {
+    return ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+}
+
+int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// Packs bytes into base64url characters as they are produced
+class Base64Writer {
+public:
+    Base64Writer(char* out, size_t size) : out(out), size(size), length(0), bits(0), pending(0), overflow(false) {}
+    
+    void write(uint8_t byte) {
+        bits = (bits << 8) | byte;
+        pending += 8;
+        while (pending >= 6) {
+            pending -= 6;
+            put(kAlphabet[(bits >> pending) & 0x3F]);
+        }
+    }
+    
+    size_t finish() {
+        if (pending > 0) {
+            put(kAlphabet[(bits << (6 - pending)) & 0x3F]);
+            pending = 0;
+        }
+        if (overflow || length >= size) {
+            if (size > 0) out[0] = '\0';
+            return 0;
+        }
+        out[length] = '\0';
+        return length;
+    }
+
+private:
+    char* out;
+    size_t size;
+    size_t length;
+    uint32_t bits;
+    uint8_t pending;
+    bool overflow;
+    
+    void put(char c) {
+        // Leave room for the terminator
+        if (length + 1 >= size) {
+            overflow = true;
+            return;
+        }
+        out[length++] = c;
+    }
+};
+
+}  // namespace
+
+size_t encodedSizeFor(uint16_t length) {
+    size_t bytes = (size_t)length * kMaxVarintBytes;
+    return (bytes * 8 + 5) / 6 + 1;
+}
+
+size_t encode(const uint16_t* timings, uint16_t length, char* out, size_t size) {
+    if (!out || size == 0) {
+        return 0;
+    }
+    
+    Base64Writer writer(out, size);
+    int32_t previous[2] = {0, 0};
+    for (uint16_t i = 0; i < length; i++) {
+        uint32_t value = zigzag((int32_t)timings[i] - previous[i & 1]);
+        previous[i & 1] = timings[i];
+        do {
+            uint8_t byte = value & 0x7F;
+            value >>= 7;
+            writer.write(value ? (byte | 0x80) : byte);
+        } while (value);
+    }
+    return writer.finish();
+}
+
+uint16_t decode(const char* text, uint16_t* timings, uint16_t capacity) {
+    if (!text || !timings) {
+        return 0;
+    }
+    
+    uint16_t count = 0;
+    int32_t previous[2] = {0, 0};
+    uint32_t bits = 0;
+    uint8_t pending = 0;
+    uint32_t varint = 0;
+    uint8_t varintBytes = 0;
+    
+    for (const char* p = text; *p && *p != '='; p++) {
+        int8_t sextet = sextetFor(*p);
+        if (sextet < 0) {
+            return 0;
+        }
+        bits = (bits << 6) | (uint32_t)sextet;
+        pending += 6;
+        if (pending < 8) {
+            continue;
+        }
+        
+        pending -= 8;
+        uint8_t byte = (bits >> pending) & 0xFF;
+        varint |= (uint32_t)(byte & 0x7F) << (7 * varintBytes);
+        if (++varintBytes > kMaxVarintBytes) {
+            return 0;
+        }
+        if (byte & 0x80) {
+            continue;
+        }
+        
+        if (count >= capacity) {
+            return 0;
+        }
+        int32_t duration = previous[count & 1] + unzigzag(varint);
+        if (duration <= 0 || duration > 0xFFFF) {
+            return 0;
+        }
+        previous[count & 1] = duration;
+        timings[count++] = (uint16_t)duration;
+        varint = 0;
+        varintBytes = 0;
+    }
+    
+    // A truncated varint, or leftover bits that are not base64 padding
+    if (varintBytes != 0 || (bits & ((1u << pending) - 1)) != 0) {
+        return 0;
+    }
+    return count;
+}
+
+}  // namespace raw_timing
@@ -0,0 +1,45 @@
+#include "utils/SniffBatch.h"
+
+SniffBatch::SniffBatch(uint32_t flushMs)
+    : flushMs(flushMs),
+      count(0),
+      lastFingerprint(0),
+      lastMs(0),
+      hasLast(false)
+{
+}
+
+bool SniffBatch::add(const SniffedFrame& frame, uint32_t learnedId) {
+    // Repeat codes and the same frame again without a pause continue the press
+    bool continues = hasLast && frame.atMs - lastMs <= kHoldGapMs &&
+                     (frame.repeat || frame.fingerprint == lastFingerprint);
+    if (continues) {
+        lastMs = frame.atMs;
+        if (count > 0 && events[count - 1].frame.fingerprint == lastFingerprint) {
+            SniffEvent& event = events[count - 1];
+            event.frames = event.frames < 0xFFFF ? event.frames + 1 : event.frames;
+            event.lastMs = frame.atMs;
+        }
+        return true;
+    }
+    if (frame.repeat) {
+        return true;  // Nothing to continue: the press started before sniffing did
+    }
+    if (isFull()) {
+        return false;
+    }
+    
+    SniffEvent& event = events[count++];
+    event.frame = frame;
+    event.learnedId = learnedId;
+    event.frames = 1;
+    event.lastMs = frame.atMs;
+    lastFingerprint = frame.fingerprint;
+    lastMs = frame.atMs;
+    hasLast = true;
+    return true;
+}
+
+bool SniffBatch::isDue(uint32_t nowMs) const {
+    return isFull() || (count > 0 && nowMs - events[0].frame.atMs >= flushMs);
+}
@@ -0,0 +1,97 @@
+#include "utils/TimerWheel.h"
+
+TimerWheel::TimerWheel(uint32_t tickMs)
+    : tickMs(tickMs ? tickMs : 1),
+      lastTickMs(0),
+      cursor(0),
+      armed(0) {
+    reset(0);
+}
+
+void TimerWheel::reset(uint32_t nowMs) {
+    lastTickMs = nowMs;
+    cursor = 0;
+    armed = 0;
+    for (uint16_t i = 0; i < kSlots; i++) {
+        heads[i] = kNoTimer;
+    }
+    for (uint8_t i = 0; i < kMaxTimers; i++) {
+        timers[i].inUse = false;
+        timers[i].next = kNoTimer;
+    }
+}
+
+uint8_t TimerWheel::schedule(uint32_t delayMs, uint32_t nowMs) {
+    uint8_t timer = kNoTimer;
+    for (uint8_t i = 0; i < kMaxTimers; i++) {
+        if (!timers[i].inUse) {
+            timer = i;
+            break;
+        }
+    }
+    if (timer == kNoTimer) {
+        return kNoTimer;
+    }
+    
+    // Ticks from the cursor (which may lag nowMs by part of a tick),
+    // rounded up so a timer never fires early
+    uint64_t fromCursor = (uint64_t)delayMs + (uint32_t)(nowMs - lastTickMs);
+    uint32_t ticks = (uint32_t)((fromCursor + tickMs - 1) / tickMs);
+    if (ticks == 0) {
+        ticks = 1;
+    }
+    
+    Timer& t = timers[timer];
+    t.inUse = true;
+    t.rounds = (ticks - 1) / kSlots;
+    t.bucket = (uint8_t)((cursor + ticks) % kSlots);
+    t.next = heads[t.bucket];
+    heads[t.bucket] = timer;
+    armed++;
+    return timer;
+}
+
+bool TimerWheel::cancel(uint8_t timer) {
+    if (timer >= kMaxTimers || !timers[timer].inUse) {
+        return false;
+    }
+    unlink(timer);
+    return true;
+}
+
+void TimerWheel::unlink(uint8_t timer) {
+    Timer& t = timers[timer];
+    uint8_t* link = &heads[t.bucket];
+    while (*link != kNoTimer && *link != timer) {
+        link = &timers[*link].next;
+    }
+    if (*link == timer) {
+        *link = t.next;
+    }
+    t.inUse = false;
+    t.next = kNoTimer;
+    armed--;
+}
+
+void TimerWheel::advance(uint32_t nowMs, const FireCallback& fire) {
+    // Wrap-safe: whole ticks elapsed since the last one processed
+    for (uint8_t step = 0; step < kMaxTicksPerAdvance && nowMs - lastTickMs >= tickMs; step++) {
+        lastTickMs += tickMs;
+        cursor = (cursor + 1) % kSlots;
+        
+        uint8_t timer = heads[cursor];
+        while (timer != kNoTimer) {
+            Timer& t = timers[timer];
+            uint8_t next = t.next;
+            if (t.rounds > 0) {
+                t.rounds--;
+            } else {
+                unlink(timer);
+                if (fire) {
+                    fire(timer);
+                }
+            }
+            timer = next;
+        }
+    }
+}
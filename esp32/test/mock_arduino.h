@@ -6,20 +6,61 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <string>
 
-// Mock IRremoteESP8266 protocol type constants
-#define NEC 1
-#define SAMSUNG 2
-#define SONY 3
-#define UNKNOWN 0
+// Mock IRremoteESP8266 protocol type constants (an unscoped enum with the
+// library's values, so scoped names like IRProtocol::NEC don't collide)
+enum decode_type_t {
+    UNKNOWN = -1,
+    UNUSED = 0,
+    RC5 = 1,
+    RC6 = 2,
+    NEC = 3,
+    SONY = 4,
+    PANASONIC = 5,
+    JVC = 6,
+    SAMSUNG = 7,
+    LG = 10,
+    SHARP = 14
+};
+
+// rawbuf units (microseconds per tick), as in IRrecv.h
+const uint16_t kRawTick = 2;
 
 // Mock decode_results structure from IRremoteESP8266
 struct decode_results {
     int decode_type;      // Protocol type (NEC, SAMSUNG, SONY, UNKNOWN, etc.)
     uint64_t value;       // Decoded value
+    uint32_t address;     // Decoded device address
+    uint32_t command;     // Decoded command
     uint16_t bits;        // Number of bits in the signal
-    uint16_t* rawbuf;     // Raw timing data buffer
+    volatile uint16_t* rawbuf;  // Raw timing data buffer (volatile, as in IRrecv.h)
     size_t rawlen;        // Length of raw buffer
+    bool repeat;          // A repeat code, not a full frame
+};
+
+// Mock Arduino clock: tests set the time through mockMillis()
+inline unsigned long& mockMillis() {
+    static unsigned long now = 0;
+    return now;
+}
+inline unsigned long millis() {
+    return mockMillis();
+}
+
+// Mock Arduino String (only what the interfaces use)
+class String {
+public:
+    String() = default;
+    String(const char* str) : data(str ? str : "") {}
+
+    const char* c_str() const { return data.c_str(); }
+    unsigned int length() const { return data.size(); }
+    bool operator==(const char* other) const { return data == (other ? other : ""); }
+    bool operator==(const String& other) const { return data == other.data; }
+
+private:
+    std::string data;
 };
 
 #endif
@@ -0,0 +1,93 @@
+#ifndef MOCK_RMT_CHANNEL_H
+#define MOCK_RMT_CHANNEL_H
+
+// Host-side RMT stand-in: records every symbol stream written to it so
+// tests can check the emitted waveform without hardware
+
+#include "transmitter/IRmtChannel.h"
+#include <vector>
+
+class MockRmtChannel : public IRmtChannel {
+public:
+    bool begun = false;
+    bool busy = false;          // Simulate a frame still on the air
+    uint32_t carrierFrequencyHz = 0;
+    uint8_t carrierDutyPercent = 0;
+    int writeCount = 0;
+    std::vector<RmtSymbol> symbols;  // Last written stream
+    
+    // Streams are pulled in half-block chunks, like the driver's
+    // ping-pong refill (ESP32-S3: 48-symbol block)
+    size_t streamChunk = 24;
+    std::vector<size_t> chunkSizes;  // fill() results of the last stream
+
+    bool begin() override {
+        begun = true;
+        return true;
+    }
+
+    bool setCarrier(uint32_t frequencyHz, uint8_t dutyPercent) override {
+        carrierFrequencyHz = frequencyHz;
+        carrierDutyPercent = dutyPercent;
+        return true;
+    }
+
+    bool write(const RmtSymbol* data, size_t count) override {
+        symbols.assign(data, data + count);
+        writeCount++;
+        return true;
+    }
+
+    bool writeStream(IRmtSymbolSource* source) override {
+        symbols.clear();
+        chunkSizes.clear();
+        std::vector<RmtSymbol> chunk(streamChunk);
+        for (;;) {
+            size_t count = source->fill(chunk.data(), streamChunk);
+            chunkSizes.push_back(count);
+            symbols.insert(symbols.end(), chunk.begin(), chunk.begin() + count);
+            if (count < streamChunk) {
+                break;
+            }
+        }
+        writeCount++;
+        return true;
+    }
+
+    bool waitDone(uint32_t timeoutMs) override {
+        (void)timeoutMs;
+        return !busy;
+    }
+
+    // Flatten the recorded symbols back to mark/space durations,
+    // merging consecutive halves at the same level
+    std::vector<uint16_t> timings() const {
+        std::vector<uint16_t> out;
+        int lastLevel = -1;
+        uint32_t accumulated = 0;
+        for (size_t i = 0; i < symbols.size(); i++) {
+            uint32_t durations[2] = {symbols[i].duration0, symbols[i].duration1};
+            int levels[2] = {(int)symbols[i].level0, (int)symbols[i].level1};
+            for (int h = 0; h < 2; h++) {
+                if (durations[h] == 0) {
+                    continue;
+                }
+                if (levels[h] == lastLevel) {
+                    accumulated += durations[h];
+                } else {
+                    if (lastLevel >= 0) {
+                        out.push_back((uint16_t)accumulated);
+                    }
+                    lastLevel = levels[h];
+                    accumulated = durations[h];
+                }
+            }
+        }
+        if (lastLevel >= 0) {
+            out.push_back((uint16_t)accumulated);
+        }
+        return out;
+    }
+};
+
+#endif
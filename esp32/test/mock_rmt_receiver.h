@@ -0,0 +1,105 @@
+#ifndef MOCK_RMT_RECEIVER_H
+#define MOCK_RMT_RECEIVER_H
+
+// Host-side RMT receiver stand-in: replays recorded edge streams as the
+// symbol frames the driver's ring buffer would hold, calling the frame
+// hook for each one like the device's watcher task
+
+#include "receiver/IRmtReceiver.h"
+#include <deque>
+#include <vector>
+
+class MockRmtReceiver : public IRmtReceiver {
+public:
+    bool begun = false;
+    bool running = false;
+    uint16_t idleThresholdUs = 0;
+    std::deque<std::vector<RmtSymbol>> frames;
+    bool canNotify = true;
+    RmtFrameHook frameHook = nullptr;
+    void* frameContext = nullptr;
+    
+    bool begin(uint16_t idleThreshold) override {
+        begun = true;
+        idleThresholdUs = idleThreshold;
+        return true;
+    }
+    
+    bool start() override {
+        running = true;
+        return true;
+    }
+    
+    void stop() override {
+        running = false;
+    }
+    
+    size_t receive(RmtSymbol* symbols, size_t capacity) override {
+        if (frames.empty()) {
+            return 0;
+        }
+        std::vector<RmtSymbol> frame = frames.front();
+        frames.pop_front();
+        for (size_t i = 0; i < frame.size() && i < capacity; i++) {
+            symbols[i] = frame[i];
+        }
+        return frame.size();
+    }
+    
+    bool setFrameHook(RmtFrameHook hook, void* context) override {
+        if (!canNotify) {
+            return false;
+        }
+        frameHook = hook;
+        frameContext = context;
+        return true;
+    }
+    
+    // Queue a mark/space recording (marks first) as the receiver would
+    // see it: active-low levels, durations over one half split across
+    // halves, optional leading idle, and the zero-length end marker
+    void pushTimings(const std::vector<uint16_t>& timings, uint32_t leadingIdleUs = 0, bool activeLow = true) {
+        std::vector<uint16_t> durations;
+        std::vector<uint8_t> levels;
+        const uint8_t mark = activeLow ? 0 : 1;
+        if (leadingIdleUs) {
+            split(leadingIdleUs, !mark, &durations, &levels);
+        }
+        for (size_t i = 0; i < timings.size(); i++) {
+            split(timings[i], i % 2 == 0 ? mark : !mark, &durations, &levels);
+        }
+        durations.push_back(0);
+        levels.push_back(!mark);
+        if (durations.size() % 2) {
+            durations.push_back(0);
+            levels.push_back(!mark);
+        }
+        
+        std::vector<RmtSymbol> frame;
+        for (size_t i = 0; i < durations.size(); i += 2) {
+            RmtSymbol symbol;
+            symbol.duration0 = durations[i];
+            symbol.level0 = levels[i];
+            symbol.duration1 = durations[i + 1];
+            symbol.level1 = levels[i + 1];
+            frame.push_back(symbol);
+        }
+        frames.push_back(frame);
+        if (frameHook) {
+            frameHook(frameContext);
+        }
+    }
+
+private:
+    static void split(uint32_t duration, uint8_t level, std::vector<uint16_t>* durations,
+                      std::vector<uint8_t>* levels) {
+        while (duration > 0) {
+            uint16_t part = duration > RMT_MAX_SYMBOL_DURATION ? RMT_MAX_SYMBOL_DURATION : duration;
+            durations->push_back(part);
+            levels->push_back(level);
+            duration -= part;
+        }
+    }
+};
+
+#endif
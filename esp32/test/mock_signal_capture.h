@@ -0,0 +1,75 @@
+#ifndef MOCK_SIGNAL_CAPTURE_H
+#define MOCK_SIGNAL_CAPTURE_H
+
+// Host-side capture stand-in: frames are queued by the test, and an
+// event-driven one fires its ready hook the way a receiver interrupt
+// would
+
+#include "receiver/ISignalCapture.h"
+#include <deque>
+#include <vector>
+
+class MockSignalCapture : public ISignalCapture {
+public:
+    bool eventDriven;
+    bool enabled = false;
+    bool held = false;
+    int decodeCalls = 0;
+    uint32_t pollMs = 0;
+    std::deque<std::vector<uint16_t>> frames;  // rawbuf contents, gap first
+    
+    explicit MockSignalCapture(bool eventDriven) : eventDriven(eventDriven) {}
+    
+    void enable() override { enabled = true; }
+    void disable() override { enabled = false; }
+    void resume() override {
+        if (held) {
+            frames.pop_front();
+            held = false;
+        }
+    }
+    bool hasSignal() override { return held || !frames.empty(); }
+    
+    bool decode(decode_results* results) override {
+        decodeCalls++;
+        if (!hasSignal()) {
+            return false;
+        }
+        held = true;
+        current = frames.front();
+        results->decode_type = UNKNOWN;
+        results->value = 0;
+        results->address = 0;
+        results->command = 0;
+        results->bits = 0;
+        results->rawbuf = current.data();
+        results->rawlen = current.size();
+        results->repeat = false;
+        return true;
+    }
+    
+    bool setReadyHook(CaptureReadyHook hook, void* context) override {
+        if (!eventDriven) {
+            return false;
+        }
+        readyHook = hook;
+        readyContext = context;
+        return true;
+    }
+    uint32_t pollIntervalMs() const override { return pollMs; }
+    
+    // A frame arrives: queued, and the hook fired as from the interrupt
+    void arrive(const std::vector<uint16_t>& rawbuf) {
+        frames.push_back(rawbuf);
+        if (readyHook) {
+            readyHook(readyContext);
+        }
+    }
+
+private:
+    CaptureReadyHook readyHook = nullptr;
+    void* readyContext = nullptr;
+    std::vector<uint16_t> current;
+};
+
+#endif
@@ -0,0 +1,272 @@
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "transmitter/AcStateProtocols.h"
+#include "transmitter/AcStateStream.h"
+#include "transmitter/IRLibProtocolEncoders.h"
+#include "transmitter/RmtIRTransmitter.h"
+#include "transmitter/TransmitQueue.h"
+#include "mock_rmt_channel.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Daikin 280-bit frame (three sections), checksums included
+static const uint8_t kDaikinState[35] = {
+    0x11, 0xDA, 0x27, 0x00, 0xC5, 0x00, 0x00, 0xD7,
+    0x11, 0xDA, 0x27, 0x00, 0x42, 0x00, 0x00, 0x54,
+    0x11, 0xDA, 0x27, 0x00, 0x00, 0x39, 0x32, 0x00, 0x30, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xC1, 0x80, 0x00, 0xEE};
+
+// ============== Checksums ==============
+
+void test_sum_checksum_per_section() {
+    const AcStateDescriptor* daikin = findAcDescriptor(AcProtocol::DAIKIN);
+    TEST_ASSERT_NOT_NULL(daikin);
+    TEST_ASSERT_EQUAL(35, acStateBytes(*daikin));
+    
+    uint8_t state[35];
+    memcpy(state, kDaikinState, sizeof(state));
+    state[7] = 0;
+    state[15] = 0;
+    state[34] = 0;
+    TEST_ASSERT_FALSE(verifyAcChecksum(*daikin, state));
+    
+    applyAcChecksum(*daikin, state);
+    TEST_ASSERT_EQUAL_HEX8(0xD7, state[7]);
+    TEST_ASSERT_EQUAL_HEX8(0x54, state[15]);
+    TEST_ASSERT_EQUAL_HEX8(0xEE, state[34]);
+    TEST_ASSERT_TRUE(verifyAcChecksum(*daikin, state));
+}
+
+void test_xor_checksum() {
+    const AcStateDescriptor* toshiba = findAcDescriptor(AcProtocol::TOSHIBA_AC);
+    uint8_t state[9] = {0xF2, 0x0D, 0x03, 0xFC, 0x01, 0x00, 0x00, 0x00, 0x00};
+    
+    applyAcChecksum(*toshiba, state);
+    TEST_ASSERT_EQUAL_HEX8(0x01, state[8]);
+}
+
+void test_names_resolve() {
+    TEST_ASSERT_EQUAL((int)AcProtocol::MITSUBISHI_AC, (int)acProtocolFromName("MITSUBISHI_AC"));
+    TEST_ASSERT_EQUAL((int)AcProtocol::UNKNOWN, (int)acProtocolFromName("NEC"));
+    TEST_ASSERT_NULL(findAcDescriptor(AcProtocol::UNKNOWN));
+}
+
+// ============== Frame Layout ==============
+
+void test_toshiba_layout_msb_first_sent_twice() {
+    const AcStateDescriptor* toshiba = findAcDescriptor(AcProtocol::TOSHIBA_AC);
+    uint8_t state[9] = {0xF2, 0x0D, 0x03, 0xFC, 0x01, 0x00, 0x00, 0x00, 0x01};
+    AcStateStream stream;
+    TEST_ASSERT_TRUE(stream.begin(*toshiba, state));
+    
+    uint16_t timings[400];
+    uint16_t length = stream.render(timings, 400);
+    
+    // Two copies of header + 72 bits + footer, one copy gap between
+    TEST_ASSERT_EQUAL(2 * (2 + 72 * 2 + 1) + 1, length);
+    TEST_ASSERT_EQUAL(4400, timings[0]);
+    TEST_ASSERT_EQUAL(4300, timings[1]);
+    TEST_ASSERT_EQUAL(1600, timings[3]);  // 0xF2: MSB is 1
+    TEST_ASSERT_EQUAL(1600, timings[5]);
+    TEST_ASSERT_EQUAL(1600, timings[7]);
+    TEST_ASSERT_EQUAL(1600, timings[9]);
+    TEST_ASSERT_EQUAL(490, timings[11]);
+    TEST_ASSERT_EQUAL(7400, timings[147]);
+    TEST_ASSERT_EQUAL(4400, timings[148]);
+    TEST_ASSERT_EQUAL(580, timings[length - 1]);
+}
+
+void test_daikin_preamble_and_sections() {
+    const AcStateDescriptor* daikin = findAcDescriptor(AcProtocol::DAIKIN);
+    AcStateStream stream;
+    TEST_ASSERT_TRUE(stream.begin(*daikin, kDaikinState));
+    
+    uint16_t timings[700];
+    uint16_t length = stream.render(timings, 700);
+    TEST_ASSERT_EQUAL(12 + 3 * (2 + 1) + 280 * 2 + 2, length);
+    
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_EQUAL(428, timings[i]);
+    }
+    TEST_ASSERT_EQUAL(29000, timings[11]);
+    TEST_ASSERT_EQUAL(3650, timings[12]);
+    TEST_ASSERT_EQUAL(1280, timings[15]);  // 0x11: LSB is 1
+    TEST_ASSERT_EQUAL(428, timings[17]);
+    
+    // Second section starts after the first footer and a section gap
+    uint16_t secondHeader = 12 + 2 + 64 * 2 + 1 + 1;
+    TEST_ASSERT_EQUAL(29000, timings[secondHeader - 1]);
+    TEST_ASSERT_EQUAL(3650, timings[secondHeader]);
+}
+
+// ============== Streaming ==============
+
+static void assertContinuous(const MockRmtChannel& channel, size_t expectedSymbols) {
+    // Every chunk but the last is full: a short refill would end the
+    // transmission mid-frame
+    TEST_ASSERT_GREATER_THAN(1, channel.chunkSizes.size());
+    for (size_t i = 0; i + 1 < channel.chunkSizes.size(); i++) {
+        TEST_ASSERT_EQUAL(channel.streamChunk, channel.chunkSizes[i]);
+    }
+    TEST_ASSERT_LESS_THAN(channel.streamChunk, channel.chunkSizes.back());
+    TEST_ASSERT_EQUAL(expectedSymbols, channel.symbols.size());
+    
+    // No zero-length half (the RMT end marker) before the last symbol
+    for (size_t i = 0; i < channel.symbols.size(); i++) {
+        const RmtSymbol& symbol = channel.symbols[i];
+        TEST_ASSERT_TRUE(symbol.duration0 != 0);
+        if (i + 1 < channel.symbols.size()) {
+            TEST_ASSERT_TRUE(symbol.duration1 != 0);
+        }
+    }
+}
+
+void test_daikin_streams_gap_free_past_symbol_buffer() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter(&channel, &encoder);
+    transmitter.begin();
+    
+    TransmitResult result = transmitter.transmitState(AcProtocol::DAIKIN, kDaikinState, 35);
+    TEST_ASSERT_TRUE(result.success);
+    TEST_ASSERT_EQUAL(38000, channel.carrierFrequencyHz);
+    TEST_ASSERT_EQUAL(50, channel.carrierDutyPercent);
+    
+    AcStateStream reference;
+    reference.begin(*findAcDescriptor(AcProtocol::DAIKIN), kDaikinState);
+    uint16_t expected[700];
+    uint16_t length = reference.render(expected, 700);
+    
+    // Longer than the fixed symbol buffer the value path renders into
+    TEST_ASSERT_GREATER_THAN(RmtIRTransmitter::kMaxSymbols, reference.symbolCount());
+    assertContinuous(channel, reference.symbolCount());
+    
+    std::vector<uint16_t> emitted = channel.timings();
+    TEST_ASSERT_EQUAL(length, emitted.size());
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, emitted.data(), length);
+}
+
+void test_long_gaps_split_across_halves() {
+    AcStateDescriptor slow = *findAcDescriptor(AcProtocol::TOSHIBA_AC);
+    slow.copyGap = 40000;
+    uint8_t state[9] = {0};
+    
+    AcStateStream stream;
+    TEST_ASSERT_TRUE(stream.begin(slow, state));
+    MockRmtChannel channel;
+    channel.begin();
+    channel.streamChunk = 7;  // Odd chunk size moves the split across refills
+    TEST_ASSERT_TRUE(channel.writeStream(&stream));
+    assertContinuous(channel, stream.symbolCount());
+    
+    std::vector<uint16_t> emitted = channel.timings();
+    TEST_ASSERT_EQUAL(40000, emitted[147]);
+    TEST_ASSERT_EQUAL(2 * 147 + 1, emitted.size());
+}
+
+void test_transmit_state_fills_checksum_and_validates() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter(&channel, &encoder);
+    transmitter.begin();
+    
+    uint8_t state[35];
+    memcpy(state, kDaikinState, sizeof(state));
+    state[7] = 0x00;  // Stale checksum
+    TEST_ASSERT_TRUE(transmitter.transmitState(AcProtocol::DAIKIN, state, 35).success);
+    TEST_ASSERT_EQUAL(0x00, state[7]);  // Caller's buffer untouched
+    
+    std::vector<uint16_t> emitted = channel.timings();
+    uint16_t expected[700];
+    AcStateStream reference;
+    reference.begin(*findAcDescriptor(AcProtocol::DAIKIN), kDaikinState);
+    reference.render(expected, 700);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, emitted.data(), emitted.size());
+    
+    TEST_ASSERT_FALSE(transmitter.transmitState(AcProtocol::DAIKIN, state, 34).success);
+    TEST_ASSERT_FALSE(transmitter.transmitState(AcProtocol::UNKNOWN, state, 35).success);
+    TEST_ASSERT_EQUAL(1, channel.writeCount);
+}
+
+static uint64_t fakeClock() { return 0; }
+
+void test_queue_sends_state_requests() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter(&channel, &encoder);
+    HoldRepeater repeater(&transmitter, &encoder);
+    TransmitQueue queue(&transmitter, &repeater, fakeClock);
+    transmitter.begin();
+    
+    TransmitRequest request;
+    request.action = TransmitAction::STATE;
+    request.acProtocol = AcProtocol::DAIKIN;
+    request.stateLength = 35;
+    memcpy(request.state, kDaikinState, 35);
+    TEST_ASSERT_TRUE(queue.submit(request));
+    queue.service();
+    
+    TEST_ASSERT_EQUAL(1, channel.writeCount);
+    TEST_ASSERT_EQUAL(1, queue.getStats().completed);
+}
+
+void test_state_carrier_override_reaches_channel() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter(&channel, &encoder);
+    HoldRepeater repeater(&transmitter, &encoder);
+    TransmitQueue queue(&transmitter, &repeater, fakeClock);
+    transmitter.begin();
+    
+    TEST_ASSERT_TRUE(transmitter.transmitState(AcProtocol::DAIKIN, kDaikinState, 35, 40, 33).success);
+    TEST_ASSERT_EQUAL(40000, channel.carrierFrequencyHz);
+    TEST_ASSERT_EQUAL(33, channel.carrierDutyPercent);
+    
+    // Through the queue, and back to the descriptor's own with 0
+    TransmitRequest request;
+    request.action = TransmitAction::STATE;
+    request.acProtocol = AcProtocol::DAIKIN;
+    request.stateLength = 35;
+    request.carrierKHz = 36;
+    request.dutyPercent = 25;
+    memcpy(request.state, kDaikinState, 35);
+    TEST_ASSERT_TRUE(queue.submit(request));
+    queue.service();
+    TEST_ASSERT_EQUAL(36000, channel.carrierFrequencyHz);
+    TEST_ASSERT_EQUAL(25, channel.carrierDutyPercent);
+    
+    request.carrierKHz = 0;
+    request.dutyPercent = 0;
+    TEST_ASSERT_TRUE(queue.submit(request));
+    queue.service();
+    TEST_ASSERT_EQUAL(38000, channel.carrierFrequencyHz);
+    TEST_ASSERT_EQUAL(50, channel.carrierDutyPercent);
+    TEST_ASSERT_EQUAL(3, channel.writeCount);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_sum_checksum_per_section);
+    RUN_TEST(test_xor_checksum);
+    RUN_TEST(test_names_resolve);
+    RUN_TEST(test_toshiba_layout_msb_first_sent_twice);
+    RUN_TEST(test_daikin_preamble_and_sections);
+    RUN_TEST(test_daikin_streams_gap_free_past_symbol_buffer);
+    RUN_TEST(test_long_gaps_split_across_halves);
+    RUN_TEST(test_transmit_state_fills_checksum_and_validates);
+    RUN_TEST(test_queue_sends_state_requests);
+    RUN_TEST(test_state_carrier_override_reaches_channel);
+
+    UNITY_END();
+
+    return 0;
+}
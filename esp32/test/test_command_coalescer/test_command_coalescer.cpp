@@ -0,0 +1,177 @@
+#include <unity.h>
+#include <vector>
+#include "utils/CommandCoalescer.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+struct Emitted {
+    uint64_t value;
+    uint8_t repeatCount;
+};
+
+static std::vector<Emitted> emitted;
+
+static void recordEmit(const PendingCommand& cmd) {
+    Emitted e = {cmd.value, cmd.repeatCount};
+    emitted.push_back(e);
+}
+
+static PendingCommand makeTap(uint64_t value) {
+    PendingCommand cmd;
+    cmd.protocol = "NEC";
+    cmd.protocolId = IRProtocol::NEC;
+    cmd.value = value;
+    cmd.bits = 32;
+    return cmd;
+}
+
+// ============== Coalescer Tests ==============
+
+void test_first_tap_goes_out_immediately() {
+    emitted.clear();
+    CommandCoalescer coalescer;
+    
+    coalescer.offer(makeTap(0xA), 1000, recordEmit);
+    TEST_ASSERT_EQUAL(1, emitted.size());
+    TEST_ASSERT_EQUAL(1, emitted[0].repeatCount);
+    TEST_ASSERT_TRUE(coalescer.isOpen());
+    
+    // Nothing merged: the window closes without a second job
+    coalescer.update(1000 + CommandCoalescer::kWindowMs, recordEmit);
+    TEST_ASSERT_EQUAL(1, emitted.size());
+    TEST_ASSERT_FALSE(coalescer.isOpen());
+    TEST_ASSERT_EQUAL(0, coalescer.getRunCount());
+}
+
+void test_rapid_taps_merge_into_one_job() {
+    emitted.clear();
+    CommandCoalescer coalescer;
+    
+    // Ten volume-ups, 80ms apart: each tap extends the window
+    for (uint32_t i = 0; i < 10; i++) {
+        coalescer.offer(makeTap(0xA), 1000 + i * 80, recordEmit);
+    }
+    TEST_ASSERT_EQUAL(1, emitted.size());
+    
+    coalescer.update(1720 + CommandCoalescer::kWindowMs - 1, recordEmit);
+    TEST_ASSERT_EQUAL(1, emitted.size());
+    coalescer.update(1720 + CommandCoalescer::kWindowMs, recordEmit);
+    
+    TEST_ASSERT_EQUAL(2, emitted.size());
+    TEST_ASSERT_EQUAL(9, emitted[1].repeatCount);
+    TEST_ASSERT_EQUAL(9, coalescer.getMergedCount());
+    TEST_ASSERT_EQUAL(1, coalescer.getRunCount());
+}
+
+void test_different_command_flushes_run() {
+    emitted.clear();
+    CommandCoalescer coalescer;
+    
+    coalescer.offer(makeTap(0xA), 0, recordEmit);
+    coalescer.offer(makeTap(0xA), 50, recordEmit);
+    coalescer.offer(makeTap(0xA), 100, recordEmit);
+    coalescer.offer(makeTap(0xB), 120, recordEmit);
+    
+    // A, then the merged As, then B, in order
+    TEST_ASSERT_EQUAL(3, emitted.size());
+    TEST_ASSERT_EQUAL_HEX64(0xA, emitted[1].value);
+    TEST_ASSERT_EQUAL(2, emitted[1].repeatCount);
+    TEST_ASSERT_EQUAL_HEX64(0xB, emitted[2].value);
+    TEST_ASSERT_EQUAL(1, emitted[2].repeatCount);
+}
+
+void test_same_code_on_other_output_not_merged() {
+    emitted.clear();
+    CommandCoalescer coalescer;
+    PendingCommand other = makeTap(0xA);
+    other.output = 1;
+    
+    // Two TVs of the same model: each gets its own volume-up
+    coalescer.offer(makeTap(0xA), 0, recordEmit);
+    coalescer.offer(other, 50, recordEmit);
+    coalescer.offer(makeTap(0xA), 100, recordEmit);
+    
+    TEST_ASSERT_EQUAL(3, emitted.size());
+    TEST_ASSERT_EQUAL(0, coalescer.getMergedCount());
+}
+
+void test_tap_after_window_starts_new_run() {
+    emitted.clear();
+    CommandCoalescer coalescer;
+    
+    coalescer.offer(makeTap(0xA), 0, recordEmit);
+    coalescer.offer(makeTap(0xA), CommandCoalescer::kWindowMs, recordEmit);
+    
+    TEST_ASSERT_EQUAL(2, emitted.size());
+    TEST_ASSERT_EQUAL(1, emitted[1].repeatCount);
+    TEST_ASSERT_EQUAL(0, coalescer.getMergedCount());
+}
+
+void test_run_capped_at_max_repeat() {
+    emitted.clear();
+    CommandCoalescer coalescer;
+    
+    for (uint32_t i = 0; i <= CommandCoalescer::kMaxRepeat + 2; i++) {
+        coalescer.offer(makeTap(0xA), i * 10, recordEmit);
+    }
+    
+    TEST_ASSERT_EQUAL(2, emitted.size());
+    TEST_ASSERT_EQUAL(CommandCoalescer::kMaxRepeat, emitted[1].repeatCount);
+    
+    coalescer.flush(recordEmit);
+    TEST_ASSERT_EQUAL(3, emitted.size());
+    TEST_ASSERT_EQUAL(2, emitted[2].repeatCount);
+}
+
+void test_only_plain_taps_merge() {
+    PendingCommand tap = makeTap(0xA);
+    TEST_ASSERT_TRUE(CommandCoalescer::canMerge(tap));
+    
+    PendingCommand press = tap;
+    press.event = CommandEvent::PRESS;
+    TEST_ASSERT_FALSE(CommandCoalescer::canMerge(press));
+    
+    PendingCommand raw = tap;
+    raw.rawLength = 10;
+    TEST_ASSERT_FALSE(CommandCoalescer::canMerge(raw));
+    
+    PendingCommand unknown = tap;
+    unknown.protocolId = IRProtocol::UNKNOWN;
+    TEST_ASSERT_FALSE(CommandCoalescer::canMerge(unknown));
+}
+
+void test_window_wraps_with_millis() {
+    emitted.clear();
+    CommandCoalescer coalescer;
+    
+    coalescer.offer(makeTap(0xA), 0xFFFFFFF0, recordEmit);
+    coalescer.offer(makeTap(0xA), 0x00000020, recordEmit);
+    coalescer.update(0x00000020 + CommandCoalescer::kWindowMs, recordEmit);
+    
+    TEST_ASSERT_EQUAL(2, emitted.size());
+    TEST_ASSERT_EQUAL(1, emitted[1].repeatCount);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_first_tap_goes_out_immediately);
+    RUN_TEST(test_rapid_taps_merge_into_one_job);
+    RUN_TEST(test_different_command_flushes_run);
+    RUN_TEST(test_same_code_on_other_output_not_merged);
+    RUN_TEST(test_tap_after_window_starts_new_run);
+    RUN_TEST(test_run_capped_at_max_repeat);
+    RUN_TEST(test_only_plain_taps_merge);
+    RUN_TEST(test_window_wraps_with_millis);
+
+    UNITY_END();
+
+    return 0;
+}
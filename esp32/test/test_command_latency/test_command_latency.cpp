@@ -0,0 +1,180 @@
+#include <unity.h>
+#include <cstring>
+#include "transmitter/IRLibProtocolEncoders.h"
+#include "transmitter/RmtIRTransmitter.h"
+#include "transmitter/TransmitQueue.h"
+#include "utils/CommandLatency.h"
+#include "utils/LatencyHistogram.h"
+#include "mock_rmt_channel.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// ============== Histogram Tests ==============
+
+void test_bucket_boundaries() {
+    TEST_ASSERT_EQUAL(0, LatencyHistogram::bucketFor(0));
+    TEST_ASSERT_EQUAL(1, LatencyHistogram::bucketFor(1));
+    TEST_ASSERT_EQUAL(2, LatencyHistogram::bucketFor(2));
+    TEST_ASSERT_EQUAL(2, LatencyHistogram::bucketFor(3));
+    TEST_ASSERT_EQUAL(11, LatencyHistogram::bucketFor(1024));
+    TEST_ASSERT_EQUAL(LatencyHistogram::kBucketCount - 1, LatencyHistogram::bucketFor(UINT32_MAX));
+    TEST_ASSERT_EQUAL(1024, LatencyHistogram::bucketUpperUs(10));
+}
+
+void test_min_max_mean() {
+    LatencyHistogram histogram;
+    histogram.record(100);
+    histogram.record(300);
+    histogram.record(200);
+    
+    TEST_ASSERT_EQUAL(3, histogram.getCount());
+    TEST_ASSERT_EQUAL(100, histogram.getMinUs());
+    TEST_ASSERT_EQUAL(300, histogram.getMaxUs());
+    TEST_ASSERT_EQUAL(200, histogram.getMeanUs());
+}
+
+void test_percentiles_expose_tail() {
+    LatencyHistogram histogram;
+    for (int i = 0; i < 98; i++) {
+        histogram.record(1500);     // Bucket [1024, 2048)
+    }
+    histogram.record(90000);        // Bucket [65536, 131072)
+    histogram.record(250000);       // Bucket [131072, 262144)
+    
+    TEST_ASSERT_EQUAL(2048, histogram.percentileUs(50));
+    TEST_ASSERT_EQUAL(2048, histogram.percentileUs(98));
+    TEST_ASSERT_EQUAL(131072, histogram.percentileUs(99));
+    TEST_ASSERT_EQUAL(250000, histogram.percentileUs(100));  // Clamped to max
+}
+
+void test_reset_clears() {
+    LatencyHistogram histogram;
+    histogram.record(42);
+    histogram.reset();
+    
+    TEST_ASSERT_EQUAL(0, histogram.getCount());
+    TEST_ASSERT_EQUAL(0, histogram.getMinUs());
+    TEST_ASSERT_EQUAL(0, histogram.percentileUs(99));
+}
+
+// ============== Stage Tests ==============
+
+void test_stages_from_timestamps() {
+    CommandLatency latency;
+    CommandTimestamps t;
+    t.streamUs = 1000;
+    t.handoffUs = 9000;
+    t.dispatchUs = 9050;
+    t.txStartUs = 9300;
+    t.txEndUs = 9800;
+    latency.record(t);
+    
+    TEST_ASSERT_EQUAL(8000, latency.stage(LatencyStage::STREAM_TO_HANDOFF).getMaxUs());
+    TEST_ASSERT_EQUAL(50, latency.stage(LatencyStage::HANDOFF_TO_DISPATCH).getMaxUs());
+    TEST_ASSERT_EQUAL(250, latency.stage(LatencyStage::DISPATCH_TO_TX_START).getMaxUs());
+    TEST_ASSERT_EQUAL(500, latency.stage(LatencyStage::TX_START_TO_END).getMaxUs());
+    TEST_ASSERT_EQUAL(8800, latency.stage(LatencyStage::TOTAL).getMaxUs());
+}
+
+void test_unstamped_stages_skipped() {
+    CommandLatency latency;
+    CommandTimestamps t;
+    t.dispatchUs = 500;
+    t.txStartUs = 700;
+    t.txEndUs = 900;
+    latency.record(t);
+    
+    TEST_ASSERT_EQUAL(0, latency.stage(LatencyStage::STREAM_TO_HANDOFF).getCount());
+    TEST_ASSERT_EQUAL(1, latency.stage(LatencyStage::DISPATCH_TO_TX_START).getCount());
+    TEST_ASSERT_EQUAL(400, latency.stage(LatencyStage::TOTAL).getMaxUs());
+}
+
+void test_timestamp_wrap() {
+    CommandLatency latency;
+    CommandTimestamps t;
+    t.txStartUs = 0xFFFFFF00;
+    t.txEndUs = 0x100;
+    latency.record(t);
+    
+    TEST_ASSERT_EQUAL(0x200, latency.stage(LatencyStage::TX_START_TO_END).getMaxUs());
+}
+
+void test_format_lists_every_stage() {
+    CommandLatency latency;
+    CommandTimestamps t;
+    t.streamUs = 1;
+    t.handoffUs = 2;
+    t.dispatchUs = 3;
+    t.txStartUs = 4;
+    t.txEndUs = 5;
+    latency.record(t);
+    
+    char report[768];
+    size_t length = latency.format(report, sizeof(report));
+    TEST_ASSERT_EQUAL(strlen(report), length);
+    TEST_ASSERT_NOT_NULL(strstr(report, "stream->handoff"));
+    TEST_ASSERT_NOT_NULL(strstr(report, "total"));
+    
+    // Truncation stays inside the buffer
+    char small[40];
+    length = latency.format(small, sizeof(small));
+    TEST_ASSERT_EQUAL(sizeof(small) - 1, length);
+    TEST_ASSERT_EQUAL(length, strlen(small));
+}
+
+// ============== Transmit Queue Integration ==============
+
+static uint64_t fakeNowUs = 0;
+static uint64_t fakeClock() { return fakeNowUs; }
+
+void test_queue_stamps_transmit() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter(&channel, &encoder);
+    HoldRepeater repeater(&transmitter, &encoder);
+    CommandLatency latency;
+    TransmitQueue queue(&transmitter, &repeater, fakeClock, &latency);
+    transmitter.begin();
+    
+    TransmitRequest request;
+    request.action = TransmitAction::SEND;
+    request.protocol = IRProtocol::NEC;
+    request.value = 0xF708FB04;
+    request.bits = 32;
+    request.timestamps.streamUs = 1000;
+    request.timestamps.handoffUs = 2000;
+    request.timestamps.dispatchUs = 2100;
+    
+    fakeNowUs = 2100;
+    queue.submit(request);
+    fakeNowUs = 2600;
+    queue.service();
+    
+    TEST_ASSERT_EQUAL(500, latency.stage(LatencyStage::DISPATCH_TO_TX_START).getMaxUs());
+    TEST_ASSERT_EQUAL(1, latency.stage(LatencyStage::TOTAL).getCount());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_bucket_boundaries);
+    RUN_TEST(test_min_max_mean);
+    RUN_TEST(test_percentiles_expose_tail);
+    RUN_TEST(test_reset_clears);
+    RUN_TEST(test_stages_from_timestamps);
+    RUN_TEST(test_unstamped_stages_skipped);
+    RUN_TEST(test_timestamp_wrap);
+    RUN_TEST(test_format_lists_every_stage);
+    RUN_TEST(test_queue_stamps_transmit);
+
+    UNITY_END();
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <unity.h>
+#include <vector>
+#include "utils/CommandSequencer.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+static std::vector<uint64_t> dispatched;
+
+static void recordDispatch(const PendingCommand& cmd) {
+    dispatched.push_back(cmd.value);
+}
+
+static CommandBatch makeBatch(uint8_t count, uint16_t gapMs) {
+    CommandBatch batch;
+    for (uint8_t i = 0; i < count; i++) {
+        batch.commands[i].protocol = "NEC";
+        batch.commands[i].protocolId = IRProtocol::NEC;
+        batch.commands[i].value = 0x100 + i;
+        batch.commands[i].bits = 32;
+        batch.commands[i].gapMs = gapMs;
+    }
+    batch.count = count;
+    return batch;
+}
+
+// ============== Sequencer Tests ==============
+
+void test_steps_without_gap_go_back_to_back() {
+    dispatched.clear();
+    CommandSequencer sequencer;
+    
+    TEST_ASSERT_TRUE(sequencer.start(makeBatch(4, 0), 1000));
+    TEST_ASSERT_TRUE(sequencer.update(1000, recordDispatch));
+    
+    TEST_ASSERT_EQUAL(4, dispatched.size());
+    TEST_ASSERT_EQUAL_HEX64(0x100, dispatched[0]);
+    TEST_ASSERT_EQUAL_HEX64(0x103, dispatched[3]);
+    TEST_ASSERT_FALSE(sequencer.isActive());
+}
+
+void test_gap_holds_next_step() {
+    dispatched.clear();
+    CommandSequencer sequencer;
+    CommandBatch batch = makeBatch(3, 0);
+    batch.commands[0].gapMs = 250;
+    
+    sequencer.start(batch, 1000);
+    TEST_ASSERT_FALSE(sequencer.update(1000, recordDispatch));
+    TEST_ASSERT_EQUAL(1, dispatched.size());
+    TEST_ASSERT_EQUAL(2, sequencer.getRemaining());
+    
+    TEST_ASSERT_FALSE(sequencer.update(1249, recordDispatch));
+    TEST_ASSERT_EQUAL(1, dispatched.size());
+    
+    // Step 2 has no gap, so step 3 follows in the same update
+    TEST_ASSERT_TRUE(sequencer.update(1250, recordDispatch));
+    TEST_ASSERT_EQUAL(3, dispatched.size());
+}
+
+void test_completion_reported_once() {
+    dispatched.clear();
+    CommandSequencer sequencer;
+    
+    sequencer.start(makeBatch(1, 0), 0);
+    TEST_ASSERT_TRUE(sequencer.update(0, recordDispatch));
+    TEST_ASSERT_FALSE(sequencer.update(10, recordDispatch));
+    TEST_ASSERT_EQUAL(1, dispatched.size());
+}
+
+void test_start_rejected_while_playing() {
+    dispatched.clear();
+    CommandSequencer sequencer;
+    
+    TEST_ASSERT_TRUE(sequencer.start(makeBatch(2, 100), 0));
+    sequencer.update(0, recordDispatch);
+    TEST_ASSERT_FALSE(sequencer.start(makeBatch(2, 0), 10));
+    
+    TEST_ASSERT_TRUE(sequencer.update(100, recordDispatch));
+    TEST_ASSERT_TRUE(sequencer.start(makeBatch(2, 0), 110));
+}
+
+void test_empty_batch_rejected() {
+    CommandSequencer sequencer;
+    TEST_ASSERT_FALSE(sequencer.start(CommandBatch(), 0));
+    TEST_ASSERT_FALSE(sequencer.isActive());
+}
+
+void test_gap_survives_millis_wrap() {
+    dispatched.clear();
+    CommandSequencer sequencer;
+    
+    sequencer.start(makeBatch(2, 100), 0xFFFFFFC0);
+    sequencer.update(0xFFFFFFC0, recordDispatch);
+    TEST_ASSERT_FALSE(sequencer.update(0xFFFFFFF0, recordDispatch));
+    TEST_ASSERT_TRUE(sequencer.update(0x30, recordDispatch));
+    TEST_ASSERT_EQUAL(2, dispatched.size());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_steps_without_gap_go_back_to_back);
+    RUN_TEST(test_gap_holds_next_step);
+    RUN_TEST(test_completion_reported_once);
+    RUN_TEST(test_start_rejected_while_playing);
+    RUN_TEST(test_empty_batch_rejected);
+    RUN_TEST(test_gap_survives_millis_wrap);
+
+    UNITY_END();
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include <unity.h>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include "transmitter/IRLibProtocolEncoders.h"
+
+// Count every heap allocation in this test binary
+static int allocations = 0;
+static int liveAllocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    liveAllocations++;
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    allocations++;
+    liveAllocations++;
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept {
+    if (p) {
+        liveAllocations--;
+        free(p);
+    }
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+static_assert(!std::is_copy_constructible<EncodedSignal>::value, "EncodedSignal must be move-only");
+static_assert(!std::is_copy_assignable<EncodedSignal>::value, "EncodedSignal must be move-only");
+static_assert(std::is_move_constructible<EncodedSignal>::value, "EncodedSignal must be movable");
+
+// Unity requires these functions
+void setUp(void) {
+    allocations = 0;
+    liveAllocations = 0;
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// ============== Caller-Owned Buffer Tests ==============
+
+void test_span_encode_performs_no_heap_allocation() {
+    IRLibProtocolEncoders encoder;
+    uint16_t buffer[128];
+    
+    allocations = 0;
+    for (uint32_t i = 0; i < 1000; i++) {
+        TEST_ASSERT_EQUAL(67, encoder.encode("NEC", i & 0xFF, (i >> 8) & 0xFF, 32, TimingSpan(buffer, 128)));
+        TEST_ASSERT_EQUAL(67, encoder.encodeValue("SAMSUNG", 0xE0E040BF + i, 32, TimingSpan(buffer, 128)));
+        TEST_ASSERT_EQUAL(25, encoder.encodeValue("SONY", i & 0xFFF, 12, TimingSpan(buffer, 128)));
+    }
+    
+    TEST_ASSERT_EQUAL(0, allocations);
+}
+
+void test_span_encode_matches_allocating_encode() {
+    IRLibProtocolEncoders encoder;
+    uint16_t buffer[128];
+    
+    uint16_t length = encoder.encode("NEC", 0x04, 0x08, 32, TimingSpan(buffer, 128));
+    EncodedSignal signal = encoder.encode("NEC", 0x04, 0x08, 32);
+    
+    TEST_ASSERT_EQUAL(signal.rawLength, length);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(signal.rawData, buffer, length);
+}
+
+void test_span_too_small_reports_needed_length() {
+    IRLibProtocolEncoders encoder;
+    uint16_t buffer[8] = {0};
+    
+    TEST_ASSERT_EQUAL(67, encoder.encodeValue("NEC", 0xF708FB04, 32, TimingSpan(buffer, 8)));
+    TEST_ASSERT_EQUAL(0, buffer[0]);  // Nothing written
+    
+    // Sizing query with an empty span
+    TEST_ASSERT_EQUAL(25, encoder.encodeValue("SONY", 0x95, 12, TimingSpan()));
+}
+
+void test_span_encode_unknown_protocol_returns_zero() {
+    IRLibProtocolEncoders encoder;
+    uint16_t buffer[128];
+    
+    TEST_ASSERT_EQUAL(0, encoder.encodeValue("FOO", 1, 32, TimingSpan(buffer, 128)));
+}
+
+void test_arena_hands_out_consecutive_frames() {
+    IRLibProtocolEncoders encoder;
+    TimingArena<150> arena;
+    
+    allocations = 0;
+    uint16_t first = encoder.encodeValue("NEC", 0xF708FB04, 32, arena.remaining());
+    arena.commit(first);
+    uint16_t second = encoder.encodeValue("SONY", 0x95, 12, arena.remaining());
+    arena.commit(second);
+    
+    TEST_ASSERT_EQUAL(67 + 25, arena.size());
+    
+    // A third NEC frame no longer fits: length is reported, arena unchanged
+    uint16_t third = encoder.encodeValue("NEC", 0xF708FB04, 32, arena.remaining());
+    TEST_ASSERT_EQUAL(67, third);
+    TEST_ASSERT_TRUE(third > 150 - arena.size());
+    TEST_ASSERT_EQUAL(0, arena.allocate(third).capacity);
+    
+    TEST_ASSERT_EQUAL(0, allocations);
+}
+
+// ============== Ownership Tests ==============
+
+void test_encoded_signal_frees_owned_buffer() {
+    IRLibProtocolEncoders encoder;
+    
+    {
+        EncodedSignal signal = encoder.encode("NEC", 0x04, 0x08, 32);
+        TEST_ASSERT_TRUE(signal.ownsRawData());
+        TEST_ASSERT_EQUAL(1, liveAllocations);
+    }
+    
+    TEST_ASSERT_EQUAL(0, liveAllocations);
+}
+
+void test_encoded_signal_move_transfers_ownership() {
+    IRLibProtocolEncoders encoder;
+    
+    EncodedSignal source = encoder.encodeValue("SAMSUNG", 0xE0E040BF, 32);
+    uint16_t* data = source.rawData;
+    
+    EncodedSignal target = std::move(source);
+    TEST_ASSERT_EQUAL_PTR(data, target.rawData);
+    TEST_ASSERT_TRUE(target.ownsRawData());
+    TEST_ASSERT_NULL(source.rawData);
+    TEST_ASSERT_FALSE(source.ownsRawData());
+    
+    // Reassigning releases the previous buffer
+    target = encoder.encodeValue("NEC", 0xF708FB04, 32);
+    TEST_ASSERT_EQUAL(1, liveAllocations);
+}
+
+void test_raw_signal_borrows_caller_buffer() {
+    IRLibProtocolEncoders encoder;
+    uint16_t rawData[] = {9000, 4500, 560};
+    
+    {
+        EncodedSignal signal = encoder.encodeRaw(rawData, 3, 38);
+        TEST_ASSERT_FALSE(signal.ownsRawData());
+    }
+    
+    // Still ours and untouched after the signal is gone
+    TEST_ASSERT_EQUAL(9000, rawData[0]);
+    TEST_ASSERT_EQUAL(0, allocations);
+}
+
+void test_borrowing_releases_owned_buffer() {
+    IRLibProtocolEncoders encoder;
+    uint16_t rawData[] = {9000, 4500, 560};
+    
+    EncodedSignal signal = encoder.encode("NEC", 0x04, 0x08, 32);
+    TEST_ASSERT_EQUAL(1, liveAllocations);
+    
+    // The view moves to the caller's buffer; the owned one is freed now,
+    // and the caller's is never freed
+    signal.borrow(rawData, 3);
+    TEST_ASSERT_EQUAL(0, liveAllocations);
+    TEST_ASSERT_FALSE(signal.ownsRawData());
+    TEST_ASSERT_EQUAL_PTR(rawData, signal.rawData);
+    
+    EncodedSignal moved = std::move(signal);
+    TEST_ASSERT_EQUAL_PTR(rawData, moved.rawData);
+    TEST_ASSERT_FALSE(moved.ownsRawData());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_span_encode_performs_no_heap_allocation);
+    RUN_TEST(test_span_encode_matches_allocating_encode);
+    RUN_TEST(test_span_too_small_reports_needed_length);
+    RUN_TEST(test_span_encode_unknown_protocol_returns_zero);
+    RUN_TEST(test_arena_hands_out_consecutive_frames);
+    RUN_TEST(test_encoded_signal_frees_owned_buffer);
+    RUN_TEST(test_encoded_signal_move_transfers_ownership);
+    RUN_TEST(test_raw_signal_borrows_caller_buffer);
+    RUN_TEST(test_borrowing_releases_owned_buffer);
+
+    UNITY_END();
+
+    return 0;
+}
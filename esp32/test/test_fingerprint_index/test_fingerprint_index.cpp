@@ -0,0 +1,258 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "receiver/SignalFingerprint.h"
+#include "utils/FingerprintIndex.h"
+
+// The file as a vector, with write failures on demand
+class MemoryFingerprintStore : public IFingerprintStore {
+public:
+    std::vector<FingerprintEntry> entries;
+    bool failWrites = false;
+    
+    uint32_t load(uint32_t offset, FingerprintEntry* out, uint32_t capacity) override {
+        uint32_t read = 0;
+        while (offset + read < entries.size() && read < capacity) {
+            out[read] = entries[offset + read];
+            read++;
+        }
+        return read;
+    }
+    
+    bool append(const FingerprintEntry& entry) override {
+        if (failWrites) {
+            return false;
+        }
+        entries.push_back(entry);
+        return true;
+    }
+    
+    bool clear() override {
+        entries.clear();
+        return true;
+    }
+};
+
+// NEC-like frame: header, 32 pulse-distance bits, footer, with every
+// duration off by up to +/-jitter percent
+std::vector<uint16_t> necFrame(uint32_t value, int jitter, uint32_t seed) {
+    std::vector<uint16_t> frame = {9000, 4500};
+    for (int i = 31; i >= 0; i--) {
+        frame.push_back(560);
+        frame.push_back((value >> i) & 1 ? 1690 : 560);
+    }
+    frame.push_back(560);
+    for (uint16_t& duration : frame) {
+        seed = seed * 1103515245u + 12345u;
+        int percent = (int)((seed >> 16) % (2 * jitter + 1)) - jitter;
+        duration = (uint16_t)(duration * (100 + percent) / 100);
+    }
+    return frame;
+}
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// ============== Fingerprint Tests ==============
+
+void test_jittered_captures_of_one_frame_share_a_fingerprint() {
+    std::vector<uint16_t> clean = necFrame(0x20DF10EF, 0, 0);
+    uint32_t expected = signal_fingerprint::ofTimings(clean.data(), clean.size());
+    for (uint32_t seed = 1; seed <= 200; seed++) {
+        std::vector<uint16_t> capture = necFrame(0x20DF10EF, 8, seed);
+        TEST_ASSERT_EQUAL_HEX32(expected, signal_fingerprint::ofTimings(capture.data(), capture.size()));
+    }
+}
+
+void test_different_frames_have_different_fingerprints() {
+    std::vector<uint16_t> frame = necFrame(0x20DF10EF, 0, 0);
+    uint32_t base = signal_fingerprint::ofTimings(frame.data(), frame.size());
+    for (int bit = 0; bit < 32; bit++) {
+        std::vector<uint16_t> other = necFrame(0x20DF10EF ^ (1u << bit), 0, 0);
+        TEST_ASSERT_TRUE(base != signal_fingerprint::ofTimings(other.data(), other.size()));
+    }
+    // A frame cut short is another frame
+    TEST_ASSERT_TRUE(base != signal_fingerprint::ofTimings(frame.data(), frame.size() - 2));
+}
+
+void test_forms_do_not_collide() {
+    uint32_t known = signal_fingerprint::ofCode(IRProtocol::NEC, 0x20DF10EF, 32);
+    TEST_ASSERT_TRUE(known != signal_fingerprint::ofCode(IRProtocol::NEC, 0x20DF10EF, 24));
+    TEST_ASSERT_TRUE(known != signal_fingerprint::ofCode(IRProtocol::SAMSUNG, 0x20DF10EF, 32));
+    TEST_ASSERT_TRUE(known != signal_fingerprint::ofInferred(BitCoding::PULSE_DISTANCE, 0x20DF10EF, 32));
+    TEST_ASSERT_TRUE(signal_fingerprint::ofInferred(BitCoding::PULSE_DISTANCE, 0x20DF10EF, 32) !=
+                     signal_fingerprint::ofInferred(BitCoding::PULSE_WIDTH, 0x20DF10EF, 32));
+    TEST_ASSERT_TRUE(signal_fingerprint::ofTimings(nullptr, 0) != 0);
+}
+
+void test_decoded_signal_picks_its_form() {
+    RawTimingPool pool(1);  // Outlives the signal's block
+    DecodedSignal signal;
+    signal.protocol = "NEC";
+    signal.isKnownProtocol = true;
+    signal.value = 0x20DF10EF;
+    signal.bits = 32;
+    TEST_ASSERT_EQUAL_HEX32(signal_fingerprint::ofCode(IRProtocol::NEC, 0x20DF10EF, 32),
+                            signal_fingerprint::of(signal));
+    
+    signal.protocol = "RAW";
+    signal.isKnownProtocol = false;
+    signal.isInferred = true;
+    signal.inferred.coding = BitCoding::PULSE_WIDTH;
+    TEST_ASSERT_EQUAL_HEX32(signal_fingerprint::ofInferred(BitCoding::PULSE_WIDTH, 0x20DF10EF, 32),
+                            signal_fingerprint::of(signal));
+    
+    // RAW: rawbuf ticks, leading gap skipped
+    std::vector<uint16_t> frame = necFrame(0x20DF10EF, 0, 0);
+    std::vector<uint16_t> rawbuf = {60000};
+    for (uint16_t duration : frame) {
+        rawbuf.push_back(duration / kRawTick);
+    }
+    signal.isInferred = false;
+    signal.rawTimings = pool.acquire(rawbuf.data(), rawbuf.size());
+    TEST_ASSERT_EQUAL_HEX32(signal_fingerprint::ofTimings(frame.data(), frame.size()),
+                            signal_fingerprint::of(signal));
+}
+
+// ============== Index Tests ==============
+
+void test_learning_twice_returns_the_first_id() {
+    MemoryFingerprintStore store;
+    FingerprintIndex index(&store, 64);
+    TEST_ASSERT_TRUE(index.begin());
+    TEST_ASSERT_EQUAL(FingerprintIndex::kNotFound, index.find(0x1234));
+    
+    bool isNew = false;
+    TEST_ASSERT_EQUAL(1, index.learn(0x1234, &isNew));
+    TEST_ASSERT_TRUE(isNew);
+    TEST_ASSERT_EQUAL(2, index.learn(0x5678, &isNew));
+    TEST_ASSERT_EQUAL(1, index.learn(0x1234, &isNew));
+    TEST_ASSERT_FALSE(isNew);
+    TEST_ASSERT_EQUAL(1, index.find(0x1234));
+    TEST_ASSERT_EQUAL(2, index.size());
+    TEST_ASSERT_EQUAL(2, store.entries.size());
+}
+
+void test_reload_restores_ids_and_continues_numbering() {
+    MemoryFingerprintStore store;
+    {
+        FingerprintIndex index(&store, 64);
+        index.begin();
+        bool isNew;
+        for (uint32_t i = 1; i <= 40; i++) {
+            index.learn(i * 2654435761u, &isNew);
+        }
+    }
+    
+    FingerprintIndex reloaded(&store, 64);
+    TEST_ASSERT_TRUE(reloaded.begin());
+    TEST_ASSERT_EQUAL(40, reloaded.size());
+    for (uint32_t i = 1; i <= 40; i++) {
+        TEST_ASSERT_EQUAL(i, reloaded.find(i * 2654435761u));
+    }
+    bool isNew;
+    TEST_ASSERT_EQUAL(41, reloaded.learn(0xABCDEF, &isNew));
+    TEST_ASSERT_TRUE(isNew);
+}
+
+void test_full_index_and_failed_writes_hand_out_no_id() {
+    MemoryFingerprintStore store;
+    FingerprintIndex index(&store, 16);  // 12 entries
+    TEST_ASSERT_EQUAL(12, index.getCapacity());
+    index.begin();
+    bool isNew;
+    for (uint32_t i = 1; i <= 12; i++) {
+        TEST_ASSERT_EQUAL(i, index.learn(i, &isNew));
+    }
+    TEST_ASSERT_EQUAL(FingerprintIndex::kNotFound, index.learn(13, &isNew));
+    TEST_ASSERT_FALSE(isNew);
+    TEST_ASSERT_EQUAL(5, index.learn(5, &isNew));  // Still found
+    
+    // Not persisted = not learned
+    index.clear();
+    TEST_ASSERT_EQUAL(0, index.size());
+    TEST_ASSERT_EQUAL(0, store.entries.size());
+    store.failWrites = true;
+    TEST_ASSERT_EQUAL(FingerprintIndex::kNotFound, index.learn(7, &isNew));
+    TEST_ASSERT_EQUAL(FingerprintIndex::kNotFound, index.find(7));
+}
+
+void test_unallocated_index_misses() {
+    FingerprintIndex index(nullptr, 16);
+    bool isNew = true;
+    TEST_ASSERT_EQUAL(FingerprintIndex::kNotFound, index.find(1));
+    TEST_ASSERT_EQUAL(FingerprintIndex::kNotFound, index.learn(1, &isNew));
+    TEST_ASSERT_FALSE(isNew);
+}
+
+// ============== Benchmark ==============
+
+void test_ten_thousand_command_library() {
+    const uint32_t kLibrary = 10000;
+    MemoryFingerprintStore store;
+    FingerprintIndex index(&store);
+    TEST_ASSERT_TRUE(index.begin());
+    
+    // Fingerprints of a library of NEC codes, as the device would learn them
+    std::vector<uint32_t> fingerprints;
+    bool isNew;
+    for (uint32_t i = 0; i < kLibrary; i++) {
+        uint32_t fingerprint = signal_fingerprint::ofCode(IRProtocol::NEC, 0x20DF0000u + i * 7919u, 32);
+        fingerprints.push_back(fingerprint);
+        TEST_ASSERT_EQUAL(i + 1, index.learn(fingerprint, &isNew));
+    }
+    TEST_ASSERT_EQUAL(kLibrary, index.size());
+    
+    const int kRounds = 50;
+    uint32_t found = 0;
+    uint32_t missed = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < kRounds; round++) {
+        for (uint32_t i = 0; i < kLibrary; i++) {
+            found += index.find(fingerprints[i]) == i + 1;
+            missed += index.find(fingerprints[i] ^ 0x80000000u) == FingerprintIndex::kNotFound;
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                (2.0 * kRounds * kLibrary);
+    
+    // Reload as after a reboot
+    start = std::chrono::steady_clock::now();
+    FingerprintIndex reloaded(&store);
+    TEST_ASSERT_TRUE(reloaded.begin());
+    double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    printf("10k-command index: %u bytes, %u stored bytes, longest probe %u, lookup %.1f ns, load %.2f ms (host)\n",
+           (unsigned)index.getMemoryBytes(), (unsigned)(store.entries.size() * sizeof(FingerprintEntry)),
+           (unsigned)index.getLongestProbe(), ns, loadMs);
+    TEST_ASSERT_EQUAL(kRounds * kLibrary, found);
+    TEST_ASSERT_EQUAL(kRounds * kLibrary, missed);
+    TEST_ASSERT_EQUAL(kLibrary, reloaded.size());
+    TEST_ASSERT_EQUAL(131072, index.getMemoryBytes());
+    TEST_ASSERT_LESS_THAN(1000, ns);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_jittered_captures_of_one_frame_share_a_fingerprint);
+    RUN_TEST(test_different_frames_have_different_fingerprints);
+    RUN_TEST(test_forms_do_not_collide);
+    RUN_TEST(test_decoded_signal_picks_its_form);
+    RUN_TEST(test_learning_twice_returns_the_first_id);
+    RUN_TEST(test_reload_restores_ids_and_continues_numbering);
+    RUN_TEST(test_full_index_and_failed_writes_hand_out_no_id);
+    RUN_TEST(test_unallocated_index_misses);
+    RUN_TEST(test_ten_thousand_command_library);
+    
+    UNITY_END();
+    
+    return 0;
+}
@@ -0,0 +1,240 @@
+#include <unity.h>
+#include "receiver/FrameDecoder.h"
+#include "transmitter/FrameEncoder.h"
+#include "transmitter/IRLibProtocolEncoders.h"
+#include "transmitter/RmtIRTransmitter.h"
+#include "transmitter/WaveformCache.h"
+#include "mock_rmt_channel.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+static uint16_t timings[300];
+
+// Encode with the library encoder, decode with the descriptor-driven
+// decoder, and expect the same value back
+static void assertRoundTrip(IRProtocol protocol, uint64_t value, uint16_t bits) {
+    IRLibProtocolEncoders encoder;
+    uint16_t length = encoder.encodeValue(protocol, value, bits, TimingSpan(timings, 300));
+    TEST_ASSERT_TRUE(length > 0 && length <= 300);
+    
+    uint64_t decoded = 0;
+    TEST_ASSERT_TRUE(frame_decoder::decodeFrame(*findDescriptor(protocol), timings, length, bits, &decoded));
+    TEST_ASSERT_EQUAL_HEX64(value, decoded);
+    
+    uint64_t identified = 0;
+    uint16_t identifiedBits = 0;
+    TEST_ASSERT_EQUAL((int)protocol, (int)frame_decoder::identifyFrame(timings, length, &identified, &identifiedBits));
+    TEST_ASSERT_EQUAL(bits, identifiedBits);
+    TEST_ASSERT_EQUAL_HEX64(value, identified);
+}
+
+// ============== Round Trips ==============
+
+void test_nec_round_trip() {
+    assertRoundTrip(IRProtocol::NEC, 0xF708FB04, 32);
+}
+
+void test_samsung_round_trip() {
+    assertRoundTrip(IRProtocol::SAMSUNG, 0xE0E040BF, 32);
+}
+
+void test_sony_round_trip() {
+    assertRoundTrip(IRProtocol::SONY, 0xA90, 12);
+    assertRoundTrip(IRProtocol::SONY, 0x5A5A5, 20);
+}
+
+void test_rc5_round_trip() {
+    // Toggle bit (0x800) clear: a fresh encoder sends toggle 0 first
+    assertRoundTrip(IRProtocol::RC5, 0x10C, 12);
+    assertRoundTrip(IRProtocol::RC5, 0x7FF, 12);
+    assertRoundTrip(IRProtocol::RC5, 0x000, 12);
+}
+
+void test_rc6_round_trip() {
+    // Mode 0, toggle (0x10000) clear, address 0x04, command 0x0C
+    assertRoundTrip(IRProtocol::RC6, 0x0040C, 20);
+    assertRoundTrip(IRProtocol::RC6, 0x0FFFF, 20);
+    assertRoundTrip(IRProtocol::RC6, 0x00000, 20);
+}
+
+void test_panasonic_round_trip() {
+    assertRoundTrip(IRProtocol::PANASONIC, 0x40040100BCBDULL, 48);
+}
+
+void test_jvc_round_trip() {
+    assertRoundTrip(IRProtocol::JVC, 0xC5E8, 16);
+}
+
+void test_lg_round_trip() {
+    assertRoundTrip(IRProtocol::LG, 0x88C0051, 28);
+}
+
+void test_sharp_round_trip() {
+    assertRoundTrip(IRProtocol::SHARP, 0x454A, 15);
+}
+
+void test_address_command_encodes_round_trip() {
+    // Packing + engine for every protocol, checked against the decoder
+    const char* names[] = {"RC5", "RC6", "PANASONIC", "JVC", "LG", "SHARP"};
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        IRLibProtocolEncoders encoder;
+        EncodedSignal signal = encoder.encode(names[i], 0x0A, 0x15, findDescriptor(protocolFromName(names[i]))->defaultBits);
+        TEST_ASSERT_TRUE(signal.isKnownProtocol);
+        TEST_ASSERT_EQUAL_STRING(names[i], signal.protocol);
+        
+        uint64_t value = 0;
+        uint16_t bits = 0;
+        TEST_ASSERT_EQUAL((int)protocolFromName(names[i]),
+                          (int)frame_decoder::identifyFrame(signal.rawData, signal.rawLength, &value, &bits));
+    }
+}
+
+// ============== Frame Layout ==============
+
+void test_rc5_frame_merges_half_bits() {
+    IRLibProtocolEncoders encoder;
+    // Toggle 0, address 0, command 1: bits 1 1 | 0 | 00000 | 000001
+    uint16_t length = encoder.encodeValue(IRProtocol::RC5, 0x001, 12, TimingSpan(timings, 300));
+    
+    // First start bit's leading space is idle; S2 and toggle marks merge
+    TEST_ASSERT_EQUAL(889, timings[0]);
+    TEST_ASSERT_EQUAL(889, timings[1]);
+    TEST_ASSERT_EQUAL(1778, timings[2]);
+    // Ends on the last '1' bit's mark
+    TEST_ASSERT_EQUAL(889, timings[length - 1]);
+    TEST_ASSERT_EQUAL(1, length % 2);
+}
+
+void test_rc6_trailer_bit_is_double_width() {
+    IRLibProtocolEncoders encoder;
+    // Mode 000, toggle 0: the toggle's mark-first halves are 889us each
+    uint16_t length = encoder.encodeValue(IRProtocol::RC6, 0x00000, 20, TimingSpan(timings, 300));
+    TEST_ASSERT_TRUE(length > 0);
+    
+    // Header, start '1' (mark, space), mode 000 (space, mark each),
+    // toggle '0' at double width, then address bit 7 '0'
+    const uint16_t expected[] = {2666, 889, 444, 888, 444, 444, 444, 444, 444, 888, 888, 444};
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, timings, 12);
+}
+
+void test_sharp_sends_inverted_second_frame() {
+    IRLibProtocolEncoders encoder;
+    uint16_t length = encoder.encodeValue(IRProtocol::SHARP, 0x454A, 15, TimingSpan(timings, 300));
+    
+    // Two 31-timing frames around the gap
+    TEST_ASSERT_EQUAL(63, length);
+    TEST_ASSERT_EQUAL(SharpProtocol::descriptor().frameLength(15), length);
+    TEST_ASSERT_EQUAL(43602, timings[31]);
+    
+    uint64_t first = 0;
+    uint64_t second = 0;
+    const ProtocolDescriptor plain = {IRProtocol::SHARP, "SHARP", BitCoding::PULSE_DISTANCE, 0, 0,
+                                      260, 1820, 260, 780, 260, 0, false, 0, PROTOCOL_NO_BIT, PROTOCOL_NO_BIT,
+                                      BitOrder::MSB_FIRST, 15, 38, 33, 0, 0, 0, 0,
+                                      RepeatFrame::FULL, 0, 0};
+    TEST_ASSERT_TRUE(frame_decoder::decodeFrame(plain, timings, 31, 15, &first));
+    TEST_ASSERT_TRUE(frame_decoder::decodeFrame(plain, timings + 32, 31, 15, &second));
+    TEST_ASSERT_EQUAL_HEX64(0x454A, first);
+    TEST_ASSERT_EQUAL_HEX64(0x454A ^ 0x3FF, second);
+}
+
+void test_generic_engine_matches_unrolled() {
+    uint16_t unrolled[80];
+    uint16_t generic[80];
+    uint16_t a = frame_encoder::encodeFrame<NecProtocol, 32>(0xF708FB04, TimingSpan(unrolled, 80));
+    uint16_t b = frame_encoder::encodeFrame(NecProtocol::descriptor(), 0xF708FB04, 32, TimingSpan(generic, 80));
+    TEST_ASSERT_EQUAL(a, b);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(unrolled, generic, a);
+}
+
+// ============== Toggle Bit ==============
+
+void test_toggle_flips_on_each_press() {
+    IRLibProtocolEncoders encoder;
+    const ProtocolDescriptor& rc5 = *findDescriptor(IRProtocol::RC5);
+    uint64_t decoded = 0;
+    
+    uint16_t length = encoder.encodeValue(IRProtocol::RC5, 0x10C, 12, TimingSpan(timings, 300));
+    TEST_ASSERT_TRUE(frame_decoder::decodeFrame(rc5, timings, length, 12, &decoded));
+    TEST_ASSERT_EQUAL_HEX64(0x10C, decoded);
+    
+    // A stored value's own toggle is ignored; the encoder's state wins
+    length = encoder.encodeValue(IRProtocol::RC5, 0x10C, 12, TimingSpan(timings, 300));
+    TEST_ASSERT_TRUE(frame_decoder::decodeFrame(rc5, timings, length, 12, &decoded));
+    TEST_ASSERT_EQUAL_HEX64(0x90C, decoded);
+    
+    length = encoder.encodeValue(IRProtocol::RC5, 0x90C, 12, TimingSpan(timings, 300));
+    TEST_ASSERT_TRUE(frame_decoder::decodeFrame(rc5, timings, length, 12, &decoded));
+    TEST_ASSERT_EQUAL_HEX64(0x10C, decoded);
+}
+
+void test_size_query_does_not_toggle() {
+    IRLibProtocolEncoders encoder;
+    encoder.encodeValue(IRProtocol::RC6, 0x0040C, 20, TimingSpan());
+    TEST_ASSERT_FALSE(encoder.toggleState(IRProtocol::RC6));
+    
+    encoder.encodeValue(IRProtocol::RC6, 0x0040C, 20, TimingSpan(timings, 300));
+    TEST_ASSERT_TRUE(encoder.toggleState(IRProtocol::RC6));
+    TEST_ASSERT_FALSE(encoder.toggleState(IRProtocol::RC5));
+}
+
+void test_toggle_protocols_bypass_cache() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    WaveformCache cache(4, 256);
+    TEST_ASSERT_TRUE(cache.begin());
+    RmtIRTransmitter transmitter(&channel, &encoder, &cache);
+    transmitter.begin();
+    
+    TEST_ASSERT_TRUE(transmitter.transmitValue(IRProtocol::RC5, 0x10C, 12).success);
+    std::vector<uint16_t> firstPress = channel.timings();
+    TEST_ASSERT_TRUE(transmitter.transmitValue(IRProtocol::RC5, 0x10C, 12).success);
+    std::vector<uint16_t> secondPress = channel.timings();
+    
+    TEST_ASSERT_EQUAL(0, cache.size());
+    TEST_ASSERT_TRUE(firstPress != secondPress);
+    TEST_ASSERT_EQUAL(36000, channel.carrierFrequencyHz);
+}
+
+void test_corrupted_frame_rejected() {
+    IRLibProtocolEncoders encoder;
+    uint16_t length = encoder.encodeValue(IRProtocol::RC6, 0x0040C, 20, TimingSpan(timings, 300));
+    timings[5] = 3000;
+    
+    uint64_t value = 0;
+    TEST_ASSERT_FALSE(frame_decoder::decodeFrame(*findDescriptor(IRProtocol::RC6), timings, length, 20, &value));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_nec_round_trip);
+    RUN_TEST(test_samsung_round_trip);
+    RUN_TEST(test_sony_round_trip);
+    RUN_TEST(test_rc5_round_trip);
+    RUN_TEST(test_rc6_round_trip);
+    RUN_TEST(test_panasonic_round_trip);
+    RUN_TEST(test_jvc_round_trip);
+    RUN_TEST(test_lg_round_trip);
+    RUN_TEST(test_sharp_round_trip);
+    RUN_TEST(test_address_command_encodes_round_trip);
+    RUN_TEST(test_rc5_frame_merges_half_bits);
+    RUN_TEST(test_rc6_trailer_bit_is_double_width);
+    RUN_TEST(test_sharp_sends_inverted_second_frame);
+    RUN_TEST(test_generic_engine_matches_unrolled);
+    RUN_TEST(test_toggle_flips_on_each_press);
+    RUN_TEST(test_size_query_does_not_toggle);
+    RUN_TEST(test_toggle_protocols_bypass_cache);
+    RUN_TEST(test_corrupted_frame_rejected);
+
+    UNITY_END();
+
+    return 0;
+}
@@ -0,0 +1,205 @@
+#include <unity.h>
+#include "transmitter/HoldRepeater.h"
+#include "transmitter/IRLibProtocolEncoders.h"
+#include "transmitter/RmtIRTransmitter.h"
+#include "mock_rmt_channel.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Transmitter + encoder + repeater wired to a mock RMT channel
+struct HoldRig {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter;
+    HoldRepeater repeater;
+    
+    explicit HoldRig(uint32_t timeoutMs = HoldRepeater::kDefaultTimeoutMs)
+        : transmitter(&channel, &encoder), repeater(&transmitter, &encoder, timeoutMs) {
+        transmitter.begin();
+    }
+};
+
+// ============== Repeat Frames ==============
+
+void test_nec_hold_sends_repeat_code_every_108ms() {
+    HoldRig rig;
+    
+    TEST_ASSERT_TRUE(rig.repeater.press(IRProtocol::NEC, 0xF708FB04, 32, 1000).success);
+    TEST_ASSERT_EQUAL(67, rig.channel.timings().size());
+    TEST_ASSERT_TRUE(rig.repeater.isHolding());
+    
+    rig.repeater.update(1107);
+    TEST_ASSERT_EQUAL(1, rig.channel.writeCount);
+    
+    rig.repeater.update(1108);
+    TEST_ASSERT_EQUAL(2, rig.channel.writeCount);
+    const uint16_t repeatCode[] = {9000, 2250, 560};
+    TEST_ASSERT_EQUAL(3, rig.channel.timings().size());
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(repeatCode, rig.channel.timings().data(), 3);
+    
+    rig.repeater.update(1216);
+    TEST_ASSERT_EQUAL(3, rig.channel.writeCount);
+    TEST_ASSERT_EQUAL(2, rig.repeater.getRepeatCount());
+}
+
+void test_repeats_keep_the_press_carrier() {
+    HoldRig rig;
+    
+    TEST_ASSERT_TRUE(rig.repeater.press(IRProtocol::RC5, 0x10C, 12, 0).success);
+    TEST_ASSERT_EQUAL(36000, rig.channel.carrierFrequencyHz);
+    TEST_ASSERT_EQUAL(25, rig.channel.carrierDutyPercent);
+    rig.repeater.release();
+    
+    TEST_ASSERT_TRUE(rig.repeater.press(IRProtocol::NEC, 0xF708FB04, 32, 1000, 40, 50).success);
+    TEST_ASSERT_EQUAL(40000, rig.channel.carrierFrequencyHz);
+    rig.repeater.update(1108);
+    TEST_ASSERT_EQUAL(3, rig.channel.timings().size());
+    TEST_ASSERT_EQUAL(40000, rig.channel.carrierFrequencyHz);
+    TEST_ASSERT_EQUAL(50, rig.channel.carrierDutyPercent);
+}
+
+void test_samsung_hold_repeats_full_frame() {
+    HoldRig rig;
+    
+    rig.repeater.press(IRProtocol::SAMSUNG, 0xE0E0E01F, 32, 0);
+    std::vector<uint16_t> first = rig.channel.timings();
+    rig.repeater.update(108);
+    
+    TEST_ASSERT_EQUAL(2, rig.channel.writeCount);
+    TEST_ASSERT_TRUE(first == rig.channel.timings());
+}
+
+void test_jvc_hold_repeats_without_header() {
+    HoldRig rig;
+    
+    rig.repeater.press(IRProtocol::JVC, 0xC5E8, 16, 0);
+    std::vector<uint16_t> first = rig.channel.timings();
+    rig.repeater.update(60);
+    
+    std::vector<uint16_t> repeat = rig.channel.timings();
+    TEST_ASSERT_EQUAL(first.size() - 2, repeat.size());
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(first.data() + 2, repeat.data(), repeat.size());
+}
+
+void test_rc5_hold_keeps_toggle() {
+    HoldRig rig;
+    
+    rig.repeater.press(IRProtocol::RC5, 0x10C, 12, 0);
+    std::vector<uint16_t> first = rig.channel.timings();
+    rig.repeater.update(114);
+    TEST_ASSERT_TRUE(first == rig.channel.timings());
+    
+    // The next press is a new press and flips the toggle
+    rig.repeater.release();
+    rig.repeater.press(IRProtocol::RC5, 0x10C, 12, 500);
+    TEST_ASSERT_TRUE(first != rig.channel.timings());
+}
+
+// ============== Press / Release ==============
+
+void test_release_stops_repeats() {
+    HoldRig rig;
+    
+    rig.repeater.press(IRProtocol::NEC, 0xF708FB04, 32, 0);
+    rig.repeater.update(108);
+    rig.repeater.release();
+    TEST_ASSERT_FALSE(rig.repeater.isHolding());
+    
+    rig.repeater.update(216);
+    TEST_ASSERT_EQUAL(2, rig.channel.writeCount);
+}
+
+void test_sony_tap_still_sends_three_frames() {
+    HoldRig rig;
+    
+    rig.repeater.press(IRProtocol::SONY, 0xA90, 12, 0);
+    rig.repeater.release();
+    TEST_ASSERT_TRUE(rig.repeater.isHolding());
+    
+    rig.repeater.update(45);
+    rig.repeater.update(90);
+    TEST_ASSERT_FALSE(rig.repeater.isHolding());
+    rig.repeater.update(135);
+    TEST_ASSERT_EQUAL(3, rig.channel.writeCount);
+}
+
+void test_safety_timeout_ends_hold() {
+    HoldRig rig(500);
+    
+    rig.repeater.press(IRProtocol::NEC, 0xF708FB04, 32, 0);
+    for (uint32_t now = 0; now <= 1000; now += 10) {
+        rig.repeater.update(now);
+    }
+    
+    TEST_ASSERT_FALSE(rig.repeater.isHolding());
+    TEST_ASSERT_EQUAL(1, rig.repeater.getTimeoutCount());
+    TEST_ASSERT_EQUAL(4, rig.repeater.getRepeatCount());  // 108, 216, 324, 432
+}
+
+void test_repress_extends_timeout_without_resending() {
+    HoldRig rig(500);
+    
+    rig.repeater.press(IRProtocol::NEC, 0xF708FB04, 32, 0);
+    rig.repeater.press(IRProtocol::NEC, 0xF708FB04, 32, 400);
+    TEST_ASSERT_EQUAL(1, rig.channel.writeCount);
+    
+    rig.repeater.update(700);
+    TEST_ASSERT_TRUE(rig.repeater.isHolding());
+    rig.repeater.update(900);
+    TEST_ASSERT_FALSE(rig.repeater.isHolding());
+}
+
+void test_stall_does_not_burst() {
+    HoldRig rig;
+    
+    rig.repeater.press(IRProtocol::NEC, 0xF708FB04, 32, 0);
+    rig.repeater.update(1000);  // Loop blocked for ~9 periods
+    rig.repeater.update(1001);
+    TEST_ASSERT_EQUAL(1, rig.repeater.getRepeatCount());
+    
+    rig.repeater.update(1108);
+    TEST_ASSERT_EQUAL(2, rig.repeater.getRepeatCount());
+}
+
+void test_protocol_without_cadence_sends_once() {
+    HoldRig rig;
+    
+    TEST_ASSERT_TRUE(rig.repeater.press(IRProtocol::SHARP, 0x454A, 15, 0).success);
+    TEST_ASSERT_FALSE(rig.repeater.isHolding());
+    TEST_ASSERT_EQUAL(1, rig.channel.writeCount);
+}
+
+void test_unknown_protocol_fails() {
+    HoldRig rig;
+    
+    TEST_ASSERT_FALSE(rig.repeater.press(IRProtocol::UNKNOWN, 0, 32, 0).success);
+    TEST_ASSERT_EQUAL(0, rig.channel.writeCount);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_nec_hold_sends_repeat_code_every_108ms);
+    RUN_TEST(test_repeats_keep_the_press_carrier);
+    RUN_TEST(test_samsung_hold_repeats_full_frame);
+    RUN_TEST(test_jvc_hold_repeats_without_header);
+    RUN_TEST(test_rc5_hold_keeps_toggle);
+    RUN_TEST(test_release_stops_repeats);
+    RUN_TEST(test_sony_tap_still_sends_three_frames);
+    RUN_TEST(test_safety_timeout_ends_hold);
+    RUN_TEST(test_repress_extends_timeout_without_resending);
+    RUN_TEST(test_stall_does_not_burst);
+    RUN_TEST(test_protocol_without_cadence_sends_once);
+    RUN_TEST(test_unknown_protocol_fails);
+
+    UNITY_END();
+
+    return 0;
+}
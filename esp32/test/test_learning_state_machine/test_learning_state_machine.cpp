@@ -0,0 +1,148 @@
+#include <unity.h>
+#include <vector>
+#include "mock_signal_capture.h"
+#include "receiver/LearningStateMachine.h"
+#include "receiver/IRLibProtocolDecoder.h"
+
+// Unity requires these functions
+void setUp(void) {
+    mockMillis() = 1000;
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// An unknown remote's frame in rawbuf ticks, gap first
+static std::vector<uint16_t> rawFrame() {
+    return {7500, 1500, 750, 250, 750, 250, 250, 250, 750, 250};
+}
+
+static int wakeCount = 0;
+static void countWake(void*) {
+    wakeCount++;
+}
+
+// ============== Learning Notification Tests ==============
+
+void test_idle_event_driven_learning_never_reads_the_capture() {
+    MockSignalCapture capture(true);
+    IRLibProtocolDecoder decoder;
+    LearningStateMachine learning(&capture, &decoder, 30000);
+    TEST_ASSERT_TRUE(learning.isEventDriven());
+    
+    learning.startLearning();
+    for (int i = 0; i < 100; i++) {
+        mockMillis() += 10;
+        learning.update();
+    }
+    TEST_ASSERT_EQUAL(0, capture.decodeCalls);
+    TEST_ASSERT_TRUE(learning.isLearning());
+}
+
+void test_poll_only_backend_is_read_every_update() {
+    MockSignalCapture capture(false);
+    IRLibProtocolDecoder decoder;
+    LearningStateMachine learning(&capture, &decoder, 30000);
+    TEST_ASSERT_FALSE(learning.isEventDriven());
+    
+    learning.startLearning();
+    learning.update();
+    learning.update();
+    TEST_ASSERT_EQUAL(2, capture.decodeCalls);
+    TEST_ASSERT_EQUAL(LearningStateMachine::kPollIntervalMs, learning.msUntilDue(mockMillis()));
+}
+
+void test_wait_limit_is_the_learning_timeout() {
+    MockSignalCapture capture(true);
+    IRLibProtocolDecoder decoder;
+    LearningStateMachine learning(&capture, &decoder, 30000);
+    
+    TEST_ASSERT_EQUAL(LearningStateMachine::kNoDeadline, learning.msUntilDue(mockMillis()));
+    learning.startLearning();
+    TEST_ASSERT_EQUAL(30001, learning.msUntilDue(mockMillis()));
+    TEST_ASSERT_EQUAL(20001, learning.msUntilDue(mockMillis() + 10000));
+    
+    // A partly received frame asks to be polled
+    capture.pollMs = 1;
+    TEST_ASSERT_EQUAL(1, learning.msUntilDue(mockMillis()));
+}
+
+void test_ready_hook_wakes_and_frames_are_collected() {
+    MockSignalCapture capture(true);
+    IRLibProtocolDecoder decoder;
+    LearningStateMachine learning(&capture, &decoder, 30000, 3);
+    wakeCount = 0;
+    learning.setWakeHook(countWake, nullptr);
+    
+    int captured = 0;
+    uint8_t confidence = 0;
+    learning.onSignalCapture([&](const DecodedSignal& signal) {
+        captured++;
+        confidence = signal.confidence;
+    });
+    
+    learning.startLearning();
+    for (int press = 0; press < 3; press++) {
+        capture.arrive(rawFrame());
+        TEST_ASSERT_EQUAL(press + 1, wakeCount);
+        TEST_ASSERT_EQUAL(0, learning.msUntilDue(mockMillis()));
+        learning.update();
+        mockMillis() += 300;
+    }
+    
+    TEST_ASSERT_EQUAL(3, capture.decodeCalls);
+    TEST_ASSERT_EQUAL(1, captured);
+    TEST_ASSERT_EQUAL(100, confidence);
+    TEST_ASSERT_EQUAL(LearningState::IDLE, learning.getState());
+}
+
+void test_collect_window_bounds_the_wait_after_the_first_frame() {
+    MockSignalCapture capture(true);
+    IRLibProtocolDecoder decoder;
+    LearningStateMachine learning(&capture, &decoder, 30000, 3, 3000);
+    int captured = 0;
+    learning.onSignalCapture([&](const DecodedSignal&) { captured++; });
+    
+    learning.startLearning();
+    capture.arrive(rawFrame());
+    learning.update();
+    TEST_ASSERT_EQUAL(3001, learning.msUntilDue(mockMillis()));
+    
+    mockMillis() += learning.msUntilDue(mockMillis());
+    learning.update();
+    TEST_ASSERT_EQUAL(1, captured);
+    TEST_ASSERT_EQUAL(1, capture.decodeCalls);
+}
+
+void test_timeout_without_any_capture() {
+    MockSignalCapture capture(true);
+    IRLibProtocolDecoder decoder;
+    LearningStateMachine learning(&capture, &decoder, 30000);
+    std::vector<LearningState> states;
+    learning.onStateChange([&](LearningState state) { states.push_back(state); });
+    
+    learning.startLearning();
+    mockMillis() += learning.msUntilDue(mockMillis());
+    learning.update();
+    
+    TEST_ASSERT_EQUAL(3, states.size());
+    TEST_ASSERT_EQUAL(LearningState::TIMEOUT, states[1]);
+    TEST_ASSERT_EQUAL(LearningState::IDLE, learning.getState());
+    TEST_ASSERT_EQUAL(0, capture.decodeCalls);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_idle_event_driven_learning_never_reads_the_capture);
+    RUN_TEST(test_poll_only_backend_is_read_every_update);
+    RUN_TEST(test_wait_limit_is_the_learning_timeout);
+    RUN_TEST(test_ready_hook_wakes_and_frames_are_collected);
+    RUN_TEST(test_collect_window_bounds_the_wait_after_the_first_frame);
+    RUN_TEST(test_timeout_without_any_capture);
+    
+    UNITY_END();
+    
+    return 0;
+}
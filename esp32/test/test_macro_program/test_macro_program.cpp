@@ -0,0 +1,316 @@
+#include <unity.h>
+#include <vector>
+#include "utils/MacroRunner.h"
+#include "transmitter/IRLibProtocolEncoders.h"
+#include "transmitter/RmtIRTransmitter.h"
+#include "mock_rmt_channel.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+struct Emitted {
+    uint8_t output;
+    uint16_t length;
+    uint16_t firstTiming;
+    uint16_t carrierKHz;
+    uint8_t dutyPercent;
+    uint32_t atMs;
+};
+
+static std::vector<Emitted> emitted;
+static uint32_t clockMs = 0;
+static bool acceptEmits = true;
+
+static bool recordEmit(uint8_t output, const uint16_t* timings, uint16_t length, uint16_t carrierKHz,
+                       uint8_t dutyPercent) {
+    if (!acceptEmits) {
+        return false;
+    }
+    Emitted e = {output, length, timings[0], carrierKHz, dutyPercent, clockMs};
+    emitted.push_back(e);
+    return true;
+}
+
+static void addStep(CommandBatch* batch, IRProtocol protocol, uint64_t value, uint16_t bits, uint16_t gapMs) {
+    PendingCommand& cmd = batch->commands[batch->count++];
+    cmd.protocol = protocolName(protocol);
+    cmd.protocolId = protocol;
+    cmd.value = value;
+    cmd.bits = bits;
+    cmd.gapMs = gapMs;
+}
+
+// "Movie mode": TV on, wait for it to boot, soundbar on, TV input
+static CommandBatch makeMovieMode() {
+    CommandBatch batch;
+    addStep(&batch, IRProtocol::NEC, 0x20DF10EF, 32, 2000);
+    addStep(&batch, IRProtocol::SONY, 0xA90, 12, 0);
+    addStep(&batch, IRProtocol::NEC, 0x20DFD02F, 32, 0);
+    batch.commands[1].output = 1;
+    return batch;
+}
+
+// ============== Compiler Tests ==============
+
+void test_compile_renders_steps_and_waits() {
+    IRLibProtocolEncoders encoder;
+    MacroProgram program;
+
+    TEST_ASSERT_EQUAL(MacroError::NONE, program.compile(makeMovieMode(), &encoder));
+    TEST_ASSERT_EQUAL(3, program.getStepCount());
+    TEST_ASSERT_EQUAL(3, program.getWaveformCount());
+
+    // EMIT 0, WAIT 2000, EMIT 1 on output 1, EMIT 2, END
+    const uint8_t* code = program.getCode();
+    TEST_ASSERT_EQUAL(13, program.getCodeLength());
+    TEST_ASSERT_EQUAL(MacroProgram::kOpEmit, code[0]);
+    TEST_ASSERT_EQUAL(MacroProgram::kOpWait, code[3]);
+    TEST_ASSERT_EQUAL(2000, code[4] | (code[5] << 8));
+    TEST_ASSERT_EQUAL(1, code[8]);
+    TEST_ASSERT_EQUAL(MacroProgram::kOpEnd, code[12]);
+
+    // Each waveform keeps its protocol's carrier
+    TEST_ASSERT_EQUAL(38, program.getWaveform(0).carrierKHz);
+    TEST_ASSERT_EQUAL(40, program.getWaveform(1).carrierKHz);
+
+    // Ready to emit: identical to what the encoder renders live
+    uint16_t live[256];
+    uint16_t length = encoder.encodeValue(IRProtocol::NEC, 0x20DF10EF, 32, TimingSpan(live, 256));
+    TEST_ASSERT_EQUAL(length, program.getWaveform(0).length);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(live, program.getTimings(program.getWaveform(0)), length);
+}
+
+void test_sony_step_matches_live_send() {
+    IRLibProtocolEncoders encoder;
+    MacroProgram program;
+    TEST_ASSERT_EQUAL(MacroError::NONE, program.compile(makeMovieMode(), &encoder));
+    
+    // A live tap: the frame plus its repeats, padded to the frame period
+    MockRmtChannel channel;
+    RmtIRTransmitter transmitter(&channel, &encoder);
+    transmitter.begin();
+    TEST_ASSERT_TRUE(transmitter.transmitValue(IRProtocol::SONY, 0xA90, 12).success);
+    std::vector<uint16_t> live = channel.timings();
+    
+    const MacroWaveform& sony = program.getWaveform(1);
+    TEST_ASSERT_EQUAL(live.size(), sony.length);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(live.data(), program.getTimings(sony), sony.length);
+    
+    // SIRC receivers want three frames
+    uint16_t frame[64];
+    uint16_t frameLength = encoder.encodeValue(IRProtocol::SONY, 0xA90, 12, TimingSpan(frame, 64));
+    TEST_ASSERT_EQUAL(3 * frameLength + 2, sony.length);
+}
+
+void test_identical_steps_share_one_waveform() {
+    IRLibProtocolEncoders encoder;
+    MacroProgram program;
+    CommandBatch batch;
+
+    // Volume up five times
+    for (uint8_t i = 0; i < 5; i++) {
+        addStep(&batch, IRProtocol::NEC, 0x20DF40BF, 32, 150);
+    }
+    TEST_ASSERT_EQUAL(MacroError::NONE, program.compile(batch, &encoder));
+    TEST_ASSERT_EQUAL(5, program.getStepCount());
+    TEST_ASSERT_EQUAL(1, program.getWaveformCount());
+}
+
+void test_command_carrier_and_raw_steps() {
+    IRLibProtocolEncoders encoder;
+    MacroProgram program;
+    CommandBatch batch;
+
+    addStep(&batch, IRProtocol::NEC, 0x20DF10EF, 32, 0);
+    batch.commands[0].carrierKHz = 56;
+
+    const uint16_t raw[] = {9000, 4500, 560, 560, 560};
+    memcpy(batch.rawTimings, raw, sizeof(raw));
+    batch.rawUsed = 5;
+    PendingCommand& cmd = batch.commands[batch.count++];
+    cmd.protocol = "RAW";
+    cmd.rawOffset = 0;
+    cmd.rawLength = 5;
+
+    TEST_ASSERT_EQUAL(MacroError::NONE, program.compile(batch, &encoder));
+    TEST_ASSERT_EQUAL(56, program.getWaveform(0).carrierKHz);
+    TEST_ASSERT_EQUAL(IR_DEFAULT_CARRIER_KHZ, program.getWaveform(1).carrierKHz);
+    TEST_ASSERT_EQUAL(IR_DEFAULT_DUTY_PERCENT, program.getWaveform(1).dutyPercent);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(raw, program.getTimings(program.getWaveform(1)), 5);
+}
+
+void test_compile_rejects_steps_it_cannot_store() {
+    IRLibProtocolEncoders encoder;
+    MacroProgram program;
+
+    CommandBatch press = makeMovieMode();
+    press.commands[1].event = CommandEvent::PRESS;
+    TEST_ASSERT_EQUAL(MacroError::UNSUPPORTED_STEP, program.compile(press, &encoder));
+    TEST_ASSERT_EQUAL(0, program.getCodeLength());
+
+    CommandBatch unknown = makeMovieMode();
+    unknown.commands[2].protocolId = IRProtocol::UNKNOWN;
+    TEST_ASSERT_EQUAL(MacroError::ENCODE_FAILED, program.compile(unknown, &encoder));
+
+    CommandBatch empty;
+    TEST_ASSERT_EQUAL(MacroError::EMPTY, program.compile(empty, &encoder));
+}
+
+// ============== Flash Layout Tests ==============
+
+void test_serialize_round_trip() {
+    IRLibProtocolEncoders encoder;
+    MacroProgram program;
+    program.compile(makeMovieMode(), &encoder);
+
+    static uint8_t blob[MacroProgram::kMaxSerializedSize];
+    size_t bytes = program.serialize(blob, sizeof(blob));
+    TEST_ASSERT_TRUE(bytes > 0);
+
+    MacroProgram loaded;
+    TEST_ASSERT_TRUE(loaded.deserialize(blob, bytes));
+    TEST_ASSERT_EQUAL(program.getStepCount(), loaded.getStepCount());
+    TEST_ASSERT_EQUAL(program.getTimingCount(), loaded.getTimingCount());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(program.getCode(), loaded.getCode(), program.getCodeLength());
+    TEST_ASSERT_EQUAL(40, loaded.getWaveform(1).carrierKHz);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(program.getTimings(program.getWaveform(2)),
+                                   loaded.getTimings(loaded.getWaveform(2)), program.getWaveform(2).length);
+}
+
+void test_deserialize_rejects_bad_blobs() {
+    IRLibProtocolEncoders encoder;
+    MacroProgram program;
+    program.compile(makeMovieMode(), &encoder);
+
+    static uint8_t blob[MacroProgram::kMaxSerializedSize];
+    size_t bytes = program.serialize(blob, sizeof(blob));
+    MacroProgram loaded;
+
+    // Truncated
+    TEST_ASSERT_FALSE(loaded.deserialize(blob, bytes - 1));
+
+    // Written by a firmware with another layout
+    blob[0] = MacroProgram::kVersion + 1;
+    TEST_ASSERT_FALSE(loaded.deserialize(blob, bytes));
+    blob[0] = MacroProgram::kVersion;
+
+    // EMIT naming a waveform that is not stored (code starts after the
+    // 6-byte header and three 7-byte waveform entries)
+    blob[6 + 3 * 7 + 1] = 9;
+    TEST_ASSERT_FALSE(loaded.deserialize(blob, bytes));
+    TEST_ASSERT_EQUAL(0, loaded.getCodeLength());
+}
+
+// ============== Runner Tests ==============
+
+void test_runner_plays_steps_without_blocking() {
+    emitted.clear();
+    acceptEmits = true;
+    IRLibProtocolEncoders encoder;
+    MacroProgram program;
+    program.compile(makeMovieMode(), &encoder);
+    MacroRunner runner;
+
+    clockMs = 1000;
+    TEST_ASSERT_TRUE(runner.start(7, program, clockMs));
+    TEST_ASSERT_FALSE(runner.update(clockMs, recordEmit));
+    TEST_ASSERT_EQUAL(1, emitted.size());
+
+    // The 2s wait returns control to the loop every time
+    clockMs = 2999;
+    TEST_ASSERT_FALSE(runner.update(clockMs, recordEmit));
+    TEST_ASSERT_EQUAL(1, emitted.size());
+    TEST_ASSERT_TRUE(runner.isActive());
+
+    clockMs = 3000;
+    TEST_ASSERT_TRUE(runner.update(clockMs, recordEmit));
+    TEST_ASSERT_EQUAL(3, emitted.size());
+    TEST_ASSERT_FALSE(runner.isActive());
+
+    TEST_ASSERT_EQUAL(0, emitted[0].output);
+    TEST_ASSERT_EQUAL(1, emitted[1].output);
+    TEST_ASSERT_EQUAL(40, emitted[1].carrierKHz);
+    TEST_ASSERT_EQUAL(3000, emitted[2].atMs);
+
+    // Another macro cannot start until this one has finished
+    TEST_ASSERT_TRUE(runner.start(8, program, clockMs));
+    TEST_ASSERT_FALSE(runner.start(9, program, clockMs));
+}
+
+void test_runner_logs_step_timing() {
+    emitted.clear();
+    acceptEmits = true;
+    IRLibProtocolEncoders encoder;
+    MacroProgram program;
+    program.compile(makeMovieMode(), &encoder);
+    MacroRunner runner;
+
+    runner.start(7, program, 0);
+    runner.update(0, recordEmit);
+
+    // Loop was busy: the second step goes out 30ms after it was due
+    clockMs = 2030;
+    runner.update(clockMs, recordEmit);
+
+    TEST_ASSERT_EQUAL(3, runner.getStepCount());
+    TEST_ASSERT_EQUAL(0, runner.getStepTiming(0).lateMs);
+    TEST_ASSERT_EQUAL(2000, runner.getStepTiming(1).plannedMs);
+    TEST_ASSERT_EQUAL(2030, runner.getStepTiming(1).actualMs);
+    TEST_ASSERT_EQUAL(30, runner.getStepTiming(1).lateMs);
+    TEST_ASSERT_EQUAL(0, runner.getStepTiming(2).lateMs);
+}
+
+void test_runner_retries_refused_step() {
+    emitted.clear();
+    IRLibProtocolEncoders encoder;
+    MacroProgram program;
+    program.compile(makeMovieMode(), &encoder);
+    MacroRunner runner;
+
+    // Transmit queue full: the step waits instead of being dropped
+    acceptEmits = false;
+    clockMs = 0;
+    runner.start(7, program, clockMs);
+    TEST_ASSERT_FALSE(runner.update(clockMs, recordEmit));
+    TEST_ASSERT_EQUAL(0, emitted.size());
+    TEST_ASSERT_EQUAL(1, runner.getDeferredCount());
+
+    acceptEmits = true;
+    clockMs = 10;
+    runner.update(clockMs, recordEmit);
+    TEST_ASSERT_EQUAL(1, emitted.size());
+    TEST_ASSERT_EQUAL(10, runner.getStepTiming(0).lateMs);
+
+    // The wait counts from when the step actually went out
+    clockMs = 2009;
+    runner.update(clockMs, recordEmit);
+    TEST_ASSERT_EQUAL(1, emitted.size());
+    clockMs = 2010;
+    TEST_ASSERT_TRUE(runner.update(clockMs, recordEmit));
+    TEST_ASSERT_EQUAL(3, emitted.size());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_compile_renders_steps_and_waits);
+    RUN_TEST(test_sony_step_matches_live_send);
+    RUN_TEST(test_identical_steps_share_one_waveform);
+    RUN_TEST(test_command_carrier_and_raw_steps);
+    RUN_TEST(test_compile_rejects_steps_it_cannot_store);
+    RUN_TEST(test_serialize_round_trip);
+    RUN_TEST(test_deserialize_rejects_bad_blobs);
+    RUN_TEST(test_runner_plays_steps_without_blocking);
+    RUN_TEST(test_runner_logs_step_timing);
+    RUN_TEST(test_runner_retries_refused_step);
+
+    UNITY_END();
+
+    return 0;
+}
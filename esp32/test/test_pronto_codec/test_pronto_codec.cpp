@@ -0,0 +1,193 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "transmitter/IRLibProtocolEncoders.h"
+#include "transmitter/ProntoCodec.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Half a 38kHz carrier period: the most a duration moves on a round trip
+static const int kRoundingUs = 14;
+
+// ============== Parser Tests ==============
+
+void test_header_sets_carrier_and_sequences() {
+    uint16_t timings[8];
+    pronto::Code code;
+    
+    uint16_t length = pronto::decode("0000 006D 0001 0001 0157 00AC 0015 05F7", timings, 8, &code);
+    TEST_ASSERT_EQUAL(4, length);
+    TEST_ASSERT_EQUAL(38028, code.carrierHz);
+    TEST_ASSERT_EQUAL(38, code.carrierKHz());
+    TEST_ASSERT_EQUAL(2, code.onceLength);
+    TEST_ASSERT_EQUAL(2, code.repeatLength);
+    
+    const uint16_t expected[] = {9019, 4523, 552, 40154};
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, timings, 4);
+    
+    // RC5 codes run at 36kHz (period word 0x73)
+    TEST_ASSERT_EQUAL(2, pronto::decode("0000 0073 0000 0001 0020 0020", timings, 8, &code));
+    TEST_ASSERT_EQUAL(36, code.carrierKHz());
+    TEST_ASSERT_EQUAL(0, code.onceLength);
+    TEST_ASSERT_EQUAL(2, code.repeatLength);
+}
+
+void test_chunked_feed_matches_whole_text() {
+    const char* text = "0000 006D 0003 0000\n0157 00AC 0015 0016\t0015 0041";
+    uint16_t whole[8];
+    pronto::Code wholeCode;
+    uint16_t length = pronto::decode(text, whole, 8, &wholeCode);
+    TEST_ASSERT_EQUAL(6, length);
+    
+    // One character at a time: words straddle every possible split
+    uint16_t chunked[8];
+    pronto::Code chunkedCode;
+    pronto::Parser parser(chunked, 8);
+    for (size_t i = 0; i < strlen(text); i++) {
+        TEST_ASSERT_TRUE(parser.feed(text + i, 1));
+    }
+    TEST_ASSERT_EQUAL(length, parser.finish(&chunkedCode));
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(whole, chunked, length);
+    TEST_ASSERT_EQUAL(wholeCode.carrierHz, chunkedCode.carrierHz);
+}
+
+void test_malformed_codes_rejected() {
+    uint16_t timings[8];
+    pronto::Code code;
+    
+    TEST_ASSERT_EQUAL(0, pronto::decode("", timings, 8, &code));
+    TEST_ASSERT_EQUAL(0, pronto::decode("0100 006D 0001 0000 0010 0010", timings, 8, &code));  // Unmodulated
+    TEST_ASSERT_EQUAL(0, pronto::decode("0000 0000 0001 0000 0010 0010", timings, 8, &code));  // No carrier
+    TEST_ASSERT_EQUAL(0, pronto::decode("0000 006D 0000 0000", timings, 8, &code));            // Empty
+    TEST_ASSERT_EQUAL(0, pronto::decode("0000 006D 0002 0000 0010 0010", timings, 8, &code));  // Truncated
+    TEST_ASSERT_EQUAL(0, pronto::decode("0000 006D 0001 0000 0010 0010 0010", timings, 8, &code));
+    TEST_ASSERT_EQUAL(0, pronto::decode("0000 006D 0001 0000 00G0 0010", timings, 8, &code));
+    TEST_ASSERT_EQUAL(0, pronto::decode("0000 006D 0001 0000 00010 0010", timings, 8, &code));  // 5 digits
+    TEST_ASSERT_EQUAL(0, pronto::decode("0000 006D 0001 0000 0000 0010", timings, 8, &code));  // Zero duration
+    TEST_ASSERT_EQUAL(0, pronto::decode("0000 006D 0005 0000", timings, 8, &code));            // Over capacity
+    
+    // A failed parser stays failed
+    pronto::Parser parser(timings, 8);
+    TEST_ASSERT_FALSE(parser.feed("0000 006D 0001 0000 0010 001X", 29));
+    TEST_ASSERT_FALSE(parser.feed(" 0010", 5));
+    TEST_ASSERT_EQUAL(0, parser.finish(&code));
+}
+
+void test_long_gap_clamped() {
+    uint16_t timings[2];
+    TEST_ASSERT_EQUAL(2, pronto::decode("0000 006D 0001 0000 0010 FFFF", timings, 2, nullptr));
+    TEST_ASSERT_EQUAL(421, timings[0]);
+    TEST_ASSERT_EQUAL(0xFFFF, timings[1]);
+}
+
+// ============== Emitter Tests ==============
+
+void test_nec_frame_round_trips() {
+    IRLibProtocolEncoders encoder;
+    uint16_t frame[80];
+    uint16_t frameLength = encoder.encodeValue(IRProtocol::NEC, 0xF708FB04, 32, TimingSpan(frame, 80));
+    TEST_ASSERT_EQUAL(67, frameLength);
+    
+    char text[512];
+    size_t written = pronto::encode(frame, frameLength, 0, 38, text, sizeof(text));
+    TEST_ASSERT_EQUAL(pronto::encodedSizeFor(frameLength, 0) - 1, written);
+    TEST_ASSERT_EQUAL(written, strlen(text));
+    
+    // 67 timings padded to 34 pairs
+    TEST_ASSERT_EQUAL(0, strncmp(text, "0000 006D 0022 0000 0156 00AB ", 30));
+    
+    uint16_t decoded[80];
+    pronto::Code code;
+    TEST_ASSERT_EQUAL(68, pronto::decode(text, decoded, 80, &code));
+    TEST_ASSERT_EQUAL(38, code.carrierKHz());
+    TEST_ASSERT_EQUAL(68, code.onceLength);
+    for (uint16_t i = 0; i < frameLength; i++) {
+        TEST_ASSERT_TRUE(abs((int)decoded[i] - (int)frame[i]) <= kRoundingUs);
+    }
+    TEST_ASSERT_TRUE(abs((int)decoded[67] - (int)pronto::kTrailingGapUs) <= kRoundingUs);
+}
+
+void test_once_and_repeat_sequences_kept_apart() {
+    const uint16_t timings[] = {9000, 4500, 560, 40000, 9000, 2250, 560};
+    char text[128];
+    TEST_ASSERT_TRUE(pronto::encode(timings, 4, 3, 38, text, sizeof(text)) > 0);
+    
+    uint16_t decoded[8];
+    pronto::Code code;
+    TEST_ASSERT_EQUAL(8, pronto::decode(text, decoded, 8, &code));
+    TEST_ASSERT_EQUAL(4, code.onceLength);
+    TEST_ASSERT_EQUAL(4, code.repeatLength);
+    TEST_ASSERT_TRUE(abs((int)decoded[5] - 2250) <= kRoundingUs);
+}
+
+void test_encode_rejects_small_buffer() {
+    const uint16_t timings[] = {9000, 4500, 560};
+    size_t needed = pronto::encodedSizeFor(3, 0);
+    TEST_ASSERT_EQUAL(8 * 5, needed);  // Header plus two pairs
+    
+    char text[64];
+    TEST_ASSERT_EQUAL(0, pronto::encode(timings, 3, 0, 38, text, needed - 1));
+    TEST_ASSERT_EQUAL('\0', text[0]);
+    TEST_ASSERT_EQUAL(0, pronto::encode(timings, 3, 0, 0, text, sizeof(text)));
+    TEST_ASSERT_EQUAL(0, pronto::encode(timings, 0, 0, 38, text, sizeof(text)));
+    TEST_ASSERT_EQUAL(needed - 1, pronto::encode(timings, 3, 0, 38, text, needed));
+}
+
+// ============== Benchmark ==============
+
+// Parser throughput on a typical library code (NEC frame plus repeat)
+void test_benchmark_parser_throughput() {
+    const int kCodes = 20000;
+    IRLibProtocolEncoders encoder;
+    uint16_t frame[80];
+    uint16_t frameLength = encoder.encodeValue(IRProtocol::NEC, 0xF708FB04, 32, TimingSpan(frame, 80));
+    const uint16_t repeat[] = {9000, 2250, 560, 40000};
+    memcpy(frame + frameLength, repeat, sizeof(repeat));
+    
+    char text[600];
+    size_t textLength = pronto::encode(frame, frameLength, 4, 38, text, sizeof(text));
+    TEST_ASSERT_TRUE(textLength > 0);
+    
+    uint16_t timings[128];
+    uint32_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCodes; i++) {
+        checksum += pronto::decode(text, timings, 128, nullptr);
+        checksum += timings[i % 72];
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    char message[128];
+    snprintf(message, sizeof(message), "[Bench] Pronto parse: %.0f ns per %u-char code, %.1f MB/s",
+             ns / kCodes, (unsigned)textLength, (double)textLength * kCodes / ns * 1000.0);
+    TEST_MESSAGE(message);
+    
+    TEST_ASSERT_TRUE(checksum > (uint32_t)kCodes * 72);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_header_sets_carrier_and_sequences);
+    RUN_TEST(test_chunked_feed_matches_whole_text);
+    RUN_TEST(test_malformed_codes_rejected);
+    RUN_TEST(test_long_gap_clamped);
+    RUN_TEST(test_nec_frame_round_trips);
+    RUN_TEST(test_once_and_repeat_sequences_kept_apart);
+    RUN_TEST(test_encode_rejects_small_buffer);
+    RUN_TEST(test_benchmark_parser_throughput);
+
+    UNITY_END();
+
+    return 0;
+}
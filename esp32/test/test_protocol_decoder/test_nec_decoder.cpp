@@ -15,9 +15,11 @@ void test_nec_protocol_decodes_tv_power() {
     // Known NEC signal: TV Power (address: 0x00, command: 0x12)
     // NEC IRremoteESP8266 value format: address | ~address<<8 | command<<16 | ~command<<24
     // Value: 0x00 | (0xFF << 8) | (0x12 << 16) | (0xED << 24) = 0xED12FF00
-    decode_results raw;
+    decode_results raw = {};
     raw.decode_type = NEC;
     raw.value = 0xED12FF00;
+    raw.address = 0x00;  // IRrecv extracts these from the value
+    raw.command = 0x12;
     raw.bits = 32;
     
     IRLibProtocolDecoder decoder;
@@ -33,9 +35,11 @@ void test_nec_protocol_decodes_samsung_tv_volume_up() {
     // Samsung TV Volume Up: address: 0x07, command: 0x02
     // NEC format: address | ~address<<8 | command<<16 | ~command<<24
     // Value: 0x07 | (0xF8 << 8) | (0x02 << 16) | (0xFD << 24) = 0xFD02F807
-    decode_results raw;
+    decode_results raw = {};
     raw.decode_type = NEC;
     raw.value = 0xFD02F807;
+    raw.address = 0x07;
+    raw.command = 0x02;
     raw.bits = 32;
     
     IRLibProtocolDecoder decoder;
@@ -63,8 +67,8 @@ void test_unknown_protocol_returns_raw() {
     
     TEST_ASSERT_EQUAL_STRING("RAW", signal.protocol);
     TEST_ASSERT_FALSE(signal.isKnownProtocol);
-    TEST_ASSERT_NOT_NULL(signal.rawTimings);
-    TEST_ASSERT_EQUAL_UINT16(10, signal.rawLength);
+    TEST_ASSERT_NOT_NULL(signal.rawTimings.data());
+    TEST_ASSERT_EQUAL_UINT16(10, signal.rawTimings.size());
 }
 
 int main(int argc, char **argv) {
@@ -0,0 +1,171 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "transmitter/IRLibProtocolEncoders.h"
+#include "transmitter/ProtocolDescriptors.h"
+
+// Descriptors are usable in constant expressions
+static_assert(NecProtocol::descriptor().headerMark == 9000, "NEC header mark");
+static_assert(NecProtocol::descriptor().frameLength(32) == 67, "NEC frame length");
+static_assert(SonyProtocol::descriptor().frameLength(12) == 25, "Sony frame length");
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// ============== Reference Encoder ==============
+
+// The hand-written encoders the descriptor tables replaced: a strcmp chain
+// and one runtime loop per protocol. Kept as the regression reference and
+// benchmark baseline.
+static uint16_t legacyEncodeValue(const char* protocol, uint64_t value, uint16_t bits, uint16_t* out) {
+    uint16_t idx = 0;
+    uint32_t data = (uint32_t)value;
+    
+    if (strcmp(protocol, "NEC") == 0 || strcmp(protocol, "SAMSUNG") == 0) {
+        bool nec = strcmp(protocol, "NEC") == 0;
+        out[idx++] = nec ? 9000 : 4500;
+        out[idx++] = 4500;
+        for (int i = 31; i >= 0; i--) {
+            out[idx++] = 560;
+            out[idx++] = ((data >> i) & 1) ? 1690 : 560;
+        }
+        out[idx++] = 560;
+    } else if (strcmp(protocol, "SONY") == 0) {
+        out[idx++] = 2400;
+        out[idx++] = 600;
+        for (int i = bits - 1; i >= 0; i--) {
+            out[idx++] = ((data >> i) & 1) ? 1200 : 600;
+            if (i > 0) {
+                out[idx++] = 600;
+            }
+        }
+    }
+    return idx;
+}
+
+// ============== Lookup Tests ==============
+
+void test_protocol_names_round_trip() {
+    TEST_ASSERT_TRUE(protocolFromName("NEC") == IRProtocol::NEC);
+    TEST_ASSERT_TRUE(protocolFromName("SAMSUNG") == IRProtocol::SAMSUNG);
+    TEST_ASSERT_TRUE(protocolFromName("SONY") == IRProtocol::SONY);
+    TEST_ASSERT_TRUE(protocolFromName("RC5X") == IRProtocol::UNKNOWN);
+    TEST_ASSERT_TRUE(protocolFromName(nullptr) == IRProtocol::UNKNOWN);
+    
+    TEST_ASSERT_EQUAL_STRING("SAMSUNG", protocolName(IRProtocol::SAMSUNG));
+    TEST_ASSERT_EQUAL_STRING("UNKNOWN", protocolName(IRProtocol::UNKNOWN));
+}
+
+void test_descriptor_lookup() {
+    const ProtocolDescriptor* sony = findDescriptor(IRProtocol::SONY);
+    TEST_ASSERT_NOT_NULL(sony);
+    TEST_ASSERT_EQUAL(2400, sony->headerMark);
+    TEST_ASSERT_EQUAL(12, sony->defaultBits);
+    TEST_ASSERT_EQUAL(40, sony->carrierKHz);
+    TEST_ASSERT_NULL(findDescriptor(IRProtocol::UNKNOWN));
+}
+
+// ============== Encoder Regression Tests ==============
+
+static void assertMatchesLegacy(IRProtocol protocol, uint64_t value, uint16_t bits) {
+    IRLibProtocolEncoders encoder;
+    uint16_t expected[128];
+    uint16_t actual[128];
+    
+    uint16_t expectedLength = legacyEncodeValue(protocolName(protocol), value, bits, expected);
+    uint16_t actualLength = encoder.encodeValue(protocol, value, bits, TimingSpan(actual, 128));
+    
+    TEST_ASSERT_EQUAL(expectedLength, actualLength);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, actual, expectedLength);
+}
+
+void test_nec_descriptor_matches_legacy_encoder() {
+    assertMatchesLegacy(IRProtocol::NEC, 0xF708FB04, 32);
+    assertMatchesLegacy(IRProtocol::NEC, 0x00000000, 32);
+    assertMatchesLegacy(IRProtocol::NEC, 0xFFFFFFFF, 32);
+}
+
+void test_samsung_descriptor_matches_legacy_encoder() {
+    assertMatchesLegacy(IRProtocol::SAMSUNG, 0xE0E040BF, 32);
+}
+
+void test_sony_descriptor_matches_legacy_encoder() {
+    assertMatchesLegacy(IRProtocol::SONY, 0x095, 12);
+    assertMatchesLegacy(IRProtocol::SONY, 0x5A95, 15);
+    assertMatchesLegacy(IRProtocol::SONY, 0xA5A95, 20);
+    assertMatchesLegacy(IRProtocol::SONY, 0x1A95, 13);  // Non-standard count: runtime loop
+}
+
+void test_encoded_signal_carries_descriptor_metadata() {
+    IRLibProtocolEncoders encoder;
+    EncodedSignal signal = encoder.encodeValue(IRProtocol::SONY, 0x095, 12);
+    
+    TEST_ASSERT_TRUE(signal.isKnownProtocol);
+    TEST_ASSERT_EQUAL_STRING("SONY", signal.protocol);
+    TEST_ASSERT_EQUAL(25, signal.rawLength);
+    TEST_ASSERT_EQUAL(40, signal.frequency);
+}
+
+// ============== Benchmark ==============
+
+// Descriptor path (enum dispatch, unrolled per protocol) versus the
+// string-compare dispatch and runtime loops it replaced
+void test_benchmark_descriptor_vs_legacy() {
+    const int kFrames = 100000;
+    const char* names[] = {"NEC", "SAMSUNG", "SONY"};
+    const IRProtocol ids[] = {IRProtocol::NEC, IRProtocol::SAMSUNG, IRProtocol::SONY};
+    const uint16_t bits[] = {32, 32, 12};
+    
+    IRLibProtocolEncoders encoder;
+    uint16_t buffer[128];
+    uint32_t checksum = 0;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kFrames; i++) {
+        int p = i % 3;
+        checksum += legacyEncodeValue(names[p], 0xF708FB04 + i, bits[p], buffer);
+        checksum += buffer[5];
+    }
+    auto legacyTime = std::chrono::steady_clock::now() - start;
+    
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kFrames; i++) {
+        int p = i % 3;
+        checksum -= encoder.encodeValue(ids[p], 0xF708FB04 + i, bits[p], TimingSpan(buffer, 128));
+        checksum -= buffer[5];
+    }
+    auto descriptorTime = std::chrono::steady_clock::now() - start;
+    
+    double legacyNs = std::chrono::duration<double, std::nano>(legacyTime).count() / kFrames;
+    double descriptorNs = std::chrono::duration<double, std::nano>(descriptorTime).count() / kFrames;
+    
+    char message[128];
+    snprintf(message, sizeof(message), "[Bench] per frame: legacy strcmp+loop %.1f ns, descriptor %.1f ns",
+             legacyNs, descriptorNs);
+    TEST_MESSAGE(message);
+    
+    TEST_ASSERT_EQUAL(0, checksum);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_protocol_names_round_trip);
+    RUN_TEST(test_descriptor_lookup);
+    RUN_TEST(test_nec_descriptor_matches_legacy_encoder);
+    RUN_TEST(test_samsung_descriptor_matches_legacy_encoder);
+    RUN_TEST(test_sony_descriptor_matches_legacy_encoder);
+    RUN_TEST(test_encoded_signal_carries_descriptor_metadata);
+    RUN_TEST(test_benchmark_descriptor_vs_legacy);
+
+    UNITY_END();
+
+    return 0;
+}
@@ -48,9 +48,11 @@ void test_nec_encoder_round_trip_symmetry() {
                              ((~originalCommand & 0xFF) << 24);
     
     // Simulate decode_results as IRrecv would populate it
-    decode_results results;
+    decode_results results = {};
     results.decode_type = NEC;
     results.value = expectedValue;
+    results.address = originalAddress;
+    results.command = originalCommand;
     results.bits = 32;
     results.rawbuf = encoded.rawData;
     results.rawlen = encoded.rawLength;
@@ -97,9 +99,11 @@ void test_samsung_encoder_round_trip_symmetry() {
                              ((originalCommand & 0xFF) << 16) | 
                              ((~originalCommand & 0xFF) << 24);
     
-    decode_results results;
+    decode_results results = {};
     results.decode_type = SAMSUNG;
     results.value = expectedValue;
+    results.address = originalAddress;
+    results.command = originalCommand;
     results.bits = 32;
     results.rawbuf = encoded.rawData;
     results.rawlen = encoded.rawLength;
@@ -124,7 +128,7 @@ void test_sony_encoder_produces_valid_signal() {
     TEST_ASSERT_TRUE(signal.isKnownProtocol);
     TEST_ASSERT_NOT_NULL(signal.rawData);
     TEST_ASSERT_GREATER_THAN(0, signal.rawLength);
-    TEST_ASSERT_EQUAL(38, signal.frequency);
+    TEST_ASSERT_EQUAL(40, signal.frequency);  // SIRC carrier
 }
 
 void test_sony_encoder_round_trip_symmetry() {
@@ -142,9 +146,11 @@ void test_sony_encoder_round_trip_symmetry() {
     // For 12-bit: command (7 bits) | address (5 bits)
     uint32_t expectedValue = (originalCommand & 0x7F) | ((originalAddress & 0x1F) << 7);
     
-    decode_results results;
+    decode_results results = {};
     results.decode_type = SONY;
     results.value = expectedValue;
+    results.address = originalAddress;
+    results.command = originalCommand;
     results.bits = originalBits;
     results.rawbuf = encoded.rawData;
     results.rawlen = encoded.rawLength;
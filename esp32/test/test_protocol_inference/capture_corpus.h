@@ -0,0 +1,153 @@
+#ifndef CAPTURE_CORPUS_H
+#define CAPTURE_CORPUS_H
+
+// Captures of remotes with no library decoder, in microseconds from the
+// first mark. Receiver modules stretch marks and shorten spaces by
+// 40-110us and add sampling jitter; these carry both. The last three
+// must stay RAW.
+
+#include <cstdint>
+#include "transmitter/ProtocolDescriptors.h"
+
+static const uint16_t k_pd_header_32[] = {
+    3473, 1607, 517, 341, 458, 1157, 514, 354, 480, 397, 512, 340,
+    513, 329, 472, 319, 469, 363, 463, 1217, 515, 380, 463, 1178,
+    499, 1255, 509, 1154, 526, 1248, 455, 1211, 513, 1225, 512, 400,
+    458, 361, 473, 366, 488, 1220, 501, 346, 481, 337, 446, 1192,
+    524, 321, 548, 1235, 548, 1227, 487, 1215, 541, 370, 506, 1183,
+    517, 1239, 448, 377, 527, 1166, 458
+};
+
+static const uint16_t k_pd_header_48[] = {
+    9077, 4436, 637, 524, 634, 494, 667, 1625, 621, 471, 616, 502,
+    638, 482, 682, 532, 581, 493, 630, 427, 659, 512, 626, 524,
+    618, 531, 598, 517, 628, 502, 645, 1612, 620, 469, 653, 1611,
+    612, 509, 596, 1590, 670, 1573, 672, 501, 665, 443, 639, 480,
+    614, 536, 609, 490, 614, 517, 628, 476, 636, 512, 628, 1584,
+    616, 1627, 640, 498, 587, 449, 674, 477, 622, 503, 603, 440,
+    600, 546, 648, 1661, 665, 447, 635, 1649, 617, 459, 637, 469,
+    620, 507, 629, 1610, 645, 1591, 626, 1622, 636, 1611, 628, 470,
+    642, 451, 633, 30000
+};
+
+static const uint16_t k_pd_headerless_16[] = {
+    361, 944, 376, 343, 373, 963, 407, 281, 350, 272, 374, 954,
+    334, 311, 326, 956, 383, 351, 397, 907, 359, 329, 386, 900,
+    394, 952, 361, 307, 411, 911, 385, 312, 383
+};
+
+static const uint16_t k_pd_header_24[] = {
+    6085, 2944, 765, 1413, 802, 1423, 731, 608, 774, 632, 720, 627,
+    774, 638, 793, 1410, 779, 1424, 748, 578, 767, 637, 833, 672,
+    738, 656, 764, 1393, 778, 1427, 772, 1442, 772, 1427, 711, 1437,
+    734, 606, 790, 645, 810, 1455, 762, 646, 802, 1398, 773, 1411,
+    774, 637, 782
+};
+
+static const uint16_t k_pw_header_15[] = {
+    2466, 579, 1278, 535, 689, 529, 716, 517, 1291, 492, 709, 480,
+    1271, 554, 674, 508, 673, 503, 678, 522, 1233, 574, 1263, 516,
+    1320, 467, 1287, 465, 632, 548, 700
+};
+
+static const uint16_t k_pw_headerless_12[] = {
+    574, 397, 1384, 410, 542, 408, 1408, 368, 1375, 365, 549, 355,
+    1399, 394, 1431, 391, 585, 373, 1412, 379, 1354, 369, 571
+};
+
+static const uint16_t k_pw_header_20[] = {
+    3096, 911, 1545, 439, 1574, 435, 1592, 422, 772, 454, 798, 421,
+    735, 445, 752, 427, 1574, 414, 1577, 404, 1627, 432, 769, 455,
+    727, 379, 730, 426, 793, 395, 1621, 470, 750, 423, 1534, 484,
+    827, 396, 1548, 453, 1531
+};
+
+static const uint16_t k_bp_rc5_like_13[] = {
+    922, 865, 1823, 1716, 1817, 788, 964, 786, 953, 1677, 912, 804,
+    1816, 1696, 1894, 1750, 988
+};
+
+static const uint16_t k_bp_rc6_like_21[] = {
+    2744, 827, 491, 785, 538, 349, 464, 346, 513, 793, 1456, 372,
+    529, 785, 551, 347, 529, 401, 919, 829, 954, 364, 502, 820,
+    982, 857, 521, 387, 512, 326, 997, 371, 533
+};
+
+static const uint16_t k_bp_headerless_16[] = {
+    627, 889, 1074, 400, 550, 908, 540, 414, 1114, 921, 1104, 409,
+    537, 952, 1081, 952, 544, 447, 577, 417, 1063
+};
+
+static const uint16_t k_noise[] = {
+    1413, 655, 927, 1264, 2811, 2739, 1954, 2000, 2502, 793, 1022, 2293,
+    176, 1210, 362, 2091, 1071, 2748, 2539, 478, 123, 2555, 1879, 2994,
+    1117, 1997, 2508, 2405, 2709, 2752, 746, 803, 1449, 2184, 2549, 1882,
+    1101, 2564, 2716, 942, 166
+};
+
+static const uint16_t k_ac_112_bits[] = {
+    3628, 1644, 545, 367, 488, 368, 470, 409, 545, 305, 531, 382,
+    473, 1167, 528, 1287, 492, 331, 481, 317, 499, 337, 539, 330,
+    524, 348, 543, 370, 488, 364, 483, 1220, 505, 375, 518, 337,
+    511, 1248, 529, 1245, 540, 1263, 492, 1238, 481, 1211, 486, 351,
+    513, 1203, 509, 403, 519, 391, 507, 391, 472, 335, 464, 331,
+    505, 357, 465, 385, 501, 360, 472, 1204, 490, 1199, 471, 379,
+    459, 303, 490, 336, 483, 1230, 501, 362, 551, 319, 536, 1166,
+    508, 1268, 494, 1256, 535, 1205, 517, 375, 447, 1250, 448, 347,
+    504, 370, 479, 325, 493, 314, 476, 353, 453, 369, 507, 383,
+    504, 316, 529, 365, 546, 333, 521, 410, 528, 1190, 454, 315,
+    554, 295, 496, 1206, 481, 339, 507, 342, 530, 1189, 513, 1240,
+    533, 377, 463, 1240, 495, 366, 458, 382, 536, 1234, 548, 1220,
+    515, 342, 504, 1255, 522, 413, 518, 1245, 510, 306, 486, 1242,
+    480, 1248, 566, 1196, 454, 341, 518, 1194, 545, 1274, 498, 299,
+    520, 384, 500, 1207, 533, 335, 552, 1247, 511, 1263, 507, 315,
+    453, 342, 500, 302, 519, 1242, 532, 1239, 521, 1227, 493, 1244,
+    471, 357, 519, 305, 517, 342, 470, 404, 485, 1208, 462, 1174,
+    488, 1265, 514, 305, 469, 1236, 487, 380, 473, 358, 485, 1262,
+    533, 407, 520, 388, 514, 1209, 513, 1216, 560, 1248, 527
+};
+
+static const uint16_t k_two_frames[] = {
+    4521, 4405, 658, 1606, 622, 1651, 578, 1674, 615, 527, 640, 500,
+    677, 495, 625, 435, 581, 498, 637, 1617, 626, 1583, 626, 1619,
+    641, 495, 596, 479, 618, 495, 634, 453, 645, 490, 603, 511,
+    622, 1659, 691, 483, 649, 478, 618, 528, 644, 461, 641, 476,
+    627, 493, 618, 1620, 606, 485, 635, 1616, 676, 1622, 624, 1619,
+    590, 1641, 626, 1655, 587, 1663, 600, 19938, 4539, 4452, 626, 1599,
+    597, 1623, 647, 1572, 661, 445, 612, 534, 661, 461, 629, 490,
+    635, 497, 646, 1587, 606, 1629, 594, 1627, 633, 461, 595, 477,
+    642, 472, 688, 505, 618, 469, 631, 466, 640, 1620, 589, 497,
+    684, 527, 636, 448, 663, 450, 667, 480, 640, 512, 598, 1660,
+    613, 494, 628, 1580, 614, 1672, 687, 1597, 641, 1645, 607, 1619,
+    603, 1608, 598
+};
+
+struct CorpusCapture {
+    const char* name;
+    const uint16_t* timings;
+    uint16_t length;
+    bool inferable;
+    BitCoding coding;
+    uint64_t value;
+    uint16_t bits;
+};
+
+#define CAPTURE(name) #name, k_##name, sizeof(k_##name) / sizeof(k_##name[0])
+
+static const CorpusCapture kCorpus[] = {
+    {CAPTURE(pd_header_32), true, BitCoding::PULSE_DISTANCE, 0x40BF12EDULL, 32},
+    {CAPTURE(pd_header_48), true, BitCoding::PULSE_DISTANCE, 0x2002B00C0A3CULL, 48},
+    {CAPTURE(pd_headerless_16), true, BitCoding::PULSE_DISTANCE, 0xA55AULL, 16},
+    {CAPTURE(pd_header_24), true, BitCoding::PULSE_DISTANCE, 0xC30F96ULL, 24},
+    {CAPTURE(pw_header_15), true, BitCoding::PULSE_WIDTH, 0x4A3CULL, 15},
+    {CAPTURE(pw_headerless_12), true, BitCoding::PULSE_WIDTH, 0x5B6ULL, 12},
+    {CAPTURE(pw_header_20), true, BitCoding::PULSE_WIDTH, 0xE1C2BULL, 20},
+    {CAPTURE(bp_rc5_like_13), true, BitCoding::BIPHASE, 0x1A35ULL, 13},
+    {CAPTURE(bp_rc6_like_21), true, BitCoding::BIPHASE, 0x10C5A3ULL, 21},
+    {CAPTURE(bp_headerless_16), true, BitCoding::BIPHASE, 0xB2D1ULL, 16},
+    {CAPTURE(noise), false, BitCoding::PULSE_DISTANCE, 0, 0},
+    {CAPTURE(ac_112_bits), false, BitCoding::PULSE_DISTANCE, 0, 0},
+    {CAPTURE(two_frames), false, BitCoding::PULSE_DISTANCE, 0, 0},
+};
+
+#endif
@@ -0,0 +1,217 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "capture_corpus.h"
+#include "receiver/ProtocolInference.h"
+#include "receiver/IRLibProtocolDecoder.h"
+#include "transmitter/FrameEncoder.h"
+
+using namespace protocol_inference;
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// ============== Corpus Tests ==============
+
+void test_corpus_captures_infer_their_coding_and_payload() {
+    for (const CorpusCapture& capture : kCorpus) {
+        InferredCode code;
+        bool inferred = inferCode(capture.timings, capture.length, &code);
+        TEST_ASSERT_EQUAL_MESSAGE(capture.inferable, inferred, capture.name);
+        if (!capture.inferable) {
+            continue;
+        }
+        TEST_ASSERT_EQUAL_MESSAGE((int)capture.coding, (int)code.descriptor.coding, capture.name);
+        TEST_ASSERT_EQUAL_MESSAGE(capture.bits, code.bits, capture.name);
+        TEST_ASSERT_TRUE_MESSAGE(capture.value == code.value, capture.name);
+        TEST_ASSERT_EQUAL_MESSAGE(IRProtocol::UNKNOWN, code.descriptor.protocol, capture.name);
+    }
+}
+
+void test_inferred_timings_are_the_cluster_means() {
+    InferredCode code;
+    TEST_ASSERT_TRUE(inferCode(k_pd_header_48, sizeof(k_pd_header_48) / sizeof(k_pd_header_48[0]), &code));
+    const ProtocolDescriptor& d = code.descriptor;
+    
+    // 9000/4500, 560 marks, 1690/560 spaces, as the receiver skews them
+    TEST_ASSERT_UINT16_WITHIN(150, 9075, d.headerMark);
+    TEST_ASSERT_UINT16_WITHIN(150, 4425, d.headerSpace);
+    TEST_ASSERT_UINT16_WITHIN(30, 635, d.oneMark);
+    TEST_ASSERT_EQUAL(d.oneMark, d.zeroMark);
+    TEST_ASSERT_UINT16_WITHIN(30, 1615, d.oneSpace);
+    TEST_ASSERT_UINT16_WITHIN(30, 485, d.zeroSpace);
+    TEST_ASSERT_EQUAL(d.oneMark, d.footerMark);
+}
+
+void test_rc6_style_trailer_bit_is_found() {
+    InferredCode code;
+    TEST_ASSERT_TRUE(inferCode(k_bp_rc6_like_21, sizeof(k_bp_rc6_like_21) / sizeof(k_bp_rc6_like_21[0]), &code));
+    TEST_ASSERT_TRUE(code.descriptor.oneMarkFirst);
+    TEST_ASSERT_EQUAL(4, code.descriptor.doubleWidthBit);
+    TEST_ASSERT_UINT16_WITHIN(40, 444, code.descriptor.biphaseUnit);
+    TEST_ASSERT_UINT16_WITHIN(150, 2666, code.descriptor.headerMark);
+}
+
+void test_replay_matches_every_capture_timing() {
+    for (const CorpusCapture& capture : kCorpus) {
+        InferredCode code;
+        if (!inferCode(capture.timings, capture.length, &code)) {
+            continue;
+        }
+        uint16_t frame[kMaxTimings];
+        uint16_t length = frame_encoder::encodeFrame(code.descriptor, code.value, code.bits,
+                                                     TimingSpan(frame, kMaxTimings));
+        // A trailing space is the gap, not part of the frame
+        TEST_ASSERT_EQUAL_MESSAGE(capture.length % 2 ? capture.length : capture.length - 1, length, capture.name);
+        for (uint16_t i = 0; i < length; i++) {
+            int difference = (int)capture.timings[i] - (int)frame[i];
+            TEST_ASSERT_TRUE_MESSAGE(abs(difference) <= frame[i] / 4 + 50, capture.name);
+        }
+    }
+}
+
+void test_inference_time_is_bounded() {
+    // The longest frame it will look at, and longer input it must refuse early
+    std::vector<uint16_t> longest = {9000, 4500};
+    for (uint16_t i = 0; i < kMaxBits; i++) {
+        longest.push_back(560);
+        longest.push_back(i % 3 ? 560 : 1690);
+    }
+    longest.push_back(560);
+    TEST_ASSERT_EQUAL(kMaxTimings, longest.size());
+    std::vector<uint16_t> tooLong(1024, 560);
+    
+    InferredCode code;
+    const int kRuns = 2000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRuns; i++) {
+        TEST_ASSERT_TRUE(inferCode(longest.data(), longest.size(), &code));
+        TEST_ASSERT_FALSE(inferCode(tooLong.data(), tooLong.size(), &code));
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / kRuns;
+    printf("Inference of a 64-bit frame: %.1f us (host)\n", us);
+    TEST_ASSERT_EQUAL(kMaxBits, code.bits);
+    TEST_ASSERT_LESS_THAN(1000, us);
+}
+
+// ============== Params Tests ==============
+
+void test_params_round_trip() {
+    for (const CorpusCapture& capture : kCorpus) {
+        InferredCode code;
+        if (!inferCode(capture.timings, capture.length, &code)) {
+            continue;
+        }
+        char text[kMaxParamsLength];
+        TEST_ASSERT_TRUE_MESSAGE(formatParams(code.descriptor, text, sizeof(text)) > 0, capture.name);
+        
+        ProtocolDescriptor parsed;
+        TEST_ASSERT_TRUE_MESSAGE(parseParams(text, &parsed), text);
+        uint16_t expected[kMaxTimings];
+        uint16_t actual[kMaxTimings];
+        uint16_t length = frame_encoder::encodeFrame(code.descriptor, code.value, code.bits,
+                                                     TimingSpan(expected, kMaxTimings));
+        TEST_ASSERT_EQUAL_MESSAGE(length, frame_encoder::encodeFrame(parsed, code.value, code.bits,
+                                                                     TimingSpan(actual, kMaxTimings)), text);
+        TEST_ASSERT_TRUE_MESSAGE(memcmp(expected, actual, length * sizeof(uint16_t)) == 0, text);
+    }
+}
+
+void test_params_format() {
+    ProtocolDescriptor d;
+    TEST_ASSERT_TRUE(parseParams("PD 9000 4500 560 1690 560 560 560", &d));
+    TEST_ASSERT_EQUAL(BitCoding::PULSE_DISTANCE, d.coding);
+    TEST_ASSERT_EQUAL(1690, d.oneSpace);
+    TEST_ASSERT_EQUAL(560, d.footerMark);
+    TEST_ASSERT_EQUAL(IR_DEFAULT_CARRIER_KHZ, d.carrierKHz);
+    
+    TEST_ASSERT_TRUE(parseParams("BP 2666 889 444 1 4", &d));
+    TEST_ASSERT_EQUAL(BitCoding::BIPHASE, d.coding);
+    TEST_ASSERT_EQUAL(4, d.doubleWidthBit);
+    TEST_ASSERT_TRUE(parseParams("BP 0 0 889 0", &d));
+    TEST_ASSERT_EQUAL(PROTOCOL_NO_BIT, d.doubleWidthBit);
+    TEST_ASSERT_FALSE(d.oneMarkFirst);
+    
+    char text[kMaxParamsLength];
+    formatParams(d, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("BP 0 0 889 0", text);
+    TEST_ASSERT_EQUAL(0, formatParams(d, text, 5));
+}
+
+void test_malformed_params_are_rejected() {
+    ProtocolDescriptor d;
+    TEST_ASSERT_FALSE(parseParams("", &d));
+    TEST_ASSERT_FALSE(parseParams("XX 1 2 3", &d));
+    TEST_ASSERT_FALSE(parseParams("PD 9000 4500 560 1690 560 560", &d));      // Field missing
+    TEST_ASSERT_FALSE(parseParams("PD 9000 4500 560 1690 560 560 560 1", &d)); // One too many
+    TEST_ASSERT_FALSE(parseParams("PD 9000 0 560 1690 560 560 560", &d));      // Header without space
+    TEST_ASSERT_FALSE(parseParams("PW 0 0 0 600 600 600 0", &d));              // No one mark
+    TEST_ASSERT_FALSE(parseParams("PD 70000 4500 560 1690 560 560 560", &d));
+    TEST_ASSERT_FALSE(parseParams("BP 0 0 0 1", &d));
+    TEST_ASSERT_FALSE(parseParams("BP 0 0 889 2", &d));
+    TEST_ASSERT_FALSE(parseParams("BP 0 0 889 1 64", &d));
+    TEST_ASSERT_FALSE(parseParams("BP 0 0 889x 1", &d));
+}
+
+// ============== Decoder Integration Tests ==============
+
+void test_decoder_attaches_the_inferred_coding_to_raw_signals() {
+    // As IRrecv stores it: kRawTick units after the leading gap
+    const uint16_t length = sizeof(k_pw_header_20) / sizeof(k_pw_header_20[0]);
+    std::vector<uint16_t> rawbuf = {25000};
+    for (uint16_t i = 0; i < length; i++) {
+        rawbuf.push_back((k_pw_header_20[i] + kRawTick / 2) / kRawTick);
+    }
+    decode_results raw = {};
+    raw.decode_type = UNKNOWN;
+    raw.rawbuf = rawbuf.data();
+    raw.rawlen = rawbuf.size();
+    
+    RawTimingPool pool(1);
+    IRLibProtocolDecoder decoder(&pool);
+    DecodedSignal signal = decoder.decode(&raw);
+    TEST_ASSERT_EQUAL_STRING("RAW", signal.protocol);
+    TEST_ASSERT_FALSE(signal.isKnownProtocol);
+    TEST_ASSERT_TRUE(signal.isInferred);
+    TEST_ASSERT_EQUAL(BitCoding::PULSE_WIDTH, signal.inferred.coding);
+    TEST_ASSERT_TRUE(signal.value == 0xE1C2B);
+    TEST_ASSERT_EQUAL(20, signal.bits);
+    TEST_ASSERT_EQUAL(rawbuf.size(), signal.rawTimings.size());
+    
+    // Noise stays opaque
+    std::vector<uint16_t> noise = {25000};
+    for (uint16_t i = 0; i < sizeof(k_noise) / sizeof(k_noise[0]); i++) {
+        noise.push_back(k_noise[i] / kRawTick);
+    }
+    raw.rawbuf = noise.data();
+    raw.rawlen = noise.size();
+    DecodedSignal opaque = decoder.decode(&raw);
+    TEST_ASSERT_FALSE(opaque.isInferred);
+    TEST_ASSERT_EQUAL(0, opaque.bits);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_corpus_captures_infer_their_coding_and_payload);
+    RUN_TEST(test_inferred_timings_are_the_cluster_means);
+    RUN_TEST(test_rc6_style_trailer_bit_is_found);
+    RUN_TEST(test_replay_matches_every_capture_timing);
+    RUN_TEST(test_inference_time_is_bounded);
+    RUN_TEST(test_params_round_trip);
+    RUN_TEST(test_params_format);
+    RUN_TEST(test_malformed_params_are_rejected);
+    RUN_TEST(test_decoder_attaches_the_inferred_coding_to_raw_signals);
+    
+    UNITY_END();
+    
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <unity.h>
+#include <cstring>
+#include "transmitter/IRLibProtocolEncoders.h"
+#include "utils/CommandSequencer.h"
+#include "utils/RawTimingCodec.h"
+#include "receiver/RawTimingPool.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+static const uint16_t kFrame[] = {9000, 4500, 560, 1690, 560, 560, 560, 1690, 560, 39000};
+
+void test_round_trip() {
+    char packed[64];
+    size_t length = raw_timing::encode(kFrame, 10, packed, sizeof(packed));
+    TEST_ASSERT_GREATER_THAN(0, length);
+    TEST_ASSERT_EQUAL(length, strlen(packed));
+    
+    uint16_t decoded[16];
+    TEST_ASSERT_EQUAL(10, raw_timing::decode(packed, decoded, 16));
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(kFrame, decoded, 10);
+}
+
+void test_extremes_round_trip() {
+    const uint16_t timings[] = {1, 0xFFFF, 0xFFFF, 1, 1, 0xFFFF};
+    char packed[64];
+    TEST_ASSERT_GREATER_THAN(0, raw_timing::encode(timings, 6, packed, sizeof(packed)));
+    
+    uint16_t decoded[6];
+    TEST_ASSERT_EQUAL(6, raw_timing::decode(packed, decoded, 6));
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(timings, decoded, 6);
+}
+
+// A whole pool block at the worst case (every delta full range) fits the
+// four characters per duration the learned-signal upload reserves
+void test_full_capture_fits_upload_buffer() {
+    const uint16_t length = RawTimingPool::kBlockTimings - 1;
+    static uint16_t timings[RawTimingPool::kBlockTimings - 1];
+    for (uint16_t i = 0; i < length; i++) {
+        timings[i] = (i / 2) % 2 ? 1 : 0xFFFF;
+    }
+    static char packed[(RawTimingPool::kBlockTimings - 1) * 4 + 1];
+    TEST_ASSERT_GREATER_THAN(0, raw_timing::encode(timings, length, packed, sizeof(packed)));
+    TEST_ASSERT_TRUE(raw_timing::encodedSizeFor(length) <= sizeof(packed));
+    
+    static uint16_t decoded[RawTimingPool::kBlockTimings - 1];
+    TEST_ASSERT_EQUAL(length, raw_timing::decode(packed, decoded, length));
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(timings, decoded, length);
+}
+
+void test_nec_frame_is_compact() {
+    IRLibProtocolEncoders encoder;
+    EncodedSignal signal = encoder.encodeValue(IRProtocol::NEC, 0xF708FB04, 32);
+    
+    char packed[raw_timing::kMaxTimings * 4 + 1];
+    size_t length = raw_timing::encode(signal.rawData, signal.rawLength, packed, sizeof(packed));
+    
+    // Repeated mark/space widths pack to one byte; well under the size
+    // of a decimal array
+    TEST_ASSERT_GREATER_THAN(0, length);
+    TEST_ASSERT_LESS_THAN(signal.rawLength * 2, length);
+    TEST_ASSERT_LESS_OR_EQUAL(raw_timing::encodedSizeFor(signal.rawLength), length + 1);
+    
+    uint16_t decoded[raw_timing::kMaxTimings];
+    TEST_ASSERT_EQUAL(signal.rawLength, raw_timing::decode(packed, decoded, raw_timing::kMaxTimings));
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(signal.rawData, decoded, signal.rawLength);
+}
+
+void test_encode_rejects_small_buffer() {
+    char packed[4];
+    TEST_ASSERT_EQUAL(0, raw_timing::encode(kFrame, 10, packed, sizeof(packed)));
+    TEST_ASSERT_EQUAL_STRING("", packed);
+}
+
+void test_decode_rejects_malformed() {
+    uint16_t decoded[16];
+    TEST_ASSERT_EQUAL(0, raw_timing::decode("ab!c", decoded, 16));      // Not base64url
+    TEST_ASSERT_EQUAL(0, raw_timing::decode("gA", decoded, 16));        // Truncated varint
+    TEST_ASSERT_EQUAL(0, raw_timing::decode("AA", decoded, 16));        // Zero duration
+    TEST_ASSERT_EQUAL(0, raw_timing::decode("_____w", decoded, 16));    // Varint too long
+    TEST_ASSERT_EQUAL(0, raw_timing::decode(nullptr, decoded, 16));
+}
+
+void test_decode_respects_capacity() {
+    char packed[64];
+    raw_timing::encode(kFrame, 10, packed, sizeof(packed));
+    
+    uint16_t decoded[9];
+    TEST_ASSERT_EQUAL(0, raw_timing::decode(packed, decoded, 9));
+}
+
+void test_decode_accepts_padding() {
+    const uint16_t timings[] = {560};
+    char packed[8];
+    size_t length = raw_timing::encode(timings, 1, packed, sizeof(packed));
+    packed[length] = '=';
+    packed[length + 1] = '\0';
+    
+    uint16_t decoded[1];
+    TEST_ASSERT_EQUAL(1, raw_timing::decode(packed, decoded, 1));
+    TEST_ASSERT_EQUAL(560, decoded[0]);
+}
+
+// ============== Batch Handoff ==============
+
+static const uint16_t* dispatchedTimings = nullptr;
+static uint16_t dispatchedLength = 0;
+
+static void recordRaw(const PendingCommand& cmd) {
+    dispatchedTimings = cmd.rawTimings;
+    dispatchedLength = cmd.rawLength;
+}
+
+void test_sequencer_points_raw_steps_at_its_copy() {
+    CommandBatch batch;
+    batch.count = 1;
+    batch.commands[0].protocol = "RAW";
+    batch.rawUsed = raw_timing::decode("0IwB", batch.rawTimings, raw_timing::kMaxTimings);
+    batch.commands[0].rawOffset = 0;
+    batch.commands[0].rawLength = batch.rawUsed;
+    TEST_ASSERT_TRUE(batch.commands[0].isRaw());
+    
+    CommandSequencer sequencer;
+    sequencer.start(batch, 0);
+    batch.rawTimings[0] = 1;  // The sequencer works from its own copy
+    sequencer.update(0, recordRaw);
+    
+    TEST_ASSERT_NOT_NULL(dispatchedTimings);
+    TEST_ASSERT_EQUAL(batch.rawUsed, dispatchedLength);
+    TEST_ASSERT_TRUE(dispatchedTimings != batch.rawTimings);
+    TEST_ASSERT_EQUAL(9000, dispatchedTimings[0]);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_extremes_round_trip);
+    RUN_TEST(test_full_capture_fits_upload_buffer);
+    RUN_TEST(test_nec_frame_is_compact);
+    RUN_TEST(test_encode_rejects_small_buffer);
+    RUN_TEST(test_decode_rejects_malformed);
+    RUN_TEST(test_decode_respects_capacity);
+    RUN_TEST(test_decode_accepts_padding);
+    RUN_TEST(test_sequencer_points_raw_steps_at_its_copy);
+
+    UNITY_END();
+
+    return 0;
+}
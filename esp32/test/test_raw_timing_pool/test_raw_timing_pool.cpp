@@ -0,0 +1,175 @@
+#include <unity.h>
+#include <utility>
+#include <vector>
+#include "receiver/RawTimingPool.h"
+#include "receiver/IRLibProtocolDecoder.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// An unknown remote's frame in rawbuf ticks, gap first
+static uint16_t kFrame[] = {7500, 1500, 750, 250, 750, 250, 250, 250, 750, 250};
+static const size_t kFrameLength = sizeof(kFrame) / sizeof(kFrame[0]);
+
+static decode_results rawCapture(uint16_t* rawbuf, uint16_t rawlen) {
+    decode_results raw = {};
+    raw.decode_type = UNKNOWN;
+    raw.rawbuf = rawbuf;
+    raw.rawlen = rawlen;
+    return raw;
+}
+
+// ============== Pool Tests ==============
+
+void test_acquire_copies_and_destruction_returns_the_block() {
+    RawTimingPool pool(2);
+    TEST_ASSERT_TRUE(pool.begin());
+    TEST_ASSERT_EQUAL(0, pool.getInUse());
+    {
+        RawTimings timings = pool.acquire(kFrame, kFrameLength);
+        TEST_ASSERT_EQUAL(kFrameLength, timings.size());
+        TEST_ASSERT_TRUE(timings.data() != kFrame);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(kFrame, timings.data(), kFrameLength);
+        TEST_ASSERT_EQUAL(1, pool.getInUse());
+    }
+    TEST_ASSERT_EQUAL(0, pool.getInUse());
+    TEST_ASSERT_EQUAL(1, pool.getHighWater());
+}
+
+void test_move_transfers_the_block() {
+    RawTimingPool pool(2);
+    RawTimings first = pool.acquire(kFrame, kFrameLength);
+    const uint16_t* block = first.data();
+    
+    RawTimings second(std::move(first));
+    TEST_ASSERT_TRUE(first.empty());
+    TEST_ASSERT_NULL(first.data());
+    TEST_ASSERT_EQUAL_PTR(block, second.data());
+    TEST_ASSERT_EQUAL(1, pool.getInUse());
+    
+    // Assigning over a handle returns the block it held
+    RawTimings third = pool.acquire(kFrame, 4);
+    TEST_ASSERT_EQUAL(2, pool.getInUse());
+    third = std::move(second);
+    TEST_ASSERT_EQUAL(1, pool.getInUse());
+    TEST_ASSERT_EQUAL_PTR(block, third.data());
+    
+    third.reset();
+    TEST_ASSERT_EQUAL(0, pool.getInUse());
+}
+
+void test_exhausted_pool_gives_an_empty_handle() {
+    RawTimingPool pool(2);
+    RawTimings a = pool.acquire(kFrame, kFrameLength);
+    RawTimings b = pool.acquire(kFrame, kFrameLength);
+    RawTimings c = pool.acquire(kFrame, kFrameLength);
+    
+    TEST_ASSERT_FALSE(a.empty());
+    TEST_ASSERT_FALSE(b.empty());
+    TEST_ASSERT_TRUE(c.empty());
+    TEST_ASSERT_EQUAL(1, pool.getFailures());
+    TEST_ASSERT_EQUAL(2, pool.getHighWater());
+    
+    // Freed blocks are handed out again
+    a.reset();
+    c = pool.acquire(kFrame, kFrameLength);
+    TEST_ASSERT_FALSE(c.empty());
+}
+
+void test_capture_longer_than_a_block_is_rejected() {
+    RawTimingPool pool(1);
+    std::vector<uint16_t> longest(RawTimingPool::kBlockTimings, 250);
+    std::vector<uint16_t> tooLong(RawTimingPool::kBlockTimings + 1, 250);
+    
+    TEST_ASSERT_TRUE(pool.acquire(tooLong.data(), tooLong.size()).empty());
+    TEST_ASSERT_EQUAL(1, pool.getFailures());
+    
+    RawTimings timings = pool.acquire(longest.data(), longest.size());
+    TEST_ASSERT_EQUAL(RawTimingPool::kBlockTimings, timings.size());
+}
+
+// ============== Decoder Ownership Tests ==============
+
+void test_raw_signal_holds_a_block_until_destroyed() {
+    RawTimingPool pool(2);
+    IRLibProtocolDecoder decoder(&pool);
+    decode_results raw = rawCapture(kFrame, kFrameLength);
+    {
+        DecodedSignal signal = decoder.decode(&raw);
+        TEST_ASSERT_EQUAL_STRING("RAW", signal.protocol);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(kFrame, signal.rawTimings.data(), kFrameLength);
+        TEST_ASSERT_EQUAL(1, pool.getInUse());
+        
+        // The capture reuses its rawbuf; the signal's copy is unaffected
+        kFrame[1] = 1;
+        TEST_ASSERT_EQUAL_UINT16(1500, signal.rawTimings[1]);
+        kFrame[1] = 1500;
+    }
+    TEST_ASSERT_EQUAL(0, pool.getInUse());
+}
+
+void test_known_signal_takes_no_block() {
+    RawTimingPool pool(2);
+    IRLibProtocolDecoder decoder(&pool);
+    decode_results raw = rawCapture(kFrame, kFrameLength);
+    raw.decode_type = NEC;
+    raw.value = 0xED12FF00;
+    raw.bits = 32;
+    
+    DecodedSignal signal = decoder.decode(&raw);
+    TEST_ASSERT_TRUE(signal.isKnownProtocol);
+    TEST_ASSERT_TRUE(signal.rawTimings.empty());
+    TEST_ASSERT_EQUAL(0, pool.getHighWater());
+}
+
+void test_no_leaks_across_100k_decode_cycles() {
+    RawTimingPool pool(2);
+    IRLibProtocolDecoder decoder(&pool);
+    std::vector<uint16_t> rawbuf(kFrame, kFrame + kFrameLength);
+    
+    size_t copied = 0;
+    for (uint32_t cycle = 0; cycle < 100000; cycle++) {
+        rawbuf[2] = 250 + cycle % 500;
+        decode_results raw = rawCapture(rawbuf.data(), rawbuf.size());
+        if (cycle % 3 == 2) {
+            raw.decode_type = SONY;
+            raw.value = cycle & 0xFFF;
+            raw.bits = 12;
+        }
+        
+        // Handed on the way the learning path does: returned, then moved
+        DecodedSignal signal = decoder.decode(&raw);
+        DecodedSignal kept = std::move(signal);
+        if (!kept.isKnownProtocol) {
+            TEST_ASSERT_EQUAL_UINT16(rawbuf[2], kept.rawTimings[2]);
+            copied++;
+        }
+    }
+    
+    TEST_ASSERT_EQUAL(66667, copied);
+    TEST_ASSERT_EQUAL(0, pool.getInUse());
+    TEST_ASSERT_EQUAL(1, pool.getHighWater());
+    TEST_ASSERT_EQUAL(0, pool.getFailures());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_acquire_copies_and_destruction_returns_the_block);
+    RUN_TEST(test_move_transfers_the_block);
+    RUN_TEST(test_exhausted_pool_gives_an_empty_handle);
+    RUN_TEST(test_capture_longer_than_a_block_is_rejected);
+    RUN_TEST(test_raw_signal_holds_a_block_until_destroyed);
+    RUN_TEST(test_known_signal_takes_no_block);
+    RUN_TEST(test_no_leaks_across_100k_decode_cycles);
+    
+    UNITY_END();
+    
+    return 0;
+}
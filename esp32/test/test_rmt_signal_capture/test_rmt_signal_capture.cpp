@@ -0,0 +1,229 @@
+#include <unity.h>
+#include <vector>
+#include "mock_rmt_receiver.h"
+#include "receiver/RmtSignalCapture.h"
+#include "receiver/IRLibProtocolDecoder.h"
+#include "receiver/LearningStateMachine.h"
+#include "transmitter/IRLibProtocolEncoders.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// A recorded frame: what the encoder sends is what the receiver sees
+static std::vector<uint16_t> renderFrame(IRProtocol protocol, uint64_t value, uint16_t bits) {
+    IRLibProtocolEncoders encoder;
+    uint16_t timings[256];
+    uint16_t length = encoder.encodeValue(protocol, value, bits, TimingSpan(timings, 256));
+    return std::vector<uint16_t>(timings, timings + length);
+}
+
+// ============== RMT Capture Tests ==============
+
+void test_enable_configures_idle_threshold() {
+    MockRmtReceiver receiver;
+    RmtSignalCapture capture(&receiver, 12000);
+
+    TEST_ASSERT_FALSE(receiver.begun);
+    capture.enable();
+    TEST_ASSERT_TRUE(receiver.begun);
+    TEST_ASSERT_TRUE(receiver.running);
+    TEST_ASSERT_EQUAL(12000, receiver.idleThresholdUs);
+
+    capture.disable();
+    TEST_ASSERT_FALSE(receiver.running);
+}
+
+void test_nec_frame_decodes_like_irrecv() {
+    MockRmtReceiver receiver;
+    RmtSignalCapture capture(&receiver);
+    capture.enable();
+
+    std::vector<uint16_t> frame = renderFrame(IRProtocol::NEC, 0x20DF10EF, 32);
+    receiver.pushTimings(frame, 40000);
+
+    decode_results results;
+    TEST_ASSERT_TRUE(capture.decode(&results));
+    TEST_ASSERT_EQUAL(NEC, results.decode_type);
+    TEST_ASSERT_EQUAL_HEX64(0x20DF10EF, results.value);
+    TEST_ASSERT_EQUAL(32, results.bits);
+
+    // rawbuf: leading gap, then each duration in kRawTick units
+    TEST_ASSERT_EQUAL(frame.size() + 1, results.rawlen);
+    TEST_ASSERT_EQUAL(RmtSignalCapture::kDefaultIdleThresholdUs / kRawTick, results.rawbuf[0]);
+    TEST_ASSERT_EQUAL(frame[0] / kRawTick, results.rawbuf[1]);
+
+    // And through the protocol decoder, as learning uses it
+    IRLibProtocolDecoder decoder;
+    DecodedSignal signal = decoder.decode(&results);
+    TEST_ASSERT_EQUAL_STRING("NEC", signal.protocol);
+    TEST_ASSERT_TRUE(signal.isKnownProtocol);
+}
+
+void test_unknown_frame_keeps_raw_timings() {
+    MockRmtReceiver receiver;
+    RmtSignalCapture capture(&receiver);
+    capture.enable();
+
+    std::vector<uint16_t> frame = {3000, 1000, 500, 500, 500, 1500, 500, 500, 500};
+    receiver.pushTimings(frame);
+
+    decode_results results;
+    TEST_ASSERT_TRUE(capture.decode(&results));
+    TEST_ASSERT_EQUAL(UNKNOWN, results.decode_type);
+    TEST_ASSERT_EQUAL(frame.size(), capture.getTimingCount());
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(frame.data(), capture.getTimings(), frame.size());
+    TEST_ASSERT_EQUAL(750, results.rawbuf[6]);
+}
+
+void test_long_pulses_split_over_symbols_are_merged() {
+    MockRmtReceiver receiver;
+    RmtSignalCapture capture(&receiver);
+    capture.enable();
+
+    // A 40ms space needs two symbol halves at the same level
+    std::vector<uint16_t> frame = {9000, 40000, 560, 560, 560, 1690, 560};
+    receiver.pushTimings(frame, 50000);
+
+    TEST_ASSERT_TRUE(capture.hasSignal());
+    TEST_ASSERT_EQUAL(frame.size(), capture.getTimingCount());
+    TEST_ASSERT_EQUAL(40000, capture.getTimings()[1]);
+}
+
+void test_noise_bursts_are_discarded() {
+    MockRmtReceiver receiver;
+    RmtSignalCapture capture(&receiver);
+    capture.enable();
+
+    receiver.pushTimings({120, 300, 90});
+    receiver.pushTimings(renderFrame(IRProtocol::SONY, 0xA90, 12));
+
+    decode_results results;
+    TEST_ASSERT_TRUE(capture.decode(&results));
+    TEST_ASSERT_EQUAL(SONY, results.decode_type);
+    TEST_ASSERT_EQUAL(1, capture.getNoiseCount());
+    TEST_ASSERT_EQUAL(1, capture.getFrameCount());
+}
+
+void test_oversized_frame_is_dropped() {
+    MockRmtReceiver receiver;
+    RmtSignalCapture capture(&receiver);
+    capture.enable();
+
+    std::vector<uint16_t> huge(RmtSignalCapture::kMaxTimings + 20, 500);
+    receiver.pushTimings(huge);
+
+    TEST_ASSERT_FALSE(capture.hasSignal());
+    TEST_ASSERT_EQUAL(1, capture.getOverflowCount());
+}
+
+void test_frame_held_until_resume() {
+    MockRmtReceiver receiver;
+    RmtSignalCapture capture(&receiver);
+    capture.enable();
+
+    receiver.pushTimings(renderFrame(IRProtocol::NEC, 0x20DF10EF, 32));
+    receiver.pushTimings(renderFrame(IRProtocol::NEC, 0x20DF40BF, 32));
+
+    decode_results results;
+    TEST_ASSERT_TRUE(capture.decode(&results));
+    TEST_ASSERT_TRUE(capture.decode(&results));
+    TEST_ASSERT_EQUAL_HEX64(0x20DF10EF, results.value);
+
+    capture.resume();
+    TEST_ASSERT_TRUE(capture.decode(&results));
+    TEST_ASSERT_EQUAL_HEX64(0x20DF40BF, results.value);
+
+    capture.resume();
+    TEST_ASSERT_FALSE(capture.decode(&results));
+}
+
+void test_disabled_capture_reads_nothing() {
+    MockRmtReceiver receiver;
+    RmtSignalCapture capture(&receiver);
+
+    receiver.pushTimings(renderFrame(IRProtocol::NEC, 0x20DF10EF, 32));
+    TEST_ASSERT_FALSE(capture.hasSignal());
+    TEST_ASSERT_EQUAL(1, receiver.frames.size());
+}
+
+static int readyCalls;
+
+static void countReady(void*) {
+    readyCalls++;
+}
+
+void test_ready_hook_fires_once_per_frame() {
+    MockRmtReceiver receiver;
+    RmtSignalCapture capture(&receiver);
+    readyCalls = 0;
+    
+    TEST_ASSERT_TRUE(capture.setReadyHook(countReady, nullptr));
+    capture.enable();
+    receiver.pushTimings(renderFrame(IRProtocol::NEC, 0x20DF10EF, 32));
+    receiver.pushTimings(renderFrame(IRProtocol::SONY, 0x910, 12));
+    TEST_ASSERT_EQUAL(2, readyCalls);
+    
+    // Whole frames only: nothing asks to be polled in between
+    TEST_ASSERT_EQUAL(0, capture.pollIntervalMs());
+    decode_results results;
+    TEST_ASSERT_TRUE(capture.decode(&results));
+    TEST_ASSERT_EQUAL(NEC, results.decode_type);
+}
+
+void test_ready_hook_refused_without_receiver_support() {
+    MockRmtReceiver receiver;
+    receiver.canNotify = false;
+    RmtSignalCapture capture(&receiver);
+    readyCalls = 0;
+    
+    TEST_ASSERT_FALSE(capture.setReadyHook(countReady, nullptr));
+    capture.enable();
+    receiver.pushTimings(renderFrame(IRProtocol::NEC, 0x20DF10EF, 32));
+    TEST_ASSERT_EQUAL(0, readyCalls);
+    TEST_ASSERT_TRUE(capture.hasSignal());
+}
+
+void test_learning_on_rmt_waits_for_the_hook() {
+    MockRmtReceiver receiver;
+    RmtSignalCapture capture(&receiver);
+    IRLibProtocolDecoder decoder;
+    LearningStateMachine learning(&capture, &decoder, 30000, 1);
+    TEST_ASSERT_TRUE(learning.isEventDriven());
+    
+    // Quiet air: the wait is the learning timeout, not a poll tick
+    mockMillis() = 1000;
+    capture.enable();
+    learning.startLearning();
+    TEST_ASSERT_TRUE(learning.msUntilDue(mockMillis()) > LearningStateMachine::kPollIntervalMs);
+    
+    receiver.pushTimings(renderFrame(IRProtocol::NEC, 0x20DF10EF, 32));
+    TEST_ASSERT_EQUAL(0, learning.msUntilDue(mockMillis()));
+    learning.update();
+    TEST_ASSERT_FALSE(learning.isLearning());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_enable_configures_idle_threshold);
+    RUN_TEST(test_nec_frame_decodes_like_irrecv);
+    RUN_TEST(test_unknown_frame_keeps_raw_timings);
+    RUN_TEST(test_long_pulses_split_over_symbols_are_merged);
+    RUN_TEST(test_noise_bursts_are_discarded);
+    RUN_TEST(test_oversized_frame_is_dropped);
+    RUN_TEST(test_frame_held_until_resume);
+    RUN_TEST(test_disabled_capture_reads_nothing);
+    RUN_TEST(test_ready_hook_fires_once_per_frame);
+    RUN_TEST(test_ready_hook_refused_without_receiver_support);
+    RUN_TEST(test_learning_on_rmt_waits_for_the_hook);
+
+    UNITY_END();
+
+    return 0;
+}
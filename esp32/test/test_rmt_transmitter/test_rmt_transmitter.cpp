@@ -0,0 +1,266 @@
+#include <unity.h>
+#include "transmitter/IRLibProtocolEncoders.h"
+#include "transmitter/RmtIRTransmitter.h"
+#include "transmitter/RmtSymbolEncoder.h"
+#include "mock_rmt_channel.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// Compare what the mock RMT emitted with an encoder-produced timing buffer
+static void assertEmitted(const MockRmtChannel& channel, const uint16_t* expected, uint16_t length) {
+    std::vector<uint16_t> emitted = channel.timings();
+    TEST_ASSERT_EQUAL(length, emitted.size());
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, emitted.data(), length);
+}
+
+// ============== Symbol Encoder Tests ==============
+
+void test_symbol_encoder_packs_mark_space_pairs() {
+    IRLibProtocolEncoders encoder;
+    EncodedSignal signal = encoder.encode("NEC", 0x04, 0x08, 32);
+    
+    RmtSymbol symbols[64];
+    size_t count = RmtSymbolEncoder::encode(signal.rawData, signal.rawLength, symbols, 64);
+    
+    // 67 timings = 33 mark/space pairs + footer mark
+    TEST_ASSERT_EQUAL(34, count);
+    TEST_ASSERT_EQUAL(9000, symbols[0].duration0);
+    TEST_ASSERT_EQUAL(1, symbols[0].level0);
+    TEST_ASSERT_EQUAL(4500, symbols[0].duration1);
+    TEST_ASSERT_EQUAL(0, symbols[0].level1);
+    
+    // Footer mark followed by the zero-length end marker
+    TEST_ASSERT_EQUAL(560, symbols[33].duration0);
+    TEST_ASSERT_EQUAL(1, symbols[33].level0);
+    TEST_ASSERT_EQUAL(0, symbols[33].duration1);
+}
+
+void test_symbol_encoder_splits_long_durations() {
+    uint16_t timings[] = {560, 40000, 560};
+    RmtSymbol symbols[4];
+    
+    size_t count = RmtSymbolEncoder::encode(timings, 3, symbols, 4);
+    
+    // 40000us does not fit one 15-bit half: split into two space halves
+    TEST_ASSERT_EQUAL(2, count);
+    TEST_ASSERT_EQUAL(560, symbols[0].duration0);
+    TEST_ASSERT_EQUAL(RMT_MAX_SYMBOL_DURATION, symbols[0].duration1);
+    TEST_ASSERT_EQUAL(0, symbols[0].level1);
+    TEST_ASSERT_EQUAL(40000 - RMT_MAX_SYMBOL_DURATION, symbols[1].duration0);
+    TEST_ASSERT_EQUAL(0, symbols[1].level0);
+    TEST_ASSERT_EQUAL(560, symbols[1].duration1);
+    TEST_ASSERT_EQUAL(1, symbols[1].level1);
+}
+
+void test_symbol_encoder_rejects_small_buffer() {
+    uint16_t timings[] = {9000, 4500, 560, 560, 560};
+    RmtSymbol symbols[2];
+    
+    TEST_ASSERT_EQUAL(3, RmtSymbolEncoder::symbolCount(timings, 5));
+    TEST_ASSERT_EQUAL(0, RmtSymbolEncoder::encode(timings, 5, symbols, 2));
+}
+
+// ============== Transmitter Tests ==============
+
+void test_raw_transmit_emits_encoder_timings() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter(&channel, &encoder);
+    transmitter.begin();
+    
+    EncodedSignal signal = encoder.encode("NEC", 0x04, 0x08, 32);
+    TransmitResult result = transmitter.transmit(signal.rawData, signal.rawLength, signal.frequency);
+    
+    TEST_ASSERT_TRUE(result.success);
+    TEST_ASSERT_TRUE(channel.begun);
+    TEST_ASSERT_EQUAL(1, channel.writeCount);
+    assertEmitted(channel, signal.rawData, signal.rawLength);
+}
+
+void test_nec_value_matches_encoder_output() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter(&channel, &encoder);
+    transmitter.begin();
+    
+    // NEC value as IRremoteESP8266 decodes it for addr=0x04, cmd=0x08
+    uint32_t value = 0x04 | (0xFB << 8) | (0x08 << 16) | (0xF7 << 24);
+    TEST_ASSERT_TRUE(transmitter.transmitNEC(value, 32).success);
+    
+    EncodedSignal expected = encoder.encode("NEC", 0x04, 0x08, 32);
+    assertEmitted(channel, expected.rawData, expected.rawLength);
+}
+
+void test_samsung_value_matches_encoder_output() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter(&channel, &encoder);
+    transmitter.begin();
+    
+    uint32_t value = (0x0707u << 16) | (0x07 << 8) | 0xF8;
+    TEST_ASSERT_TRUE(transmitter.transmitSamsung(value, 32).success);
+    
+    EncodedSignal expected = encoder.encode("SAMSUNG", 0x0707, 0x07, 32);
+    assertEmitted(channel, expected.rawData, expected.rawLength);
+}
+
+void test_sony_sends_three_frames_on_45ms_period() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter(&channel, &encoder);
+    transmitter.begin();
+    
+    uint32_t value = 0x15 | (0x01 << 7);
+    TEST_ASSERT_TRUE(transmitter.transmitSony(value, 12).success);
+    
+    EncodedSignal frame = encoder.encode("SONY", 0x01, 0x15, 12);
+    std::vector<uint16_t> emitted = channel.timings();
+    TEST_ASSERT_EQUAL(frame.rawLength * 3 + 2, emitted.size());
+    
+    uint32_t frameDuration = 0;
+    for (uint16_t i = 0; i < frame.rawLength; i++) {
+        frameDuration += frame.rawData[i];
+    }
+    
+    for (int f = 0; f < 3; f++) {
+        const uint16_t* copy = emitted.data() + f * (frame.rawLength + 1);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(frame.rawData, copy, frame.rawLength);
+        if (f < 2) {
+            TEST_ASSERT_EQUAL(45000 - frameDuration, copy[frame.rawLength]);
+        }
+    }
+}
+
+void test_transmit_configures_carrier() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter(&channel, &encoder);
+    transmitter.begin();
+    
+    uint16_t rawData[] = {9000, 4500, 560};
+    TEST_ASSERT_TRUE(transmitter.transmit(rawData, 3, 40).success);
+    
+    TEST_ASSERT_EQUAL(40000, channel.carrierFrequencyHz);
+    TEST_ASSERT_EQUAL(33, channel.carrierDutyPercent);
+}
+
+// ============== Carrier Tests ==============
+
+void test_each_protocol_sets_its_own_carrier() {
+    struct Expected {
+        IRProtocol protocol;
+        uint64_t value;
+        uint16_t bits;
+        uint32_t frequencyHz;
+        uint8_t dutyPercent;
+    };
+    const Expected expected[] = {
+        {IRProtocol::NEC, 0xF708FB04, 32, 38000, 33},
+        {IRProtocol::SAMSUNG, 0xE0E040BF, 32, 38000, 33},
+        {IRProtocol::SONY, 0xA90, 12, 40000, 33},
+        {IRProtocol::RC5, 0x10C, 12, 36000, 25},
+        {IRProtocol::RC6, 0x1000C, 20, 36000, 25},
+        {IRProtocol::PANASONIC, 0x400401000405ULL, 48, 37000, 33},
+        {IRProtocol::JVC, 0xC5E8, 16, 38000, 33},
+        {IRProtocol::LG, 0x88C0051, 28, 38000, 33},
+        {IRProtocol::SHARP, 0x454A, 15, 38000, 33},
+    };
+    
+    size_t descriptorCount = 0;
+    protocolDescriptors(&descriptorCount);
+    TEST_ASSERT_EQUAL(descriptorCount, sizeof(expected) / sizeof(expected[0]));
+    
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter(&channel, &encoder);
+    transmitter.begin();
+    
+    // Alternate protocols so every send has to change the carrier
+    for (size_t i = 0; i < descriptorCount; i++) {
+        const Expected& e = expected[i];
+        TEST_ASSERT_TRUE(transmitter.transmitValue(e.protocol, e.value, e.bits).success);
+        TEST_ASSERT_EQUAL(e.frequencyHz, channel.carrierFrequencyHz);
+        TEST_ASSERT_EQUAL(e.dutyPercent, channel.carrierDutyPercent);
+        TEST_ASSERT_EQUAL(findDescriptor(e.protocol)->carrierKHz * 1000, channel.carrierFrequencyHz);
+    }
+}
+
+void test_command_carrier_overrides_protocol() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    WaveformCache cache(4, 256);
+    cache.begin();
+    RmtIRTransmitter transmitter(&channel, &encoder, &cache);
+    transmitter.begin();
+    
+    // A learned NEC code for a 56kHz receiver, sent twice (second from cache)
+    for (int press = 0; press < 2; press++) {
+        TEST_ASSERT_TRUE(transmitter.transmitValue(IRProtocol::NEC, 0xF708FB04, 32, 56, 50).success);
+        TEST_ASSERT_EQUAL(56000, channel.carrierFrequencyHz);
+        TEST_ASSERT_EQUAL(50, channel.carrierDutyPercent);
+    }
+    TEST_ASSERT_EQUAL(1, cache.getHits());
+    
+    // The cached frame goes back to the protocol carrier without an override
+    TEST_ASSERT_TRUE(transmitter.transmitValue(IRProtocol::NEC, 0xF708FB04, 32).success);
+    TEST_ASSERT_EQUAL(38000, channel.carrierFrequencyHz);
+    TEST_ASSERT_EQUAL(33, channel.carrierDutyPercent);
+    
+    // Overriding only the duty keeps the protocol frequency
+    TEST_ASSERT_TRUE(transmitter.transmitValue(IRProtocol::SONY, 0xA90, 12, 0, 50).success);
+    TEST_ASSERT_EQUAL(40000, channel.carrierFrequencyHz);
+    TEST_ASSERT_EQUAL(50, channel.carrierDutyPercent);
+}
+
+void test_busy_channel_rejects_frame() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter(&channel, &encoder);
+    transmitter.begin();
+    
+    channel.busy = true;
+    TEST_ASSERT_TRUE(transmitter.isBusy());
+    
+    TransmitResult result = transmitter.transmitNEC(0xF708FB04, 32);
+    
+    TEST_ASSERT_FALSE(result.success);
+    TEST_ASSERT_EQUAL(0, channel.writeCount);
+}
+
+void test_invalid_raw_data_rejected() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter(&channel, &encoder);
+    transmitter.begin();
+    
+    TEST_ASSERT_FALSE(transmitter.transmit(nullptr, 10, 38).success);
+    TEST_ASSERT_EQUAL(0, channel.writeCount);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_symbol_encoder_packs_mark_space_pairs);
+    RUN_TEST(test_symbol_encoder_splits_long_durations);
+    RUN_TEST(test_symbol_encoder_rejects_small_buffer);
+    RUN_TEST(test_raw_transmit_emits_encoder_timings);
+    RUN_TEST(test_nec_value_matches_encoder_output);
+    RUN_TEST(test_samsung_value_matches_encoder_output);
+    RUN_TEST(test_sony_sends_three_frames_on_45ms_period);
+    RUN_TEST(test_transmit_configures_carrier);
+    RUN_TEST(test_each_protocol_sets_its_own_carrier);
+    RUN_TEST(test_command_carrier_overrides_protocol);
+    RUN_TEST(test_busy_channel_rejects_frame);
+    RUN_TEST(test_invalid_raw_data_rejected);
+
+    UNITY_END();
+
+    return 0;
+}
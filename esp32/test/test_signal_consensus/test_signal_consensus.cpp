@@ -0,0 +1,227 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "receiver/SignalConsensus.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// A capture as IRrecv reports it: rawbuf in kRawTick units, gap first
+struct Capture {
+    std::vector<uint16_t> raw;
+    decode_results results;
+    
+    Capture(int type, uint64_t value, uint16_t bits, const std::vector<uint16_t>& timings) : raw(timings) {
+        results.decode_type = type;
+        results.value = value;
+        results.address = 0;
+        results.command = 0;
+        results.bits = bits;
+        results.rawbuf = raw.data();
+        results.rawlen = raw.size();
+        results.repeat = false;
+    }
+};
+
+// Unknown pulse-distance remote: 3000/1500 header, 500 marks, 500/1500
+// spaces (in 2us ticks), each slot pushed off nominal by jitter[slot % n]
+static std::vector<uint16_t> rawFrame(const std::vector<int>& jitter) {
+    std::vector<uint16_t> raw = {20000, 1500, 750};
+    const uint8_t data = 0xA5;
+    for (int bit = 0; bit < 8; bit++) {
+        raw.push_back(250);
+        raw.push_back((data >> bit) & 1 ? 750 : 250);
+    }
+    raw.push_back(250);
+    for (size_t i = 1; i < raw.size(); i++) {
+        raw[i] += jitter[i % jitter.size()];
+    }
+    return raw;
+}
+
+// ============== Consensus Tests ==============
+
+void test_agreeing_decodes_give_full_confidence() {
+    SignalConsensus consensus;
+    std::vector<uint16_t> timings = rawFrame({0});
+    for (int i = 0; i < 3; i++) {
+        Capture capture(NEC, 0x20DF10EF, 32, timings);
+        TEST_ASSERT_TRUE(consensus.add(capture.results));
+    }
+    
+    decode_results merged;
+    TEST_ASSERT_EQUAL(100, consensus.build(&merged, 3));
+    TEST_ASSERT_EQUAL(NEC, merged.decode_type);
+    TEST_ASSERT_EQUAL_HEX64(0x20DF10EF, merged.value);
+    TEST_ASSERT_EQUAL(32, merged.bits);
+}
+
+void test_majority_decode_wins() {
+    SignalConsensus consensus;
+    std::vector<uint16_t> timings = rawFrame({0});
+    Capture a(NEC, 0x20DF10EF, 32, timings);
+    Capture misread(NEC, 0x20DF10FF, 32, timings);
+    consensus.add(a.results);
+    consensus.add(misread.results);
+    consensus.add(a.results);
+    
+    decode_results merged;
+    TEST_ASSERT_EQUAL(66, consensus.build(&merged, 3));
+    TEST_ASSERT_EQUAL_HEX64(0x20DF10EF, merged.value);
+}
+
+void test_raw_frames_merge_to_slot_median_on_grid() {
+    SignalConsensus consensus;
+    Capture a(UNKNOWN, 0, 0, rawFrame({10, -8, 3}));
+    Capture b(UNKNOWN, 0, 0, rawFrame({-6, 12, 0}));
+    Capture c(UNKNOWN, 0, 0, rawFrame({2, 4, -10}));
+    consensus.add(a.results);
+    consensus.add(b.results);
+    consensus.add(c.results);
+    
+    decode_results merged;
+    uint8_t confidence = consensus.build(&merged, 3);
+    TEST_ASSERT_EQUAL(UNKNOWN, merged.decode_type);
+    TEST_ASSERT_EQUAL(a.raw.size(), merged.rawlen);
+    TEST_ASSERT_TRUE(confidence > 80 && confidence < 100);
+    
+    // Every mark is one grid value, and each kind of space is another
+    const uint16_t mark = merged.rawbuf[3];
+    for (size_t i = 3; i < merged.rawlen; i += 2) {
+        TEST_ASSERT_EQUAL(mark, merged.rawbuf[i]);
+    }
+    TEST_ASSERT_UINT16_WITHIN(6, 250, mark);
+    TEST_ASSERT_EQUAL(merged.rawbuf[4], merged.rawbuf[8]);   // Bits 0 and 2: ones
+    TEST_ASSERT_EQUAL(merged.rawbuf[6], merged.rawbuf[10]);  // Bits 1 and 3: zeros
+    TEST_ASSERT_UINT16_WITHIN(6, 750, merged.rawbuf[4]);
+    TEST_ASSERT_UINT16_WITHIN(6, 250, merged.rawbuf[6]);
+}
+
+void test_glitched_capture_is_outvoted() {
+    SignalConsensus consensus;
+    Capture a(UNKNOWN, 0, 0, rawFrame({4}));
+    Capture b(UNKNOWN, 0, 0, rawFrame({-4}));
+    
+    // A noise spike split one space in two
+    std::vector<uint16_t> glitched = rawFrame({0});
+    glitched[6] = 100;
+    glitched.insert(glitched.begin() + 7, {20, 130});
+    Capture c(UNKNOWN, 0, 0, glitched);
+    
+    consensus.add(a.results);
+    consensus.add(c.results);
+    consensus.add(b.results);
+    
+    decode_results merged;
+    uint8_t confidence = consensus.build(&merged, 3);
+    TEST_ASSERT_EQUAL(a.raw.size(), merged.rawlen);
+    TEST_ASSERT_TRUE(confidence > 0 && confidence <= 66);
+}
+
+void test_single_capture_has_low_confidence() {
+    SignalConsensus consensus;
+    Capture a(UNKNOWN, 0, 0, rawFrame({0}));
+    consensus.add(a.results);
+    
+    decode_results merged;
+    TEST_ASSERT_EQUAL(33, consensus.build(&merged, 3));
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(a.raw.data() + 1, merged.rawbuf + 1, a.raw.size() - 1);
+}
+
+void test_repeat_codes_and_oversized_frames_are_ignored() {
+    SignalConsensus consensus;
+    Capture repeat(NEC, 0xFFFFFFFFFFFFFFFFULL, 0, {20000, 4500, 1125, 280});
+    repeat.results.repeat = true;
+    TEST_ASSERT_FALSE(consensus.add(repeat.results));
+    
+    Capture huge(UNKNOWN, 0, 0, std::vector<uint16_t>(SignalConsensus::kMaxTimings + 1, 300));
+    TEST_ASSERT_FALSE(consensus.add(huge.results));
+    TEST_ASSERT_EQUAL(0, consensus.getFrameCount());
+    
+    Capture a(UNKNOWN, 0, 0, rawFrame({0}));
+    for (uint8_t i = 0; i < SignalConsensus::kMaxFrames; i++) {
+        TEST_ASSERT_TRUE(consensus.add(a.results));
+    }
+    TEST_ASSERT_FALSE(consensus.add(a.results));
+}
+
+void test_unaligned_frames_fall_back_to_one() {
+    SignalConsensus consensus;
+    decode_results merged;
+    TEST_ASSERT_EQUAL(0, consensus.build(&merged, 3));
+    TEST_ASSERT_EQUAL(0, merged.rawlen);
+    
+    // Three lengths: no two frames line up, so each is a group of one
+    std::vector<uint16_t> first = rawFrame({0});
+    std::vector<uint16_t> second = first;
+    second.push_back(750);
+    Capture a(UNKNOWN, 0, 0, first);
+    Capture b(UNKNOWN, 0, 0, second);
+    Capture c(UNKNOWN, 0, 0, {20000, 250});
+    consensus.add(a.results);
+    consensus.add(b.results);
+    consensus.add(c.results);
+    
+    // One of three expected frames, no deviation from itself
+    TEST_ASSERT_EQUAL(33, consensus.build(&merged, 3));
+    TEST_ASSERT_EQUAL(first.size(), merged.rawlen);
+    for (size_t i = 0; i < first.size(); i++) {
+        TEST_ASSERT_EQUAL(first[i], merged.rawbuf[i]);
+    }
+}
+
+void test_build_time_is_bounded() {
+    SignalConsensus consensus;
+    std::vector<Capture> captures;
+    for (uint8_t f = 0; f < SignalConsensus::kMaxFrames; f++) {
+        std::vector<uint16_t> raw(SignalConsensus::kMaxTimings);
+        for (size_t i = 0; i < raw.size(); i++) {
+            raw[i] = (i % 3 ? 280 : 840) + (i * 7 + f * 13) % 20;
+        }
+        captures.push_back(Capture(UNKNOWN, 0, 0, raw));
+    }
+    for (size_t f = 0; f < captures.size(); f++) {
+        captures[f].results.rawbuf = captures[f].raw.data();
+        consensus.add(captures[f].results);
+    }
+    
+    const int iterations = 200;
+    decode_results merged;
+    uint8_t confidence = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        confidence = consensus.build(&merged, SignalConsensus::kMaxFrames);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    
+    char message[96];
+    snprintf(message, sizeof(message), "[Bench] consensus of %d x %d timings: %.1f us",
+             SignalConsensus::kMaxFrames, SignalConsensus::kMaxTimings, (double)elapsed.count() / iterations);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL(SignalConsensus::kMaxTimings, merged.rawlen);
+    TEST_ASSERT_TRUE(confidence > 0);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_agreeing_decodes_give_full_confidence);
+    RUN_TEST(test_majority_decode_wins);
+    RUN_TEST(test_raw_frames_merge_to_slot_median_on_grid);
+    RUN_TEST(test_glitched_capture_is_outvoted);
+    RUN_TEST(test_single_capture_has_low_confidence);
+    RUN_TEST(test_repeat_codes_and_oversized_frames_are_ignored);
+    RUN_TEST(test_unaligned_frames_fall_back_to_one);
+    RUN_TEST(test_build_time_is_bounded);
+    
+    UNITY_END();
+    
+    return 0;
+}
@@ -0,0 +1,289 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "mock_signal_capture.h"
+#include "receiver/SignalSniffer.h"
+#include "receiver/SignalFingerprint.h"
+#include "receiver/IRLibProtocolDecoder.h"
+#include "utils/SniffBatch.h"
+
+// Fake microsecond clock: every reading is 25us later
+static uint32_t fakeNow = 0;
+static uint32_t fakeClock() {
+    return fakeNow += 25;
+}
+
+static uint32_t hostClock() {
+    static const auto start = std::chrono::steady_clock::now();
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// NEC-timed frame in rawbuf ticks, gap first (the mock capture reports
+// it as UNKNOWN, so it is sniffed as an inferred pulse-distance code)
+static std::vector<uint16_t> necFrame(uint32_t value) {
+    std::vector<uint16_t> rawbuf = {20000, 9000 / kRawTick, 4500 / kRawTick};
+    for (int i = 0; i < 32; i++) {
+        rawbuf.push_back(560 / kRawTick);
+        rawbuf.push_back((value >> (31 - i)) & 1 ? 1690 / kRawTick : 560 / kRawTick);
+    }
+    rawbuf.push_back(560 / kRawTick);
+    return rawbuf;
+}
+
+// An unknown remote's frame, as in the learning tests
+static std::vector<uint16_t> rawFrame() {
+    return {7500, 1500, 750, 250, 750, 250, 250, 250, 750, 250};
+}
+
+// What the sniffer should report for a rawbuf
+static uint32_t fingerprintOf(std::vector<uint16_t> rawbuf) {
+    decode_results results = {};
+    results.decode_type = UNKNOWN;
+    results.rawbuf = rawbuf.data();
+    results.rawlen = rawbuf.size();
+    RawTimingPool pool(1);
+    IRLibProtocolDecoder decoder(&pool);
+    DecodedSignal signal = decoder.decode(&results);
+    return signal_fingerprint::of(signal);
+}
+
+static SniffedFrame frameAt(uint32_t fingerprint, uint32_t atMs, bool repeat = false) {
+    SniffedFrame frame = {"NEC", 0x20DF10EF, 32, repeat, fingerprint, atMs};
+    return frame;
+}
+
+// Unity requires these functions
+void setUp(void) {
+    mockMillis() = 1000;
+    fakeNow = 0;
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+// ============== Sniffer Tests ==============
+
+void test_frames_are_decoded_into_the_ring_and_the_capture_resumed() {
+    MockSignalCapture capture(true);
+    RawTimingPool pool(1);
+    IRLibProtocolDecoder decoder(&pool);
+    SignalSniffer sniffer(&capture, &decoder, fakeClock);
+    
+    TEST_ASSERT_FALSE(sniffer.poll());
+    capture.arrive(necFrame(0xEF10DF20));
+    capture.arrive(rawFrame());
+    TEST_ASSERT_TRUE(sniffer.poll());
+    mockMillis() += 120;
+    TEST_ASSERT_TRUE(sniffer.poll());
+    TEST_ASSERT_FALSE(sniffer.poll());
+    TEST_ASSERT_TRUE(capture.frames.empty());
+    TEST_ASSERT_EQUAL(0, pool.getInUse());  // RAW blocks are not kept
+    
+    SniffedFrame frame;
+    TEST_ASSERT_TRUE(sniffer.pop(&frame));
+    TEST_ASSERT_EQUAL_STRING("RAW", frame.protocol);
+    TEST_ASSERT_TRUE(frame.value == 0xEF10DF20);
+    TEST_ASSERT_EQUAL(32, frame.bits);
+    TEST_ASSERT_EQUAL_HEX32(signal_fingerprint::ofInferred(BitCoding::PULSE_DISTANCE, 0xEF10DF20, 32),
+                            frame.fingerprint);
+    TEST_ASSERT_EQUAL(1000, frame.atMs);
+    
+    TEST_ASSERT_TRUE(sniffer.pop(&frame));
+    TEST_ASSERT_EQUAL_STRING("RAW", frame.protocol);
+    TEST_ASSERT_EQUAL_HEX32(fingerprintOf(rawFrame()), frame.fingerprint);
+    TEST_ASSERT_EQUAL(1120, frame.atMs);
+    TEST_ASSERT_FALSE(sniffer.pop(&frame));
+    
+    SnifferStats stats = sniffer.getStats();
+    TEST_ASSERT_EQUAL(2, stats.frames);
+    TEST_ASSERT_EQUAL(0, stats.overruns);
+    TEST_ASSERT_EQUAL(2, stats.maxDepth);
+    TEST_ASSERT_EQUAL(25, stats.meanFrameUs);  // One clock step from start to queued
+}
+
+void test_full_ring_counts_overruns_and_keeps_the_oldest() {
+    MockSignalCapture capture(false);
+    IRLibProtocolDecoder decoder;
+    SignalSniffer sniffer(&capture, &decoder, fakeClock);
+    
+    const uint32_t kFrames = SignalSniffer::kCapacity + 5;
+    for (uint32_t i = 0; i < kFrames; i++) {
+        capture.arrive(necFrame(i));
+        TEST_ASSERT_TRUE(sniffer.poll());
+    }
+    SnifferStats stats = sniffer.getStats();
+    TEST_ASSERT_EQUAL(SignalSniffer::kCapacity, stats.frames);
+    TEST_ASSERT_EQUAL(5, stats.overruns);
+    TEST_ASSERT_EQUAL(SignalSniffer::kCapacity, stats.depth);
+    
+    // The first frames were kept; popping one makes room again
+    SniffedFrame frame;
+    TEST_ASSERT_TRUE(sniffer.pop(&frame));
+    TEST_ASSERT_EQUAL_HEX32(fingerprintOf(necFrame(0)), frame.fingerprint);
+    capture.arrive(necFrame(1));
+    TEST_ASSERT_TRUE(sniffer.poll());
+    TEST_ASSERT_EQUAL(SignalSniffer::kCapacity + 1, sniffer.getStats().frames);
+}
+
+void test_paused_sniffer_leaves_the_capture_to_learning() {
+    MockSignalCapture capture(true);
+    IRLibProtocolDecoder decoder;
+    SignalSniffer sniffer(&capture, &decoder, fakeClock);
+    
+    sniffer.pause();
+    TEST_ASSERT_TRUE(sniffer.isPaused());
+    capture.arrive(rawFrame());
+    TEST_ASSERT_FALSE(sniffer.poll());
+    TEST_ASSERT_EQUAL(0, capture.decodeCalls);
+    TEST_ASSERT_EQUAL(1, capture.frames.size());
+    
+    sniffer.resume();
+    TEST_ASSERT_TRUE(sniffer.poll());
+    TEST_ASSERT_EQUAL(1, capture.decodeCalls);
+}
+
+void test_poll_interval_follows_a_partial_frame() {
+    MockSignalCapture capture(true);
+    IRLibProtocolDecoder decoder;
+    SignalSniffer sniffer(&capture, &decoder, fakeClock);
+    TEST_ASSERT_EQUAL(SignalSniffer::kPollIntervalMs, sniffer.msUntilDue());
+    capture.pollMs = 1;
+    TEST_ASSERT_EQUAL(1, sniffer.msUntilDue());
+}
+
+void test_threads_lose_nothing_but_overruns() {
+    MockSignalCapture capture(false);
+    IRLibProtocolDecoder decoder;
+    SignalSniffer sniffer(&capture, &decoder, hostClock);
+    const uint32_t kFrames = 5000;
+    for (uint32_t i = 1; i <= kFrames; i++) {
+        capture.frames.push_back(necFrame(i));  // All-zero payloads do not infer as such
+    }
+    
+    // The capture is the producer's alone once it starts. Frames come
+    // faster than any remote sends them, and the consumer mostly keeps up.
+    std::thread producer([&]() {
+        while (sniffer.poll()) {
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+    });
+    std::vector<uint64_t> values;
+    SniffedFrame frame;
+    while (values.size() + sniffer.getStats().overruns < kFrames) {
+        if (sniffer.pop(&frame)) {
+            values.push_back(frame.value);
+        }
+    }
+    producer.join();
+    
+    // Delivered in order, each once
+    SnifferStats stats = sniffer.getStats();
+    TEST_ASSERT_FALSE(sniffer.pop(&frame));
+    TEST_ASSERT_EQUAL(kFrames, values.size() + stats.overruns);
+    TEST_ASSERT_EQUAL(stats.frames, values.size());
+    for (size_t i = 1; i < values.size(); i++) {
+        TEST_ASSERT_TRUE_MESSAGE(values[i] > values[i - 1], "Frame out of order or twice");
+    }
+    printf("Sniffer: %u frames, %u overruns, frame cost mean %u us max %u us (host)\n",
+           (unsigned)stats.frames, (unsigned)stats.overruns, (unsigned)stats.meanFrameUs,
+           (unsigned)stats.maxFrameUs);
+}
+
+void test_cost_per_frame() {
+    MockSignalCapture capture(false);
+    RawTimingPool pool(1);
+    IRLibProtocolDecoder decoder(&pool);
+    SignalSniffer sniffer(&capture, &decoder, hostClock);
+    
+    // Inferable 32-bit frames and opaque RAW ones, alternately
+    const int kFrames = 2000;
+    std::vector<uint16_t> inferable = necFrame(0xEF10DF20);
+    std::vector<uint16_t> opaque = rawFrame();
+    SniffedFrame frame;
+    double totalUs = 0;
+    for (int i = 0; i < kFrames; i++) {
+        capture.frames.push_back(i % 2 ? inferable : opaque);
+        auto start = std::chrono::steady_clock::now();
+        TEST_ASSERT_TRUE(sniffer.poll());
+        totalUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        TEST_ASSERT_TRUE(sniffer.pop(&frame));
+    }
+    SnifferStats stats = sniffer.getStats();
+    printf("Sniffed frame: mean %.2f us, max %u us (host)\n", totalUs / kFrames, (unsigned)stats.maxFrameUs);
+    TEST_ASSERT_EQUAL(kFrames, stats.frames);
+    TEST_ASSERT_EQUAL(0, stats.overruns);
+    TEST_ASSERT_LESS_THAN(1000, totalUs / kFrames);
+}
+
+// ============== Batch Tests ==============
+
+void test_held_button_is_one_event() {
+    SniffBatch batch;
+    TEST_ASSERT_TRUE(batch.add(frameAt(0xAAAA, 1000), 7));
+    TEST_ASSERT_TRUE(batch.add(frameAt(0xFFFF, 1108, true), 0));   // NEC repeat code
+    TEST_ASSERT_TRUE(batch.add(frameAt(0xAAAA, 1216), 7));         // Protocols that resend the frame
+    TEST_ASSERT_EQUAL(1, batch.size());
+    TEST_ASSERT_EQUAL(3, batch[0].frames);
+    TEST_ASSERT_EQUAL(1216, batch[0].lastMs);
+    TEST_ASSERT_EQUAL(7, batch[0].learnedId);
+    
+    // Pressed again after a pause, then another button
+    TEST_ASSERT_TRUE(batch.add(frameAt(0xAAAA, 2000), 7));
+    TEST_ASSERT_TRUE(batch.add(frameAt(0xBBBB, 2100), 0));
+    TEST_ASSERT_EQUAL(3, batch.size());
+    TEST_ASSERT_EQUAL(1, batch[1].frames);
+    TEST_ASSERT_EQUAL(0, batch[2].learnedId);
+}
+
+void test_hold_across_an_upload_is_not_reported_twice() {
+    SniffBatch batch;
+    batch.add(frameAt(0xAAAA, 1000), 7);
+    batch.clear();
+    TEST_ASSERT_TRUE(batch.add(frameAt(0xAAAA, 1100), 7));
+    TEST_ASSERT_TRUE(batch.add(frameAt(0xFFFF, 1200, true), 0));
+    TEST_ASSERT_EQUAL(0, batch.size());
+    
+    // A repeat with nothing before it is dropped too
+    SniffBatch fresh;
+    TEST_ASSERT_TRUE(fresh.add(frameAt(0xFFFF, 1000, true), 0));
+    TEST_ASSERT_EQUAL(0, fresh.size());
+}
+
+void test_batch_is_due_when_full_or_old() {
+    SniffBatch batch(30000);
+    TEST_ASSERT_FALSE(batch.isDue(1000));
+    batch.add(frameAt(1, 1000), 0);
+    TEST_ASSERT_FALSE(batch.isDue(30999));
+    TEST_ASSERT_TRUE(batch.isDue(31000));
+    
+    for (uint32_t i = 2; i <= SniffBatch::kCapacity; i++) {
+        TEST_ASSERT_TRUE(batch.add(frameAt(i, 1000 + i * 1000), 0));
+    }
+    TEST_ASSERT_TRUE(batch.isFull());
+    TEST_ASSERT_TRUE(batch.isDue(20000));
+    TEST_ASSERT_FALSE(batch.add(frameAt(99, 40000), 0));
+    TEST_ASSERT_TRUE(batch.add(frameAt(SniffBatch::kCapacity, 17100), 0));  // Still folds into the last press
+    TEST_ASSERT_EQUAL(2, batch[SniffBatch::kCapacity - 1].frames);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_frames_are_decoded_into_the_ring_and_the_capture_resumed);
+    RUN_TEST(test_full_ring_counts_overruns_and_keeps_the_oldest);
+    RUN_TEST(test_paused_sniffer_leaves_the_capture_to_learning);
+    RUN_TEST(test_poll_interval_follows_a_partial_frame);
+    RUN_TEST(test_threads_lose_nothing_but_overruns);
+    RUN_TEST(test_cost_per_frame);
+    RUN_TEST(test_held_button_is_one_event);
+    RUN_TEST(test_hold_across_an_upload_is_not_reported_twice);
+    RUN_TEST(test_batch_is_due_when_full_or_old);
+    
+    UNITY_END();
+    
+    return 0;
+}
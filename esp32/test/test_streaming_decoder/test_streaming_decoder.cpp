@@ -0,0 +1,286 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "receiver/StreamingDecoder.h"
+#include "receiver/EdgeSignalCapture.h"
+#include "receiver/FrameDecoder.h"
+#include "transmitter/IRLibProtocolEncoders.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+static std::vector<uint16_t> renderFrame(IRProtocol protocol, uint64_t value, uint16_t bits) {
+    IRLibProtocolEncoders encoder;
+    uint16_t timings[256];
+    uint16_t length = encoder.encodeValue(protocol, value, bits, TimingSpan(timings, 256));
+    return std::vector<uint16_t>(timings, timings + length);
+}
+
+// Push durations until the decoder reports; returns how many it took
+static size_t pushUntilResult(StreamingDecoder& decoder, const std::vector<uint16_t>& timings) {
+    for (size_t i = 0; i < timings.size(); i++) {
+        if (decoder.push(timings[i])) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+static uint32_t fakeNow = 0;
+static uint32_t fakeClock() {
+    return fakeNow;
+}
+
+// Replay a frame through the edge interrupt, starting at fakeNow
+static void playEdges(EdgeSignalCapture& capture, const std::vector<uint16_t>& timings) {
+    capture.onEdge(fakeNow);
+    for (size_t i = 0; i < timings.size(); i++) {
+        fakeNow += timings[i];
+        capture.onEdge(fakeNow);
+    }
+}
+
+// ============== Streaming Decoder Tests ==============
+
+void test_nec_completes_at_its_footer_mark() {
+    StreamingDecoder decoder;
+    std::vector<uint16_t> frame = renderFrame(IRProtocol::NEC, 0x20DF10EF, 32);
+    
+    TEST_ASSERT_EQUAL(frame.size(), pushUntilResult(decoder, frame));
+    TEST_ASSERT_EQUAL(IRProtocol::NEC, decoder.getResult().protocol);
+    TEST_ASSERT_EQUAL_HEX64(0x20DF10EF, decoder.getResult().value);
+    TEST_ASSERT_EQUAL(32, decoder.getResult().bits);
+    TEST_ASSERT_FALSE(decoder.getResult().repeat);
+}
+
+void test_header_mismatch_rejects_at_first_mark() {
+    StreamingDecoder decoder;
+    TEST_ASSERT_FALSE(decoder.push(9000));
+    uint8_t afterNecHeader = decoder.getLiveCount();
+    TEST_ASSERT_TRUE(afterNecHeader > 0 && afterNecHeader <= 3);  // NEC, JVC, LG
+    
+    decoder.reset();
+    TEST_ASSERT_FALSE(decoder.push(20000));
+    TEST_ASSERT_EQUAL(0, decoder.getLiveCount());
+    TEST_ASSERT_FALSE(decoder.idle(100000));
+}
+
+void test_every_protocol_matches_frame_decoder() {
+    struct Case {
+        IRProtocol protocol;
+        uint64_t value;
+        uint16_t bits;
+    } cases[] = {
+        {IRProtocol::NEC, 0x20DF10EF, 32},
+        {IRProtocol::SAMSUNG, 0xE0E040BF, 32},
+        {IRProtocol::SONY, 0xA90, 12},
+        {IRProtocol::SONY, 0x5A5A, 15},
+        {IRProtocol::SONY, 0xABCDE, 20},
+        {IRProtocol::RC5, 0x80C, 12},
+        {IRProtocol::RC5, 0x0A5, 12},
+        {IRProtocol::RC6, 0x0C, 20},
+        {IRProtocol::RC6, 0x1F0F0, 20},
+        {IRProtocol::PANASONIC, 0x40040100BCBDULL, 48},
+        {IRProtocol::JVC, 0xC5E8, 16},
+        {IRProtocol::LG, 0x8800347, 28},
+        {IRProtocol::SHARP, 0x4321, 15},
+    };
+    
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        std::vector<uint16_t> frame = renderFrame(cases[c].protocol, cases[c].value, cases[c].bits);
+        uint64_t expectedValue = 0;
+        uint16_t expectedBits = 0;
+        IRProtocol expected = frame_decoder::identifyFrame(frame.data(), frame.size(), &expectedValue, &expectedBits);
+        TEST_ASSERT_EQUAL(cases[c].protocol, expected);
+        
+        StreamingDecoder decoder;
+        if (!pushUntilResult(decoder, frame)) {
+            TEST_ASSERT_TRUE(decoder.idle(20000));
+        }
+        char message[48];
+        snprintf(message, sizeof(message), "case %u", (unsigned)c);
+        TEST_ASSERT_EQUAL_MESSAGE(expected, decoder.getResult().protocol, message);
+        TEST_ASSERT_TRUE_MESSAGE(expectedValue == decoder.getResult().value, message);
+        TEST_ASSERT_EQUAL_MESSAGE(expectedBits, decoder.getResult().bits, message);
+    }
+}
+
+void test_sony_completes_after_a_short_silence() {
+    StreamingDecoder decoder;
+    std::vector<uint16_t> frame = renderFrame(IRProtocol::SONY, 0xA90, 12);
+    
+    // 12, 15 or 20 bits: the frame could go on until the line stays quiet
+    TEST_ASSERT_EQUAL(0, pushUntilResult(decoder, frame));
+    TEST_ASSERT_FALSE(decoder.idle(600));
+    TEST_ASSERT_TRUE(decoder.idle(1000));
+    TEST_ASSERT_EQUAL(IRProtocol::SONY, decoder.getResult().protocol);
+    TEST_ASSERT_EQUAL(12, decoder.getResult().bits);
+}
+
+void test_jvc_is_not_taken_for_a_short_nec_frame() {
+    StreamingDecoder decoder;
+    std::vector<uint16_t> frame = renderFrame(IRProtocol::JVC, 0xC5E8, 16);
+    
+    // NEC and LG share the header and are still live at JVC's footer
+    TEST_ASSERT_EQUAL(0, pushUntilResult(decoder, frame));
+    TEST_ASSERT_TRUE(decoder.idle(5000));
+    TEST_ASSERT_EQUAL(IRProtocol::JVC, decoder.getResult().protocol);
+}
+
+void test_nec_repeat_code() {
+    StreamingDecoder decoder;
+    std::vector<uint16_t> repeat = {9000, 2250, 560};
+    
+    TEST_ASSERT_EQUAL(3, pushUntilResult(decoder, repeat));
+    TEST_ASSERT_EQUAL(IRProtocol::NEC, decoder.getResult().protocol);
+    TEST_ASSERT_TRUE(decoder.getResult().repeat);
+    TEST_ASSERT_EQUAL(0, decoder.getResult().bits);
+}
+
+void test_corrupted_bit_rejects_every_protocol() {
+    StreamingDecoder decoder;
+    std::vector<uint16_t> frame = renderFrame(IRProtocol::NEC, 0x20DF10EF, 32);
+    frame[10] = 3000;
+    
+    TEST_ASSERT_EQUAL(0, pushUntilResult(decoder, frame));
+    TEST_ASSERT_EQUAL(0, decoder.getLiveCount());
+    TEST_ASSERT_FALSE(decoder.idle(20000));
+    TEST_ASSERT_FALSE(decoder.hasResult());
+}
+
+void test_push_cost_per_edge() {
+    std::vector<uint16_t> frame = renderFrame(IRProtocol::NEC, 0x20DF10EF, 32);
+    const int iterations = 20000;
+    StreamingDecoder decoder;
+    uint64_t checksum = 0;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        decoder.reset();
+        pushUntilResult(decoder, frame);
+        checksum += decoder.getResult().value;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    
+    char message[96];
+    snprintf(message, sizeof(message), "[Bench] streaming decode: %.1f ns per edge, all protocols live",
+             (double)elapsed.count() / iterations / frame.size());
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_HEX64(0x20DF10EFULL * iterations, checksum);
+}
+
+// ============== Edge Capture Tests ==============
+
+void test_edge_capture_holds_nec_without_the_idle_timeout() {
+    EdgeSignalCapture capture(fakeClock);
+    capture.enable();
+    
+    std::vector<uint16_t> frame = renderFrame(IRProtocol::NEC, 0x20DF10EF, 32);
+    playEdges(capture, frame);
+    
+    // Polled right at the last edge: no gap needed
+    decode_results results;
+    TEST_ASSERT_TRUE(capture.decode(&results));
+    TEST_ASSERT_EQUAL(0, capture.getLastLatencyUs());
+    TEST_ASSERT_EQUAL(NEC, results.decode_type);
+    TEST_ASSERT_EQUAL_HEX64(0x20DF10EF, results.value);
+    TEST_ASSERT_EQUAL(32, results.bits);
+    TEST_ASSERT_EQUAL(frame.size() + 1, results.rawlen);
+    TEST_ASSERT_EQUAL(frame[0] / kRawTick, results.rawbuf[1]);
+}
+
+void test_edge_capture_ends_unknown_frames_on_idle() {
+    EdgeSignalCapture capture(fakeClock);
+    capture.enable();
+    
+    std::vector<uint16_t> frame = {3000, 1000, 500, 500, 500, 1500, 500, 500, 500};
+    playEdges(capture, frame);
+    TEST_ASSERT_FALSE(capture.hasSignal());
+    
+    fakeNow += EdgeSignalCapture::kDefaultIdleThresholdUs;
+    decode_results results;
+    TEST_ASSERT_TRUE(capture.decode(&results));
+    TEST_ASSERT_EQUAL(UNKNOWN, results.decode_type);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(frame.data(), capture.getTimings(), frame.size());
+}
+
+void test_edge_capture_flags_repeat_codes_and_drops_noise() {
+    EdgeSignalCapture capture(fakeClock);
+    capture.enable();
+    
+    playEdges(capture, {120, 300, 90});
+    fakeNow += 20000;
+    TEST_ASSERT_FALSE(capture.hasSignal());
+    TEST_ASSERT_EQUAL(1, capture.getNoiseCount());
+    
+    playEdges(capture, {9000, 2250, 560});
+    decode_results results;
+    TEST_ASSERT_TRUE(capture.decode(&results));
+    TEST_ASSERT_TRUE(results.repeat);
+    TEST_ASSERT_EQUAL(NEC, results.decode_type);
+}
+
+void test_edge_capture_ignores_edges_while_disabled() {
+    EdgeSignalCapture capture(fakeClock);
+    playEdges(capture, renderFrame(IRProtocol::NEC, 0x20DF10EF, 32));
+    capture.enable();
+    TEST_ASSERT_FALSE(capture.hasSignal());
+    TEST_ASSERT_EQUAL(0, capture.getFrameCount());
+}
+
+static int readyCount = 0;
+static void countReady(void*) {
+    readyCount++;
+}
+
+void test_edge_capture_hook_fires_once_per_burst() {
+    EdgeSignalCapture capture(fakeClock);
+    TEST_ASSERT_TRUE(capture.setReadyHook(countReady, nullptr));
+    capture.enable();
+    readyCount = 0;
+
+    fakeNow += 100000;
+    playEdges(capture, renderFrame(IRProtocol::SONY, 0xA90, 12));
+    TEST_ASSERT_EQUAL(1, readyCount);
+
+    // Mid-frame until silence ends it: poll soon, not on the next edge
+    TEST_ASSERT_FALSE(capture.hasSignal());
+    TEST_ASSERT_EQUAL(1, capture.pollIntervalMs());
+    fakeNow += 1000;
+    TEST_ASSERT_TRUE(capture.hasSignal());
+    TEST_ASSERT_EQUAL(0, capture.pollIntervalMs());
+
+    capture.resume();
+    fakeNow += 20000;
+    playEdges(capture, renderFrame(IRProtocol::SONY, 0xA90, 12));
+    TEST_ASSERT_EQUAL(2, readyCount);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    
+    RUN_TEST(test_nec_completes_at_its_footer_mark);
+    RUN_TEST(test_header_mismatch_rejects_at_first_mark);
+    RUN_TEST(test_every_protocol_matches_frame_decoder);
+    RUN_TEST(test_sony_completes_after_a_short_silence);
+    RUN_TEST(test_jvc_is_not_taken_for_a_short_nec_frame);
+    RUN_TEST(test_nec_repeat_code);
+    RUN_TEST(test_corrupted_bit_rejects_every_protocol);
+    RUN_TEST(test_push_cost_per_edge);
+    RUN_TEST(test_edge_capture_holds_nec_without_the_idle_timeout);
+    RUN_TEST(test_edge_capture_ends_unknown_frames_on_idle);
+    RUN_TEST(test_edge_capture_flags_repeat_codes_and_drops_noise);
+    RUN_TEST(test_edge_capture_ignores_edges_while_disabled);
+    RUN_TEST(test_edge_capture_hook_fires_once_per_burst);
+    
+    UNITY_END();
+    
+    return 0;
+}
@@ -0,0 +1,361 @@
+#include <unity.h>
+#include <vector>
+#include "utils/CommandScheduler.h"
+#include "utils/TimerWheel.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+static std::vector<uint8_t> firedTimers;
+
+static void recordTimer(uint8_t timer) {
+    firedTimers.push_back(timer);
+}
+
+// Advance in 100ms steps (the main loop calls far more often)
+static void runUntil(TimerWheel& wheel, uint32_t fromMs, uint32_t toMs) {
+    for (uint32_t t = fromMs; t != toMs; t += 100) {
+        wheel.advance(t, recordTimer);
+    }
+    wheel.advance(toMs, recordTimer);
+}
+
+// ============== Timer Wheel ==============
+
+void test_timer_fires_on_due_tick_never_early() {
+    firedTimers.clear();
+    TimerWheel wheel(1000);
+    wheel.reset(0);
+    
+    // Scheduled mid-tick: due at 3400ms, so the 4000ms tick fires it
+    uint8_t timer = wheel.schedule(3000, 400);
+    runUntil(wheel, 400, 3900);
+    TEST_ASSERT_EQUAL(0, firedTimers.size());
+    
+    runUntil(wheel, 3900, 4000);
+    TEST_ASSERT_EQUAL(1, firedTimers.size());
+    TEST_ASSERT_EQUAL(timer, firedTimers[0]);
+    TEST_ASSERT_EQUAL(0, wheel.getArmedCount());
+}
+
+void test_timer_beyond_one_turn_waits_rounds() {
+    firedTimers.clear();
+    TimerWheel wheel(1000);
+    wheel.reset(0);
+    
+    // 30 minutes: the bucket comes round 28 times before it is due
+    wheel.schedule(1800000, 0);
+    wheel.schedule(5000, 0);
+    runUntil(wheel, 0, 1799000);
+    TEST_ASSERT_EQUAL(1, firedTimers.size());
+    
+    runUntil(wheel, 1799000, 1800000);
+    TEST_ASSERT_EQUAL(2, firedTimers.size());
+}
+
+void test_cancel_and_pool_limit() {
+    firedTimers.clear();
+    TimerWheel wheel(1000);
+    wheel.reset(0);
+    
+    uint8_t timers[TimerWheel::kMaxTimers];
+    for (uint8_t i = 0; i < TimerWheel::kMaxTimers; i++) {
+        timers[i] = wheel.schedule(2000, 0);  // All in one bucket
+        TEST_ASSERT_TRUE(timers[i] != TimerWheel::kNoTimer);
+    }
+    TEST_ASSERT_EQUAL(TimerWheel::kNoTimer, wheel.schedule(2000, 0));
+    
+    TEST_ASSERT_TRUE(wheel.cancel(timers[5]));
+    TEST_ASSERT_FALSE(wheel.cancel(timers[5]));
+    runUntil(wheel, 0, 2000);
+    TEST_ASSERT_EQUAL(TimerWheel::kMaxTimers - 1, firedTimers.size());
+}
+
+void test_catch_up_is_spread_over_calls() {
+    firedTimers.clear();
+    TimerWheel wheel(1000);
+    wheel.reset(0);
+    wheel.schedule(10000, 0);
+    
+    // loop() stalled for 20s: each call only runs a few ticks
+    wheel.advance(20000, recordTimer);
+    TEST_ASSERT_EQUAL(0, firedTimers.size());
+    wheel.advance(20000, recordTimer);
+    TEST_ASSERT_EQUAL(1, firedTimers.size());
+}
+
+void test_wheel_survives_millis_wrap() {
+    firedTimers.clear();
+    TimerWheel wheel(1000);
+    wheel.reset(0xFFFFF000);
+    wheel.schedule(8000, 0xFFFFF000);
+    
+    runUntil(wheel, 0xFFFFF000, 0xFFFFF000 + 7900);
+    TEST_ASSERT_EQUAL(0, firedTimers.size());
+    runUntil(wheel, 0xFFFFF000 + 7900, 0xFFFFF000 + 8000);
+    TEST_ASSERT_EQUAL(1, firedTimers.size());
+}
+
+// ============== Scheduler ==============
+
+class FakeTimerStore : public ITimerStore {
+public:
+    std::vector<ScheduledCommand> saved;
+    int saveCount = 0;
+    uint32_t firedThrough = 0;
+    int firedSaveCount = 0;
+    
+    uint8_t load(ScheduledCommand* commands, uint8_t capacity) override {
+        uint8_t count = 0;
+        for (size_t i = 0; i < saved.size() && count < capacity; i++) {
+            commands[count++] = saved[i];
+        }
+        return count;
+    }
+    
+    bool save(const ScheduledCommand* commands, uint8_t count) override {
+        saved.assign(commands, commands + count);
+        saveCount++;
+        return true;
+    }
+    
+    uint32_t loadFiredThrough() override {
+        return firedThrough;
+    }
+    
+    bool saveFiredThrough(uint32_t epochSec) override {
+        firedThrough = epochSec;
+        firedSaveCount++;
+        return true;
+    }
+};
+
+static const uint32_t kEpoch = 1760000000;
+static std::vector<uint32_t> firedIds;
+
+static void recordCommand(const ScheduledCommand& command) {
+    firedIds.push_back(command.id);
+}
+
+static ScheduledCommand makeCommand(uint32_t id, uint32_t dueEpoch = 0) {
+    ScheduledCommand command;
+    command.id = id;
+    command.dueEpoch = dueEpoch;
+    command.protocol = IRProtocol::NEC;
+    command.value = 0x20DF10EF;
+    command.bits = 32;
+    command.output = 0;
+    command.carrierKHz = 0;
+    command.dutyPercent = 0;
+    return command;
+}
+
+void test_scheduler_waits_for_wall_clock() {
+    FakeTimerStore store;
+    CommandScheduler scheduler(&store);
+    
+    scheduler.update(0, 0, recordCommand);
+    TEST_ASSERT_FALSE(scheduler.isRestored());
+    TEST_ASSERT_FALSE(scheduler.scheduleIn(makeCommand(1), 60, 0, 0));
+    
+    scheduler.update(100, kEpoch, recordCommand);
+    TEST_ASSERT_TRUE(scheduler.isRestored());
+    TEST_ASSERT_TRUE(scheduler.scheduleIn(makeCommand(1), 60, 100, kEpoch));
+}
+
+void test_relative_and_absolute_fire_and_persist() {
+    firedIds.clear();
+    FakeTimerStore store;
+    CommandScheduler scheduler(&store);
+    scheduler.update(0, kEpoch, recordCommand);
+    
+    TEST_ASSERT_TRUE(scheduler.scheduleIn(makeCommand(7), 30, 0, kEpoch));
+    TEST_ASSERT_TRUE(scheduler.scheduleAt(makeCommand(8, kEpoch + 10), 0, kEpoch));
+    scheduler.update(0, kEpoch, recordCommand);
+    TEST_ASSERT_EQUAL(2, store.saved.size());
+    TEST_ASSERT_EQUAL(kEpoch + 30, store.saved[0].dueEpoch);
+    
+    for (uint32_t ms = 0; ms <= 32000; ms += 500) {
+        scheduler.update(ms, kEpoch + ms / 1000, recordCommand);
+    }
+    TEST_ASSERT_EQUAL(2, firedIds.size());
+    TEST_ASSERT_EQUAL(8, firedIds[0]);
+    TEST_ASSERT_EQUAL(7, firedIds[1]);
+    
+    // Firing moves the mark; the table is not rewritten
+    TEST_ASSERT_EQUAL(1, store.saveCount);
+    TEST_ASSERT_EQUAL(kEpoch + 30, store.firedThrough);
+    TEST_ASSERT_FALSE(scheduler.isDirty());
+}
+
+void test_same_id_replaces_and_cancel_removes() {
+    firedIds.clear();
+    FakeTimerStore store;
+    CommandScheduler scheduler(&store);
+    scheduler.update(0, kEpoch, recordCommand);
+    
+    scheduler.scheduleIn(makeCommand(3), 5, 0, kEpoch);
+    scheduler.scheduleIn(makeCommand(3), 20, 0, kEpoch);
+    TEST_ASSERT_EQUAL(1, scheduler.getCount());
+    scheduler.update(0, kEpoch, recordCommand);
+    TEST_ASSERT_EQUAL(1, store.saved.size());
+    TEST_ASSERT_EQUAL(kEpoch + 20, store.saved[0].dueEpoch);
+    
+    TEST_ASSERT_TRUE(scheduler.cancel(3));
+    TEST_ASSERT_FALSE(scheduler.cancel(3));
+    scheduler.update(CommandScheduler::kSaveIntervalMs, kEpoch + 2, recordCommand);
+    TEST_ASSERT_EQUAL(0, store.saved.size());
+    
+    TEST_ASSERT_FALSE(scheduler.scheduleIn(makeCommand(4), CommandScheduler::kMaxDelaySec + 1, 0, kEpoch));
+}
+
+void test_timers_restored_after_reboot() {
+    firedIds.clear();
+    FakeTimerStore store;
+    {
+        CommandScheduler before(&store);
+        before.update(0, kEpoch, recordCommand);
+        before.scheduleIn(makeCommand(1), 1800, 0, kEpoch);  // Off in 30 min
+        before.scheduleAt(makeCommand(2, kEpoch + 60), 0, kEpoch);
+        before.update(0, kEpoch, recordCommand);
+    }
+    
+    // Reboot two minutes later: millis() restarts, the wall clock does
+    // not. Timer 2 is overdue but within kMaxLateSec, so it fires at once.
+    const uint32_t rebootEpoch = kEpoch + 120;
+    CommandScheduler after(&store);
+    after.update(0, rebootEpoch, recordCommand);
+    TEST_ASSERT_EQUAL(2, after.getCount());
+    
+    after.update(1000, rebootEpoch + 1, recordCommand);
+    TEST_ASSERT_EQUAL(1, firedIds.size());
+    TEST_ASSERT_EQUAL(2, firedIds[0]);
+    
+    // Timer 1 keeps its wall-clock due time: 1680s after the reboot
+    for (uint32_t ms = 1000; ms < 1679000; ms += 1000) {
+        after.update(ms, rebootEpoch + ms / 1000, recordCommand);
+    }
+    TEST_ASSERT_EQUAL(1, firedIds.size());
+    after.update(1680000, rebootEpoch + 1680, recordCommand);
+    TEST_ASSERT_EQUAL(2, firedIds.size());
+    TEST_ASSERT_EQUAL(1, firedIds[1]);
+}
+
+void test_stale_timers_dropped_on_restore() {
+    firedIds.clear();
+    FakeTimerStore store;
+    store.saved.push_back(makeCommand(1, kEpoch - CommandScheduler::kMaxLateSec - 1));
+    store.saved.push_back(makeCommand(2, kEpoch - 10));
+    store.saved.push_back(makeCommand(3, kEpoch + 1200));
+    
+    CommandScheduler scheduler(&store);
+    scheduler.update(0, kEpoch, recordCommand);
+    TEST_ASSERT_EQUAL(2, scheduler.getCount());
+    TEST_ASSERT_EQUAL(2, store.saved.size());
+    
+    scheduler.update(1000, kEpoch + 1, recordCommand);
+    TEST_ASSERT_EQUAL(1, firedIds.size());
+    TEST_ASSERT_EQUAL(2, firedIds[0]);
+    
+    for (uint32_t ms = 1000; ms <= 1200000; ms += 1000) {
+        scheduler.update(ms, kEpoch + ms / 1000, recordCommand);
+    }
+    TEST_ASSERT_EQUAL(2, firedIds.size());
+    TEST_ASSERT_EQUAL(3, firedIds[1]);
+}
+
+void test_changes_written_on_rate_limit() {
+    FakeTimerStore store;
+    CommandScheduler scheduler(&store);
+    scheduler.update(0, kEpoch, recordCommand);
+    
+    // Scheduling and cancelling never write themselves
+    scheduler.scheduleIn(makeCommand(1), 600, 0, kEpoch);
+    scheduler.scheduleIn(makeCommand(2), 600, 0, kEpoch);
+    scheduler.scheduleIn(makeCommand(3), 600, 0, kEpoch);
+    scheduler.cancel(2);
+    TEST_ASSERT_EQUAL(0, store.saveCount);
+    TEST_ASSERT_TRUE(scheduler.isDirty());
+    
+    // A burst costs one write
+    scheduler.update(10, kEpoch, recordCommand);
+    TEST_ASSERT_EQUAL(1, store.saveCount);
+    TEST_ASSERT_EQUAL(2, store.saved.size());
+    TEST_ASSERT_FALSE(scheduler.isDirty());
+    
+    // The next change waits for kSaveIntervalMs after that write
+    scheduler.scheduleIn(makeCommand(4), 600, 20, kEpoch);
+    for (uint32_t ms = 20; ms < 10 + CommandScheduler::kSaveIntervalMs; ms += 10) {
+        scheduler.update(ms, kEpoch + ms / 1000, recordCommand);
+    }
+    TEST_ASSERT_EQUAL(1, store.saveCount);
+    scheduler.update(10 + CommandScheduler::kSaveIntervalMs, kEpoch + 2, recordCommand);
+    TEST_ASSERT_EQUAL(2, store.saveCount);
+    TEST_ASSERT_EQUAL(3, store.saved.size());
+}
+
+void test_fired_timer_not_refired_after_reboot() {
+    firedIds.clear();
+    FakeTimerStore store;
+    {
+        CommandScheduler before(&store);
+        before.update(0, kEpoch, recordCommand);
+        before.scheduleAt(makeCommand(1, kEpoch + 5), 0, kEpoch);
+        before.scheduleAt(makeCommand(2, kEpoch + 600), 0, kEpoch);
+        for (uint32_t ms = 0; ms <= 8000; ms += 500) {
+            before.update(ms, kEpoch + ms / 1000, recordCommand);
+        }
+        TEST_ASSERT_EQUAL(1, firedIds.size());
+        TEST_ASSERT_EQUAL(2, store.saved.size());
+        TEST_ASSERT_EQUAL(1, store.firedSaveCount);
+    }
+    
+    // Timer 1 is still in the stored table and within kMaxLateSec, but
+    // the mark says it already went off
+    CommandScheduler after(&store);
+    after.update(0, kEpoch + 60, recordCommand);
+    TEST_ASSERT_EQUAL(1, after.getCount());
+    after.update(1000, kEpoch + 61, recordCommand);
+    TEST_ASSERT_EQUAL(1, firedIds.size());
+    TEST_ASSERT_EQUAL(1, store.saved.size());
+    TEST_ASSERT_EQUAL(2, store.saved[0].id);
+    
+    // A time already passed still fires; the table written with it gone
+    // makes a newer mark unnecessary
+    TEST_ASSERT_TRUE(after.scheduleAt(makeCommand(3, kEpoch), 1000, kEpoch + 61));
+    for (uint32_t ms = 1000; ms <= 4000; ms += 500) {
+        after.update(ms, kEpoch + 61, recordCommand);
+    }
+    TEST_ASSERT_EQUAL(2, firedIds.size());
+    TEST_ASSERT_EQUAL(3, firedIds[1]);
+    TEST_ASSERT_EQUAL(1, store.saved.size());
+    TEST_ASSERT_EQUAL(kEpoch + 5, store.firedThrough);
+    TEST_ASSERT_FALSE(after.isDirty());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_timer_fires_on_due_tick_never_early);
+    RUN_TEST(test_timer_beyond_one_turn_waits_rounds);
+    RUN_TEST(test_cancel_and_pool_limit);
+    RUN_TEST(test_catch_up_is_spread_over_calls);
+    RUN_TEST(test_wheel_survives_millis_wrap);
+    RUN_TEST(test_scheduler_waits_for_wall_clock);
+    RUN_TEST(test_relative_and_absolute_fire_and_persist);
+    RUN_TEST(test_same_id_replaces_and_cancel_removes);
+    RUN_TEST(test_timers_restored_after_reboot);
+    RUN_TEST(test_stale_timers_dropped_on_restore);
+    RUN_TEST(test_changes_written_on_rate_limit);
+    RUN_TEST(test_fired_timer_not_refired_after_reboot);
+
+    UNITY_END();
+
+    return 0;
+}
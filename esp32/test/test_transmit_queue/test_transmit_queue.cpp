@@ -0,0 +1,324 @@
+#include <unity.h>
+#include <thread>
+#include "transmitter/IRLibProtocolEncoders.h"
+#include "transmitter/RmtIRTransmitter.h"
+#include "transmitter/TransmitQueue.h"
+#include "utils/SpscRing.h"
+#include "mock_rmt_channel.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+static uint64_t fakeNowUs = 0;
+static uint64_t fakeClock() { return fakeNowUs; }
+
+static TransmitRequest makeRequest(TransmitAction action, uint64_t value = 0xF708FB04) {
+    TransmitRequest request;
+    request.action = action;
+    request.protocol = IRProtocol::NEC;
+    request.value = value;
+    request.bits = 32;
+    request.enqueuedUs = 0;
+    return request;
+}
+
+// Queue wired to a mock RMT channel
+struct QueueRig {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter;
+    HoldRepeater repeater;
+    TransmitQueue queue;
+    
+    QueueRig()
+        : transmitter(&channel, &encoder),
+          repeater(&transmitter, &encoder),
+          queue(&transmitter, &repeater, fakeClock) {
+        transmitter.begin();
+        fakeNowUs = 0;
+    }
+};
+
+static bool submitAt(QueueRig& rig, const TransmitRequest& request, uint64_t nowUs) {
+    fakeNowUs = nowUs;
+    return rig.queue.submit(request);
+}
+
+static uint32_t serviceAt(QueueRig& rig, uint64_t nowUs) {
+    fakeNowUs = nowUs;
+    return rig.queue.service();
+}
+
+// ============== Ring Tests ==============
+
+void test_ring_is_fifo_and_bounded() {
+    SpscRing<int, 4> ring;
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(ring.push(i));
+    }
+    TEST_ASSERT_FALSE(ring.push(99));
+    TEST_ASSERT_EQUAL(4, ring.size());
+    
+    int value = -1;
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(ring.pop(&value));
+        TEST_ASSERT_EQUAL(i, value);
+    }
+    TEST_ASSERT_FALSE(ring.pop(&value));
+}
+
+void test_ring_indices_wrap() {
+    SpscRing<uint32_t, 2> ring;
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < 1000; i++) {
+        TEST_ASSERT_TRUE(ring.push(i));
+        TEST_ASSERT_TRUE(ring.pop(&value));
+        TEST_ASSERT_EQUAL(i, value);
+    }
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+void test_ring_threads_preserve_order() {
+    static SpscRing<uint32_t, 64> ring;
+    const uint32_t count = 200000;
+    
+    std::thread producer([&]() {
+        for (uint32_t i = 0; i < count; ) {
+            if (ring.push(i)) {
+                i++;
+            }
+        }
+    });
+    
+    uint32_t expected = 0;
+    bool ordered = true;
+    while (expected < count) {
+        uint32_t value;
+        if (ring.pop(&value)) {
+            ordered = ordered && value == expected;
+            expected++;
+        }
+    }
+    producer.join();
+    
+    TEST_ASSERT_TRUE(ordered);
+}
+
+// ============== Queue Tests ==============
+
+void test_service_transmits_and_records_wait() {
+    QueueRig rig;
+    
+    TEST_ASSERT_TRUE(submitAt(rig, makeRequest(TransmitAction::SEND), 1000));
+    TEST_ASSERT_EQUAL(0, rig.channel.writeCount);
+    
+    serviceAt(rig, 1750);
+    TEST_ASSERT_EQUAL(1, rig.channel.writeCount);
+    
+    TransmitQueueStats stats = rig.queue.getStats();
+    TEST_ASSERT_EQUAL(1, stats.submitted);
+    TEST_ASSERT_EQUAL(1, stats.completed);
+    TEST_ASSERT_EQUAL(0, stats.depth);
+    TEST_ASSERT_EQUAL(1, stats.maxDepth);
+    TEST_ASSERT_EQUAL(750, stats.lastWaitUs);
+    TEST_ASSERT_EQUAL(750, stats.maxWaitUs);
+    TEST_ASSERT_EQUAL(750, stats.meanWaitUs);
+}
+
+void test_full_ring_drops_and_counts() {
+    QueueRig rig;
+    for (size_t i = 0; i < TransmitQueue::kCapacity; i++) {
+        TEST_ASSERT_TRUE(submitAt(rig, makeRequest(TransmitAction::SEND), 0));
+    }
+    TEST_ASSERT_FALSE(submitAt(rig, makeRequest(TransmitAction::SEND), 0));
+    
+    TransmitQueueStats stats = rig.queue.getStats();
+    TEST_ASSERT_EQUAL(TransmitQueue::kCapacity, stats.depth);
+    TEST_ASSERT_EQUAL(TransmitQueue::kCapacity, stats.maxDepth);
+    TEST_ASSERT_EQUAL(1, stats.dropped);
+    
+    serviceAt(rig, 100);
+    TEST_ASSERT_EQUAL(TransmitQueue::kCapacity, rig.queue.getStats().completed);
+}
+
+void test_failures_counted() {
+    QueueRig rig;
+    TransmitRequest request = makeRequest(TransmitAction::SEND);
+    request.protocol = IRProtocol::UNKNOWN;
+    
+    submitAt(rig, request, 0);
+    serviceAt(rig, 0);
+    
+    TEST_ASSERT_EQUAL(1, rig.queue.getStats().failed);
+    TEST_ASSERT_EQUAL(0, rig.queue.getStats().completed);
+}
+
+void test_hold_runs_from_service_and_sets_sleep() {
+    QueueRig rig;
+    
+    submitAt(rig, makeRequest(TransmitAction::PRESS), 0);
+    uint32_t sleepMs = serviceAt(rig, 0);
+    TEST_ASSERT_EQUAL(100, sleepMs);  // Capped idle wait; repeat due at 108ms
+    TEST_ASSERT_EQUAL(8, serviceAt(rig, 100000));
+    
+    serviceAt(rig, 108000);
+    TEST_ASSERT_EQUAL(2, rig.channel.writeCount);
+    
+    submitAt(rig, makeRequest(TransmitAction::RELEASE), 110000);
+    serviceAt(rig, 110000);
+    serviceAt(rig, 216000);
+    TEST_ASSERT_EQUAL(2, rig.channel.writeCount);
+    
+    // The release is not a transmission
+    TEST_ASSERT_EQUAL(1, rig.queue.getStats().completed);
+}
+
+void test_raw_slots_copied_and_released() {
+    QueueRig rig;
+    uint16_t timings[] = {3000, 1000, 500, 1500, 500};
+    TransmitRequest request = makeRequest(TransmitAction::RAW);
+    request.carrierKHz = 40;
+    
+    // Both slots claimed; a third raw command waits for one to free up
+    TEST_ASSERT_TRUE(rig.queue.submitRaw(request, timings, 5));
+    timings[0] = 2000;  // Caller's buffer may be reused straight away
+    TEST_ASSERT_TRUE(rig.queue.submitRaw(request, timings, 5));
+    TEST_ASSERT_FALSE(rig.queue.submitRaw(request, timings, 5));
+    TEST_ASSERT_EQUAL(1, rig.queue.getStats().dropped);
+    
+    serviceAt(rig, 0);
+    TEST_ASSERT_EQUAL(2, rig.channel.writeCount);
+    TEST_ASSERT_EQUAL(40000, rig.channel.carrierFrequencyHz);
+    std::vector<uint16_t> emitted = rig.channel.timings();
+    TEST_ASSERT_EQUAL(2000, emitted[0]);
+    TEST_ASSERT_EQUAL(2, rig.queue.getStats().completed);
+    
+    TEST_ASSERT_TRUE(rig.queue.submitRaw(request, timings, 5));
+    TEST_ASSERT_FALSE(rig.queue.submitRaw(request, timings, 0));
+    TEST_ASSERT_FALSE(rig.queue.submitRaw(request, timings, raw_timing::kMaxTimings + 1));
+}
+
+void test_counted_send_spaced_by_frame_period() {
+    QueueRig rig;
+    TransmitRequest request = makeRequest(TransmitAction::SEND);
+    request.count = 3;
+    
+    submitAt(rig, request, 0);
+    submitAt(rig, makeRequest(TransmitAction::SEND, 0x1234), 0);
+    TEST_ASSERT_EQUAL(100, serviceAt(rig, 0));
+    TEST_ASSERT_EQUAL(1, rig.channel.writeCount);
+    
+    // NEC frames start 108ms apart; the request behind waits its turn
+    TEST_ASSERT_EQUAL(8, serviceAt(rig, 100000));
+    TEST_ASSERT_EQUAL(1, rig.channel.writeCount);
+    TEST_ASSERT_EQUAL(100, serviceAt(rig, 108000));
+    TEST_ASSERT_EQUAL(2, rig.channel.writeCount);
+    
+    serviceAt(rig, 216000);
+    TEST_ASSERT_EQUAL(3, rig.channel.writeCount);
+    TEST_ASSERT_EQUAL(2, rig.queue.getStats().burstFrames);
+    
+    // The queued command keeps a frame period after the last one
+    TEST_ASSERT_EQUAL(100, serviceAt(rig, 216500));
+    TEST_ASSERT_EQUAL(3, rig.channel.writeCount);
+    serviceAt(rig, 324000);
+    TEST_ASSERT_EQUAL(4, rig.channel.writeCount);
+    TEST_ASSERT_EQUAL(2, rig.queue.getStats().completed);
+}
+
+void test_request_carrier_applies_to_every_frame() {
+    QueueRig rig;
+    TransmitRequest request = makeRequest(TransmitAction::SEND);
+    request.count = 2;
+    request.carrierKHz = 56;
+    request.dutyPercent = 50;
+    
+    submitAt(rig, request, 0);
+    serviceAt(rig, 0);
+    rig.channel.setCarrier(38000, 33);
+    serviceAt(rig, 108000);
+    
+    // The burst frame keeps the command's carrier
+    TEST_ASSERT_EQUAL(2, rig.channel.writeCount);
+    TEST_ASSERT_EQUAL(56000, rig.channel.carrierFrequencyHz);
+    TEST_ASSERT_EQUAL(50, rig.channel.carrierDutyPercent);
+    
+    // RAW without a carrier falls back to the default
+    uint16_t timings[] = {3000, 1000, 500};
+    TransmitRequest raw = makeRequest(TransmitAction::RAW);
+    rig.queue.submitRaw(raw, timings, 3);
+    serviceAt(rig, 300000);
+    TEST_ASSERT_EQUAL(IR_DEFAULT_CARRIER_KHZ * 1000, rig.channel.carrierFrequencyHz);
+    TEST_ASSERT_EQUAL(IR_DEFAULT_DUTY_PERCENT, rig.channel.carrierDutyPercent);
+}
+
+void test_outputs_do_not_block_each_other() {
+    // One queue per emitter, as MultiChannelTransmitter wires them
+    QueueRig tv;
+    QueueRig amp;
+    TransmitRequest volume = makeRequest(TransmitAction::SEND);
+    volume.count = 5;
+    
+    submitAt(tv, volume, 0);
+    serviceAt(tv, 0);
+    submitAt(amp, makeRequest(TransmitAction::SEND, 0x1234), 1000);
+    serviceAt(amp, 1000);
+    
+    // The amp's frame goes out while the TV is mid-burst
+    TEST_ASSERT_EQUAL(1, amp.channel.writeCount);
+    TEST_ASSERT_EQUAL(0, amp.queue.getStats().lastWaitUs);
+    serviceAt(tv, 108000);
+    TEST_ASSERT_EQUAL(2, tv.channel.writeCount);
+    TEST_ASSERT_EQUAL(1, amp.channel.writeCount);
+}
+
+static uint64_t steppingNowUs = 0;
+static uint64_t steppingClock() {
+    steppingNowUs += 400;  // Each read: 400us of rendering and handover
+    return steppingNowUs;
+}
+
+void test_busy_time_accumulates_per_queue() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    RmtIRTransmitter transmitter(&channel, &encoder);
+    HoldRepeater repeater(&transmitter, &encoder);
+    TransmitQueue queue(&transmitter, &repeater, steppingClock);
+    transmitter.begin();
+    
+    TEST_ASSERT_EQUAL(0, queue.getStats().busyUs);
+    queue.submit(makeRequest(TransmitAction::SEND));
+    queue.submit(makeRequest(TransmitAction::SEND, 0x1234));
+    queue.service();
+    
+    // Start and end stamps are one clock read apart for each request
+    TEST_ASSERT_EQUAL(2, queue.getStats().completed);
+    TEST_ASSERT_EQUAL(800, queue.getStats().busyUs);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_ring_is_fifo_and_bounded);
+    RUN_TEST(test_ring_indices_wrap);
+    RUN_TEST(test_ring_threads_preserve_order);
+    RUN_TEST(test_service_transmits_and_records_wait);
+    RUN_TEST(test_full_ring_drops_and_counts);
+    RUN_TEST(test_failures_counted);
+    RUN_TEST(test_hold_runs_from_service_and_sets_sleep);
+    RUN_TEST(test_raw_slots_copied_and_released);
+    RUN_TEST(test_counted_send_spaced_by_frame_period);
+    RUN_TEST(test_request_carrier_applies_to_every_frame);
+    RUN_TEST(test_outputs_do_not_block_each_other);
+    RUN_TEST(test_busy_time_accumulates_per_queue);
+
+    UNITY_END();
+
+    return 0;
+}
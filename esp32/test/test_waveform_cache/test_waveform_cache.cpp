@@ -0,0 +1,172 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include "transmitter/IRLibProtocolEncoders.h"
+#include "transmitter/RmtIRTransmitter.h"
+#include "transmitter/WaveformCache.h"
+#include "mock_rmt_channel.h"
+
+// Unity requires these functions
+void setUp(void) {
+    // Set up before each test
+}
+
+void tearDown(void) {
+    // Clean up after each test
+}
+
+static const uint16_t kFrame[] = {9000, 4500, 560, 1690, 560};
+
+// ============== Cache Tests ==============
+
+void test_cache_miss_then_hit() {
+    WaveformCache cache(4, 16);
+    TEST_ASSERT_TRUE(cache.begin());
+    
+    uint16_t length = 0;
+    uint16_t frequency = 0;
+    TEST_ASSERT_NULL(cache.lookup(IRProtocol::NEC, 0xF708FB04, 32, &length, &frequency));
+    TEST_ASSERT_TRUE(cache.insert(IRProtocol::NEC, 0xF708FB04, 32, kFrame, 5, 38));
+    
+    const uint16_t* cached = cache.lookup(IRProtocol::NEC, 0xF708FB04, 32, &length, &frequency);
+    TEST_ASSERT_NOT_NULL(cached);
+    TEST_ASSERT_EQUAL(5, length);
+    TEST_ASSERT_EQUAL(38, frequency);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(kFrame, cached, 5);
+    
+    TEST_ASSERT_EQUAL(1, cache.getHits());
+    TEST_ASSERT_EQUAL(1, cache.getMisses());
+}
+
+void test_cache_key_includes_protocol_and_bits() {
+    WaveformCache cache(4, 16);
+    cache.begin();
+    cache.insert(IRProtocol::SONY, 0x95, 12, kFrame, 5, 40);
+    
+    uint16_t length = 0;
+    uint16_t frequency = 0;
+    TEST_ASSERT_NULL(cache.lookup(IRProtocol::SONY, 0x95, 15, &length, &frequency));
+    TEST_ASSERT_NULL(cache.lookup(IRProtocol::NEC, 0x95, 12, &length, &frequency));
+    TEST_ASSERT_NOT_NULL(cache.lookup(IRProtocol::SONY, 0x95, 12, &length, &frequency));
+}
+
+void test_cache_evicts_least_recently_used() {
+    WaveformCache cache(2, 16);
+    cache.begin();
+    
+    uint16_t length = 0;
+    uint16_t frequency = 0;
+    cache.insert(IRProtocol::NEC, 1, 32, kFrame, 5, 38);
+    cache.insert(IRProtocol::NEC, 2, 32, kFrame, 5, 38);
+    
+    // Touch 1 so 2 becomes the eviction candidate
+    cache.lookup(IRProtocol::NEC, 1, 32, &length, &frequency);
+    cache.insert(IRProtocol::NEC, 3, 32, kFrame, 5, 38);
+    
+    TEST_ASSERT_EQUAL(2, cache.size());
+    TEST_ASSERT_EQUAL(1, cache.getEvictions());
+    TEST_ASSERT_NOT_NULL(cache.lookup(IRProtocol::NEC, 1, 32, &length, &frequency));
+    TEST_ASSERT_NULL(cache.lookup(IRProtocol::NEC, 2, 32, &length, &frequency));
+    TEST_ASSERT_NOT_NULL(cache.lookup(IRProtocol::NEC, 3, 32, &length, &frequency));
+}
+
+void test_cache_rejects_oversized_frame() {
+    WaveformCache cache(2, 4);
+    cache.begin();
+    
+    TEST_ASSERT_FALSE(cache.insert(IRProtocol::NEC, 1, 32, kFrame, 5, 38));
+    TEST_ASSERT_EQUAL(0, cache.size());
+}
+
+void test_cache_rejects_zero_capacity() {
+    WaveformCache cache(0, 16);
+    TEST_ASSERT_FALSE(cache.begin());
+    TEST_ASSERT_FALSE(cache.insert(IRProtocol::NEC, 1, 32, kFrame, 5, 38));
+    
+    uint16_t length = 0;
+    uint16_t frequency = 0;
+    TEST_ASSERT_NULL(cache.lookup(IRProtocol::NEC, 1, 32, &length, &frequency));
+}
+
+void test_transmitter_reuses_cached_frame() {
+    MockRmtChannel channel;
+    IRLibProtocolEncoders encoder;
+    WaveformCache cache;
+    cache.begin();
+    RmtIRTransmitter transmitter(&channel, &encoder, &cache);
+    transmitter.begin();
+    
+    TEST_ASSERT_TRUE(transmitter.transmitNEC(0xF708FB04, 32).success);
+    std::vector<uint16_t> first = channel.timings();
+    TEST_ASSERT_TRUE(transmitter.transmitNEC(0xF708FB04, 32).success);
+    std::vector<uint16_t> second = channel.timings();
+    
+    TEST_ASSERT_EQUAL(1, cache.getHits());
+    TEST_ASSERT_EQUAL(1, cache.getMisses());
+    TEST_ASSERT_EQUAL(first.size(), second.size());
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(first.data(), second.data(), first.size());
+}
+
+// ============== Benchmark ==============
+
+// Per-press cost of rendering a frame: encoding through IRLibProtocolEncoders
+// versus a cache hit, over a working set of a few hot buttons
+void test_benchmark_cache_hit_vs_encode() {
+    const int kPresses = 20000;
+    const uint32_t kButtons[] = {0xF708FB04, 0xEF10FB04, 0xEE11FB04, 0xBF40FB04};
+    
+    IRLibProtocolEncoders encoder;
+    WaveformCache cache;
+    cache.begin();
+    
+    uint32_t checksum = 0;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kPresses; i++) {
+        EncodedSignal signal = encoder.encodeValue(IRProtocol::NEC, kButtons[i % 4], 32);
+        checksum += signal.rawData[2 + (i % 64)];
+    }
+    auto encodeTime = std::chrono::steady_clock::now() - start;
+    
+    for (int b = 0; b < 4; b++) {
+        EncodedSignal signal = encoder.encodeValue(IRProtocol::NEC, kButtons[b], 32);
+        cache.insert(IRProtocol::NEC, kButtons[b], 32, signal.rawData, signal.rawLength, signal.frequency);
+    }
+    
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kPresses; i++) {
+        uint16_t length = 0;
+        uint16_t frequency = 0;
+        const uint16_t* cached = cache.lookup(IRProtocol::NEC, kButtons[i % 4], 32, &length, &frequency);
+        checksum -= cached[2 + (i % 64)];
+    }
+    auto cacheTime = std::chrono::steady_clock::now() - start;
+    
+    double encodeNs = std::chrono::duration<double, std::nano>(encodeTime).count() / kPresses;
+    double cacheNs = std::chrono::duration<double, std::nano>(cacheTime).count() / kPresses;
+    
+    char message[128];
+    snprintf(message, sizeof(message), "[Bench] per press: encode %.1f ns, cache hit %.1f ns, saved %.1f ns",
+             encodeNs, cacheNs, encodeNs - cacheNs);
+    TEST_MESSAGE(message);
+    
+    TEST_ASSERT_EQUAL(0, checksum);
+    TEST_ASSERT_EQUAL((uint32_t)kPresses, cache.getHits());
+    TEST_ASSERT_TRUE(cacheNs < encodeNs);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_cache_miss_then_hit);
+    RUN_TEST(test_cache_key_includes_protocol_and_bits);
+    RUN_TEST(test_cache_evicts_least_recently_used);
+    RUN_TEST(test_cache_rejects_oversized_frame);
+    RUN_TEST(test_cache_rejects_zero_capacity);
+    RUN_TEST(test_transmitter_reuses_cached_frame);
+    RUN_TEST(test_benchmark_cache_hit_vs_encode);
+
+    UNITY_END();
+
+    return 0;
+}